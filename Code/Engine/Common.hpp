@@ -17,6 +17,7 @@
 #   define UNPACK ;__pragma(pack(pop))
 #	define THREAD_LOCAL __declspec(thread)
 #	define NOINLINE __declspec(noinline)
+#	define FORCEINLINE __forceinline
 #   ifndef _CRT_SECURE_NO_WARNINGS
 #       define _CRT_SECURE_NO_WARNINGS // CRT unsafe
 #   endif
@@ -40,6 +41,7 @@
 #   define UNPACK
 #   define THREAD_LOCAL __thread
 #	define NOINLINE __attribute__((noinline))
+#	define FORCEINLINE inline __attribute__((always_inline))
 #	define abstract =0
 #else
 #	warning "unknown compiler"
@@ -51,6 +53,7 @@
 #   define UNPACK
 #   define THREAD_LOCAL
 #	define NOINLINE
+#	define FORCEINLINE inline
 #endif
 
 #define COMPILER_MESSAGE(_prefix, _message) _PRAGMA_MESSAGE(_prefix ": " _message )
@@ -87,8 +90,10 @@
 //----------------------------------------------------------------------------//
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <time.h>
@@ -130,6 +135,9 @@ namespace Reax
 #	define ASSERT(cond, ...)
 #endif
 
+	//! Check the condition in all builds and terminate the program if it is false. For errors after which the program cannot continue safely.
+#define FATAL_ASSERT(cond, ...) ((cond) ? (void)0 : (Reax::Assert("Fatal error", __FUNCTION__, __FILE__, __LINE__, #cond, ##__VA_ARGS__), abort()))
+
 	//!
 	RX_API void Assert(const char* _type, const char* _func, const char* _file, int _line, const char* _desc, const char* _msg = nullptr, ...);
 
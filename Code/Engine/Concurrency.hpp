@@ -2,6 +2,7 @@
 
 #include "Common.hpp"
 #include <atomic>
+#include <thread>
 
 namespace Reax
 {
@@ -42,14 +43,14 @@ namespace Reax
 	//!
 	template<class T> void AtomicSet(T& _atom, T _value, MemoryOrder _order = MemoryOrder::Sequential)
 	{
-		ASSERT(_order == MemoryOrder::Relaxed || _order == MemoryOrder::Consume || _order == MemoryOrder::Acquire || _order == MemoryOrder::Sequential);
+		ASSERT(_order == MemoryOrder::Relaxed || _order == MemoryOrder::Release || _order == MemoryOrder::Sequential);
 		std::atomic_store_explicit(reinterpret_cast<std::atomic<T>*>(&_atom), _value, _StdMemoryOrder(_order));
 	}
 	//!
 	template<class T> void AtomicSet(T*& _atom, void* _value, MemoryOrder _order = MemoryOrder::Sequential)
 	{
-		ASSERT(_order == MemoryOrder::Relaxed || _order == MemoryOrder::Consume || _order == MemoryOrder::Acquire || _order == MemoryOrder::Sequential);
-		std::atomic_store_explicit(reinterpret_cast<std::atomic<T*>*>(&_atom), _value, _StdMemoryOrder(_order));
+		ASSERT(_order == MemoryOrder::Relaxed || _order == MemoryOrder::Release || _order == MemoryOrder::Sequential);
+		std::atomic_store_explicit(reinterpret_cast<std::atomic<T*>*>(&_atom), static_cast<T*>(_value), _StdMemoryOrder(_order));
 	}
 	//! \return Previous value.
 	template<class T> T AtomicAdd(T& _atom, T _value, MemoryOrder _order = MemoryOrder::Sequential)
@@ -297,14 +298,49 @@ namespace Reax
 	//
 	//----------------------------------------------------------------------------//
 
-	class SpinLock
+	//! Busy-wait lock for very short critical sections.
+	class SpinLock : public NonCopyable
 	{
 	public:
+		//!
+		SpinLock(void) = default;
+		//!
+		~SpinLock(void) { ASSERT(m_lock.Get() == 0, "Lock is acquired"); }
+
+		//!
+		bool TryLock(void) { return m_lock.CompareExchange(0, 1, MemoryOrder::Acquire); }
+		//!
+		void Lock(void)
+		{
+			while (!TryLock())
+			{
+				while (m_lock.Get()); // wait without a write to the cache line
+			}
+		}
+		//!
+		void Unlock(void) { m_lock.Set(0, MemoryOrder::Release); }
 
 	protected:
 		Atomic<int> m_lock;
 	};
 
+	//----------------------------------------------------------------------------//
+	// ScopeLock
+	//----------------------------------------------------------------------------//
+
+	//! Lock guard for any type with Lock and Unlock methods.
+	template <class T> class ScopeLock : public NonCopyable
+	{
+	public:
+		//!
+		ScopeLock(T& _lock) : m_lock(_lock) { m_lock.Lock(); }
+		//!
+		~ScopeLock(void) { m_lock.Unlock(); }
+
+	protected:
+		T& m_lock;
+	};
+
 	//----------------------------------------------------------------------------//
 	//
 	//----------------------------------------------------------------------------//
@@ -376,6 +412,43 @@ namespace Reax
 	protected:
 	};
 
+	//----------------------------------------------------------------------------//
+	// Parallel
+	//----------------------------------------------------------------------------//
+
+	//! Number of logical processors.
+	inline uint CpuCount(void)
+	{
+		uint _count = std::thread::hardware_concurrency();
+		return _count ? _count : 1;
+	}
+
+	//! Call _func(uint _index) for each _index in [0, _count) on separate threads and wait for all of them.
+	//! The calling thread runs the index 0. Intended for a few heavy jobs (e.g. one per processor), not for fine-grained tasks.
+	//! At most 64 threads are used, greater indices are run sequentially by the same threads (thread i runs i, i + 64, ...).
+	template <class F> void RunParallel(uint _count, const F& _func)
+	{
+		static const uint MAX_THREADS = 64;
+		if (_count <= 1)
+		{
+			if (_count)
+				_func(0u);
+			return;
+		}
+		uint _numThreads = _count < MAX_THREADS ? _count : MAX_THREADS;
+		auto _run = [&_func, _count, _numThreads](uint _first)
+		{
+			for (uint i = _first; i < _count; i += _numThreads)
+				_func(i);
+		};
+		std::thread _threads[MAX_THREADS];
+		for (uint i = 1; i < _numThreads; ++i)
+			_threads[i] = std::thread(_run, i);
+		_run(0u);
+		for (uint i = 1; i < _numThreads; ++i)
+			_threads[i].join();
+	}
+
 	//----------------------------------------------------------------------------//
 	//
 	//----------------------------------------------------------------------------//
@@ -3,6 +3,9 @@
 #include "Common.hpp"
 #include <initializer_list>
 #include <iterator>
+#ifdef _WIN32
+#	include <malloc.h>
+#endif
 
 namespace Reax
 {
@@ -19,6 +22,29 @@ namespace Reax
 	template <class T> T* Allocate(uint _count) { return reinterpret_cast<T*>(new uint8[_count * sizeof(T)]); }
 	//! Delete memory block.
 	template <class T> void Deallocate(T* _ptr) { delete[] reinterpret_cast<uint8*>(_ptr); }
+	//! Get new memory block aligned to _align (power of two). new[] guarantees only 8 bytes on 32-bit platforms.
+	template <class T> T* AllocateAligned(uint _size, uint _align)
+	{
+#ifdef _WIN32
+		void* _ptr = _aligned_malloc(_size, _align);
+#else
+		void* _ptr = nullptr;
+		if (posix_memalign(&_ptr, _align < sizeof(void*) ? sizeof(void*) : _align, _size))
+			_ptr = nullptr;
+#endif
+		if (!_ptr)
+			throw std::bad_alloc();
+		return reinterpret_cast<T*>(_ptr);
+	}
+	//! Delete memory block of AllocateAligned.
+	template <class T> void DeallocateAligned(T* _ptr)
+	{
+#ifdef _WIN32
+		_aligned_free(_ptr);
+#else
+		free(_ptr);
+#endif
+	}
 	//!	Grow size.
 	inline uint GrowTo(uint _currentSize, uint _newSize)
 	{
@@ -42,7 +68,7 @@ namespace Reax
 	template <class T> T* DestroyRange(T* _dst, T* _end)
 	{
 		for (; _dst < _end; ++_dst)
-			Destroy(_dst++);
+			Destroy(_dst);
 		return _dst;
 	}
 
@@ -301,7 +327,7 @@ namespace Reax
 			}
 			else if (_size > m_size)
 			{
-				if (Unused() < _size)
+				if (m_capacity < _size)
 					_Realloc(GrowTo(m_capacity, _size));
 				ConstructRange(m_data + m_size, m_data + _size);
 				m_size = _size;
@@ -318,7 +344,7 @@ namespace Reax
 			}
 			else if (_size > m_size)
 			{
-				if (Unused() < _size)
+				if (m_capacity < _size)
 					_Realloc(GrowTo(m_capacity, _size));
 				ConstructRange(m_data + m_size, m_data + _size, _value);
 				m_size = _size;
@@ -1371,10 +1397,12 @@ namespace Reax
 			while (m_size)
 			{
 				Node* _head = m_tail.m_next;
-				Node* _next = _head->m_next;
 				_head->m_next->m_prev = _head->m_prev;
 				_head->m_prev->m_next = _head->m_next;
 				--m_size;
+
+				Destroy(&_head->m_value);
+				Deallocate(_head);
 			}
 			memset(m_buckets, 0, m_numBuckets * sizeof(m_buckets[0]));
 			return *this;
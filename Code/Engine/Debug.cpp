@@ -20,6 +20,7 @@ namespace Reax
 			va_end(_args);
 		}
 		printf("\n");
+		fflush(stdout);
 	}
 
 	//----------------------------------------------------------------------------//
@@ -0,0 +1,430 @@
+#include "Entity.hpp"
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// ComponentInfo
+	//----------------------------------------------------------------------------//
+
+	static ComponentInfo s_componentTypes[MAX_COMPONENT_TYPES];
+	static uint s_numComponentTypes = 0;
+
+	//----------------------------------------------------------------------------//
+	uint ComponentInfo::Register(const ComponentInfo& _info)
+	{
+		uint _id = AtomicAdd(s_numComponentTypes, 1u);
+		FATAL_ASSERT(_id < MAX_COMPONENT_TYPES, "Too many types of components");
+		FATAL_ASSERT(_info.align <= MAX_COMPONENT_ALIGN, "Alignment of component must be not more than 16");
+		s_componentTypes[_id] = _info;
+		return _id;
+	}
+	//----------------------------------------------------------------------------//
+	const ComponentInfo& ComponentInfo::Get(uint _id)
+	{
+		ASSERT(_id < AtomicGet(s_numComponentTypes, MemoryOrder::Relaxed));
+		return s_componentTypes[_id];
+	}
+
+	//----------------------------------------------------------------------------//
+	// Archetype
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	Archetype::Archetype(ComponentMask _mask) :
+		m_mask(_mask)
+	{
+		uint _entitySize = sizeof(Entity);
+		for (uint i = 0; i < MAX_COMPONENT_TYPES; ++i)
+		{
+			m_offsets[i] = 0;
+			if (Has(i))
+			{
+				m_components.Push(i);
+				_entitySize += ComponentInfo::Get(i).size;
+			}
+		}
+
+		// the largest capacity at which all arrays with alignment padding fit in the chunk
+		for (m_capacity = EntityChunk::DATA_SIZE / _entitySize; m_capacity > 0; --m_capacity)
+		{
+			uint _offset = m_capacity * sizeof(Entity);
+			for (uint i : m_components)
+			{
+				const ComponentInfo& _info = ComponentInfo::Get(i);
+				_offset = (_offset + _info.align - 1) & ~(_info.align - 1);
+				m_offsets[i] = (uint16)_offset;
+				_offset += m_capacity * _info.size;
+			}
+			if (_offset <= EntityChunk::DATA_SIZE)
+				break;
+		}
+		FATAL_ASSERT(m_capacity > 0, "Components are too large for a chunk");
+	}
+	//----------------------------------------------------------------------------//
+	Archetype::~Archetype(void)
+	{
+		for (EntityChunk* _chunk : m_chunks)
+		{
+			for (uint i : m_components)
+			{
+				const ComponentInfo& _info = ComponentInfo::Get(i);
+				uint8* _data = Components(_chunk, i);
+				for (uint j = 0; j < _chunk->count; ++j, _data += _info.size)
+					_info.destruct(_data);
+			}
+			DeallocateAligned(_chunk);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void Archetype::_Push(const Entity& _entity, EntityChunk*& _chunk, uint& _row)
+	{
+		if (m_chunks.IsEmpty() || m_chunks.Back()->count == m_capacity)
+		{
+			EntityChunk* _newChunk = AllocateAligned<EntityChunk>(EntityChunk::SIZE, EntityChunk::ALIGN);
+			_newChunk->archetype = this;
+			_newChunk->count = 0;
+			m_chunks.Push(_newChunk);
+		}
+
+		_chunk = m_chunks.Back();
+		_row = _chunk->count++;
+		Entities(_chunk)[_row] = _entity;
+		++m_size;
+	}
+	//----------------------------------------------------------------------------//
+	Entity Archetype::_Erase(EntityChunk* _chunk, uint _row)
+	{
+		EntityChunk* _last = m_chunks.Back();
+		uint _lastRow = _last->count - 1;
+		Entity _moved;
+
+		if (_chunk != _last || _row != _lastRow)
+		{
+			for (uint i : m_components)
+			{
+				const ComponentInfo& _info = ComponentInfo::Get(i);
+				_info.move(Components(_chunk, i) + _row * _info.size, Components(_last, i) + _lastRow * _info.size);
+			}
+			_moved = Entities(_last)[_lastRow];
+			Entities(_chunk)[_row] = _moved;
+		}
+
+		--m_size;
+		if (!--_last->count)
+		{
+			DeallocateAligned(_last);
+			m_chunks.Pop();
+		}
+
+		return _moved;
+	}
+
+	//----------------------------------------------------------------------------//
+	// EntityWorld
+	//----------------------------------------------------------------------------//
+
+	RX_TYPE(EntityWorld)
+	{
+	}
+
+	//----------------------------------------------------------------------------//
+	EntityWorld::EntityWorld(void)
+	{
+	}
+	//----------------------------------------------------------------------------//
+	EntityWorld::~EntityWorld(void)
+	{
+		for (Archetype* _archetype : m_archetypes)
+			delete _archetype;
+	}
+	//----------------------------------------------------------------------------//
+	Entity EntityWorld::Create(ComponentMask _components)
+	{
+		Entity _entity;
+		if (m_free.NonEmpty())
+		{
+			_entity.index = m_free.Back();
+			m_free.Pop();
+		}
+		else
+		{
+			_entity.index = m_records.Size();
+			m_records.Push({ nullptr, nullptr, 0, 0 });
+		}
+
+		_Record& _record = m_records[_entity.index];
+		_entity.generation = _record.generation;
+		_record.archetype = _GetArchetype(_components);
+		_record.archetype->_Push(_entity, _record.chunk, _record.row);
+
+		for (uint i : _record.archetype->m_components)
+		{
+			const ComponentInfo& _info = ComponentInfo::Get(i);
+			_info.construct(_record.archetype->Components(_record.chunk, i) + _record.row * _info.size);
+		}
+
+		++m_size;
+		return _entity;
+	}
+	//----------------------------------------------------------------------------//
+	void EntityWorld::Destroy(const Entity& _entity)
+	{
+		if (!IsAlive(_entity))
+			return;
+
+		_Record& _record = m_records[_entity.index];
+		Archetype* _archetype = _record.archetype;
+		for (uint i : _archetype->m_components)
+		{
+			const ComponentInfo& _info = ComponentInfo::Get(i);
+			_info.destruct(_archetype->Components(_record.chunk, i) + _record.row * _info.size);
+		}
+
+		_Moved(_archetype->_Erase(_record.chunk, _record.row), _record.chunk, _record.row);
+
+		_record.archetype = nullptr;
+		_record.chunk = nullptr;
+		++_record.generation;
+		m_free.Push(_entity.index);
+		--m_size;
+	}
+	//----------------------------------------------------------------------------//
+	void* EntityWorld::AddComponent(const Entity& _entity, uint _component, void* _src)
+	{
+		ASSERT(IsAlive(_entity));
+		ASSERT(_component < MAX_COMPONENT_TYPES);
+
+		_Record& _record = m_records[_entity.index];
+		if (_record.archetype->Has(_component))
+		{
+			void* _dst = GetComponent(_entity, _component);
+			if (_src)
+			{
+				const ComponentInfo& _info = ComponentInfo::Get(_component);
+				_info.destruct(_dst);
+				_info.move(_dst, _src);
+			}
+			return _dst;
+		}
+
+		_Move(_entity, _GetArchetype(_record.archetype->m_mask | ((ComponentMask)1 << _component)), _component, _src);
+		return GetComponent(_entity, _component);
+	}
+	//----------------------------------------------------------------------------//
+	void EntityWorld::RemoveComponent(const Entity& _entity, uint _component)
+	{
+		ASSERT(IsAlive(_entity));
+		ASSERT(_component < MAX_COMPONENT_TYPES);
+
+		_Record& _record = m_records[_entity.index];
+		if (_record.archetype->Has(_component))
+			_Move(_entity, _GetArchetype(_record.archetype->m_mask & ~((ComponentMask)1 << _component)), MAX_COMPONENT_TYPES, nullptr);
+	}
+	//----------------------------------------------------------------------------//
+	void* EntityWorld::GetComponent(const Entity& _entity, uint _component) const
+	{
+		if (!IsAlive(_entity))
+			return nullptr;
+
+		const _Record& _record = m_records[_entity.index];
+		if (!_record.archetype->Has(_component))
+			return nullptr;
+
+		return _record.archetype->Components(_record.chunk, _component) + _record.row * ComponentInfo::Get(_component).size;
+	}
+	//----------------------------------------------------------------------------//
+	Archetype* EntityWorld::_GetArchetype(ComponentMask _mask)
+	{
+		auto _iter = m_archetypesByMask.Find(_mask);
+		if (_iter != m_archetypesByMask.End())
+			return _iter->second;
+
+		Archetype* _archetype = new Archetype(_mask);
+		m_archetypes.Push(_archetype);
+		m_archetypesByMask[_mask] = _archetype;
+		return _archetype;
+	}
+	//----------------------------------------------------------------------------//
+	void EntityWorld::_Move(const Entity& _entity, Archetype* _to, uint _component, void* _src)
+	{
+		_Record& _record = m_records[_entity.index];
+		Archetype* _from = _record.archetype;
+		EntityChunk* _chunk;
+		uint _row;
+		_to->_Push(_entity, _chunk, _row);
+
+		for (uint i : _from->m_components)
+		{
+			const ComponentInfo& _info = ComponentInfo::Get(i);
+			uint8* _old = _from->Components(_record.chunk, i) + _record.row * _info.size;
+			if (_to->Has(i))
+				_info.move(_to->Components(_chunk, i) + _row * _info.size, _old);
+			else
+				_info.destruct(_old);
+		}
+		for (uint i : _to->m_components)
+		{
+			if (_from->Has(i))
+				continue;
+
+			const ComponentInfo& _info = ComponentInfo::Get(i);
+			uint8* _new = _to->Components(_chunk, i) + _row * _info.size;
+			if (i == _component && _src)
+				_info.move(_new, _src);
+			else
+				_info.construct(_new);
+		}
+
+		EntityChunk* _oldChunk = _record.chunk;
+		uint _oldRow = _record.row;
+		_record.archetype = _to;
+		_record.chunk = _chunk;
+		_record.row = _row;
+
+		_Moved(_from->_Erase(_oldChunk, _oldRow), _oldChunk, _oldRow);
+	}
+	//----------------------------------------------------------------------------//
+	void EntityWorld::_Moved(const Entity& _entity, EntityChunk* _chunk, uint _row)
+	{
+		if (!_entity.IsNull())
+		{
+			_Record& _record = m_records[_entity.index];
+			_record.chunk = _chunk;
+			_record.row = _row;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void EntityWorld::_GatherChunks(ComponentMask _mask, Array<EntityChunk*>& _chunks) const
+	{
+		for (Archetype* a : m_archetypes)
+		{
+			if ((a->m_mask & _mask) == _mask)
+				_chunks.Push(a->m_chunks.Data(), a->m_chunks.Size());
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	// EntityCommandBuffer
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	EntityCommandBuffer::~EntityCommandBuffer(void)
+	{
+		Clear();
+		for (_Page& _page : m_pages)
+			DeallocateAligned(_page.data);
+	}
+	//----------------------------------------------------------------------------//
+	Entity EntityCommandBuffer::Create(ComponentMask _components)
+	{
+		Entity _entity;
+		_entity.index = DEFERRED | m_numCreated++;
+		_Push(OP_Create, _entity, 0, _components, 0);
+		return _entity;
+	}
+	//----------------------------------------------------------------------------//
+	void EntityCommandBuffer::Destroy(const Entity& _entity)
+	{
+		_Push(OP_Destroy, _entity, 0, 0, 0);
+	}
+	//----------------------------------------------------------------------------//
+	void EntityCommandBuffer::Playback(EntityWorld& _world)
+	{
+		Array<Entity> _created;
+		_created.Reserve(m_numCreated);
+
+		for (const _Page& _page : m_pages)
+		{
+			for (uint _offset = 0; _offset < _page.size;)
+			{
+				_Command* _cmd = reinterpret_cast<_Command*>(_page.data + _offset);
+				void* _value = _page.data + _offset + COMMAND_SIZE;
+				_offset += _cmd->size;
+
+				Entity _entity = _cmd->entity;
+				if (!_entity.IsNull() && (_entity.index & DEFERRED) && _cmd->op != OP_Create)
+					_entity = _created[_entity.index & ~DEFERRED];
+
+				switch (_cmd->op)
+				{
+				case OP_Create:
+					_created.Push(_world.Create(_cmd->mask));
+					break;
+
+				case OP_Destroy:
+					_world.Destroy(_entity);
+					break;
+
+				case OP_Add:
+					if (_world.IsAlive(_entity))
+						_world.AddComponent(_entity, _cmd->component, _value);
+					else
+						ComponentInfo::Get(_cmd->component).destruct(_value);
+					break;
+
+				case OP_Remove:
+					if (_world.IsAlive(_entity))
+						_world.RemoveComponent(_entity, _cmd->component);
+					break;
+				}
+			}
+		}
+
+		_Reset();
+	}
+	//----------------------------------------------------------------------------//
+	void EntityCommandBuffer::Clear(void)
+	{
+		for (const _Page& _page : m_pages)
+		{
+			for (uint _offset = 0; _offset < _page.size;)
+			{
+				_Command* _cmd = reinterpret_cast<_Command*>(_page.data + _offset);
+				if (_cmd->op == OP_Add)
+					ComponentInfo::Get(_cmd->component).destruct(_page.data + _offset + COMMAND_SIZE);
+				_offset += _cmd->size;
+			}
+		}
+
+		_Reset();
+	}
+	//----------------------------------------------------------------------------//
+	void* EntityCommandBuffer::_Push(uint _op, const Entity& _entity, uint _component, ComponentMask _mask, uint _valueSize)
+	{
+		uint _size = COMMAND_SIZE + ((_valueSize + 15) & ~15);
+		if (m_pages.IsEmpty() || m_pages[m_page].size + _size > m_pages[m_page].capacity)
+		{
+			if (m_pages.NonEmpty() && m_pages[m_page].size)
+				++m_page;
+			if (m_page == m_pages.Size())
+				m_pages.Push({ nullptr, 0, 0 });
+
+			_Page& _next = m_pages[m_page];
+			if (_next.capacity < _size)
+			{
+				DeallocateAligned(_next.data);
+				_next.capacity = _size > PAGE_SIZE ? _size : PAGE_SIZE;
+				_next.data = AllocateAligned<uint8>(_next.capacity, MAX_COMPONENT_ALIGN);
+			}
+		}
+
+		_Page& _page = m_pages[m_page];
+		_Command* _cmd = reinterpret_cast<_Command*>(_page.data + _page.size);
+		_cmd->op = (uint16)_op;
+		_cmd->component = (uint16)_component;
+		_cmd->size = _size;
+		_cmd->entity = _entity;
+		_cmd->mask = _mask;
+		_page.size += _size;
+
+		return reinterpret_cast<uint8*>(_cmd) + COMMAND_SIZE;
+	}
+	//----------------------------------------------------------------------------//
+	void EntityCommandBuffer::_Reset(void)
+	{
+		for (_Page& _page : m_pages)
+			_page.size = 0;
+		m_page = 0;
+		m_numCreated = 0;
+	}
+}
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "Object.hpp"
+
+namespace Reax
+{
+	//!\addtogroup Scene
+	//!\{
+
+	class Archetype;
+	class EntityWorld;
+
+	//----------------------------------------------------------------------------//
+	// Entity
+	//----------------------------------------------------------------------------//
+
+	//! Handle of entity. The generation is changed when the entity is destroyed, so old handles become invalid.
+	struct Entity
+	{
+		static const uint NONE = ~0u;
+
+		//!
+		bool IsNull(void) const { return index == NONE; }
+		//!
+		bool operator == (const Entity& _rhs) const { return index == _rhs.index && generation == _rhs.generation; }
+		//!
+		bool operator != (const Entity& _rhs) const { return !(*this == _rhs); }
+
+		uint index = NONE;
+		uint generation = 0;
+	};
+
+	//----------------------------------------------------------------------------//
+	// Component
+	//----------------------------------------------------------------------------//
+
+	//! Set of component types, one bit per ComponentType::Id.
+	typedef uint64 ComponentMask;
+
+	//!
+	static const uint MAX_COMPONENT_TYPES = 64;
+	//! Maximal alignment of component.
+	static const uint MAX_COMPONENT_ALIGN = 16;
+
+	//! Description of type of component. Components are stored in chunks and can be moved between them,
+	//! any copyable or movable type with alignment up to 16 can be used.
+	struct RX_API ComponentInfo
+	{
+		//! Default-construct the value.
+		typedef void(*ConstructFunc)(void* _dst);
+		//!
+		typedef void(*DestructFunc)(void* _dst);
+		//! Move-construct _dst from _src and destroy _src.
+		typedef void(*MoveFunc)(void* _dst, void* _src);
+
+		//! Register a type of component. Returns its id. Terminates the program if there are more than MAX_COMPONENT_TYPES types
+		//! or the alignment is more than MAX_COMPONENT_ALIGN. \see ComponentType
+		static uint Register(const ComponentInfo& _info);
+		//!
+		static const ComponentInfo& Get(uint _id);
+
+		uint size;
+		uint align;
+		ConstructFunc construct;
+		DestructFunc destruct;
+		MoveFunc move;
+	};
+
+	//! Id of type of component. The types are registered on first use.
+	template <class T> struct ComponentType
+	{
+		//!
+		static uint Id(void)
+		{
+			static_assert(alignof(T) <= MAX_COMPONENT_ALIGN, "Alignment of component must be not more than 16");
+			static const uint _id = ComponentInfo::Register({ sizeof(T), alignof(T), &_Construct, &_Destruct, &_Move });
+			return _id;
+		}
+		//!
+		static ComponentMask Mask(void) { return (ComponentMask)1 << Id(); }
+
+	protected:
+		static void _Construct(void* _dst) { new(_dst) T(); }
+		static void _Destruct(void* _dst) { reinterpret_cast<T*>(_dst)->~T(); }
+		static void _Move(void* _dst, void* _src)
+		{
+			new(_dst) T(Move(*reinterpret_cast<T*>(_src)));
+			reinterpret_cast<T*>(_src)->~T();
+		}
+	};
+
+	//! Mask of component types.
+	template <class... T> ComponentMask ComponentMaskOf(void)
+	{
+		ComponentMask _masks[] = { 0, ComponentType<T>::Mask()... };
+		ComponentMask _mask = 0;
+		for (ComponentMask i : _masks)
+			_mask |= i;
+		return _mask;
+	}
+
+	//----------------------------------------------------------------------------//
+	// EntityChunk
+	//----------------------------------------------------------------------------//
+
+	//! Block of memory with entities of one archetype. The data is stored as structure of arrays:
+	//! array of Entity followed by one array per component, so iteration reads memory linearly.
+	struct EntityChunk
+	{
+		//! Size of chunk including the header.
+		static const uint SIZE = 16 * 1024;
+		//! Size of the header. The data is aligned to the cache line.
+		static const uint HEADER_SIZE = 64;
+		//! Alignment of chunk.
+		static const uint ALIGN = 64;
+		//!
+		static const uint DATA_SIZE = SIZE - HEADER_SIZE;
+
+		//!
+		uint8* Data(void) { return reinterpret_cast<uint8*>(this) + HEADER_SIZE; }
+
+		Archetype* archetype;
+		//! Number of entities.
+		uint count;
+	};
+
+	//----------------------------------------------------------------------------//
+	// Archetype
+	//----------------------------------------------------------------------------//
+
+	//! Storage of all entities with the same set of components. All chunks except the last one are full.
+	class RX_API Archetype : public NonCopyable
+	{
+	public:
+		//!
+		Archetype(ComponentMask _mask);
+		//! Destroys all components.
+		~Archetype(void);
+
+		//!
+		ComponentMask Mask(void) const { return m_mask; }
+		//!
+		bool Has(uint _component) const { return ((m_mask >> _component) & 1) != 0; }
+		//! Number of entities.
+		uint Size(void) const { return m_size; }
+		//! Number of entities in one chunk.
+		uint Capacity(void) const { return m_capacity; }
+		//!
+		const Array<EntityChunk*>& Chunks(void) const { return m_chunks; }
+		//! Component types, in order of id.
+		const Array<uint>& Components(void) const { return m_components; }
+
+		//!
+		Entity* Entities(EntityChunk* _chunk) const { return reinterpret_cast<Entity*>(_chunk->Data()); }
+		//! Array of the components in the chunk.
+		uint8* Components(EntityChunk* _chunk, uint _component) const { ASSERT(Has(_component)); return _chunk->Data() + m_offsets[_component]; }
+		//!
+		template <class T> T* Components(EntityChunk* _chunk) const { return reinterpret_cast<T*>(Components(_chunk, ComponentType<T>::Id())); }
+
+	protected:
+		friend class EntityWorld;
+
+		//! Add entity to the end. Components are not constructed.
+		void _Push(const Entity& _entity, EntityChunk*& _chunk, uint& _row);
+		//! Remove the entity by moving the last entity to its place. The components must be destroyed already.
+		//! Returns the moved entity or Null.
+		Entity _Erase(EntityChunk* _chunk, uint _row);
+
+		ComponentMask m_mask;
+		Array<uint> m_components;
+		//! Offset of array of components in chunk, by component id.
+		uint16 m_offsets[MAX_COMPONENT_TYPES];
+		uint m_capacity = 0;
+		uint m_size = 0;
+		Array<EntityChunk*> m_chunks;
+	};
+
+	//----------------------------------------------------------------------------//
+	// EntityWorld
+	//----------------------------------------------------------------------------//
+
+	//! Container of entities and their components.
+	//! Structural changes (creation, destruction, adding and removing of components) move the entities between archetypes,
+	//! so they are not allowed during iteration. Use EntityCommandBuffer to defer them.
+	class RX_API EntityWorld : public Object
+	{
+		RX_OBJECT(EntityWorld, Object);
+
+	public:
+		//!
+		EntityWorld(void);
+		//!
+		~EntityWorld(void);
+
+		//! Create entity with default-constructed components.
+		Entity Create(ComponentMask _components = 0);
+		//!
+		void Destroy(const Entity& _entity);
+		//!
+		bool IsAlive(const Entity& _entity) const { return _entity.index < m_records.Size() && m_records[_entity.index].generation == _entity.generation && m_records[_entity.index].archetype; }
+		//! Number of entities.
+		uint Size(void) const { return m_size; }
+		//!
+		ComponentMask GetMask(const Entity& _entity) const { ASSERT(IsAlive(_entity)); return m_records[_entity.index].archetype->m_mask; }
+
+		//! Add a component. If _src is not null, the component is moved from it and _src is destroyed,
+		//! otherwise a new component is default-constructed and existing one is kept.
+		void* AddComponent(const Entity& _entity, uint _component, void* _src = nullptr);
+		//!
+		void RemoveComponent(const Entity& _entity, uint _component);
+		//! Returns nullptr if the entity has no such component.
+		void* GetComponent(const Entity& _entity, uint _component) const;
+
+		//!
+		template <class T> T& Add(const Entity& _entity, const T& _value = T())
+		{
+			T* _component = reinterpret_cast<T*>(AddComponent(_entity, ComponentType<T>::Id()));
+			*_component = _value;
+			return *_component;
+		}
+		//!
+		template <class T> void Remove(const Entity& _entity) { RemoveComponent(_entity, ComponentType<T>::Id()); }
+		//!
+		template <class T> T* Get(const Entity& _entity) const { return reinterpret_cast<T*>(GetComponent(_entity, ComponentType<T>::Id())); }
+		//!
+		template <class T> bool Has(const Entity& _entity) const { return (GetMask(_entity) & ComponentType<T>::Mask()) != 0; }
+
+		//! Call _func(uint _count, const Entity* _entities, T*... _components) for each chunk with all components T.
+		template <class... T, class F> void ForEachChunk(const F& _func) const
+		{
+			ComponentMask _mask = ComponentMaskOf<T...>();
+			for (Archetype* a : m_archetypes)
+			{
+				if ((a->m_mask & _mask) == _mask)
+				{
+					for (EntityChunk* c : a->m_chunks)
+						_func(c->count, const_cast<const Entity*>(a->Entities(c)), a->template Components<T>(c)...);
+				}
+			}
+		}
+		//! Call _func(const Entity& _entity, T&... _components) for each entity with all components T.
+		template <class... T, class F> void ForEach(const F& _func) const
+		{
+			ForEachChunk<T...>([&_func](uint _count, const Entity* _entities, T*... _components)
+			{
+				for (uint i = 0; i < _count; ++i)
+					_func(_entities[i], _components[i]...);
+			});
+		}
+		//! Parallel ForEachChunk. The chunks are distributed dynamically between _threads threads (0 - all processors).
+		template <class... T, class F> void ForEachChunkParallel(const F& _func, uint _threads = 0) const
+		{
+			Array<EntityChunk*> _chunks;
+			_GatherChunks(ComponentMaskOf<T...>(), _chunks);
+			if (!_threads)
+				_threads = CpuCount();
+			if (_threads > _chunks.Size())
+				_threads = _chunks.Size();
+
+			uint _next = 0;
+			RunParallel(_threads, [&](uint)
+			{
+				for (uint i; (i = AtomicAdd(_next, 1u, MemoryOrder::Relaxed)) < _chunks.Size();)
+				{
+					EntityChunk* c = _chunks[i];
+					Archetype* a = c->archetype;
+					_func(c->count, const_cast<const Entity*>(a->Entities(c)), a->template Components<T>(c)...);
+				}
+			});
+		}
+		//! Parallel ForEach.
+		template <class... T, class F> void ForEachParallel(const F& _func, uint _threads = 0) const
+		{
+			ForEachChunkParallel<T...>([&_func](uint _count, const Entity* _entities, T*... _components)
+			{
+				for (uint i = 0; i < _count; ++i)
+					_func(_entities[i], _components[i]...);
+			}, _threads);
+		}
+
+		//!
+		const Array<Archetype*>& Archetypes(void) const { return m_archetypes; }
+
+	protected:
+		//!
+		struct _Record
+		{
+			Archetype* archetype;
+			EntityChunk* chunk;
+			uint row;
+			uint generation;
+		};
+
+		//! Find or create archetype.
+		Archetype* _GetArchetype(ComponentMask _mask);
+		//! Move the entity to other archetype. The new component _component is moved from _src or default-constructed.
+		void _Move(const Entity& _entity, Archetype* _to, uint _component, void* _src);
+		//! Update the record of entity moved by Archetype::_Erase.
+		void _Moved(const Entity& _entity, EntityChunk* _chunk, uint _row);
+		//! Get chunks with all components of _mask.
+		void _GatherChunks(ComponentMask _mask, Array<EntityChunk*>& _chunks) const;
+
+		Array<_Record> m_records;
+		Array<uint> m_free;
+		uint m_size = 0;
+		Array<Archetype*> m_archetypes;
+		HashMap<ComponentMask, Archetype*> m_archetypesByMask;
+	};
+
+	//----------------------------------------------------------------------------//
+	// EntityCommandBuffer
+	//----------------------------------------------------------------------------//
+
+	//! Deferred structural changes of EntityWorld. Can be filled during iteration (one buffer per thread) and played back after it.
+	//! The components are stored in pages of the buffer until playback. The pages are never reallocated, so the components are not relocated.
+	class RX_API EntityCommandBuffer : public NonCopyable
+	{
+	public:
+		//!
+		EntityCommandBuffer(void) = default;
+		//!
+		~EntityCommandBuffer(void);
+
+		//! Create entity. The returned handle can be used only in commands of this buffer.
+		Entity Create(ComponentMask _components = 0);
+		//!
+		void Destroy(const Entity& _entity);
+		//!
+		template <class T> void Add(const Entity& _entity, const T& _value = T()) { new(_Push(OP_Add, _entity, ComponentType<T>::Id(), 0, sizeof(T))) T(_value); }
+		//!
+		template <class T> void Remove(const Entity& _entity) { _Push(OP_Remove, _entity, ComponentType<T>::Id(), 0, 0); }
+
+		//! Execute all commands and clear the buffer. Commands for dead entities are ignored.
+		void Playback(EntityWorld& _world);
+		//! Remove all commands. The pages are kept for reuse.
+		void Clear(void);
+		//!
+		bool IsEmpty(void) const { return m_pages.IsEmpty() || !m_pages[0].size; }
+
+	protected:
+		//! Bit of index of entity created by this buffer.
+		static const uint DEFERRED = 0x80000000;
+
+		enum Op : uint16
+		{
+			OP_Create,
+			OP_Destroy,
+			OP_Add,
+			OP_Remove,
+		};
+
+		//! Header of command. The value of component follows it.
+		struct _Command
+		{
+			uint16 op;
+			uint16 component;
+			//! Size of command including the value.
+			uint size;
+			Entity entity;
+			ComponentMask mask;
+		};
+
+		//! Size of _Command aligned to 16.
+		static const uint COMMAND_SIZE = (sizeof(_Command) + 15) & ~15;
+		//! Size of page. Larger commands get a page of their size.
+		static const uint PAGE_SIZE = 16 * 1024;
+
+		//! Block of commands aligned to MAX_COMPONENT_ALIGN. Only the pages up to m_page are not empty.
+		struct _Page
+		{
+			uint8* data;
+			uint size;
+			uint capacity;
+		};
+
+		//! Add a command and return pointer to its value.
+		void* _Push(uint _op, const Entity& _entity, uint _component, ComponentMask _mask, uint _valueSize);
+		//! Empty all pages.
+		void _Reset(void);
+
+		Array<_Page> m_pages;
+		uint m_page = 0;
+		uint m_numCreated = 0;
+	};
+
+	//!\} Scene
+}
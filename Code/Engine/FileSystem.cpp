@@ -0,0 +1,708 @@
+#include "FileSystem.hpp"
+#include <mutex>
+#include <condition_variable>
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	if defined(__linux__) && defined(__has_include)
+#		if __has_include(<linux/io_uring.h>)
+#			include <linux/io_uring.h>
+#			include <sys/syscall.h>
+#			define RX_IO_URING
+#		endif
+#	endif
+#endif
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// MappedFile
+	//----------------------------------------------------------------------------//
+
+#ifdef _WIN32
+
+	//----------------------------------------------------------------------------//
+	bool MappedFile::Open(const char* _path, uint _hints)
+	{
+		Close();
+
+		DWORD _flags = FILE_ATTRIBUTE_NORMAL;
+		if (_hints & H_Sequential)
+			_flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+		else if (_hints & H_Random)
+			_flags |= FILE_FLAG_RANDOM_ACCESS;
+
+		HANDLE _file = CreateFileW(String::ToWide(_path).CStr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, _flags, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER _size;
+		if (!GetFileSizeEx(_file, &_size))
+		{
+			CloseHandle(_file);
+			return false;
+		}
+
+		m_file = _file;
+		m_size = (uint64)_size.QuadPart;
+		m_open = true;
+
+		if (m_size) // empty file cannot be mapped
+		{
+			m_mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			m_data = m_mapping ? reinterpret_cast<const uint8*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+			if (!m_data)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		if (_hints & H_WillNeed)
+			Advise(H_WillNeed);
+
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	void MappedFile::Close(void)
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+		m_open = false;
+	}
+	//----------------------------------------------------------------------------//
+	void MappedFile::Advise(uint _hints, uint64 _offset, uint64 _size) const
+	{
+		if (!m_data || _offset >= m_size)
+			return;
+
+		// read-ahead is set by flags of the file, huge pages are not supported for mapped files
+		if (_hints & H_WillNeed)
+		{
+			WIN32_MEMORY_RANGE_ENTRY _range;
+			_range.VirtualAddress = const_cast<uint8*>(m_data + _offset);
+			_range.NumberOfBytes = (SIZE_T)(_size < m_size - _offset ? _size : m_size - _offset);
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &_range, 0);
+		}
+	}
+
+#else
+
+	//----------------------------------------------------------------------------//
+	bool MappedFile::Open(const char* _path, uint _hints)
+	{
+		Close();
+
+		int _file = open(_path, O_RDONLY | O_CLOEXEC);
+		if (_file < 0)
+			return false;
+
+		struct stat _stat;
+		if (fstat(_file, &_stat))
+		{
+			close(_file);
+			return false;
+		}
+
+		m_size = (uint64)_stat.st_size;
+		m_open = true;
+
+		if (m_size) // empty file cannot be mapped
+		{
+			void* _data = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_PRIVATE, _file, 0);
+			m_data = _data != MAP_FAILED ? reinterpret_cast<const uint8*>(_data) : nullptr;
+		}
+		close(_file); // the mapping holds the file
+
+		if (m_size && !m_data)
+		{
+			Close();
+			return false;
+		}
+
+		if (_hints)
+			Advise(_hints);
+
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	void MappedFile::Close(void)
+	{
+		if (m_data)
+			munmap(const_cast<uint8*>(m_data), (size_t)m_size);
+
+		m_data = nullptr;
+		m_size = 0;
+		m_open = false;
+	}
+	//----------------------------------------------------------------------------//
+	void MappedFile::Advise(uint _hints, uint64 _offset, uint64 _size) const
+	{
+		if (!m_data || _offset >= m_size)
+			return;
+
+		uint64 _page = (uint64)sysconf(_SC_PAGESIZE);
+		uint64 _end = _size < m_size - _offset ? _offset + _size : m_size;
+		_offset &= ~(_page - 1);
+		void* _start = const_cast<uint8*>(m_data + _offset);
+		size_t _length = (size_t)(_end - _offset);
+
+		if (_hints & H_Sequential)
+			madvise(_start, _length, MADV_SEQUENTIAL);
+		else if (_hints & H_Random)
+			madvise(_start, _length, MADV_RANDOM);
+#ifdef MADV_HUGEPAGE
+		if (_hints & H_HugePages)
+			madvise(_start, _length, MADV_HUGEPAGE);
+#endif
+		if (_hints & H_WillNeed)
+			madvise(_start, _length, MADV_WILLNEED);
+	}
+
+#endif
+
+	//----------------------------------------------------------------------------//
+	// IoRing
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_IO_URING
+
+	//! Minimal io_uring without liburing.
+	struct _IoRing
+	{
+		//!
+		bool Init(uint _entries)
+		{
+			io_uring_params _params;
+			memset(&_params, 0, sizeof(_params));
+			fd = (int)syscall(__NR_io_uring_setup, _entries, &_params);
+			if (fd < 0)
+				return false;
+
+			// IORING_OP_READ is available since the same kernel as IORING_FEAT_RW_CUR_POS (5.6)
+			if (!(_params.features & IORING_FEAT_RW_CUR_POS))
+			{
+				Destroy();
+				return false;
+			}
+
+			sqSize = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+			cqSize = _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe);
+			sqesSize = _params.sq_entries * sizeof(io_uring_sqe);
+			bool _single = (_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (_single)
+				sqSize = cqSize = sqSize > cqSize ? sqSize : cqSize;
+
+			sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			cqPtr = _single ? sqPtr : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			void* _sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+			if (sqPtr == MAP_FAILED || cqPtr == MAP_FAILED || _sqes == MAP_FAILED)
+			{
+				if (_sqes != MAP_FAILED)
+					munmap(_sqes, sqesSize);
+				if (sqPtr == MAP_FAILED)
+					sqPtr = nullptr;
+				if (cqPtr == MAP_FAILED)
+					cqPtr = nullptr;
+				Destroy();
+				return false;
+			}
+
+			uint8* _sq = reinterpret_cast<uint8*>(sqPtr);
+			uint8* _cq = reinterpret_cast<uint8*>(cqPtr);
+			sqHead = reinterpret_cast<unsigned*>(_sq + _params.sq_off.head);
+			sqTail = reinterpret_cast<unsigned*>(_sq + _params.sq_off.tail);
+			sqMask = *reinterpret_cast<unsigned*>(_sq + _params.sq_off.ring_mask);
+			sqEntries = _params.sq_entries;
+			sqArray = reinterpret_cast<unsigned*>(_sq + _params.sq_off.array);
+			sqes = reinterpret_cast<io_uring_sqe*>(_sqes);
+			cqHead = reinterpret_cast<unsigned*>(_cq + _params.cq_off.head);
+			cqTail = reinterpret_cast<unsigned*>(_cq + _params.cq_off.tail);
+			cqMask = *reinterpret_cast<unsigned*>(_cq + _params.cq_off.ring_mask);
+			cqes = reinterpret_cast<io_uring_cqe*>(_cq + _params.cq_off.cqes);
+
+			return true;
+		}
+		//!
+		void Destroy(void)
+		{
+			if (sqes)
+				munmap(sqes, sqesSize);
+			if (cqPtr && cqPtr != sqPtr)
+				munmap(cqPtr, cqSize);
+			if (sqPtr)
+				munmap(sqPtr, sqSize);
+			if (fd >= 0)
+				close(fd);
+
+			sqes = nullptr;
+			sqPtr = nullptr;
+			cqPtr = nullptr;
+			fd = -1;
+		}
+		//! Add an entry to the submission queue. Must be synchronized with other producers.
+		bool Push(const io_uring_sqe& _sqe)
+		{
+			unsigned _tail = *sqTail;
+			if (_tail - AtomicGet(*sqHead, MemoryOrder::Acquire) >= sqEntries)
+				return false;
+
+			unsigned _index = _tail & sqMask;
+			sqes[_index] = _sqe;
+			sqArray[_index] = _index;
+			AtomicSet(*sqTail, _tail + 1, MemoryOrder::Release);
+			return true;
+		}
+		//! Take an entry from the completion queue. Single consumer.
+		bool Pop(io_uring_cqe& _cqe)
+		{
+			unsigned _head = *cqHead;
+			if (_head == AtomicGet(*cqTail, MemoryOrder::Acquire))
+				return false;
+
+			_cqe = cqes[_head & cqMask];
+			AtomicSet(*cqHead, _head + 1, MemoryOrder::Release);
+			return true;
+		}
+		//! Submit all queued entries and wait for _wait completions.
+		int Enter(uint _wait)
+		{
+			unsigned _submit = AtomicGet(*sqTail, MemoryOrder::Acquire) - AtomicGet(*sqHead, MemoryOrder::Acquire);
+			return (int)syscall(__NR_io_uring_enter, fd, _submit, _wait, _wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+		}
+
+		int fd = -1;
+		void* sqPtr = nullptr;
+		void* cqPtr = nullptr;
+		size_t sqSize = 0;
+		size_t cqSize = 0;
+		size_t sqesSize = 0;
+		unsigned* sqHead = nullptr;
+		unsigned* sqTail = nullptr;
+		unsigned* sqArray = nullptr;
+		unsigned sqMask = 0;
+		unsigned sqEntries = 0;
+		io_uring_sqe* sqes = nullptr;
+		unsigned* cqHead = nullptr;
+		unsigned* cqTail = nullptr;
+		unsigned cqMask = 0;
+		io_uring_cqe* cqes = nullptr;
+	};
+
+#endif
+
+	//----------------------------------------------------------------------------//
+	// FileSystem::_Impl
+	//----------------------------------------------------------------------------//
+
+	struct FileSystem::_Impl
+	{
+		static const uint MAX_THREADS = 16;
+		//! Max size of one read request.
+		static const uint MAX_READ = 1 << 30;
+
+#ifdef RX_IO_URING
+		//! Add read of the next part of the file to the ring. The mutex must be locked.
+		bool SubmitRead(AsyncRead* _request)
+		{
+			uint _size = _request->m_data.Size() - _request->m_offset;
+			io_uring_sqe _sqe;
+			memset(&_sqe, 0, sizeof(_sqe));
+			_sqe.opcode = IORING_OP_READ;
+			_sqe.fd = _request->m_file;
+			_sqe.addr = (uint64)(size_t)(_request->m_data.Data() + _request->m_offset);
+			_sqe.len = _size < MAX_READ ? _size : MAX_READ;
+			_sqe.off = _request->m_offset;
+			_sqe.user_data = (uint64)(size_t)_request;
+
+			if (!ring.Push(_sqe))
+				return false;
+			ring.Enter(0); // on error the entry stays in the queue and is submitted by the next call
+			return true;
+		}
+
+		_IoRing ring;
+#endif
+
+		std::mutex mutex;
+		//! Signal for the workers.
+		std::condition_variable queueSignal;
+		//! Signal for the waiting threads.
+		std::condition_variable doneSignal;
+		AsyncRead* first = nullptr;
+		AsyncRead* last = nullptr;
+		uint pending = 0;
+		bool stop = false;
+		std::thread threads[MAX_THREADS];
+		uint numThreads = 0;
+	};
+
+	//----------------------------------------------------------------------------//
+	// AsyncRead
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	bool AsyncRead::Wait(void)
+	{
+		if (GetState() == State::Pending)
+		{
+			std::unique_lock<std::mutex> _lock(m_owner->m_impl->mutex);
+			while (GetState() == State::Pending)
+				m_owner->m_impl->doneSignal.wait(_lock);
+		}
+		return GetState() == State::Done;
+	}
+	//----------------------------------------------------------------------------//
+	void AsyncRead::_Complete(State _state)
+	{
+#ifndef _WIN32
+		if (m_file >= 0)
+			close(m_file);
+#endif
+		m_file = -1;
+		if (_state != State::Done)
+			m_data.Clear();
+
+		// the request can be deleted by a waiting thread as soon as the state is set
+		FileSystem::_Impl* _impl = m_owner->m_impl;
+		std::lock_guard<std::mutex> _lock(_impl->mutex);
+		AtomicSet(m_state, (int)_state, MemoryOrder::Release);
+		--_impl->pending;
+		_impl->doneSignal.notify_all();
+	}
+
+	//----------------------------------------------------------------------------//
+	// FileSystem
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	FileSystem::FileSystem(uint _threads) :
+		m_impl(new _Impl)
+	{
+#ifdef RX_IO_URING
+		if (m_impl->ring.Init(64))
+		{
+			m_impl->threads[0] = std::thread(&FileSystem::_Completions, this);
+			m_impl->numThreads = 1;
+			return;
+		}
+#endif
+		if (!_threads)
+			_threads = 4; // the threads mostly wait for the disk
+		m_impl->numThreads = _threads < _Impl::MAX_THREADS ? _threads : _Impl::MAX_THREADS;
+		for (uint i = 0; i < m_impl->numThreads; ++i)
+			m_impl->threads[i] = std::thread(&FileSystem::_Worker, this);
+	}
+	//----------------------------------------------------------------------------//
+	FileSystem::~FileSystem(void)
+	{
+		{
+			std::unique_lock<std::mutex> _lock(m_impl->mutex);
+			while (m_impl->pending)
+				m_impl->doneSignal.wait(_lock);
+
+			m_impl->stop = true;
+			m_impl->queueSignal.notify_all();
+
+#ifdef RX_IO_URING
+			if (m_impl->ring.fd >= 0)
+			{
+				// wake up the completion thread
+				io_uring_sqe _sqe;
+				memset(&_sqe, 0, sizeof(_sqe));
+				_sqe.opcode = IORING_OP_NOP;
+				while (!m_impl->ring.Push(_sqe))
+					std::this_thread::yield();
+				m_impl->ring.Enter(0);
+			}
+#endif
+		}
+
+		for (uint i = 0; i < m_impl->numThreads; ++i)
+			m_impl->threads[i].join();
+
+#ifdef RX_IO_URING
+		m_impl->ring.Destroy();
+#endif
+		delete m_impl;
+	}
+	//----------------------------------------------------------------------------//
+	bool FileSystem::Read(const char* _path, AsyncRead& _request)
+	{
+		ASSERT(!_request.IsPending(), "The request is pending");
+
+		_request.m_owner = this;
+		_request.m_next = nullptr;
+		_request.m_path = _path;
+		_request.m_data.Clear();
+		_request.m_offset = 0;
+
+#ifdef RX_IO_URING
+		if (m_impl->ring.fd >= 0)
+		{
+			// open in the calling thread, only the data is read asynchronously
+			int _file = open(_path, O_RDONLY | O_CLOEXEC);
+			struct stat _stat;
+			if (_file < 0 || fstat(_file, &_stat) || (uint64)_stat.st_size > 0xffffffff)
+			{
+				if (_file >= 0)
+					close(_file);
+				_request.m_state = (int)AsyncRead::State::Failed;
+				return false;
+			}
+
+			_request.m_data.Resize((uint)_stat.st_size);
+			if (_request.m_data.IsEmpty())
+			{
+				close(_file);
+				_request.m_state = (int)AsyncRead::State::Done;
+				return true;
+			}
+
+			_request.m_file = _file;
+			_request.m_state = (int)AsyncRead::State::Pending;
+
+			std::lock_guard<std::mutex> _lock(m_impl->mutex);
+			if (!m_impl->SubmitRead(&_request))
+			{
+				close(_file);
+				_request.m_file = -1;
+				_request.m_data.Clear();
+				_request.m_state = (int)AsyncRead::State::Failed;
+				return false;
+			}
+			++m_impl->pending;
+			return true;
+		}
+#endif
+
+		_request.m_state = (int)AsyncRead::State::Pending;
+
+		std::lock_guard<std::mutex> _lock(m_impl->mutex);
+		if (m_impl->last)
+			m_impl->last->m_next = &_request;
+		else
+			m_impl->first = &_request;
+		m_impl->last = &_request;
+		++m_impl->pending;
+		m_impl->queueSignal.notify_one();
+
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	void FileSystem::Prefetch(const char* _path)
+	{
+#ifdef _WIN32
+		// the pages stay in the file cache after unmapping
+		MappedFile _file;
+		_file.Open(_path, MappedFile::H_WillNeed);
+#else
+		int _file = open(_path, O_RDONLY | O_CLOEXEC);
+		if (_file >= 0)
+		{
+#	ifdef POSIX_FADV_WILLNEED
+			posix_fadvise(_file, 0, 0, POSIX_FADV_WILLNEED); // starts read-ahead and returns
+#	endif
+			close(_file);
+		}
+#endif
+	}
+	//----------------------------------------------------------------------------//
+	bool FileSystem::UsesIoRing(void) const
+	{
+#ifdef RX_IO_URING
+		return m_impl->ring.fd >= 0;
+#else
+		return false;
+#endif
+	}
+	//----------------------------------------------------------------------------//
+	void FileSystem::_Worker(void)
+	{
+		std::unique_lock<std::mutex> _lock(m_impl->mutex);
+		for (;;)
+		{
+			while (!m_impl->first && !m_impl->stop)
+				m_impl->queueSignal.wait(_lock);
+
+			AsyncRead* _request = m_impl->first;
+			if (!_request)
+				break;
+
+			m_impl->first = _request->m_next;
+			if (!m_impl->first)
+				m_impl->last = nullptr;
+
+			_lock.unlock();
+			bool _result = ReadFile(_request->m_path.CStr(), _request->m_data);
+			_request->_Complete(_result ? AsyncRead::State::Done : AsyncRead::State::Failed);
+			_lock.lock();
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void FileSystem::_Completions(void)
+	{
+#ifdef RX_IO_URING
+		_IoRing& _ring = m_impl->ring;
+		for (;;)
+		{
+			io_uring_cqe _cqe;
+			if (!_ring.Pop(_cqe))
+			{
+				_ring.Enter(1);
+				continue;
+			}
+
+			AsyncRead* _request = reinterpret_cast<AsyncRead*>((size_t)_cqe.user_data);
+			if (!_request)
+				break; // see ~FileSystem
+
+			if (_cqe.res > 0)
+				_request->m_offset += (uint)_cqe.res;
+			else if (_cqe.res != -EINTR && _cqe.res != -EAGAIN) // error or the file was truncated
+			{
+				_request->_Complete(AsyncRead::State::Failed);
+				continue;
+			}
+
+			if (_request->m_offset < _request->m_data.Size())
+			{
+				// short read
+				std::lock_guard<std::mutex> _lock(m_impl->mutex);
+				if (m_impl->SubmitRead(_request))
+					continue;
+			}
+
+			_request->_Complete(_request->m_offset == _request->m_data.Size() ? AsyncRead::State::Done : AsyncRead::State::Failed);
+		}
+#endif
+	}
+	//----------------------------------------------------------------------------//
+	bool FileSystem::ReadFile(const char* _path, Array<uint8>& _dst)
+	{
+#ifdef _WIN32
+		HANDLE _file = CreateFileW(String::ToWide(_path).CStr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER _size;
+		if (!GetFileSizeEx(_file, &_size) || (uint64)_size.QuadPart > 0xffffffff)
+		{
+			CloseHandle(_file);
+			return false;
+		}
+
+		_dst.Resize((uint)_size.QuadPart);
+		uint _offset = 0;
+		while (_offset < _dst.Size())
+		{
+			DWORD _read = 0;
+			uint _count = _dst.Size() - _offset;
+			if (!::ReadFile(_file, _dst.Data() + _offset, _count < _Impl::MAX_READ ? _count : _Impl::MAX_READ, &_read, nullptr) || !_read)
+				break;
+			_offset += _read;
+		}
+		CloseHandle(_file);
+#else
+		int _file = open(_path, O_RDONLY | O_CLOEXEC);
+		if (_file < 0)
+			return false;
+
+		struct stat _stat;
+		if (fstat(_file, &_stat) || (uint64)_stat.st_size > 0xffffffff)
+		{
+			close(_file);
+			return false;
+		}
+
+		_dst.Resize((uint)_stat.st_size);
+		uint _offset = 0;
+		while (_offset < _dst.Size())
+		{
+			uint _count = _dst.Size() - _offset;
+			ssize_t _read = read(_file, _dst.Data() + _offset, _count < _Impl::MAX_READ ? _count : _Impl::MAX_READ);
+			if (_read < 0 && errno == EINTR)
+				continue;
+			if (_read <= 0)
+				break;
+			_offset += (uint)_read;
+		}
+		close(_file);
+#endif
+		if (_offset < _dst.Size())
+		{
+			_dst.Clear();
+			return false;
+		}
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	bool FileSystem::WriteFile(const char* _path, const void* _data, uint _size)
+	{
+		const uint8* _src = reinterpret_cast<const uint8*>(_data);
+		uint _offset = 0;
+#ifdef _WIN32
+		HANDLE _file = CreateFileW(String::ToWide(_path).CStr(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		while (_offset < _size)
+		{
+			DWORD _written = 0;
+			if (!::WriteFile(_file, _src + _offset, _size - _offset, &_written, nullptr) || !_written)
+				break;
+			_offset += _written;
+		}
+		CloseHandle(_file);
+#else
+		int _file = open(_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (_file < 0)
+			return false;
+
+		while (_offset < _size)
+		{
+			ssize_t _written = write(_file, _src + _offset, _size - _offset);
+			if (_written < 0 && errno == EINTR)
+				continue;
+			if (_written <= 0)
+				break;
+			_offset += (uint)_written;
+		}
+		if (close(_file))
+			return false;
+#endif
+		return _offset == _size;
+	}
+	//----------------------------------------------------------------------------//
+	bool FileSystem::FileSize(const char* _path, uint64& _size)
+	{
+#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA _attribs;
+		if (!GetFileAttributesExW(String::ToWide(_path).CStr(), GetFileExInfoStandard, &_attribs) || (_attribs.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			return false;
+		_size = ((uint64)_attribs.nFileSizeHigh << 32) | _attribs.nFileSizeLow;
+#else
+		struct stat _stat;
+		if (stat(_path, &_stat) || !S_ISREG(_stat.st_mode))
+			return false;
+		_size = (uint64)_stat.st_size;
+#endif
+		return true;
+	}
+}
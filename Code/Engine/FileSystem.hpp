@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Container.hpp"
+#include "String.hpp"
+#include "Concurrency.hpp"
+
+namespace Reax
+{
+	//!\addtogroup Base
+	//!\{
+
+	//----------------------------------------------------------------------------//
+	// MappedFile
+	//----------------------------------------------------------------------------//
+
+	//! Read-only file mapped to memory. The pages are loaded by the OS on first access, so opening is cheap
+	//! and the data can be used in place (e.g. by BlobView) without copying.
+	class RX_API MappedFile : public NonCopyable
+	{
+	public:
+		//! Access hints. Only a hint, unsupported ones are ignored.
+		enum Hint
+		{
+			H_Normal = 0,
+			//! The data will be read once from start to end. Increases read-ahead.
+			H_Sequential = 0x1,
+			//! The data will be read in random order. Disables read-ahead.
+			H_Random = 0x2,
+			//! Start loading of the pages in background.
+			H_WillNeed = 0x4,
+			//! Use huge pages if the file system supports them.
+			H_HugePages = 0x8,
+		};
+
+		//!
+		MappedFile(void) = default;
+		//!
+		~MappedFile(void) { Close(); }
+
+		//! Map whole file. Returns false if the file cannot be opened.
+		bool Open(const char* _path, uint _hints = H_Normal);
+		//!
+		void Close(void);
+		//! Apply hints to a range of the file.
+		void Advise(uint _hints, uint64 _offset = 0, uint64 _size = ~0ull) const;
+
+		//!
+		bool IsOpen(void) const { return m_open; }
+		//! Null for empty file.
+		const uint8* Data(void) const { return m_data; }
+		//!
+		uint64 Size(void) const { return m_size; }
+		//!
+		StringView View(void) const { ASSERT(m_size < 0xffffffff); return StringView(reinterpret_cast<const char*>(m_data), (uint)m_size); }
+
+	protected:
+		const uint8* m_data = nullptr;
+		uint64 m_size = 0;
+		bool m_open = false;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+
+	//----------------------------------------------------------------------------//
+	// AsyncRead
+	//----------------------------------------------------------------------------//
+
+	//! Request of asynchronous reading of whole file. \see FileSystem::Read
+	//! The file is read directly to Data(), there are no intermediate buffers.
+	class RX_API AsyncRead : public NonCopyable
+	{
+	public:
+		//!
+		enum class State
+		{
+			Idle,
+			Pending,
+			Done,
+			Failed,
+		};
+
+		//!
+		AsyncRead(void) = default;
+		//! Waits for the request.
+		~AsyncRead(void) { Wait(); }
+
+		//!
+		State GetState(void) const { return static_cast<State>(AtomicGet(const_cast<int&>(m_state), MemoryOrder::Acquire)); }
+		//!
+		bool IsPending(void) const { return GetState() == State::Pending; }
+		//!
+		bool IsDone(void) const { return GetState() == State::Done; }
+		//! Wait for completion. Returns true if the file was read successfully.
+		bool Wait(void);
+
+		//! Content of the file. Valid if IsDone.
+		Array<uint8>& Data(void) { return m_data; }
+		//!
+		const String& Path(void) const { return m_path; }
+
+	protected:
+		friend class FileSystem;
+
+		//!
+		void _Complete(State _state);
+
+		class FileSystem* m_owner = nullptr;
+		AsyncRead* m_next = nullptr;
+		String m_path;
+		Array<uint8> m_data;
+		uint m_offset = 0;
+		int m_file = -1;
+		int m_state = (int)State::Idle;
+	};
+
+	//----------------------------------------------------------------------------//
+	// FileSystem
+	//----------------------------------------------------------------------------//
+
+#define gFileSystem FileSystem::Instance
+
+	//! File I/O. Asynchronous reads use io_uring on Linux if the kernel supports it, otherwise a few threads with blocking reads.
+	class RX_API FileSystem : public Singleton<FileSystem>, public NonCopyable
+	{
+	public:
+		//! _threads is number of threads for blocking reads, 0 - default.
+		FileSystem(uint _threads = 0);
+		//! Waits for all requests.
+		~FileSystem(void);
+
+		//! Start reading of whole file. The request must not be pending and must be alive until it is completed.
+		//! Returns false if the request cannot be started, the state of the request is Failed then.
+		bool Read(const char* _path, AsyncRead& _request);
+		//! Ask the OS to load the file to the cache in background. Doesn't wait for anything.
+		void Prefetch(const char* _path);
+		//! Returns true if the requests are performed by io_uring.
+		bool UsesIoRing(void) const;
+
+		//! Read whole file to _dst. Returns false on error or if the file is larger than 4 GB.
+		static bool ReadFile(const char* _path, Array<uint8>& _dst);
+		//! Create or overwrite a file.
+		static bool WriteFile(const char* _path, const void* _data, uint _size);
+		//! Returns false if the file doesn't exist.
+		static bool FileSize(const char* _path, uint64& _size);
+
+	protected:
+		friend class AsyncRead;
+		struct _Impl;
+
+		//! Thread of blocking reads.
+		void _Worker(void);
+		//! Thread of io_uring completions.
+		void _Completions(void);
+
+		_Impl* m_impl;
+	};
+
+	//!\} Base
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.hpp"
+#include "Simd.hpp"
 #include <math.h>
 
 namespace Reax
@@ -48,21 +49,89 @@ namespace Reax
 
 	//! 
 	inline float Sqrt(float _x) { return sqrt(_x); }
-	//! 
+
+	// Fast approximations. Sin, Cos, SinCos, ATan2, Exp2 and Log2 use the same operations as their vector versions
+	// (_V4SinCos etc.) and give the same results. Maximum errors are measured against double precision libm.
+
+	//! Bits of float.
+	inline uint _FloatBits(float _x) { union { float f; uint i; }_fb = { _x }; return _fb.i; }
+	//! Float from bits.
+	inline float _BitsFloat(uint _x) { union { uint i; float f; }_fb = { _x }; return _fb.f; }
+
+	// Adding and subtracting 1.5 * 2^23 rounds a float to the nearest integer (|x| < 2^22), the integer is in the low bits of the sum.
+	static const float _ROUND_MAGIC = 12582912.0f;
+
+	// Polynomial coefficients of the fast functions.
+	static const float _SIN_C0 = -1.6666654611e-1f, _SIN_C1 = 8.3321608736e-3f, _SIN_C2 = -1.9515295891e-4f; // sin(x) on [-pi/4, pi/4]
+	static const float _COS_C0 = 4.166664568298827e-2f, _COS_C1 = -1.388731625493765e-3f, _COS_C2 = 2.443315711809948e-5f; // cos(x) on [-pi/4, pi/4]
+	static const float _PIO2_1 = 1.5703125f, _PIO2_2 = 4.837512969970703125e-4f, _PIO2_3 = 7.54978995489188216e-8f; // pi/2 = _PIO2_1 + _PIO2_2 + _PIO2_3
+	static const float _ATAN_C0 = 0.999999417f, _ATAN_C1 = -0.333270133f, _ATAN_C2 = 0.198873212f, _ATAN_C3 = -0.135121762f, _ATAN_C4 = 0.0843541024f, _ATAN_C5 = -0.0374429959f, _ATAN_C6 = 0.00800690688f; // atan(x) / x on [0, 1]
+	static const float _EXP2_C0 = 1.00000007f, _EXP2_C1 = 0.693146967f, _EXP2_C2 = 0.240221197f, _EXP2_C3 = 0.0555071327f, _EXP2_C4 = 0.00967554133f, _EXP2_C5 = 0.0013276472f; // 2^x on [-0.5, 0.5]
+	static const float _LOG2_C0 = 2.88539043f, _LOG2_C1 = 0.961587859f, _LOG2_C2 = 0.595796565f; // log2((1 + t) / (1 - t)) / t on [-0.172, 0.172]
+	static const float _SQRT2 = 1.41421356f;
+	// Greater angles lose precision in the reduction, so Sin, Cos and SinCos compute them by libm.
+	static const float _SINCOS_MAX = 8192.0f;
+
+	//! Reciprocal square root. Max relative error: 3e-7 with SSE (estimate and Newton step), 2e-7 with NEON (estimate and two steps).
 	inline float RSqrt(float _x)
 	{
-		TODO("Use asm");
+#if defined(RX_SSE2)
+		float _y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(_x)));
+		return _y * (1.5f - (0.5f * _x) * _y * _y);
+#elif defined(RX_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+		float _y = vrsqrtes_f32(_x);
+		_y *= vrsqrtss_f32(_x * _y, _y);
+		return _y * vrsqrtss_f32(_x * _y, _y);
+#else
 		return 1 / sqrt(_x);
+#endif
 	}
-	//! 
-	inline float Sin(float _x) { return sin(_x); }
-	//! 
-	inline float Cos(float _x) { return cos(_x); }
-	//! 
+	//! Reduce the angle to [-pi/4, pi/4]. Returns the quadrant in the low bits.
+	inline uint _ReduceAngle(float _x, float& _r)
+	{
+		float _q = _x * (2 / PI) + _ROUND_MAGIC;
+		float _n = _q - _ROUND_MAGIC;
+		_r = ((_x - _n * _PIO2_1) - _n * _PIO2_2) - _n * _PIO2_3;
+		return _FloatBits(_q);
+	}
+	//! Sine on [-pi/4, pi/4], _z = _r * _r.
+	inline float _SinPoly(float _r, float _z) { return ((_SIN_C2 * _z + _SIN_C1) * _z + _SIN_C0) * _z * _r + _r; }
+	//! Cosine on [-pi/4, pi/4], _z = _r * _r.
+	inline float _CosPoly(float _z) { return (((_COS_C2 * _z + _COS_C1) * _z + _COS_C0) * _z * _z - 0.5f * _z) + 1; }
+	//! Fast sine. Max absolute error: 1e-7. Angles greater than 8192 are computed by libm (slow path).
+	inline float Sin(float _x)
+	{
+		if (_BitsFloat(_FloatBits(_x) & 0x7fffffff) > _SINCOS_MAX)
+			return sin(_x);
+		float _r;
+		uint _q = _ReduceAngle(_x, _r);
+		float _z = _r * _r;
+		return _BitsFloat(_FloatBits((_q & 1) ? _CosPoly(_z) : _SinPoly(_r, _z)) ^ ((_q << 30) & 0x80000000));
+	}
+	//! Fast cosine. Max absolute error: 1e-7. Angles greater than 8192 are computed by libm (slow path).
+	inline float Cos(float _x)
+	{
+		if (_BitsFloat(_FloatBits(_x) & 0x7fffffff) > _SINCOS_MAX)
+			return cos(_x);
+		float _r;
+		uint _q = _ReduceAngle(_x, _r);
+		float _z = _r * _r;
+		return _BitsFloat(_FloatBits((_q & 1) ? _SinPoly(_r, _z) : _CosPoly(_z)) ^ (((_q + 1) << 30) & 0x80000000));
+	}
+	//! Fast sine and cosine. Max absolute error: 1e-7. Angles greater than 8192 are computed by libm (slow path).
 	inline void SinCos(float _a, float& _s, float& _c)
 	{
-		TODO("Use asm");
-		_s = sin(_a), _c = cos(_a);
+		if (_BitsFloat(_FloatBits(_a) & 0x7fffffff) > _SINCOS_MAX)
+		{
+			_s = sin(_a), _c = cos(_a);
+			return;
+		}
+		float _r;
+		uint _q = _ReduceAngle(_a, _r);
+		float _z = _r * _r;
+		float _sp = _SinPoly(_r, _z), _cp = _CosPoly(_z);
+		_s = _BitsFloat(_FloatBits((_q & 1) ? _cp : _sp) ^ ((_q << 30) & 0x80000000));
+		_c = _BitsFloat(_FloatBits((_q & 1) ? _sp : _cp) ^ (((_q + 1) << 30) & 0x80000000));
 	}
 	//! 
 	inline float Tan(float _x) { return tan(_x); }
@@ -70,12 +139,46 @@ namespace Reax
 	inline float ASin(float _x) { return asin(_x); }
 	//! 
 	inline float ACos(float _x) { return acos(_x); }
-	//! 
-	inline float ATan2(float _y, float _x) { return atan2(_y, _x); }
-	//! 
-	inline float Log2(float _x) { return log2(_x); }
-	//! 
-	inline int Log2i(int _x) { return (int)log2f((float)_x); }
+	//! Fast arctangent of _y / _x in [-pi, pi]. Max absolute error: 1e-6. The arguments must be finite. Signs of zeros are handled like in atan2.
+	inline float ATan2(float _y, float _x)
+	{
+		float _ax = _BitsFloat(_FloatBits(_x) & 0x7fffffff), _ay = _BitsFloat(_FloatBits(_y) & 0x7fffffff);
+		float _max = _ax > _ay ? _ax : _ay, _min = _ax < _ay ? _ax : _ay;
+		float _a = _max > 0 ? _min / _max : 0;
+		float _s = _a * _a;
+		float _r = ((((((_ATAN_C6 * _s + _ATAN_C5) * _s + _ATAN_C4) * _s + _ATAN_C3) * _s + _ATAN_C2) * _s + _ATAN_C1) * _s + _ATAN_C0) * _a;
+		if (_ay > _ax)
+			_r = PI * 0.5f - _r;
+		if (_FloatBits(_x) & 0x80000000)
+			_r = PI - _r;
+		return _BitsFloat(_FloatBits(_r) ^ (_FloatBits(_y) & 0x80000000));
+	}
+	//! Fast 2^x. Max relative error: 2.5e-7. Results less than 2^-126 are flushed to zero, results greater than 2^128 are infinite.
+	inline float Exp2(float _x)
+	{
+		_x = _x < 128 ? _x : 128;
+		_x = _x > -127 ? _x : -127;
+		float _q = _x + _ROUND_MAGIC;
+		float _f = _x - (_q - _ROUND_MAGIC);
+		float _p = ((((_EXP2_C5 * _f + _EXP2_C4) * _f + _EXP2_C3) * _f + _EXP2_C2) * _f + _EXP2_C1) * _f + _EXP2_C0;
+		// 2^128 doesn't fit to exponent, so positive values are scaled by 2^(n - 1) * 2
+		bool _neg = _x < 0;
+		return (_p * (_neg ? 1.0f : 2.0f)) * _BitsFloat((_FloatBits(_q) + (_neg ? 127 : 126)) << 23);
+	}
+	//! Fast logarithm to base 2. Max absolute error: 2e-7 on [0.5, 2], 4e-6 in the whole range. _x must be positive and normal (not denormal, infinite or NaN).
+	inline float Log2(float _x)
+	{
+		uint _b = _FloatBits(_x);
+		float _e = _BitsFloat((_b >> 23) | _FloatBits(_ROUND_MAGIC)) - (_ROUND_MAGIC + 127);
+		float _m = _BitsFloat((_b & 0x007fffff) | 0x3f800000); // [1, 2)
+		if (_m > _SQRT2)
+			_m *= 0.5f, _e += 1;
+		float _t = (_m - 1) / (_m + 1);
+		float _s = _t * _t;
+		return ((_LOG2_C2 * _s + _LOG2_C1) * _s + _LOG2_C0) * _t + _e;
+	}
+	//! Integer logarithm to base 2 (index of the highest set bit). _x must be positive.
+	inline int Log2i(int _x) { return 31 - (int)RX_CLZ((uint)_x); }
 
 	//! 
 	inline uint FirstPow2(uint _val)
@@ -93,77 +196,38 @@ namespace Reax
 	inline uint8 FloatToByte(float _value) { return (uint8)(_value * 0xff); }
 	//! 
 	inline float ByteToFloat(uint8 _value) { return (float)(_value * (1.0f / 255.0f)); }
-	//! 
+	//! Convert float to half-float. Rounds to nearest even like F16C, NaN keeps the high bits of the payload.
 	inline uint16 FloatToHalf(float _value)
 	{
-		union { float f; uint i; }_fb = { _value };
+		uint _f = _FloatBits(_value);
 #	ifdef _FAST_HALF_FLOAT
-		return (uint16)((_fb.i >> 16) & 0x8000) | ((((_fb.i & 0x7f800000) - 0x38000000) >> 13) & 0x7c00) | ((_fb.i >> 13) & 0x03ff);
+		return (uint16)((_f >> 16) & 0x8000) | ((((_f & 0x7f800000) - 0x38000000) >> 13) & 0x7c00) | ((_f >> 13) & 0x03ff);
 #	else
-		uint _s = (_fb.i >> 16) & 0x00008000; // sign
-		int _e = ((_fb.i >> 23) & 0x000000ff) - 0x00000070; // exponent
-		uint _r = _fb.i & 0x007fffff; // mantissa
-		if (_e < 1)
-		{
-			if (_e < -10)
-				return 0;
-			_r = (_r | 0x00800000) >> (14 - _e);
-			return (uint16)(_s | _r);
-		}
-		else if (_e == 0x00000071)
-		{
-			if (_r == 0)
-				return (uint16)(_s | 0x7c00); // Inf
-			else
-				return (uint16)(((_s | 0x7c00) | (_r >>= 13)) | (_r == 0)); // NAN
-		}
-		if (_e > 30)
-			return (uint16)(_s | 0x7c00); // Overflow
-		return (uint16)((_s | (_e << 10)) | (_r >> 13));
+		uint _s = (_f >> 16) & 0x8000; // sign
+		_f &= 0x7fffffff;
+		if (_f >= 0x47800000) // overflow, Inf or NaN
+			return (uint16)(_s | (_f > 0x7f800000 ? 0x7e00 | ((_f >> 13) & 0x03ff) : 0x7c00));
+		if (_f < 0x38800000) // denormalized number or zero: the addition rounds the mantissa at the bottom of 0.5f
+			return (uint16)(_s | (_FloatBits(_BitsFloat(_f) + 0.5f) - 0x3f000000));
+		_f += 0xc8000fff + ((_f >> 13) & 1); // rebias exponent (-112 << 23) and round to nearest even
+		return (uint16)(_s | (_f >> 13));
 #	endif
 	}
-	//! 
+	//! Convert half-float to float. The conversion is exact.
 	inline float HalfToFloat(uint16 _value)
 	{
-		union { uint i; float f; }_fb;
 #	ifdef _FAST_HALF_FLOAT
-		_fb.i = ((_value & 0x8000) << 16) | (((_value & 0x7c00) + 0x1C000) << 13) | ((_value & 0x03FF) << 13);
+		return _BitsFloat(((_value & 0x8000) << 16) | (((_value & 0x7c00) + 0x1C000) << 13) | ((_value & 0x03FF) << 13));
 #	else
-		register int _s = (_value >> 15) & 0x00000001; // sign
-		register int _e = (_value >> 10) & 0x0000001f; // exponent
-		register int _r = _value & 0x000003ff; // mantissa
-		if (_e == 0)
-		{
-			if (_r == 0) // Plus or minus zero
-			{
-				_fb.i = _s << 31;
-				return _fb.f;
-			}
-			else // Denormalized number -- renormalize it
-			{
-				for (; !(_r & 0x00000400); _r <<= 1, _e -= 1);
-				_e += 1;
-				_r &= ~0x00000400;
-			}
-		}
-		else if (_e == 31)
-		{
-			if (_r == 0) // Inf
-			{
-				_fb.i = (_s << 31) | 0x7f800000;
-				return _fb.f;
-			}
-			else // NaN
-			{
-				_fb.i = ((_s << 31) | 0x7f800000) | (_r << 13);
-				return _fb.f;
-			}
-		}
-		_e = (_e + 112) << 23;
-		_r = _r << 13;
-		_fb.i = ((_s << 31) | _e) | _r;
+		uint _f = (_value & 0x7fff) << 13; // exponent and mantissa
+		uint _e = _f & 0x0f800000;
+		_f += 0x38000000; // rebias exponent (112 << 23)
+		if (_e == 0x0f800000) // Inf or NaN, NaN becomes quiet
+			_f = (_f + 0x38000000) | ((_f & 0x007fffff) ? 0x00400000 : 0);
+		else if (_e == 0) // denormalized number or zero: renormalize
+			_f = _FloatBits(_BitsFloat(_f + 0x00800000) - _BitsFloat(0x38800000));
+		return _BitsFloat(_f | ((_value & 0x8000) << 16));
 #	endif
-		return _fb.f;
 	}
 	//! 
 	inline float FixedToFloat(uint _value, uint _bits, float _default = 0.0f)
@@ -204,6 +268,340 @@ namespace Reax
 		return _value;
 	}
 
+	//----------------------------------------------------------------------------//
+	// SIMD
+	//----------------------------------------------------------------------------//
+
+	// Four floats in a register for Vector4, Quaternion and matrices. All algorithms are written once with these operations,
+	// so the SSE, NEON and scalar versions give identical results (unless the compiler fuses multiply-add).
+
+#if defined(RX_SSE2)
+
+	//!
+	typedef __m128 _V4;
+
+	//!
+	inline _V4 _V4Load(const float* _v) { return _mm_loadu_ps(_v); }
+	//!
+	inline void _V4Store(float* _dst, _V4 _v) { _mm_storeu_ps(_dst, _v); }
+	//!
+	inline _V4 _V4Set(float _x, float _y, float _z, float _w) { return _mm_setr_ps(_x, _y, _z, _w); }
+	//!
+	inline _V4 _V4Splat(float _s) { return _mm_set1_ps(_s); }
+	//! First component.
+	inline float _V4X(_V4 _v) { return _mm_cvtss_f32(_v); }
+	//!
+	inline _V4 _V4Add(_V4 _a, _V4 _b) { return _mm_add_ps(_a, _b); }
+	//!
+	inline _V4 _V4Sub(_V4 _a, _V4 _b) { return _mm_sub_ps(_a, _b); }
+	//!
+	inline _V4 _V4Mul(_V4 _a, _V4 _b) { return _mm_mul_ps(_a, _b); }
+	//!
+	inline _V4 _V4Div(_V4 _a, _V4 _b) { return _mm_div_ps(_a, _b); }
+	//! _a < _b ? _a : _b
+	inline _V4 _V4Min(_V4 _a, _V4 _b) { return _mm_min_ps(_a, _b); }
+	//! _a > _b ? _a : _b
+	inline _V4 _V4Max(_V4 _a, _V4 _b) { return _mm_max_ps(_a, _b); }
+	//!
+	inline _V4 _V4Sqrt(_V4 _v) { return _mm_sqrt_ps(_v); }
+	//! (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(W, Z, Y, X)); }
+	//! (a[X], a[Y], b[Z], b[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _a, _V4 _b) { return _mm_shuffle_ps(_a, _b, _MM_SHUFFLE(W, Z, Y, X)); }
+	//!
+	inline void _V4Transpose(_V4& _r0, _V4& _r1, _V4& _r2, _V4& _r3) { _MM_TRANSPOSE4_PS(_r0, _r1, _r2, _r3); }
+
+	//!
+	inline _V4 _V4And(_V4 _a, _V4 _b) { return _mm_and_ps(_a, _b); }
+	//!
+	inline _V4 _V4Or(_V4 _a, _V4 _b) { return _mm_or_ps(_a, _b); }
+	//!
+	inline _V4 _V4Xor(_V4 _a, _V4 _b) { return _mm_xor_ps(_a, _b); }
+	//! _mask ? _a : _b, where _mask is a result of comparison.
+	inline _V4 _V4Select(_V4 _mask, _V4 _a, _V4 _b) { return _mm_or_ps(_mm_and_ps(_mask, _a), _mm_andnot_ps(_mask, _b)); }
+	//! _a < _b (all bits are set or clear).
+	inline _V4 _V4Less(_V4 _a, _V4 _b) { return _mm_cmplt_ps(_a, _b); }
+	//! _a > _b (all bits are set or clear).
+	inline _V4 _V4Greater(_V4 _a, _V4 _b) { return _mm_cmpgt_ps(_a, _b); }
+	//! Sign bits of components in the low bits of integer. Bit i is set if component i of a comparison result is true.
+	inline uint _V4Mask(_V4 _v) { return (uint)_mm_movemask_ps(_v); }
+	//! Integer in all components.
+	inline _V4 _V4SplatBits(uint _i) { return _mm_castsi128_ps(_mm_set1_epi32((int)_i)); }
+	//! Integer addition.
+	inline _V4 _V4AddBits(_V4 _a, _V4 _b) { return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(_a), _mm_castps_si128(_b))); }
+	//! Integer equality (all bits are set or clear).
+	inline _V4 _V4EqualBits(_V4 _a, _V4 _b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_castps_si128(_a), _mm_castps_si128(_b))); }
+	//!
+	template <int N> _V4 _V4ShiftLeftBits(_V4 _v) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(_v), N)); }
+	//!
+	template <int N> _V4 _V4ShiftRightBits(_V4 _v) { return _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(_v), N)); }
+	//! Fast reciprocal square root, see RSqrt.
+	inline _V4 _V4RSqrt(_V4 _v)
+	{
+		_V4 _y = _mm_rsqrt_ps(_v);
+		return _mm_mul_ps(_y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), _v), _y), _y)));
+	}
+
+#elif defined(RX_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+
+	//!
+	typedef float32x4_t _V4;
+
+	//!
+	inline _V4 _V4Load(const float* _v) { return vld1q_f32(_v); }
+	//!
+	inline void _V4Store(float* _dst, _V4 _v) { vst1q_f32(_dst, _v); }
+	//!
+	inline _V4 _V4Set(float _x, float _y, float _z, float _w) { const float _v[4] = { _x, _y, _z, _w }; return vld1q_f32(_v); }
+	//!
+	inline _V4 _V4Splat(float _s) { return vdupq_n_f32(_s); }
+	//! First component.
+	inline float _V4X(_V4 _v) { return vgetq_lane_f32(_v, 0); }
+	//!
+	inline _V4 _V4Add(_V4 _a, _V4 _b) { return vaddq_f32(_a, _b); }
+	//!
+	inline _V4 _V4Sub(_V4 _a, _V4 _b) { return vsubq_f32(_a, _b); }
+	//!
+	inline _V4 _V4Mul(_V4 _a, _V4 _b) { return vmulq_f32(_a, _b); }
+	//!
+	inline _V4 _V4Div(_V4 _a, _V4 _b) { return vdivq_f32(_a, _b); }
+	//! _a < _b ? _a : _b
+	inline _V4 _V4Min(_V4 _a, _V4 _b) { return vbslq_f32(vcltq_f32(_a, _b), _a, _b); }
+	//! _a > _b ? _a : _b
+	inline _V4 _V4Max(_V4 _a, _V4 _b) { return vbslq_f32(vcgtq_f32(_a, _b), _a, _b); }
+	//!
+	inline _V4 _V4Sqrt(_V4 _v) { return vsqrtq_f32(_v); }
+	//! (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _v) { return _V4Set(vgetq_lane_f32(_v, X), vgetq_lane_f32(_v, Y), vgetq_lane_f32(_v, Z), vgetq_lane_f32(_v, W)); }
+	//! (a[X], a[Y], b[Z], b[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _a, _V4 _b) { return _V4Set(vgetq_lane_f32(_a, X), vgetq_lane_f32(_a, Y), vgetq_lane_f32(_b, Z), vgetq_lane_f32(_b, W)); }
+	//!
+	inline void _V4Transpose(_V4& _r0, _V4& _r1, _V4& _r2, _V4& _r3)
+	{
+		float64x2_t _t0 = vreinterpretq_f64_f32(vtrn1q_f32(_r0, _r1)); // x0 x1 z0 z1
+		float64x2_t _t1 = vreinterpretq_f64_f32(vtrn2q_f32(_r0, _r1)); // y0 y1 w0 w1
+		float64x2_t _t2 = vreinterpretq_f64_f32(vtrn1q_f32(_r2, _r3)); // x2 x3 z2 z3
+		float64x2_t _t3 = vreinterpretq_f64_f32(vtrn2q_f32(_r2, _r3)); // y2 y3 w2 w3
+		_r0 = vreinterpretq_f32_f64(vtrn1q_f64(_t0, _t2));
+		_r1 = vreinterpretq_f32_f64(vtrn1q_f64(_t1, _t3));
+		_r2 = vreinterpretq_f32_f64(vtrn2q_f64(_t0, _t2));
+		_r3 = vreinterpretq_f32_f64(vtrn2q_f64(_t1, _t3));
+	}
+
+	//!
+	inline _V4 _V4And(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(_a), vreinterpretq_u32_f32(_b))); }
+	//!
+	inline _V4 _V4Or(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(_a), vreinterpretq_u32_f32(_b))); }
+	//!
+	inline _V4 _V4Xor(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(_a), vreinterpretq_u32_f32(_b))); }
+	//! _mask ? _a : _b, where _mask is a result of comparison.
+	inline _V4 _V4Select(_V4 _mask, _V4 _a, _V4 _b) { return vbslq_f32(vreinterpretq_u32_f32(_mask), _a, _b); }
+	//! _a < _b (all bits are set or clear).
+	inline _V4 _V4Less(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vcltq_f32(_a, _b)); }
+	//! _a > _b (all bits are set or clear).
+	inline _V4 _V4Greater(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vcgtq_f32(_a, _b)); }
+	//! Sign bits of components in the low bits of integer. Bit i is set if component i of a comparison result is true.
+	inline uint _V4Mask(_V4 _v)
+	{
+		static const int32_t _shift[4] = { 0, 1, 2, 3 };
+		return vaddvq_u32(vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(_v), 31), vld1q_s32(_shift)));
+	}
+	//! Integer in all components.
+	inline _V4 _V4SplatBits(uint _i) { return vreinterpretq_f32_u32(vdupq_n_u32(_i)); }
+	//! Integer addition.
+	inline _V4 _V4AddBits(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vaddq_u32(vreinterpretq_u32_f32(_a), vreinterpretq_u32_f32(_b))); }
+	//! Integer equality (all bits are set or clear).
+	inline _V4 _V4EqualBits(_V4 _a, _V4 _b) { return vreinterpretq_f32_u32(vceqq_u32(vreinterpretq_u32_f32(_a), vreinterpretq_u32_f32(_b))); }
+	//!
+	template <int N> _V4 _V4ShiftLeftBits(_V4 _v) { return vreinterpretq_f32_u32(vshlq_n_u32(vreinterpretq_u32_f32(_v), N)); }
+	//!
+	template <int N> _V4 _V4ShiftRightBits(_V4 _v) { return vreinterpretq_f32_u32(vshrq_n_u32(vreinterpretq_u32_f32(_v), N)); }
+	//! Fast reciprocal square root, see RSqrt.
+	inline _V4 _V4RSqrt(_V4 _v)
+	{
+		_V4 _y = vrsqrteq_f32(_v);
+		_y = vmulq_f32(_y, vrsqrtsq_f32(vmulq_f32(_v, _y), _y));
+		return vmulq_f32(_y, vrsqrtsq_f32(vmulq_f32(_v, _y), _y));
+	}
+
+#else
+
+	//!
+	struct _V4 { float v[4]; };
+
+	//!
+	inline _V4 _V4Load(const float* _v) { return { { _v[0], _v[1], _v[2], _v[3] } }; }
+	//!
+	inline void _V4Store(float* _dst, _V4 _v) { _dst[0] = _v.v[0], _dst[1] = _v.v[1], _dst[2] = _v.v[2], _dst[3] = _v.v[3]; }
+	//!
+	inline _V4 _V4Set(float _x, float _y, float _z, float _w) { return { { _x, _y, _z, _w } }; }
+	//!
+	inline _V4 _V4Splat(float _s) { return { { _s, _s, _s, _s } }; }
+	//! First component.
+	inline float _V4X(_V4 _v) { return _v.v[0]; }
+	//!
+	inline _V4 _V4Add(_V4 _a, _V4 _b) { return { { _a.v[0] + _b.v[0], _a.v[1] + _b.v[1], _a.v[2] + _b.v[2], _a.v[3] + _b.v[3] } }; }
+	//!
+	inline _V4 _V4Sub(_V4 _a, _V4 _b) { return { { _a.v[0] - _b.v[0], _a.v[1] - _b.v[1], _a.v[2] - _b.v[2], _a.v[3] - _b.v[3] } }; }
+	//!
+	inline _V4 _V4Mul(_V4 _a, _V4 _b) { return { { _a.v[0] * _b.v[0], _a.v[1] * _b.v[1], _a.v[2] * _b.v[2], _a.v[3] * _b.v[3] } }; }
+	//!
+	inline _V4 _V4Div(_V4 _a, _V4 _b) { return { { _a.v[0] / _b.v[0], _a.v[1] / _b.v[1], _a.v[2] / _b.v[2], _a.v[3] / _b.v[3] } }; }
+	//! _a < _b ? _a : _b
+	inline _V4 _V4Min(_V4 _a, _V4 _b) { return { { _a.v[0] < _b.v[0] ? _a.v[0] : _b.v[0], _a.v[1] < _b.v[1] ? _a.v[1] : _b.v[1], _a.v[2] < _b.v[2] ? _a.v[2] : _b.v[2], _a.v[3] < _b.v[3] ? _a.v[3] : _b.v[3] } }; }
+	//! _a > _b ? _a : _b
+	inline _V4 _V4Max(_V4 _a, _V4 _b) { return { { _a.v[0] > _b.v[0] ? _a.v[0] : _b.v[0], _a.v[1] > _b.v[1] ? _a.v[1] : _b.v[1], _a.v[2] > _b.v[2] ? _a.v[2] : _b.v[2], _a.v[3] > _b.v[3] ? _a.v[3] : _b.v[3] } }; }
+	//!
+	inline _V4 _V4Sqrt(_V4 _v) { return { { sqrtf(_v.v[0]), sqrtf(_v.v[1]), sqrtf(_v.v[2]), sqrtf(_v.v[3]) } }; }
+	//! (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _v) { return { { _v.v[X], _v.v[Y], _v.v[Z], _v.v[W] } }; }
+	//! (a[X], a[Y], b[Z], b[W])
+	template <int X, int Y, int Z, int W> _V4 _V4Shuffle(_V4 _a, _V4 _b) { return { { _a.v[X], _a.v[Y], _b.v[Z], _b.v[W] } }; }
+	//!
+	inline void _V4Transpose(_V4& _r0, _V4& _r1, _V4& _r2, _V4& _r3)
+	{
+		Swap(_r0.v[1], _r1.v[0]);
+		Swap(_r0.v[2], _r2.v[0]);
+		Swap(_r0.v[3], _r3.v[0]);
+		Swap(_r1.v[2], _r2.v[1]);
+		Swap(_r1.v[3], _r3.v[1]);
+		Swap(_r2.v[3], _r3.v[2]);
+	}
+
+	//!
+	inline _V4 _V4And(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_a.v[i]) & _FloatBits(_b.v[i])); return _r; }
+	//!
+	inline _V4 _V4Or(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_a.v[i]) | _FloatBits(_b.v[i])); return _r; }
+	//!
+	inline _V4 _V4Xor(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_a.v[i]) ^ _FloatBits(_b.v[i])); return _r; }
+	//! _mask ? _a : _b, where _mask is a result of comparison.
+	inline _V4 _V4Select(_V4 _mask, _V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _FloatBits(_mask.v[i]) ? _a.v[i] : _b.v[i]; return _r; }
+	//! _a < _b (all bits are set or clear).
+	inline _V4 _V4Less(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_a.v[i] < _b.v[i] ? ~0u : 0); return _r; }
+	//! _a > _b (all bits are set or clear).
+	inline _V4 _V4Greater(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_a.v[i] > _b.v[i] ? ~0u : 0); return _r; }
+	//! Sign bits of components in the low bits of integer. Bit i is set if component i of a comparison result is true.
+	inline uint _V4Mask(_V4 _v) { uint _r = 0; for (uint i = 0; i < 4; ++i) _r |= (_FloatBits(_v.v[i]) >> 31) << i; return _r; }
+	//! Integer in all components.
+	inline _V4 _V4SplatBits(uint _i) { return _V4Splat(_BitsFloat(_i)); }
+	//! Integer addition.
+	inline _V4 _V4AddBits(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_a.v[i]) + _FloatBits(_b.v[i])); return _r; }
+	//! Integer equality (all bits are set or clear).
+	inline _V4 _V4EqualBits(_V4 _a, _V4 _b) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_a.v[i]) == _FloatBits(_b.v[i]) ? ~0u : 0); return _r; }
+	//!
+	template <int N> _V4 _V4ShiftLeftBits(_V4 _v) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_v.v[i]) << N); return _r; }
+	//!
+	template <int N> _V4 _V4ShiftRightBits(_V4 _v) { _V4 _r; for (uint i = 0; i < 4; ++i) _r.v[i] = _BitsFloat(_FloatBits(_v.v[i]) >> N); return _r; }
+	//! Reciprocal square root, see RSqrt.
+	inline _V4 _V4RSqrt(_V4 _v) { return { { RSqrt(_v.v[0]), RSqrt(_v.v[1]), RSqrt(_v.v[2]), RSqrt(_v.v[3]) } }; }
+
+#endif
+
+	//! Sum of all components in each component: (x + y) + (z + w).
+	inline _V4 _V4Sum(_V4 _v)
+	{
+		_v = _V4Add(_v, _V4Shuffle<1, 0, 3, 2>(_v));
+		return _V4Add(_v, _V4Shuffle<2, 3, 0, 1>(_v));
+	}
+	//! Dot product in each component.
+	inline _V4 _V4Dot(_V4 _a, _V4 _b) { return _V4Sum(_V4Mul(_a, _b)); }
+	//! Dot products of rows and the vector: (dot(r0, v), dot(r1, v), dot(r2, v), dot(r3, v)).
+	inline _V4 _V4Transform(_V4 _r0, _V4 _r1, _V4 _r2, _V4 _r3, _V4 _v)
+	{
+		_r0 = _V4Mul(_r0, _v);
+		_r1 = _V4Mul(_r1, _v);
+		_r2 = _V4Mul(_r2, _v);
+		_r3 = _V4Mul(_r3, _v);
+		_V4Transpose(_r0, _r1, _r2, _r3);
+		return _V4Add(_V4Add(_r0, _r1), _V4Add(_r2, _r3));
+	}
+	//! Linear combination of rows: r0 * v.x + r1 * v.y + r2 * v.z + r3 * v.w.
+	inline _V4 _V4Combine(const float* _v, _V4 _r0, _V4 _r1, _V4 _r2, _V4 _r3)
+	{
+		_V4 _r = _V4Mul(_V4Splat(_v[0]), _r0);
+		_r = _V4Add(_r, _V4Mul(_V4Splat(_v[1]), _r1));
+		_r = _V4Add(_r, _V4Mul(_V4Splat(_v[2]), _r2));
+		return _V4Add(_r, _V4Mul(_V4Splat(_v[3]), _r3));
+	}
+
+	//! _a * _b + _c (not fused).
+	inline _V4 _V4MulAdd(_V4 _a, _V4 _b, _V4 _c) { return _V4Add(_V4Mul(_a, _b), _c); }
+	//! Fast sine and cosine in each component, see SinCos.
+	inline void _V4SinCos(_V4 _x, _V4& _s, _V4& _c)
+	{
+		_V4 _q = _V4MulAdd(_x, _V4Splat(2 / PI), _V4Splat(_ROUND_MAGIC));
+		_V4 _n = _V4Sub(_q, _V4Splat(_ROUND_MAGIC));
+		_V4 _r = _V4Sub(_V4Sub(_V4Sub(_x, _V4Mul(_n, _V4Splat(_PIO2_1))), _V4Mul(_n, _V4Splat(_PIO2_2))), _V4Mul(_n, _V4Splat(_PIO2_3)));
+		_V4 _z = _V4Mul(_r, _r);
+		_V4 _sp = _V4MulAdd(_V4Mul(_V4MulAdd(_V4MulAdd(_V4Splat(_SIN_C2), _z, _V4Splat(_SIN_C1)), _z, _V4Splat(_SIN_C0)), _z), _r, _r);
+		_V4 _cp = _V4Add(_V4Sub(_V4Mul(_V4Mul(_V4MulAdd(_V4MulAdd(_V4Splat(_COS_C2), _z, _V4Splat(_COS_C1)), _z, _V4Splat(_COS_C0)), _z), _z), _V4Mul(_V4Splat(0.5f), _z)), _V4Splat(1));
+		_V4 _one = _V4SplatBits(1), _sign = _V4SplatBits(0x80000000);
+		_V4 _swap = _V4EqualBits(_V4And(_q, _one), _one);
+		_s = _V4Xor(_V4Select(_swap, _cp, _sp), _V4And(_V4ShiftLeftBits<30>(_q), _sign));
+		_c = _V4Xor(_V4Select(_swap, _sp, _cp), _V4And(_V4ShiftLeftBits<30>(_V4AddBits(_q, _one)), _sign));
+
+		if (_V4Mask(_V4Greater(_V4And(_x, _V4SplatBits(0x7fffffff)), _V4Splat(_SINCOS_MAX))))
+		{
+			float _va[4], _vs[4], _vc[4];
+			_V4Store(_va, _x);
+			_V4Store(_vs, _s);
+			_V4Store(_vc, _c);
+			for (uint i = 0; i < 4; ++i)
+			{
+				if (_BitsFloat(_FloatBits(_va[i]) & 0x7fffffff) > _SINCOS_MAX)
+					_vs[i] = sin(_va[i]), _vc[i] = cos(_va[i]);
+			}
+			_s = _V4Load(_vs);
+			_c = _V4Load(_vc);
+		}
+	}
+	//! Fast arctangent in each component, see ATan2.
+	inline _V4 _V4ATan2(_V4 _y, _V4 _x)
+	{
+		_V4 _abs = _V4SplatBits(0x7fffffff);
+		_V4 _ax = _V4And(_x, _abs), _ay = _V4And(_y, _abs);
+		_V4 _max = _V4Max(_ax, _ay);
+		_V4 _a = _V4And(_V4Greater(_max, _V4Splat(0)), _V4Div(_V4Min(_ax, _ay), _max));
+		_V4 _s = _V4Mul(_a, _a);
+		_V4 _r = _V4MulAdd(_V4Splat(_ATAN_C6), _s, _V4Splat(_ATAN_C5));
+		_r = _V4MulAdd(_r, _s, _V4Splat(_ATAN_C4));
+		_r = _V4MulAdd(_r, _s, _V4Splat(_ATAN_C3));
+		_r = _V4MulAdd(_r, _s, _V4Splat(_ATAN_C2));
+		_r = _V4MulAdd(_r, _s, _V4Splat(_ATAN_C1));
+		_r = _V4Mul(_V4MulAdd(_r, _s, _V4Splat(_ATAN_C0)), _a);
+		_r = _V4Select(_V4Greater(_ay, _ax), _V4Sub(_V4Splat(PI * 0.5f), _r), _r);
+		_V4 _sign = _V4SplatBits(0x80000000);
+		_r = _V4Select(_V4EqualBits(_V4And(_x, _sign), _sign), _V4Sub(_V4Splat(PI), _r), _r);
+		return _V4Xor(_r, _V4And(_y, _sign));
+	}
+	//! Fast 2^x in each component, see Exp2.
+	inline _V4 _V4Exp2(_V4 _x)
+	{
+		_x = _V4Max(_V4Min(_x, _V4Splat(128)), _V4Splat(-127));
+		_V4 _q = _V4Add(_x, _V4Splat(_ROUND_MAGIC));
+		_V4 _f = _V4Sub(_x, _V4Sub(_q, _V4Splat(_ROUND_MAGIC)));
+		_V4 _p = _V4MulAdd(_V4Splat(_EXP2_C5), _f, _V4Splat(_EXP2_C4));
+		_p = _V4MulAdd(_p, _f, _V4Splat(_EXP2_C3));
+		_p = _V4MulAdd(_p, _f, _V4Splat(_EXP2_C2));
+		_p = _V4MulAdd(_p, _f, _V4Splat(_EXP2_C1));
+		_p = _V4MulAdd(_p, _f, _V4Splat(_EXP2_C0));
+		_V4 _neg = _V4Less(_x, _V4Splat(0));
+		_p = _V4Mul(_p, _V4Select(_neg, _V4Splat(1), _V4Splat(2)));
+		return _V4Mul(_p, _V4ShiftLeftBits<23>(_V4AddBits(_q, _V4Select(_neg, _V4SplatBits(127), _V4SplatBits(126)))));
+	}
+	//! Fast logarithm to base 2 in each component, see Log2.
+	inline _V4 _V4Log2(_V4 _x)
+	{
+		_V4 _e = _V4Sub(_V4Or(_V4ShiftRightBits<23>(_x), _V4Splat(_ROUND_MAGIC)), _V4Splat(_ROUND_MAGIC + 127));
+		_V4 _m = _V4Or(_V4And(_x, _V4SplatBits(0x007fffff)), _V4SplatBits(0x3f800000)); // [1, 2)
+		_V4 _big = _V4Greater(_m, _V4Splat(_SQRT2));
+		_m = _V4Select(_big, _V4Mul(_m, _V4Splat(0.5f)), _m);
+		_e = _V4Add(_e, _V4And(_big, _V4Splat(1)));
+		_V4 _t = _V4Div(_V4Sub(_m, _V4Splat(1)), _V4Add(_m, _V4Splat(1)));
+		_V4 _s = _V4Mul(_t, _t);
+		return _V4MulAdd(_V4MulAdd(_V4MulAdd(_V4Splat(_LOG2_C2), _s, _V4Splat(_LOG2_C1)), _s, _V4Splat(_LOG2_C0)), _t, _e);
+	}
+
 	//----------------------------------------------------------------------------//
 	// 
 	//----------------------------------------------------------------------------//
@@ -253,6 +651,73 @@ namespace Reax
 	//! Vector2 
 	struct Vector2
 	{
+		//!
+		Vector2(void) = default;
+		//!
+		explicit Vector2(float _s) { x = _s, y = _s; }
+		//!
+		Vector2(float _x, float _y) { x = _x, y = _y; }
+
+		//!
+		Vector2 operator - (void) const { return Vector2(-x, -y); }
+		//!
+		Vector2 operator + (const Vector2& _rhs) const { return Vector2(x + _rhs.x, y + _rhs.y); }
+		//!
+		Vector2 operator - (const Vector2& _rhs) const { return Vector2(x - _rhs.x, y - _rhs.y); }
+		//!
+		Vector2 operator * (const Vector2& _rhs) const { return Vector2(x * _rhs.x, y * _rhs.y); }
+		//!
+		Vector2 operator / (const Vector2& _rhs) const { return Vector2(x / _rhs.x, y / _rhs.y); }
+		//!
+		Vector2 operator * (float _rhs) const { return Vector2(x * _rhs, y * _rhs); }
+		//!
+		Vector2 operator / (float _rhs) const { return Vector2(x / _rhs, y / _rhs); }
+		//!
+		friend Vector2 operator * (float _lhs, const Vector2& _rhs) { return _rhs * _lhs; }
+		//!
+		Vector2& operator += (const Vector2& _rhs) { return *this = *this + _rhs; }
+		//!
+		Vector2& operator -= (const Vector2& _rhs) { return *this = *this - _rhs; }
+		//!
+		Vector2& operator *= (const Vector2& _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector2& operator /= (const Vector2& _rhs) { return *this = *this / _rhs; }
+		//!
+		Vector2& operator *= (float _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector2& operator /= (float _rhs) { return *this = *this / _rhs; }
+		//!
+		bool operator == (const Vector2& _rhs) const { return x == _rhs.x && y == _rhs.y; }
+		//!
+		bool operator != (const Vector2& _rhs) const { return !(*this == _rhs); }
+
+		//!
+		float Dot(const Vector2& _rhs) const { return x * _rhs.x + y * _rhs.y; }
+		//! Z component of the cross product.
+		float Cross(const Vector2& _rhs) const { return x * _rhs.y - y * _rhs.x; }
+		//!
+		float LengthSq(void) const { return Dot(*this); }
+		//!
+		float Length(void) const { return Sqrt(LengthSq()); }
+		//!
+		float Distance(const Vector2& _rhs) const { return (*this - _rhs).Length(); }
+		//! Normalize the vector if its length is not zero.
+		Vector2& Normalize(void)
+		{
+			float _l = LengthSq();
+			if (_l > EPSILON2)
+				*this *= 1 / Sqrt(_l);
+			return *this;
+		}
+		//!
+		Vector2 Copy(void) const { return *this; }
+		//!
+		Vector2 Lerp(const Vector2& _b, float _t) const { return *this + (_b - *this) * _t; }
+		//!
+		Vector2 Min(const Vector2& _rhs) const { return Vector2(Reax::Min(x, _rhs.x), Reax::Min(y, _rhs.y)); }
+		//!
+		Vector2 Max(const Vector2& _rhs) const { return Vector2(Reax::Max(x, _rhs.x), Reax::Max(y, _rhs.y)); }
+
 		union
 		{
 			float v[2];
@@ -267,6 +732,75 @@ namespace Reax
 	//! Vector3
 	struct Vector3
 	{
+		//!
+		Vector3(void) = default;
+		//!
+		explicit Vector3(float _s) { x = _s, y = _s, z = _s; }
+		//!
+		Vector3(float _x, float _y, float _z) { x = _x, y = _y, z = _z; }
+
+		//!
+		Vector3 operator - (void) const { return Vector3(-x, -y, -z); }
+		//!
+		Vector3 operator + (const Vector3& _rhs) const { return Vector3(x + _rhs.x, y + _rhs.y, z + _rhs.z); }
+		//!
+		Vector3 operator - (const Vector3& _rhs) const { return Vector3(x - _rhs.x, y - _rhs.y, z - _rhs.z); }
+		//!
+		Vector3 operator * (const Vector3& _rhs) const { return Vector3(x * _rhs.x, y * _rhs.y, z * _rhs.z); }
+		//!
+		Vector3 operator / (const Vector3& _rhs) const { return Vector3(x / _rhs.x, y / _rhs.y, z / _rhs.z); }
+		//!
+		Vector3 operator * (float _rhs) const { return Vector3(x * _rhs, y * _rhs, z * _rhs); }
+		//!
+		Vector3 operator / (float _rhs) const { return Vector3(x / _rhs, y / _rhs, z / _rhs); }
+		//!
+		friend Vector3 operator * (float _lhs, const Vector3& _rhs) { return _rhs * _lhs; }
+		//!
+		Vector3& operator += (const Vector3& _rhs) { return *this = *this + _rhs; }
+		//!
+		Vector3& operator -= (const Vector3& _rhs) { return *this = *this - _rhs; }
+		//!
+		Vector3& operator *= (const Vector3& _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector3& operator /= (const Vector3& _rhs) { return *this = *this / _rhs; }
+		//!
+		Vector3& operator *= (float _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector3& operator /= (float _rhs) { return *this = *this / _rhs; }
+		//!
+		bool operator == (const Vector3& _rhs) const { return x == _rhs.x && y == _rhs.y && z == _rhs.z; }
+		//!
+		bool operator != (const Vector3& _rhs) const { return !(*this == _rhs); }
+
+		//!
+		float Dot(const Vector3& _rhs) const { return x * _rhs.x + y * _rhs.y + z * _rhs.z; }
+		//!
+		Vector3 Cross(const Vector3& _rhs) const { return Vector3(y * _rhs.z - z * _rhs.y, z * _rhs.x - x * _rhs.z, x * _rhs.y - y * _rhs.x); }
+		//!
+		float LengthSq(void) const { return Dot(*this); }
+		//!
+		float Length(void) const { return Sqrt(LengthSq()); }
+		//!
+		float Distance(const Vector3& _rhs) const { return (*this - _rhs).Length(); }
+		//! Normalize the vector if its length is not zero.
+		Vector3& Normalize(void)
+		{
+			float _l = LengthSq();
+			if (_l > EPSILON2)
+				*this *= 1 / Sqrt(_l);
+			return *this;
+		}
+		//!
+		Vector3 Copy(void) const { return *this; }
+		//!
+		Vector3 Lerp(const Vector3& _b, float _t) const { return *this + (_b - *this) * _t; }
+		//!
+		Vector3 Min(const Vector3& _rhs) const { return Vector3(Reax::Min(x, _rhs.x), Reax::Min(y, _rhs.y), Reax::Min(z, _rhs.z)); }
+		//!
+		Vector3 Max(const Vector3& _rhs) const { return Vector3(Reax::Max(x, _rhs.x), Reax::Max(y, _rhs.y), Reax::Max(z, _rhs.z)); }
+		//!
+		Vector3 Abs(void) const { return Vector3(Reax::Abs(x), Reax::Abs(y), Reax::Abs(z)); }
+
 		union
 		{
 			float v[3];
@@ -281,6 +815,79 @@ namespace Reax
 	//! Vector4
 	struct Vector4
 	{
+		//!
+		Vector4(void) = default;
+		//!
+		explicit Vector4(float _s) { x = _s, y = _s, z = _s, w = _s; }
+		//!
+		Vector4(float _x, float _y, float _z, float _w) { x = _x, y = _y, z = _z, w = _w; }
+		//!
+		Vector4(const Vector3& _v, float _w) { x = _v.x, y = _v.y, z = _v.z, w = _w; }
+		//!
+		explicit Vector4(_V4 _v) { _V4Store(v, _v); }
+
+		//!
+		_V4 Load(void) const { return _V4Load(v); }
+
+		//!
+		Vector4 operator - (void) const { return Vector4(_V4Sub(_V4Splat(0), Load())); }
+		//!
+		Vector4 operator + (const Vector4& _rhs) const { return Vector4(_V4Add(Load(), _rhs.Load())); }
+		//!
+		Vector4 operator - (const Vector4& _rhs) const { return Vector4(_V4Sub(Load(), _rhs.Load())); }
+		//!
+		Vector4 operator * (const Vector4& _rhs) const { return Vector4(_V4Mul(Load(), _rhs.Load())); }
+		//!
+		Vector4 operator / (const Vector4& _rhs) const { return Vector4(_V4Div(Load(), _rhs.Load())); }
+		//!
+		Vector4 operator * (float _rhs) const { return Vector4(_V4Mul(Load(), _V4Splat(_rhs))); }
+		//!
+		Vector4 operator / (float _rhs) const { return Vector4(_V4Div(Load(), _V4Splat(_rhs))); }
+		//!
+		friend Vector4 operator * (float _lhs, const Vector4& _rhs) { return _rhs * _lhs; }
+		//!
+		Vector4& operator += (const Vector4& _rhs) { return *this = *this + _rhs; }
+		//!
+		Vector4& operator -= (const Vector4& _rhs) { return *this = *this - _rhs; }
+		//!
+		Vector4& operator *= (const Vector4& _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector4& operator /= (const Vector4& _rhs) { return *this = *this / _rhs; }
+		//!
+		Vector4& operator *= (float _rhs) { return *this = *this * _rhs; }
+		//!
+		Vector4& operator /= (float _rhs) { return *this = *this / _rhs; }
+		//!
+		bool operator == (const Vector4& _rhs) const { return x == _rhs.x && y == _rhs.y && z == _rhs.z && w == _rhs.w; }
+		//!
+		bool operator != (const Vector4& _rhs) const { return !(*this == _rhs); }
+
+		//! (x * x + y * y) + (z * z + w * w)
+		float Dot(const Vector4& _rhs) const { return _V4X(_V4Dot(Load(), _rhs.Load())); }
+		//!
+		float LengthSq(void) const { return Dot(*this); }
+		//!
+		float Length(void) const { return Sqrt(LengthSq()); }
+		//! Normalize the vector if its length is not zero.
+		Vector4& Normalize(void)
+		{
+			_V4 _v = Load();
+			_V4 _l = _V4Dot(_v, _v);
+			if (_V4X(_l) > EPSILON2)
+				_V4Store(v, _V4Div(_v, _V4Sqrt(_l)));
+			return *this;
+		}
+		//!
+		Vector4 Copy(void) const { return *this; }
+		//!
+		Vector4 Lerp(const Vector4& _b, float _t) const { _V4 _a = Load(); return Vector4(_V4Add(_a, _V4Mul(_V4Sub(_b.Load(), _a), _V4Splat(_t)))); }
+		//!
+		Vector4 Min(const Vector4& _rhs) const { return Vector4(_V4Min(Load(), _rhs.Load())); }
+		//!
+		Vector4 Max(const Vector4& _rhs) const { return Vector4(_V4Max(Load(), _rhs.Load())); }
+		//!
+		Vector3 AsVector3(void) const { return Vector3(x, y, z); }
+
 		union
 		{
 			float v[4];
@@ -292,9 +899,102 @@ namespace Reax
 	// 
 	//----------------------------------------------------------------------------//
 
-	//! Quaternion
+	//! Quaternion. The product q1 * q2 rotates by q2 and then by q1.
 	struct Quaternion
 	{
+		//!
+		Quaternion(void) = default;
+		//!
+		Quaternion(float _x, float _y, float _z, float _w) { x = _x, y = _y, z = _z, w = _w; }
+		//!
+		explicit Quaternion(_V4 _v) { _V4Store(v, _v); }
+		//! Rotation around the axis. The axis must be normalized.
+		Quaternion(const Vector3& _axis, float _angle)
+		{
+			float _s, _c;
+			SinCos(_angle * 0.5f, _s, _c);
+			x = _axis.x * _s, y = _axis.y * _s, z = _axis.z * _s, w = _c;
+		}
+
+		//!
+		_V4 Load(void) const { return _V4Load(v); }
+
+		//!
+		Quaternion& SetIdentity(void) { x = 0, y = 0, z = 0, w = 1; return *this; }
+
+		//!
+		Quaternion operator - (void) const { return Quaternion(_V4Sub(_V4Splat(0), Load())); }
+		//!
+		Quaternion operator + (const Quaternion& _rhs) const { return Quaternion(_V4Add(Load(), _rhs.Load())); }
+		//!
+		Quaternion operator - (const Quaternion& _rhs) const { return Quaternion(_V4Sub(Load(), _rhs.Load())); }
+		//!
+		Quaternion operator * (float _rhs) const { return Quaternion(_V4Mul(Load(), _V4Splat(_rhs))); }
+		//! Composition of rotations.
+		Quaternion operator * (const Quaternion& _rhs) const
+		{
+			_V4 _b = _rhs.Load();
+			_V4 _r = _V4Mul(_V4Splat(w), _b);
+			_r = _V4Add(_r, _V4Mul(_V4Mul(_V4Splat(x), _V4Shuffle<3, 2, 1, 0>(_b)), _V4Set(1, -1, 1, -1)));
+			_r = _V4Add(_r, _V4Mul(_V4Mul(_V4Splat(y), _V4Shuffle<2, 3, 0, 1>(_b)), _V4Set(1, 1, -1, -1)));
+			_r = _V4Add(_r, _V4Mul(_V4Mul(_V4Splat(z), _V4Shuffle<1, 0, 3, 2>(_b)), _V4Set(-1, 1, 1, -1)));
+			return Quaternion(_r);
+		}
+		//!
+		Quaternion& operator *= (const Quaternion& _rhs) { return *this = *this * _rhs; }
+		//! Rotate the vector.
+		Vector3 operator * (const Vector3& _rhs) const
+		{
+			Vector3 _u(x, y, z);
+			Vector3 _t = _u.Cross(_rhs) * 2;
+			return _rhs + _t * w + _u.Cross(_t);
+		}
+		//!
+		bool operator == (const Quaternion& _rhs) const { return x == _rhs.x && y == _rhs.y && z == _rhs.z && w == _rhs.w; }
+		//!
+		bool operator != (const Quaternion& _rhs) const { return !(*this == _rhs); }
+
+		//!
+		float Dot(const Quaternion& _rhs) const { return _V4X(_V4Dot(Load(), _rhs.Load())); }
+		//!
+		float LengthSq(void) const { return Dot(*this); }
+		//!
+		float Length(void) const { return Sqrt(LengthSq()); }
+		//! Normalize the quaternion if its length is not zero.
+		Quaternion& Normalize(void)
+		{
+			_V4 _v = Load();
+			_V4 _l = _V4Dot(_v, _v);
+			if (_V4X(_l) > EPSILON2)
+				_V4Store(v, _V4Div(_v, _V4Sqrt(_l)));
+			return *this;
+		}
+		//!
+		Quaternion Copy(void) const { return *this; }
+		//! Inverse of unit quaternion.
+		Quaternion Conjugate(void) const { return Quaternion(-x, -y, -z, w); }
+		//!
+		Quaternion Inverse(void) const
+		{
+			float _l = LengthSq();
+			return _l > EPSILON2 ? Quaternion(_V4Div(Load(), _V4Set(-_l, -_l, -_l, _l))) : *this;
+		}
+		//! Spherical linear interpolation by the shortest arc. Nearly equal rotations are interpolated linearly.
+		Quaternion Slerp(const Quaternion& _q, float _t) const
+		{
+			float _cos = Dot(_q);
+			float _k = 1;
+			if (_cos < 0)
+				_cos = -_cos, _k = -1;
+
+			if (_cos > 1 - EPSILON)
+				return (*this * (1 - _t) + _q * (_k * _t)).Normalize();
+
+			float _angle = ACos(_cos);
+			float _s = 1 / Sin(_angle);
+			return *this * (Sin((1 - _t) * _angle) * _s) + _q * (_k * Sin(_t * _angle) * _s);
+		}
+
 		union
 		{
 			float v[4];
@@ -306,9 +1006,88 @@ namespace Reax
 	// 
 	//----------------------------------------------------------------------------//
 
-	//! Matrix3x4
+	//! Affine transformation. Points are transformed as columns: p' = M * (p, 1).
 	struct Matrix3x4
 	{
+		//!
+		Matrix3x4(void) = default;
+		//!
+		Matrix3x4(float _m00, float _m01, float _m02, float _m03, float _m10, float _m11, float _m12, float _m13, float _m20, float _m21, float _m22, float _m23)
+		{
+			m00 = _m00, m01 = _m01, m02 = _m02, m03 = _m03;
+			m10 = _m10, m11 = _m11, m12 = _m12, m13 = _m13;
+			m20 = _m20, m21 = _m21, m22 = _m22, m23 = _m23;
+		}
+		//! Transformation: scale, then rotation, then translation.
+		Matrix3x4(const Vector3& _translation, const Quaternion& _rotation, const Vector3& _scale = Vector3(1))
+		{
+			float _xx = _rotation.x * _rotation.x, _yy = _rotation.y * _rotation.y, _zz = _rotation.z * _rotation.z;
+			float _xy = _rotation.x * _rotation.y, _xz = _rotation.x * _rotation.z, _yz = _rotation.y * _rotation.z;
+			float _wx = _rotation.w * _rotation.x, _wy = _rotation.w * _rotation.y, _wz = _rotation.w * _rotation.z;
+			m00 = (1 - 2 * (_yy + _zz)) * _scale.x, m01 = 2 * (_xy - _wz) * _scale.y, m02 = 2 * (_xz + _wy) * _scale.z, m03 = _translation.x;
+			m10 = 2 * (_xy + _wz) * _scale.x, m11 = (1 - 2 * (_xx + _zz)) * _scale.y, m12 = 2 * (_yz - _wx) * _scale.z, m13 = _translation.y;
+			m20 = 2 * (_xz - _wy) * _scale.x, m21 = 2 * (_yz + _wx) * _scale.y, m22 = (1 - 2 * (_xx + _yy)) * _scale.z, m23 = _translation.z;
+		}
+
+		//!
+		Matrix3x4& SetIdentity(void) { return *this = Matrix3x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0); }
+
+		//! Composition: (A * B) * p = A * (B * p).
+		Matrix3x4 operator * (const Matrix3x4& _rhs) const
+		{
+			_V4 _b0 = _V4Load(_rhs.m[0]), _b1 = _V4Load(_rhs.m[1]), _b2 = _V4Load(_rhs.m[2]), _b3 = _V4Set(0, 0, 0, 1);
+			Matrix3x4 _r;
+			_V4Store(_r.m[0], _V4Combine(m[0], _b0, _b1, _b2, _b3));
+			_V4Store(_r.m[1], _V4Combine(m[1], _b0, _b1, _b2, _b3));
+			_V4Store(_r.m[2], _V4Combine(m[2], _b0, _b1, _b2, _b3));
+			return _r;
+		}
+		//!
+		Matrix3x4& operator *= (const Matrix3x4& _rhs) { return *this = *this * _rhs; }
+		//!
+		bool operator == (const Matrix3x4& _rhs) const
+		{
+			for (uint i = 0; i < 12; ++i)
+			{
+				if (v[i] != _rhs.v[i])
+					return false;
+			}
+			return true;
+		}
+		//!
+		bool operator != (const Matrix3x4& _rhs) const { return !(*this == _rhs); }
+		//!
+		Vector3 TransformPoint(const Vector3& _p) const
+		{
+			_V4 _r0 = _V4Load(m[0]);
+			Vector4 _r(_V4Transform(_r0, _V4Load(m[1]), _V4Load(m[2]), _r0, _V4Set(_p.x, _p.y, _p.z, 1)));
+			return Vector3(_r.x, _r.y, _r.z);
+		}
+		//! Transform the direction without translation.
+		Vector3 TransformVector(const Vector3& _v) const
+		{
+			_V4 _r0 = _V4Load(m[0]);
+			Vector4 _r(_V4Transform(_r0, _V4Load(m[1]), _V4Load(m[2]), _r0, _V4Set(_v.x, _v.y, _v.z, 0)));
+			return Vector3(_r.x, _r.y, _r.z);
+		}
+		//!
+		Vector3 GetTranslation(void) const { return Vector3(m03, m13, m23); }
+		//! Inverse transformation. A singular matrix is returned unchanged.
+		Matrix3x4 Inverse(void) const
+		{
+			float _c00 = m11 * m22 - m12 * m21, _c01 = m02 * m21 - m01 * m22, _c02 = m01 * m12 - m02 * m11;
+			float _c10 = m12 * m20 - m10 * m22, _c11 = m00 * m22 - m02 * m20, _c12 = m02 * m10 - m00 * m12;
+			float _c20 = m10 * m21 - m11 * m20, _c21 = m01 * m20 - m00 * m21, _c22 = m00 * m11 - m01 * m10;
+			float _det = m00 * _c00 + m01 * _c10 + m02 * _c20;
+			if (Abs(_det) < EPSILON2)
+				return *this;
+			float _s = 1 / _det;
+			Matrix3x4 _r(_c00 * _s, _c01 * _s, _c02 * _s, 0, _c10 * _s, _c11 * _s, _c12 * _s, 0, _c20 * _s, _c21 * _s, _c22 * _s, 0);
+			Vector3 _t = -_r.TransformVector(GetTranslation());
+			_r.m03 = _t.x, _r.m13 = _t.y, _r.m23 = _t.z;
+			return _r;
+		}
+
 		union
 		{
 			float v[12];
@@ -326,13 +1105,126 @@ namespace Reax
 	// 
 	//----------------------------------------------------------------------------//
 
-	//! Matrix4x4
+	//! Matrix4x4. Vectors are transformed as columns: v' = M * v.
 	struct Matrix4x4
 	{
+		//!
+		Matrix4x4(void) = default;
+		//!
+		Matrix4x4(float _m00, float _m01, float _m02, float _m03, float _m10, float _m11, float _m12, float _m13, float _m20, float _m21, float _m22, float _m23, float _m30, float _m31, float _m32, float _m33)
+		{
+			m00 = _m00, m01 = _m01, m02 = _m02, m03 = _m03;
+			m10 = _m10, m11 = _m11, m12 = _m12, m13 = _m13;
+			m20 = _m20, m21 = _m21, m22 = _m22, m23 = _m23;
+			m30 = _m30, m31 = _m31, m32 = _m32, m33 = _m33;
+		}
+		//!
+		Matrix4x4(const Matrix3x4& _m)
+		{
+			memcpy(v, _m.v, sizeof(_m.v));
+			m30 = 0, m31 = 0, m32 = 0, m33 = 1;
+		}
+
+		//!
+		Matrix4x4& SetIdentity(void) { return *this = Matrix4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1); }
+
+		//! Composition: (A * B) * v = A * (B * v).
+		Matrix4x4 operator * (const Matrix4x4& _rhs) const
+		{
+			_V4 _b0 = _V4Load(_rhs.m[0]), _b1 = _V4Load(_rhs.m[1]), _b2 = _V4Load(_rhs.m[2]), _b3 = _V4Load(_rhs.m[3]);
+			Matrix4x4 _r;
+			_V4Store(_r.m[0], _V4Combine(m[0], _b0, _b1, _b2, _b3));
+			_V4Store(_r.m[1], _V4Combine(m[1], _b0, _b1, _b2, _b3));
+			_V4Store(_r.m[2], _V4Combine(m[2], _b0, _b1, _b2, _b3));
+			_V4Store(_r.m[3], _V4Combine(m[3], _b0, _b1, _b2, _b3));
+			return _r;
+		}
+		//!
+		Matrix4x4& operator *= (const Matrix4x4& _rhs) { return *this = *this * _rhs; }
+		//!
+		bool operator == (const Matrix4x4& _rhs) const
+		{
+			for (uint i = 0; i < 16; ++i)
+			{
+				if (v[i] != _rhs.v[i])
+					return false;
+			}
+			return true;
+		}
+		//!
+		bool operator != (const Matrix4x4& _rhs) const { return !(*this == _rhs); }
+		//!
+		Vector4 operator * (const Vector4& _rhs) const { return Vector4(_V4Transform(_V4Load(m[0]), _V4Load(m[1]), _V4Load(m[2]), _V4Load(m[3]), _rhs.Load())); }
+		//! Transform the point with the perspective division.
+		Vector3 TransformPoint(const Vector3& _p) const
+		{
+			Vector4 _r = *this * Vector4(_p, 1);
+			return Vector3(_r.x, _r.y, _r.z) / _r.w;
+		}
+		//! Transform the direction without translation.
+		Vector3 TransformVector(const Vector3& _v) const { return (*this * Vector4(_v, 0)).AsVector3(); }
+		//!
+		Matrix4x4 Transpose(void) const
+		{
+			_V4 _r0 = _V4Load(m[0]), _r1 = _V4Load(m[1]), _r2 = _V4Load(m[2]), _r3 = _V4Load(m[3]);
+			_V4Transpose(_r0, _r1, _r2, _r3);
+			Matrix4x4 _r;
+			_V4Store(_r.m[0], _r0);
+			_V4Store(_r.m[1], _r1);
+			_V4Store(_r.m[2], _r2);
+			_V4Store(_r.m[3], _r3);
+			return _r;
+		}
+		//! Inverse of any invertible matrix by 2x2 blocks: | A B | | C D |. A singular matrix gives infinities.
+		Matrix4x4 Inverse(void) const
+		{
+			_V4 _r0 = _V4Load(m[0]), _r1 = _V4Load(m[1]), _r2 = _V4Load(m[2]), _r3 = _V4Load(m[3]);
+
+			// 2x2 blocks as (m00, m01, m10, m11)
+			_V4 _a = _V4Shuffle<0, 1, 0, 1>(_r0, _r1);
+			_V4 _b = _V4Shuffle<2, 3, 2, 3>(_r0, _r1);
+			_V4 _c = _V4Shuffle<0, 1, 0, 1>(_r2, _r3);
+			_V4 _d = _V4Shuffle<2, 3, 2, 3>(_r2, _r3);
+
+			// determinants of the blocks (|A|, |B|, |C|, |D|)
+			_V4 _det = _V4Sub(_V4Mul(_V4Shuffle<0, 2, 0, 2>(_r0, _r2), _V4Shuffle<1, 3, 1, 3>(_r1, _r3)), _V4Mul(_V4Shuffle<1, 3, 1, 3>(_r0, _r2), _V4Shuffle<0, 2, 0, 2>(_r1, _r3)));
+			_V4 _detA = _V4Shuffle<0, 0, 0, 0>(_det);
+			_V4 _detB = _V4Shuffle<1, 1, 1, 1>(_det);
+			_V4 _detC = _V4Shuffle<2, 2, 2, 2>(_det);
+			_V4 _detD = _V4Shuffle<3, 3, 3, 3>(_det);
+
+			// adj(D) * C and adj(A) * B
+			_V4 _dc = _Mat2AdjMul(_d, _c);
+			_V4 _ab = _Mat2AdjMul(_a, _b);
+
+			// adjugates of the blocks of inverse
+			_V4 _x = _V4Sub(_V4Mul(_detD, _a), _Mat2Mul(_b, _dc));
+			_V4 _w = _V4Sub(_V4Mul(_detA, _d), _Mat2Mul(_c, _ab));
+			_V4 _y = _V4Sub(_V4Mul(_detB, _c), _Mat2MulAdj(_d, _ab));
+			_V4 _z = _V4Sub(_V4Mul(_detC, _b), _Mat2MulAdj(_a, _dc));
+
+			// |M| = |A| * |D| + |B| * |C| - tr(adj(A) * B * adj(D) * C)
+			_V4 _detM = _V4Add(_V4Mul(_detA, _detD), _V4Mul(_detB, _detC));
+			_detM = _V4Sub(_detM, _V4Sum(_V4Mul(_ab, _V4Shuffle<0, 2, 1, 3>(_dc))));
+
+			_V4 _rdet = _V4Div(_V4Set(1, -1, -1, 1), _detM);
+			_x = _V4Mul(_x, _rdet);
+			_y = _V4Mul(_y, _rdet);
+			_z = _V4Mul(_z, _rdet);
+			_w = _V4Mul(_w, _rdet);
+
+			Matrix4x4 _r;
+			_V4Store(_r.m[0], _V4Shuffle<3, 1, 3, 1>(_x, _y));
+			_V4Store(_r.m[1], _V4Shuffle<2, 0, 2, 0>(_x, _y));
+			_V4Store(_r.m[2], _V4Shuffle<3, 1, 3, 1>(_z, _w));
+			_V4Store(_r.m[3], _V4Shuffle<2, 0, 2, 0>(_z, _w));
+			return _r;
+		}
+
 		union
 		{
 			float v[16];
-			float m[1][4]; // [row][column]
+			float m[4][4]; // [row][column]
 			struct
 			{
 				float m00, m01, m02, m03;
@@ -341,6 +1233,14 @@ namespace Reax
 				float m30, m31, m32, m33;
 			};
 		};
+
+	protected:
+		//! 2x2 matrices A * B
+		static _V4 _Mat2Mul(_V4 _a, _V4 _b) { return _V4Add(_V4Mul(_a, _V4Shuffle<0, 3, 0, 3>(_b)), _V4Mul(_V4Shuffle<1, 0, 3, 2>(_a), _V4Shuffle<2, 1, 2, 1>(_b))); }
+		//! adj(A) * B
+		static _V4 _Mat2AdjMul(_V4 _a, _V4 _b) { return _V4Sub(_V4Mul(_V4Shuffle<3, 3, 0, 0>(_a), _b), _V4Mul(_V4Shuffle<1, 1, 2, 2>(_a), _V4Shuffle<2, 3, 0, 1>(_b))); }
+		//! A * adj(B)
+		static _V4 _Mat2MulAdj(_V4 _a, _V4 _b) { return _V4Sub(_V4Mul(_a, _V4Shuffle<3, 0, 3, 0>(_b)), _V4Mul(_V4Shuffle<1, 0, 3, 2>(_a), _V4Shuffle<2, 1, 2, 1>(_b))); }
 	};
 
 	//----------------------------------------------------------------------------//
@@ -353,13 +1253,23 @@ namespace Reax
 		Vector3 origin, dir;
 	};
 
+	//! Sphere
+	struct Sphere
+	{
+		Vector3 center;
+		float radius;
+	};
+
 	//----------------------------------------------------------------------------//
 	//
 	//----------------------------------------------------------------------------//
 
-	//! Plane
+	//! Plane: normal.Dot(p) + dist = 0.
 	struct Plane
 	{
+		//! Signed distance to the point, positive in front of the plane. The normal must be normalized.
+		float Distance(const Vector3& _p) const { return _p.Dot(normal) + dist; }
+
 		Vector3 normal;
 		float dist;
 	};
@@ -368,54 +1278,231 @@ namespace Reax
 	//
 	//----------------------------------------------------------------------------//
 
-	//! AlignedBox
+	//! Axis-aligned bounding box.
 	struct AlignedBox
 	{
+		//!
+		AlignedBox(void) = default;
+		//!
+		AlignedBox(const Vector3& _min, const Vector3& _max) : mn(_min), mx(_max) { }
+
+		//! Union of boxes.
+		AlignedBox operator + (const AlignedBox& _rhs) const { return AlignedBox(mn.Min(_rhs.mn), mx.Max(_rhs.mx)); }
+		//!
+		AlignedBox& operator += (const AlignedBox& _rhs) { return *this = *this + _rhs; }
+		//!
+		bool operator == (const AlignedBox& _rhs) const { return mn == _rhs.mn && mx == _rhs.mx; }
+		//!
+		bool operator != (const AlignedBox& _rhs) const { return !(*this == _rhs); }
+
+		//!
+		Vector3 Center(void) const { return (mn + mx) * 0.5f; }
+		//! Half-size.
+		Vector3 Extent(void) const { return (mx - mn) * 0.5f; }
+		//! Half of the surface area, the cost of the box in surface area heuristic.
+		float Area(void) const
+		{
+			Vector3 _d = mx - mn;
+			return _d.x * _d.y + _d.y * _d.z + _d.z * _d.x;
+		}
+		//! The corner farthest along the direction.
+		Vector3 Support(const Vector3& _dir) const { return Vector3(_dir.x > 0 ? mx.x : mn.x, _dir.y > 0 ? mx.y : mn.y, _dir.z > 0 ? mx.z : mn.z); }
+		//! Box enlarged by _margin on each side.
+		AlignedBox Expand(float _margin) const { return AlignedBox(mn - Vector3(_margin), mx + Vector3(_margin)); }
+		//!
+		bool Contains(const AlignedBox& _box) const
+		{
+			return mn.x <= _box.mn.x && mn.y <= _box.mn.y && mn.z <= _box.mn.z && mx.x >= _box.mx.x && mx.y >= _box.mx.y && mx.z >= _box.mx.z;
+		}
+		//!
+		bool Intersects(const AlignedBox& _box) const
+		{
+			return mn.x <= _box.mx.x && mn.y <= _box.mx.y && mn.z <= _box.mx.z && mx.x >= _box.mn.x && mx.y >= _box.mn.y && mx.z >= _box.mn.z;
+		}
+
 		Vector3 mn, mx;
 	};
 
 	//----------------------------------------------------------------------------//
-	//
+	// PreparedRay, RayPacket
 	//----------------------------------------------------------------------------//
 
-	//! Frustum
-	struct Frustum
+	//! Ray with precomputed values for intersection tests.
+	struct PreparedRay
 	{
-		Plane planes[6];
-	};
+		//!
+		PreparedRay(void) = default;
+		//!
+		PreparedRay(const Ray& _ray) : origin(_ray.origin), dir(_ray.dir), invDir(1 / _ray.dir.x, 1 / _ray.dir.y, 1 / _ray.dir.z)
+		{
+			Vector3 _abs = dir.Abs();
+			kz = _abs.x > _abs.y ? (_abs.x > _abs.z ? 0 : 2) : (_abs.y > _abs.z ? 1 : 2);
+			kx = kz < 2 ? kz + 1 : 0;
+			ky = kx < 2 ? kx + 1 : 0;
+			shear = Vector3(dir.v[kx] / dir.v[kz], dir.v[ky] / dir.v[kz], 1 / dir.v[kz]);
+		}
 
-	//----------------------------------------------------------------------------//
-	//
-	//----------------------------------------------------------------------------//
+		//! Slab test in [0, _maxDist], _dist is the entry distance.
+		bool Intersects(const AlignedBox& _box, float _maxDist, float& _dist) const
+		{
+			Vector3 _t0 = (_box.mn - origin) * invDir;
+			Vector3 _t1 = (_box.mx - origin) * invDir;
+			Vector3 _near = _t0.Min(_t1), _far = _t0.Max(_t1);
+			_dist = Max(Max(_near.x, _near.y), Max(_near.z, 0.0f));
+			return _dist <= Min(Min(_far.x, _far.y), Min(_far.z, _maxDist));
+		}
+
+		//! Two-sided watertight ray-triangle test (Woop, Benthin, Wald 2013) in (0, _maxDist), _dist is the distance of the hit.
+		//! The vertices are transformed to the space where the ray starts at the origin and goes along z, so rays hitting a shared edge
+		//! or vertex hit at least one of the triangles.
+		bool Intersects(const Vector3& _v0, const Vector3& _v1, const Vector3& _v2, float _maxDist, float& _dist) const
+		{
+			float _az = _v0.v[kz] - origin.v[kz], _bz = _v1.v[kz] - origin.v[kz], _cz = _v2.v[kz] - origin.v[kz];
+			float _ax = (_v0.v[kx] - origin.v[kx]) - shear.x * _az, _ay = (_v0.v[ky] - origin.v[ky]) - shear.y * _az;
+			float _bx = (_v1.v[kx] - origin.v[kx]) - shear.x * _bz, _by = (_v1.v[ky] - origin.v[ky]) - shear.y * _bz;
+			float _cx = (_v2.v[kx] - origin.v[kx]) - shear.x * _cz, _cy = (_v2.v[ky] - origin.v[ky]) - shear.y * _cz;
+			float _u = _cx * _by - _cy * _bx, _v = _ax * _cy - _ay * _cx, _w = _bx * _ay - _by * _ax;
+			if ((_u < 0 || _v < 0 || _w < 0) && (_u > 0 || _v > 0 || _w > 0))
+				return false;
+			float _det = _u + _v + _w;
+			float _t = (_u * _az + _v * _bz + _w * _cz) * shear.z / _det;
+			if (_det == 0 || !(_t > 0 && _t < _maxDist))
+				return false;
+			_dist = _t;
+			return true;
+		}
+
+		Vector3 origin, dir, invDir;
+		//! (dir[kx] / dir[kz], dir[ky] / dir[kz], 1 / dir[kz]), kz is the axis of the largest component of the direction.
+		Vector3 shear;
+		uint kx, ky, kz;
+	};
 
-	//! Dynamic bounding-volumes tree node
-	struct DbvNode
+	//! Packet of 4 or 8 rays for coherent traversal. The values are in structure of arrays for the slab test of all rays at once.
+	template <uint N> struct RayPacket
 	{
-		AlignedBox bounds;
-		DbvNode* parent;
-		union
+		static_assert(N == 4 || N == 8, "Packet must have 4 or 8 rays");
+
+		//! Mask of all rays.
+		static const uint ALL = (1 << N) - 1;
+
+		//!
+		void Set(uint _index, const Ray& _ray, float _maxDist)
 		{
-			DbvNode* child[2] = { 0, 0 };
-			struct
+			ray[_index] = _ray;
+			ox[_index] = _ray.origin.x;
+			oy[_index] = _ray.origin.y;
+			oz[_index] = _ray.origin.z;
+			ix[_index] = ray[_index].invDir.x;
+			iy[_index] = ray[_index].invDir.y;
+			iz[_index] = ray[_index].invDir.z;
+			maxDist[_index] = _maxDist;
+		}
+
+		//! Slab test of rays of _rays mask, the same as PreparedRay::Intersects. Returns the mask of rays intersecting the box, _dist is the nearest entry distance.
+		uint Intersects(const AlignedBox& _box, uint _rays, float& _dist) const
+		{
+			_V4 _mnX = _V4Splat(_box.mn.x), _mnY = _V4Splat(_box.mn.y), _mnZ = _V4Splat(_box.mn.z);
+			_V4 _mxX = _V4Splat(_box.mx.x), _mxY = _V4Splat(_box.mx.y), _mxZ = _V4Splat(_box.mx.z);
+			RX_ALIGN(16) float _near[N];
+			uint _hits = 0;
+			for (uint i = 0; i < N; i += 4)
 			{
-				void* object;
-				bool isInternal;
-			};
-		};
+				if (!((_rays >> i) & 0xf))
+					continue;
+				_V4 _ox = _V4Load(ox + i), _oy = _V4Load(oy + i), _oz = _V4Load(oz + i);
+				_V4 _ix = _V4Load(ix + i), _iy = _V4Load(iy + i), _iz = _V4Load(iz + i);
+				_V4 _t0x = _V4Mul(_V4Sub(_mnX, _ox), _ix), _t1x = _V4Mul(_V4Sub(_mxX, _ox), _ix);
+				_V4 _t0y = _V4Mul(_V4Sub(_mnY, _oy), _iy), _t1y = _V4Mul(_V4Sub(_mxY, _oy), _iy);
+				_V4 _t0z = _V4Mul(_V4Sub(_mnZ, _oz), _iz), _t1z = _V4Mul(_V4Sub(_mxZ, _oz), _iz);
+				_V4 _entry = _V4Max(_V4Max(_V4Min(_t0x, _t1x), _V4Min(_t0y, _t1y)), _V4Max(_V4Min(_t0z, _t1z), _V4Splat(0)));
+				_V4 _far = _V4Min(_V4Min(_V4Max(_t0x, _t1x), _V4Max(_t0y, _t1y)), _V4Min(_V4Max(_t0z, _t1z), _V4Load(maxDist + i)));
+				_V4Store(_near + i, _entry);
+				_hits |= (~_V4Mask(_V4Greater(_entry, _far)) & (_rays >> i) & 0xf) << i;
+			}
+			_dist = 1e30f;
+			for (uint i = _hits; i; i &= i - 1)
+				_dist = Min(_dist, _near[RX_CTZ(i)]);
+			return _hits;
+		}
+
+		PreparedRay ray[N];
+		float ox[N], oy[N], oz[N];
+		float ix[N], iy[N], iz[N];
+		//! The end of each ray, the callbacks of traversal shorten it to find the nearest hits.
+		float maxDist[N];
 	};
 
 	//----------------------------------------------------------------------------//
 	//
 	//----------------------------------------------------------------------------//
 
-	//! Dynamic bounding-volumes tree
-	class DbvTree
+	//! Mask of all planes of frustum for hierarchical tests.
+	static const uint FRUSTUM_ALL_PLANES = 0x3f;
+
+	//! Frustum. The planes face inside: points in front of all planes are inside.
+	//! Hierarchical tests take a mask of planes to test (a bit per plane, FRUSTUM_ALL_PLANES for the root) and remove the planes fully containing
+	//! the volume, so children are tested only with planes intersecting their parent and an empty mask means the volume is inside the frustum.
+	//! The plane that rejected the previous volume is tested first (_last), neighbouring volumes are usually rejected by the same plane.
+	struct Frustum
 	{
-	public:
+		//!
+		bool Intersects(const AlignedBox& _box) const
+		{
+			for (uint i = 0; i < 6; ++i)
+			{
+				if (planes[i].Distance(_box.Support(planes[i].normal)) < 0)
+					return false;
+			}
+			return true;
+		}
+		//!
+		bool Intersects(const Sphere& _sphere) const
+		{
+			for (uint i = 0; i < 6; ++i)
+			{
+				if (planes[i].Distance(_sphere.center) < -_sphere.radius)
+					return false;
+			}
+			return true;
+		}
+		//! Hierarchical test with plane coherency.
+		bool Intersects(const AlignedBox& _box, uint& _planes, uint& _last) const
+		{
+			for (uint j = 0, i = _last; j < 6; ++j, i = i < 5 ? i + 1 : 0)
+			{
+				if (!(_planes & (1 << i)))
+					continue;
+				if (planes[i].Distance(_box.Support(planes[i].normal)) < 0)
+				{
+					_last = i;
+					return false;
+				}
+				if (planes[i].Distance(_box.Support(-planes[i].normal)) > 0)
+					_planes &= ~(1 << i);
+			}
+			return true;
+		}
+		//! Hierarchical test with plane coherency.
+		bool Intersects(const Sphere& _sphere, uint& _planes, uint& _last) const
+		{
+			for (uint j = 0, i = _last; j < 6; ++j, i = i < 5 ? i + 1 : 0)
+			{
+				if (!(_planes & (1 << i)))
+					continue;
+				float _d = planes[i].Distance(_sphere.center);
+				if (_d < -_sphere.radius)
+				{
+					_last = i;
+					return false;
+				}
+				if (_d > _sphere.radius)
+					_planes &= ~(1 << i);
+			}
+			return true;
+		}
 
-	protected:
-		DbvNode* m_root;
-		DbvNode* m_free;
+		Plane planes[6];
 	};
 
 	//----------------------------------------------------------------------------//
@@ -0,0 +1,913 @@
+#include "MathBatch.hpp"
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// Dispatch
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_X86
+	static const bool s_hasAvx2 = GetCpuFeatures().avx2;
+	static const bool s_hasAvx512 = GetCpuFeatures().avx512f;
+	static const bool s_hasF16c = GetCpuFeatures().f16c;
+#endif
+
+	// AVX2 kernels repeat the operations of the scalar code and give the same results.
+	// AVX-512 kernels use fused multiply-add (AVX-512 implies FMA) and can differ from the scalar code in the last bit.
+
+	//! Mask of first _count lanes (_count < 16).
+	static inline uint16 _TailMask(uint _count) { return (uint16)((1u << _count) - 1); }
+
+	//----------------------------------------------------------------------------//
+	// TransformPoints, TransformVectors
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_X86
+	//!
+	template <bool Point> RX_TARGET("avx512f") static uint _TransformAvx512(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dx, float* _dy, float* _dz, uint _count)
+	{
+		__m512 _r[3][4];
+		for (uint i = 0; i < 3; ++i)
+		{
+			for (uint j = 0; j < 4; ++j)
+				_r[i][j] = _mm512_set1_ps(_m.m[i][j]);
+		}
+		for (uint i = 0; i < _count; i += 16)
+		{
+			__mmask16 _mask = _count - i >= 16 ? 0xffff : _TailMask(_count - i);
+			__m512 _vx = _mm512_maskz_loadu_ps(_mask, _x + i);
+			__m512 _vy = _mm512_maskz_loadu_ps(_mask, _y + i);
+			__m512 _vz = _mm512_maskz_loadu_ps(_mask, _z + i);
+			__m512 _t[3];
+			for (uint j = 0; j < 3; ++j)
+			{
+				__m512 _w = Point ? _r[j][3] : _mm512_setzero_ps();
+				_t[j] = _mm512_fmadd_ps(_r[j][2], _vz, _mm512_fmadd_ps(_r[j][1], _vy, _mm512_fmadd_ps(_r[j][0], _vx, _w)));
+			}
+			_mm512_mask_storeu_ps(_dx + i, _mask, _t[0]);
+			_mm512_mask_storeu_ps(_dy + i, _mask, _t[1]);
+			_mm512_mask_storeu_ps(_dz + i, _mask, _t[2]);
+		}
+		return _count;
+	}
+
+	//!
+	template <bool Point> RX_TARGET("avx2") static uint _TransformAvx2(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dx, float* _dy, float* _dz, uint _count)
+	{
+		__m256 _r[3][4];
+		for (uint i = 0; i < 3; ++i)
+		{
+			for (uint j = 0; j < 4; ++j)
+				_r[i][j] = _mm256_set1_ps(_m.m[i][j]);
+		}
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256 _vx = _mm256_loadu_ps(_x + i);
+			__m256 _vy = _mm256_loadu_ps(_y + i);
+			__m256 _vz = _mm256_loadu_ps(_z + i);
+			__m256 _t[3];
+			for (uint j = 0; j < 3; ++j)
+			{
+				__m256 _xy = _mm256_add_ps(_mm256_mul_ps(_r[j][0], _vx), _mm256_mul_ps(_r[j][1], _vy));
+				__m256 _zw = _mm256_mul_ps(_r[j][2], _vz);
+				_t[j] = _mm256_add_ps(_xy, Point ? _mm256_add_ps(_zw, _r[j][3]) : _zw);
+			}
+			_mm256_storeu_ps(_dx + i, _t[0]);
+			_mm256_storeu_ps(_dy + i, _t[1]);
+			_mm256_storeu_ps(_dz + i, _t[2]);
+		}
+		return i;
+	}
+#endif
+
+	//!
+	template <bool Point> static void _Transform(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dx, float* _dy, float* _dz, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _TransformAvx512<Point>(_m, _x, _y, _z, _dx, _dy, _dz, _count);
+		else if (s_hasAvx2)
+			i = _TransformAvx2<Point>(_m, _x, _y, _z, _dx, _dy, _dz, _count);
+#endif
+		for (; i < _count; ++i)
+		{
+			Vector3 _v(_x[i], _y[i], _z[i]);
+			_v = Point ? _m.TransformPoint(_v) : _m.TransformVector(_v);
+			_dx[i] = _v.x, _dy[i] = _v.y, _dz[i] = _v.z;
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	void TransformPoints(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dstX, float* _dstY, float* _dstZ, uint _count)
+	{
+		_Transform<true>(_m, _x, _y, _z, _dstX, _dstY, _dstZ, _count);
+	}
+	//----------------------------------------------------------------------------//
+	void TransformPoints(const Matrix3x4& _m, const Vector3Array& _src, Vector3Array& _dst)
+	{
+		_dst.Resize(_src.Size());
+		_Transform<true>(_m, _src.X(), _src.Y(), _src.Z(), _dst.X(), _dst.Y(), _dst.Z(), _src.Size());
+	}
+	//----------------------------------------------------------------------------//
+	void TransformVectors(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dstX, float* _dstY, float* _dstZ, uint _count)
+	{
+		_Transform<false>(_m, _x, _y, _z, _dstX, _dstY, _dstZ, _count);
+	}
+	//----------------------------------------------------------------------------//
+	void TransformVectors(const Matrix3x4& _m, const Vector3Array& _src, Vector3Array& _dst)
+	{
+		_dst.Resize(_src.Size());
+		_Transform<false>(_m, _src.X(), _src.Y(), _src.Z(), _dst.X(), _dst.Y(), _dst.Z(), _src.Size());
+	}
+
+	//----------------------------------------------------------------------------//
+	// NormalizeVectors
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_X86
+	//!
+	RX_TARGET("avx512f") static uint _NormalizeAvx512(float* _x, float* _y, float* _z, uint _count)
+	{
+		const __m512 _one = _mm512_set1_ps(1), _eps = _mm512_set1_ps(EPSILON2);
+		for (uint i = 0; i < _count; i += 16)
+		{
+			__mmask16 _mask = _count - i >= 16 ? 0xffff : _TailMask(_count - i);
+			__m512 _vx = _mm512_maskz_loadu_ps(_mask, _x + i);
+			__m512 _vy = _mm512_maskz_loadu_ps(_mask, _y + i);
+			__m512 _vz = _mm512_maskz_loadu_ps(_mask, _z + i);
+			__m512 _l = _mm512_fmadd_ps(_vz, _vz, _mm512_fmadd_ps(_vy, _vy, _mm512_mul_ps(_vx, _vx)));
+			__m512 _s = _mm512_div_ps(_one, _mm512_sqrt_ps(_l));
+			_mask &= _mm512_cmp_ps_mask(_l, _eps, _CMP_GT_OQ); // zero vectors are not changed
+			_mm512_mask_storeu_ps(_x + i, _mask, _mm512_mul_ps(_vx, _s));
+			_mm512_mask_storeu_ps(_y + i, _mask, _mm512_mul_ps(_vy, _s));
+			_mm512_mask_storeu_ps(_z + i, _mask, _mm512_mul_ps(_vz, _s));
+		}
+		return _count;
+	}
+
+	//!
+	RX_TARGET("avx2") static uint _NormalizeAvx2(float* _x, float* _y, float* _z, uint _count)
+	{
+		const __m256 _one = _mm256_set1_ps(1), _eps = _mm256_set1_ps(EPSILON2);
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256 _vx = _mm256_loadu_ps(_x + i);
+			__m256 _vy = _mm256_loadu_ps(_y + i);
+			__m256 _vz = _mm256_loadu_ps(_z + i);
+			__m256 _l = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_vx, _vx), _mm256_mul_ps(_vy, _vy)), _mm256_mul_ps(_vz, _vz));
+			__m256 _s = _mm256_div_ps(_one, _mm256_sqrt_ps(_l));
+			_s = _mm256_blendv_ps(_one, _s, _mm256_cmp_ps(_l, _eps, _CMP_GT_OQ)); // zero vectors are not changed
+			_mm256_storeu_ps(_x + i, _mm256_mul_ps(_vx, _s));
+			_mm256_storeu_ps(_y + i, _mm256_mul_ps(_vy, _s));
+			_mm256_storeu_ps(_z + i, _mm256_mul_ps(_vz, _s));
+		}
+		return i;
+	}
+#endif
+
+	//----------------------------------------------------------------------------//
+	void NormalizeVectors(float* _x, float* _y, float* _z, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _NormalizeAvx512(_x, _y, _z, _count);
+		else if (s_hasAvx2)
+			i = _NormalizeAvx2(_x, _y, _z, _count);
+#endif
+		for (; i < _count; ++i)
+		{
+			Vector3 _v = Vector3(_x[i], _y[i], _z[i]).Normalize();
+			_x[i] = _v.x, _y[i] = _v.y, _z[i] = _v.z;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void NormalizeVectors(Vector3Array& _v)
+	{
+		NormalizeVectors(_v.X(), _v.Y(), _v.Z(), _v.Size());
+	}
+
+	//----------------------------------------------------------------------------//
+	// DotProducts
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_X86
+	//!
+	RX_TARGET("avx512f") static uint _DotAvx512(const float* _ax, const float* _ay, const float* _az, const float* _bx, const float* _by, const float* _bz, float* _dst, uint _count)
+	{
+		for (uint i = 0; i < _count; i += 16)
+		{
+			__mmask16 _mask = _count - i >= 16 ? 0xffff : _TailMask(_count - i);
+			__m512 _d = _mm512_mul_ps(_mm512_maskz_loadu_ps(_mask, _ax + i), _mm512_maskz_loadu_ps(_mask, _bx + i));
+			_d = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(_mask, _ay + i), _mm512_maskz_loadu_ps(_mask, _by + i), _d);
+			_d = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(_mask, _az + i), _mm512_maskz_loadu_ps(_mask, _bz + i), _d);
+			_mm512_mask_storeu_ps(_dst + i, _mask, _d);
+		}
+		return _count;
+	}
+
+	//!
+	RX_TARGET("avx2") static uint _DotAvx2(const float* _ax, const float* _ay, const float* _az, const float* _bx, const float* _by, const float* _bz, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256 _x = _mm256_mul_ps(_mm256_loadu_ps(_ax + i), _mm256_loadu_ps(_bx + i));
+			__m256 _y = _mm256_mul_ps(_mm256_loadu_ps(_ay + i), _mm256_loadu_ps(_by + i));
+			__m256 _z = _mm256_mul_ps(_mm256_loadu_ps(_az + i), _mm256_loadu_ps(_bz + i));
+			_mm256_storeu_ps(_dst + i, _mm256_add_ps(_mm256_add_ps(_x, _y), _z));
+		}
+		return i;
+	}
+#endif
+
+	//----------------------------------------------------------------------------//
+	void DotProducts(const float* _ax, const float* _ay, const float* _az, const float* _bx, const float* _by, const float* _bz, float* _dst, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _DotAvx512(_ax, _ay, _az, _bx, _by, _bz, _dst, _count);
+		else if (s_hasAvx2)
+			i = _DotAvx2(_ax, _ay, _az, _bx, _by, _bz, _dst, _count);
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = Vector3(_ax[i], _ay[i], _az[i]).Dot(Vector3(_bx[i], _by[i], _bz[i]));
+	}
+	//----------------------------------------------------------------------------//
+	void DotProducts(const Vector3Array& _a, const Vector3Array& _b, float* _dst)
+	{
+		ASSERT(_a.Size() == _b.Size());
+		DotProducts(_a.X(), _a.Y(), _a.Z(), _b.X(), _b.Y(), _b.Z(), _dst, _a.Size());
+	}
+
+	//----------------------------------------------------------------------------//
+	// ClassifyBoxes
+	//----------------------------------------------------------------------------//
+
+	// The box is tested by its center and half-size: the distance from the center is compared with the projected radius |n| * e.
+
+	//!
+	static inline int8 _ClassifyBox(const Plane& _plane, const Vector3& _absNormal, const Vector3& _min, const Vector3& _max)
+	{
+		float _d = _plane.Distance((_min + _max) * 0.5f);
+		float _r = _absNormal.Dot((_max - _min) * 0.5f);
+		return _d > _r ? 1 : (_d < -_r ? -1 : 0);
+	}
+
+#ifdef RX_X86
+	//!
+	RX_TARGET("avx512f") static uint _ClassifyBoxesAvx512(const Plane& _plane, const Vector3Array& _min, const Vector3Array& _max, int8* _dst)
+	{
+		const float* _mn[3] = { _min.X(), _min.Y(), _min.Z() };
+		const float* _mx[3] = { _max.X(), _max.Y(), _max.Z() };
+		const __m512 _half = _mm512_set1_ps(0.5f);
+		const __m512 _dist = _mm512_set1_ps(_plane.dist);
+		__m512 _n[3], _an[3];
+		for (uint j = 0; j < 3; ++j)
+		{
+			_n[j] = _mm512_set1_ps(_plane.normal.v[j]);
+			_an[j] = _mm512_set1_ps(Abs(_plane.normal.v[j]));
+		}
+		uint _count = _min.Size();
+		for (uint i = 0; i < _count; i += 16)
+		{
+			__mmask16 _mask = _count - i >= 16 ? 0xffff : _TailMask(_count - i);
+			__m512 _c[3], _e[3];
+			for (uint j = 0; j < 3; ++j)
+			{
+				__m512 _a = _mm512_maskz_loadu_ps(_mask, _mn[j] + i);
+				__m512 _b = _mm512_maskz_loadu_ps(_mask, _mx[j] + i);
+				_c[j] = _mm512_mul_ps(_mm512_add_ps(_a, _b), _half);
+				_e[j] = _mm512_mul_ps(_mm512_sub_ps(_b, _a), _half);
+			}
+			__m512 _d = _mm512_fmadd_ps(_c[2], _n[2], _mm512_fmadd_ps(_c[1], _n[1], _mm512_fmadd_ps(_c[0], _n[0], _dist)));
+			__m512 _r = _mm512_fmadd_ps(_an[2], _e[2], _mm512_fmadd_ps(_an[1], _e[1], _mm512_mul_ps(_an[0], _e[0])));
+			__m512i _front = _mm512_maskz_set1_epi32(_mm512_cmp_ps_mask(_d, _r, _CMP_GT_OQ), 1);
+			__m512i _back = _mm512_maskz_set1_epi32(_mm512_cmp_ps_mask(_d, _mm512_sub_ps(_mm512_setzero_ps(), _r), _CMP_LT_OQ), 1);
+			_mm512_mask_cvtepi32_storeu_epi8(_dst + i, _mask, _mm512_sub_epi32(_front, _back));
+		}
+		return _count;
+	}
+
+	//!
+	RX_TARGET("avx2") static uint _ClassifyBoxesAvx2(const Plane& _plane, const Vector3Array& _min, const Vector3Array& _max, int8* _dst)
+	{
+		const float* _mn[3] = { _min.X(), _min.Y(), _min.Z() };
+		const float* _mx[3] = { _max.X(), _max.Y(), _max.Z() };
+		const __m256 _half = _mm256_set1_ps(0.5f);
+		const __m256 _dist = _mm256_set1_ps(_plane.dist);
+		__m256 _n[3], _an[3];
+		for (uint j = 0; j < 3; ++j)
+		{
+			_n[j] = _mm256_set1_ps(_plane.normal.v[j]);
+			_an[j] = _mm256_set1_ps(Abs(_plane.normal.v[j]));
+		}
+		uint _count = _min.Size();
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m256 _c[3], _e[3];
+			for (uint j = 0; j < 3; ++j)
+			{
+				__m256 _a = _mm256_loadu_ps(_mn[j] + i);
+				__m256 _b = _mm256_loadu_ps(_mx[j] + i);
+				_c[j] = _mm256_mul_ps(_mm256_add_ps(_a, _b), _half);
+				_e[j] = _mm256_mul_ps(_mm256_sub_ps(_b, _a), _half);
+			}
+			__m256 _d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_c[0], _n[0]), _mm256_mul_ps(_c[1], _n[1])), _mm256_mul_ps(_c[2], _n[2])), _dist);
+			__m256 _r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_an[0], _e[0]), _mm256_mul_ps(_an[1], _e[1])), _mm256_mul_ps(_an[2], _e[2]));
+			uint _front = (uint)_mm256_movemask_ps(_mm256_cmp_ps(_d, _r, _CMP_GT_OQ));
+			uint _back = (uint)_mm256_movemask_ps(_mm256_cmp_ps(_d, _mm256_sub_ps(_mm256_setzero_ps(), _r), _CMP_LT_OQ));
+			for (uint j = 0; j < 8; ++j)
+				_dst[i + j] = (int8)(((_front >> j) & 1) - ((_back >> j) & 1));
+		}
+		return i;
+	}
+#endif
+
+	//----------------------------------------------------------------------------//
+	void ClassifyBoxes(const Plane& _plane, const Vector3Array& _min, const Vector3Array& _max, int8* _dst)
+	{
+		ASSERT(_min.Size() == _max.Size());
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _ClassifyBoxesAvx512(_plane, _min, _max, _dst);
+		else if (s_hasAvx2)
+			i = _ClassifyBoxesAvx2(_plane, _min, _max, _dst);
+#endif
+		Vector3 _absNormal = _plane.normal.Abs();
+		for (uint _count = _min.Size(); i < _count; ++i)
+			_dst[i] = _ClassifyBox(_plane, _absNormal, _min[i], _max[i]);
+	}
+
+	//----------------------------------------------------------------------------//
+	// CullBoxes
+	//----------------------------------------------------------------------------//
+
+	// A box is outside if the corner farthest along the normal (AlignedBox::Support) is behind a plane. The corners are selected once for each plane,
+	// so a plane costs three multiplications and additions for a group of boxes. Groups of four boxes are transposed to SoA by two 4x4 transposes
+	// of overlapping loads: (mn.x, mn.y, mn.z, mx.x) and (mn.z, mx.x, mx.y, mx.z). The testing of group stops when all its boxes are rejected,
+	// the plane that rejected the previous group is tested first.
+
+	//! Planes to test with indices of the components of their support points in the transposed group.
+	struct _CullPlanes
+	{
+		_CullPlanes(const Frustum& _frustum, uint _mask)
+		{
+			count = 0;
+			for (uint i = 0; i < 6; ++i)
+			{
+				if (_mask & (1 << i))
+				{
+					plane[count] = _frustum.planes[i];
+					support[count][0] = plane[count].normal.x > 0 ? 3 : 0;
+					support[count][1] = plane[count].normal.y > 0 ? 6 : 1;
+					support[count][2] = plane[count].normal.z > 0 ? 7 : 2;
+					++count;
+				}
+			}
+		}
+
+		Plane plane[6];
+		uint support[6][3];
+		uint count;
+	};
+
+	//! Four boxes transposed to SoA: (mn.x, mn.y, mn.z, mx.x) to _v[0..3] and (mn.z, mx.x, mx.y, mx.z) to _v[4..7].
+	static inline void _LoadBoxesV4(const AlignedBox* _boxes, _V4* _v)
+	{
+		const float* _src = &_boxes->mn.x;
+		for (uint j = 0; j < 4; ++j)
+		{
+			_v[j] = _V4Load(_src + j * 6);
+			_v[j + 4] = _V4Load(_src + j * 6 + 2);
+		}
+		_V4Transpose(_v[0], _v[1], _v[2], _v[3]);
+		_V4Transpose(_v[4], _v[5], _v[6], _v[7]);
+	}
+
+	//! Number of set bits.
+	static inline uint _BitCount(uint _x)
+	{
+		_x = _x - ((_x >> 1) & 0x55555555);
+		_x = (_x & 0x33333333) + ((_x >> 2) & 0x33333333);
+		return (((_x + (_x >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+	}
+
+	//!
+	static uint _CullBoxesV4(const _CullPlanes& _planes, const AlignedBox* _boxes, uint _count, uint* _visible)
+	{
+		_V4 _p[6][4];
+		for (uint i = 0; i < _planes.count; ++i)
+		{
+			_p[i][0] = _V4Splat(_planes.plane[i].normal.x);
+			_p[i][1] = _V4Splat(_planes.plane[i].normal.y);
+			_p[i][2] = _V4Splat(_planes.plane[i].normal.z);
+			_p[i][3] = _V4Splat(_planes.plane[i].dist);
+		}
+		const _V4 _zero = _V4Splat(0);
+		uint _first = 0;
+		uint i = 0;
+		for (; i + 32 <= _count; i += 32)
+		{
+			uint _bits = 0;
+			for (uint k = 0; k < 32; k += 4)
+			{
+				_V4 _v[8];
+				_LoadBoxesV4(_boxes + i + k, _v);
+				_V4 _out = _zero;
+				for (uint j = 0, p = _first; j < _planes.count; ++j, p = p + 1 < _planes.count ? p + 1 : 0)
+				{
+					const uint* _s = _planes.support[p];
+					_V4 _d = _V4Add(_V4Add(_V4Add(_V4Mul(_v[_s[0]], _p[p][0]), _V4Mul(_v[_s[1]], _p[p][1])), _V4Mul(_v[_s[2]], _p[p][2])), _p[p][3]);
+					_out = _V4Or(_out, _V4Less(_d, _zero));
+					if (_V4Mask(_out) == 0xf)
+					{
+						_first = p;
+						break;
+					}
+				}
+				_bits |= (~_V4Mask(_out) & 0xf) << k;
+			}
+			_visible[i >> 5] = _bits;
+		}
+		return i;
+	}
+
+#ifdef RX_X86
+	//! _MM_TRANSPOSE4_PS in both halves.
+	RX_TARGET("avx2") static inline void _Transpose4Avx(__m256& _r0, __m256& _r1, __m256& _r2, __m256& _r3)
+	{
+		__m256 _t0 = _mm256_unpacklo_ps(_r0, _r1), _t1 = _mm256_unpacklo_ps(_r2, _r3);
+		__m256 _t2 = _mm256_unpackhi_ps(_r0, _r1), _t3 = _mm256_unpackhi_ps(_r2, _r3);
+		_r0 = _mm256_shuffle_ps(_t0, _t1, _MM_SHUFFLE(1, 0, 1, 0));
+		_r1 = _mm256_shuffle_ps(_t0, _t1, _MM_SHUFFLE(3, 2, 3, 2));
+		_r2 = _mm256_shuffle_ps(_t2, _t3, _MM_SHUFFLE(1, 0, 1, 0));
+		_r3 = _mm256_shuffle_ps(_t2, _t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	//! Boxes i..i+3 in the low halves and i+4..i+7 in the high halves.
+	RX_TARGET("avx2") static uint _CullBoxesAvx2(const _CullPlanes& _planes, const AlignedBox* _boxes, uint _count, uint* _visible)
+	{
+		__m256 _p[6][4];
+		for (uint i = 0; i < _planes.count; ++i)
+		{
+			_p[i][0] = _mm256_set1_ps(_planes.plane[i].normal.x);
+			_p[i][1] = _mm256_set1_ps(_planes.plane[i].normal.y);
+			_p[i][2] = _mm256_set1_ps(_planes.plane[i].normal.z);
+			_p[i][3] = _mm256_set1_ps(_planes.plane[i].dist);
+		}
+		const __m256 _zero = _mm256_setzero_ps();
+		uint _first = 0;
+		uint i = 0;
+		for (; i + 32 <= _count; i += 32)
+		{
+			uint _bits = 0;
+			for (uint k = 0; k < 32; k += 8)
+			{
+				const float* _src = &_boxes[i + k].mn.x;
+				__m256 _v[8];
+				for (uint j = 0; j < 4; ++j)
+				{
+					_v[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(_src + j * 6)), _mm_loadu_ps(_src + j * 6 + 24), 1);
+					_v[j + 4] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(_src + j * 6 + 2)), _mm_loadu_ps(_src + j * 6 + 26), 1);
+				}
+				_Transpose4Avx(_v[0], _v[1], _v[2], _v[3]);
+				_Transpose4Avx(_v[4], _v[5], _v[6], _v[7]);
+				__m256 _out = _zero;
+				for (uint j = 0, p = _first; j < _planes.count; ++j, p = p + 1 < _planes.count ? p + 1 : 0)
+				{
+					const uint* _s = _planes.support[p];
+					__m256 _d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_v[_s[0]], _p[p][0]), _mm256_mul_ps(_v[_s[1]], _p[p][1])), _mm256_mul_ps(_v[_s[2]], _p[p][2])), _p[p][3]);
+					_out = _mm256_or_ps(_out, _mm256_cmp_ps(_d, _zero, _CMP_LT_OQ));
+					if (_mm256_movemask_ps(_out) == 0xff)
+					{
+						_first = p;
+						break;
+					}
+				}
+				_bits |= (~(uint)_mm256_movemask_ps(_out) & 0xff) << k;
+			}
+			_visible[i >> 5] = _bits;
+		}
+		return i;
+	}
+#endif
+
+	//----------------------------------------------------------------------------//
+	uint CullBoxes(const Frustum& _frustum, const AlignedBox* _boxes, uint _count, uint* _visible, uint _planes)
+	{
+		_CullPlanes _cull(_frustum, _planes);
+		uint i;
+#ifdef RX_X86
+		if (s_hasAvx2)
+			i = _CullBoxesAvx2(_cull, _boxes, _count, _visible);
+		else
+#endif
+			i = _CullBoxesV4(_cull, _boxes, _count, _visible);
+
+		if (i < _count)
+		{
+			uint _bits = 0;
+			for (uint k = 0; i + k < _count; ++k)
+			{
+				bool _inside = true;
+				for (uint j = 0; j < _cull.count && _inside; ++j)
+					_inside = _cull.plane[j].Distance(_boxes[i + k].Support(_cull.plane[j].normal)) >= 0;
+				_bits |= (uint)_inside << k;
+			}
+			_visible[i >> 5] = _bits;
+		}
+
+		uint _total = 0;
+		for (uint j = 0, _words = (_count + 31) >> 5; j < _words; ++j)
+			_total += _BitCount(_visible[j]);
+		return _total;
+	}
+
+	//----------------------------------------------------------------------------//
+	// RayBoxes, RayTriangles
+	//----------------------------------------------------------------------------//
+
+	// The same operations as PreparedRay::Intersects for four boxes or triangles at a time with SSE or NEON.
+
+	//!
+	static uint _RayBoxesV4(const PreparedRay& _ray, float _maxDist, const AlignedBox* _boxes, uint _count, uint* _hits)
+	{
+		const _V4 _ox = _V4Splat(_ray.origin.x), _oy = _V4Splat(_ray.origin.y), _oz = _V4Splat(_ray.origin.z);
+		const _V4 _ix = _V4Splat(_ray.invDir.x), _iy = _V4Splat(_ray.invDir.y), _iz = _V4Splat(_ray.invDir.z);
+		const _V4 _zero = _V4Splat(0), _max = _V4Splat(_maxDist);
+		uint i = 0;
+		for (; i + 32 <= _count; i += 32)
+		{
+			uint _bits = 0;
+			for (uint k = 0; k < 32; k += 4)
+			{
+				_V4 _v[8];
+				_LoadBoxesV4(_boxes + i + k, _v);
+				_V4 _t0x = _V4Mul(_V4Sub(_v[0], _ox), _ix), _t1x = _V4Mul(_V4Sub(_v[3], _ox), _ix);
+				_V4 _t0y = _V4Mul(_V4Sub(_v[1], _oy), _iy), _t1y = _V4Mul(_V4Sub(_v[6], _oy), _iy);
+				_V4 _t0z = _V4Mul(_V4Sub(_v[2], _oz), _iz), _t1z = _V4Mul(_V4Sub(_v[7], _oz), _iz);
+				_V4 _near = _V4Max(_V4Max(_V4Min(_t0x, _t1x), _V4Min(_t0y, _t1y)), _V4Max(_V4Min(_t0z, _t1z), _zero));
+				_V4 _far = _V4Min(_V4Min(_V4Max(_t0x, _t1x), _V4Max(_t0y, _t1y)), _V4Min(_V4Max(_t0z, _t1z), _max));
+				_bits |= (~_V4Mask(_V4Greater(_near, _far)) & 0xf) << k;
+			}
+			_hits[i >> 5] = _bits;
+		}
+		return i;
+	}
+
+	//! _a, _b, _c are the coordinates of vertices in order kx, ky, kz of the ray.
+	static uint _RayTrianglesV4(const PreparedRay& _ray, const float* const* _a, const float* const* _b, const float* const* _c, uint _count, float& _maxDist, uint& _hit)
+	{
+		const _V4 _ox = _V4Splat(_ray.origin.v[_ray.kx]), _oy = _V4Splat(_ray.origin.v[_ray.ky]), _oz = _V4Splat(_ray.origin.v[_ray.kz]);
+		const _V4 _sx = _V4Splat(_ray.shear.x), _sy = _V4Splat(_ray.shear.y), _sz = _V4Splat(_ray.shear.z);
+		const _V4 _zero = _V4Splat(0);
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+		{
+			_V4 _az = _V4Sub(_V4Load(_a[2] + i), _oz), _bz = _V4Sub(_V4Load(_b[2] + i), _oz), _cz = _V4Sub(_V4Load(_c[2] + i), _oz);
+			_V4 _ax = _V4Sub(_V4Sub(_V4Load(_a[0] + i), _ox), _V4Mul(_sx, _az)), _ay = _V4Sub(_V4Sub(_V4Load(_a[1] + i), _oy), _V4Mul(_sy, _az));
+			_V4 _bx = _V4Sub(_V4Sub(_V4Load(_b[0] + i), _ox), _V4Mul(_sx, _bz)), _by = _V4Sub(_V4Sub(_V4Load(_b[1] + i), _oy), _V4Mul(_sy, _bz));
+			_V4 _cx = _V4Sub(_V4Sub(_V4Load(_c[0] + i), _ox), _V4Mul(_sx, _cz)), _cy = _V4Sub(_V4Sub(_V4Load(_c[1] + i), _oy), _V4Mul(_sy, _cz));
+			_V4 _u = _V4Sub(_V4Mul(_cx, _by), _V4Mul(_cy, _bx));
+			_V4 _v = _V4Sub(_V4Mul(_ax, _cy), _V4Mul(_ay, _cx));
+			_V4 _w = _V4Sub(_V4Mul(_bx, _ay), _V4Mul(_by, _ax));
+			_V4 _neg = _V4Or(_V4Or(_V4Less(_u, _zero), _V4Less(_v, _zero)), _V4Less(_w, _zero));
+			_V4 _pos = _V4Or(_V4Or(_V4Greater(_u, _zero), _V4Greater(_v, _zero)), _V4Greater(_w, _zero));
+			_V4 _det = _V4Add(_V4Add(_u, _v), _w);
+			_V4 _t = _V4Div(_V4Mul(_V4Add(_V4Add(_V4Mul(_u, _az), _V4Mul(_v, _bz)), _V4Mul(_w, _cz)), _sz), _det);
+			_V4 _valid = _V4And(_V4Or(_V4Less(_det, _zero), _V4Greater(_det, _zero)), _V4And(_V4Greater(_t, _zero), _V4Less(_t, _V4Splat(_maxDist))));
+			uint _mask = _V4Mask(_valid) & ~_V4Mask(_V4And(_neg, _pos));
+			if (_mask)
+			{
+				RX_ALIGN(16) float _dist[4];
+				_V4Store(_dist, _t);
+				for (; _mask; _mask &= _mask - 1)
+				{
+					uint j = RX_CTZ(_mask);
+					if (_dist[j] < _maxDist)
+					{
+						_maxDist = _dist[j];
+						_hit = i + j;
+					}
+				}
+			}
+		}
+		return i;
+	}
+
+	//----------------------------------------------------------------------------//
+	uint RayBoxes(const PreparedRay& _ray, float _maxDist, const AlignedBox* _boxes, uint _count, uint* _hits)
+	{
+		uint i = _RayBoxesV4(_ray, _maxDist, _boxes, _count, _hits);
+		if (i < _count)
+		{
+			uint _bits = 0;
+			float _dist;
+			for (uint k = 0; i + k < _count; ++k)
+				_bits |= (uint)_ray.Intersects(_boxes[i + k], _maxDist, _dist) << k;
+			_hits[i >> 5] = _bits;
+		}
+
+		uint _total = 0;
+		for (uint j = 0, _words = (_count + 31) >> 5; j < _words; ++j)
+			_total += _BitCount(_hits[j]);
+		return _total;
+	}
+	//----------------------------------------------------------------------------//
+	uint RayTriangles(const PreparedRay& _ray, float _maxDist, const Vector3Array& _v0, const Vector3Array& _v1, const Vector3Array& _v2, float& _dist)
+	{
+		ASSERT(_v0.Size() == _v1.Size() && _v0.Size() == _v2.Size());
+		const float* _x[3][3] = { { _v0.X(), _v0.Y(), _v0.Z() }, { _v1.X(), _v1.Y(), _v1.Z() }, { _v2.X(), _v2.Y(), _v2.Z() } };
+		const float* _a[3] = { _x[0][_ray.kx], _x[0][_ray.ky], _x[0][_ray.kz] };
+		const float* _b[3] = { _x[1][_ray.kx], _x[1][_ray.ky], _x[1][_ray.kz] };
+		const float* _c[3] = { _x[2][_ray.kx], _x[2][_ray.ky], _x[2][_ray.kz] };
+		uint _hit = (uint)-1;
+		uint _count = _v0.Size();
+		uint i = _RayTrianglesV4(_ray, _a, _b, _c, _count, _maxDist, _hit);
+		for (; i < _count; ++i)
+		{
+			if (_ray.Intersects(_v0[i], _v1[i], _v2[i], _maxDist, _maxDist))
+				_hit = i;
+		}
+		if (_hit != (uint)-1)
+			_dist = _maxDist;
+		return _hit;
+	}
+
+	//----------------------------------------------------------------------------//
+	// FloatToHalf, HalfToFloat
+	//----------------------------------------------------------------------------//
+
+#ifdef RX_SSE2
+	//! _mask ? _a : _b
+	static inline __m128i _SelectSse2(__m128i _mask, __m128i _a, __m128i _b) { return _mm_or_si128(_mm_and_si128(_mask, _a), _mm_andnot_si128(_mask, _b)); }
+
+	//! Four floats to half-floats (sign-extended to 32 bits), the same operations as the scalar FloatToHalf.
+	static inline __m128i _FloatToHalfSse2(__m128 _v)
+	{
+		const __m128i _abs = _mm_set1_epi32(0x7fffffff);
+		__m128i _f = _mm_castps_si128(_v);
+		__m128i _s = _mm_srli_epi32(_mm_andnot_si128(_abs, _f), 16);
+		_f = _mm_and_si128(_f, _abs);
+		__m128i _mantissa = _mm_srli_epi32(_f, 13);
+		__m128i _inf = _mm_cmpgt_epi32(_f, _mm_set1_epi32(0x477fffff));
+		__m128i _nan = _mm_cmpgt_epi32(_f, _mm_set1_epi32(0x7f800000));
+		__m128i _denorm = _mm_cmplt_epi32(_f, _mm_set1_epi32(0x38800000));
+		__m128i _i = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(_nan, _mm_or_si128(_mm_set1_epi32(0x0200), _mm_and_si128(_mantissa, _mm_set1_epi32(0x03ff)))));
+		__m128i _d = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(_f), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3f000000));
+		__m128i _n = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(_f, _mm_set1_epi32((int)0xc8000fff)), _mm_and_si128(_mantissa, _mm_set1_epi32(1))), 13);
+		__m128i _r = _mm_or_si128(_SelectSse2(_inf, _i, _SelectSse2(_denorm, _d, _n)), _s);
+		return _mm_srai_epi32(_mm_slli_epi32(_r, 16), 16); // for _mm_packs_epi32
+	}
+
+	//! Four half-floats (in 32 bits) to floats, the same operations as the scalar HalfToFloat.
+	static inline __m128 _HalfToFloatSse2(__m128i _h)
+	{
+		__m128i _f = _mm_slli_epi32(_mm_and_si128(_h, _mm_set1_epi32(0x7fff)), 13);
+		__m128i _e = _mm_and_si128(_f, _mm_set1_epi32(0x0f800000));
+		__m128i _inf = _mm_cmpeq_epi32(_e, _mm_set1_epi32(0x0f800000));
+		__m128i _denorm = _mm_cmpeq_epi32(_e, _mm_setzero_si128());
+		__m128i _quiet = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(_f, _mm_set1_epi32(0x007fffff)), _mm_setzero_si128()), _mm_set1_epi32(0x00400000));
+		_f = _mm_add_epi32(_f, _mm_set1_epi32(0x38000000));
+		__m128i _i = _mm_or_si128(_mm_add_epi32(_f, _mm_set1_epi32(0x38000000)), _quiet);
+		__m128i _d = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(_f, _mm_set1_epi32(0x00800000))), _mm_castsi128_ps(_mm_set1_epi32(0x38800000))));
+		__m128i _r = _SelectSse2(_inf, _i, _SelectSse2(_denorm, _d, _f));
+		return _mm_castsi128_ps(_mm_or_si128(_r, _mm_slli_epi32(_mm_and_si128(_h, _mm_set1_epi32(0x8000)), 16)));
+	}
+
+	//!
+	static uint _FloatToHalfSse2(const float* _src, uint16* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m128i _h = _mm_packs_epi32(_FloatToHalfSse2(_mm_loadu_ps(_src + i)), _FloatToHalfSse2(_mm_loadu_ps(_src + i + 4)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _h);
+		}
+		return i;
+	}
+
+	//!
+	static uint _HalfToFloatSse2(const uint16* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+		{
+			__m128i _h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+			_mm_storeu_ps(_dst + i, _HalfToFloatSse2(_mm_unpacklo_epi16(_h, _mm_setzero_si128())));
+			_mm_storeu_ps(_dst + i + 4, _HalfToFloatSse2(_mm_unpackhi_epi16(_h, _mm_setzero_si128())));
+		}
+		return i;
+	}
+#endif
+
+#ifdef RX_X86
+	//!
+	RX_TARGET("avx512f") static uint _FloatToHalfAvx512(const float* _src, uint16* _dst, uint _count)
+	{
+		for (uint i = 0; i < _count; i += 16)
+		{
+			__mmask16 _mask = _count - i >= 16 ? 0xffff : _TailMask(_count - i);
+			__m256i _h = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(_mask, _src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			_mm512_mask_cvtepi32_storeu_epi16(_dst + i, _mask, _mm512_cvtepu16_epi32(_h));
+		}
+		return _count;
+	}
+
+	//!
+	RX_TARGET("avx512f") static uint _HalfToFloatAvx512(const uint16* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 16 <= _count; i += 16)
+			_mm512_storeu_ps(_dst + i, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i))));
+		return i;
+	}
+
+	//!
+	RX_TARGET("avx,f16c") static uint _FloatToHalfF16c(const float* _src, uint16* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(_src + i), _MM_FROUND_TO_NEAREST_INT));
+		return i;
+	}
+
+	//!
+	RX_TARGET("avx,f16c") static uint _HalfToFloatF16c(const uint16* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 8 <= _count; i += 8)
+			_mm256_storeu_ps(_dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i))));
+		return i;
+	}
+#endif
+
+	//----------------------------------------------------------------------------//
+	void FloatToHalf(const float* _src, uint16* _dst, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _FloatToHalfAvx512(_src, _dst, _count);
+		else if (s_hasF16c)
+			i = _FloatToHalfF16c(_src, _dst, _count);
+#endif
+#ifdef RX_SSE2
+		i += _FloatToHalfSse2(_src + i, _dst + i, _count - i);
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = FloatToHalf(_src[i]);
+	}
+	//----------------------------------------------------------------------------//
+	void HalfToFloat(const uint16* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_X86
+		if (s_hasAvx512)
+			i = _HalfToFloatAvx512(_src, _dst, _count);
+		else if (s_hasF16c)
+			i = _HalfToFloatF16c(_src, _dst, _count);
+#endif
+#ifdef RX_SSE2
+		i += _HalfToFloatSse2(_src + i, _dst + i, _count - i);
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = HalfToFloat(_src[i]);
+	}
+
+	//----------------------------------------------------------------------------//
+	// FloatToFixed, FixedToFloat, FloatToByte
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	void FloatToFixed(const float* _src, uint* _dst, uint _count, uint _bits)
+	{
+		if (_bits > 31)
+			_bits = 31;
+		uint i = 0;
+#ifdef RX_SSE2
+		const __m128 _one = _mm_set1_ps(1), _zero = _mm_setzero_ps(), _scale = _mm_set1_ps((float)(1u << _bits));
+		const __m128i _max = _mm_set1_epi32((int)((1u << _bits) - 1u));
+		for (; i + 4 <= _count; i += 4)
+		{
+			__m128 _v = _mm_loadu_ps(_src + i);
+			__m128i _r = _mm_cvttps_epi32(_mm_mul_ps(_v, _scale));
+			_r = _SelectSse2(_mm_castps_si128(_mm_cmpge_ps(_v, _one)), _max, _r);
+			_r = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(_v, _zero)), _r);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _r);
+		}
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = FloatToFixed(_src[i], _bits);
+	}
+	//----------------------------------------------------------------------------//
+	void FixedToFloat(const uint* _src, float* _dst, uint _count, uint _bits, float _default)
+	{
+		if (_bits > 31)
+			_bits = 31;
+		uint i = 0;
+		if (!_bits)
+		{
+			for (; i < _count; ++i)
+				_dst[i] = _default;
+			return;
+		}
+#ifdef RX_SSE2
+		const __m128 _scale = _mm_set1_ps((float)((1u << _bits) - 1u));
+		const __m128 _hiScale = _mm_set1_ps(65536);
+		const __m128i _loMask = _mm_set1_epi32(0xffff);
+		for (; i + 4 <= _count; i += 4)
+		{
+			// unsigned to float with one rounding: both halves are exact
+			__m128i _v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+			__m128 _f = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(_v, 16)), _hiScale), _mm_cvtepi32_ps(_mm_and_si128(_v, _loMask)));
+			_mm_storeu_ps(_dst + i, _mm_div_ps(_f, _scale));
+		}
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = FixedToFloat(_src[i], _bits, _default);
+	}
+	//----------------------------------------------------------------------------//
+	void FloatToByte(const float* _src, uint8* _dst, uint _count)
+	{
+		uint i = 0;
+#ifdef RX_SSE2
+		const __m128 _zero = _mm_setzero_ps(), _one = _mm_set1_ps(1), _scale = _mm_set1_ps(0xff);
+		__m128i _r[4];
+		for (; i + 16 <= _count; i += 16)
+		{
+			for (uint j = 0; j < 4; ++j)
+				_r[j] = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(_src + i + j * 4), _zero), _one), _scale));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _mm_packus_epi16(_mm_packs_epi32(_r[0], _r[1]), _mm_packs_epi32(_r[2], _r[3])));
+		}
+#endif
+		for (; i < _count; ++i)
+			_dst[i] = FloatToByte(Clamp(_src[i], 0.0f, 1.0f));
+	}
+
+	//----------------------------------------------------------------------------//
+	// Batch functions
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	void RSqrt(const float* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+			_V4Store(_dst + i, _V4RSqrt(_V4Load(_src + i)));
+		for (; i < _count; ++i)
+			_dst[i] = RSqrt(_src[i]);
+	}
+	//----------------------------------------------------------------------------//
+	void SinCos(const float* _src, float* _sin, float* _cos, uint _count)
+	{
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+		{
+			_V4 _s, _c;
+			_V4SinCos(_V4Load(_src + i), _s, _c);
+			_V4Store(_sin + i, _s);
+			_V4Store(_cos + i, _c);
+		}
+		for (; i < _count; ++i)
+			SinCos(_src[i], _sin[i], _cos[i]);
+	}
+	//----------------------------------------------------------------------------//
+	void ATan2(const float* _y, const float* _x, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+			_V4Store(_dst + i, _V4ATan2(_V4Load(_y + i), _V4Load(_x + i)));
+		for (; i < _count; ++i)
+			_dst[i] = ATan2(_y[i], _x[i]);
+	}
+	//----------------------------------------------------------------------------//
+	void Exp2(const float* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+			_V4Store(_dst + i, _V4Exp2(_V4Load(_src + i)));
+		for (; i < _count; ++i)
+			_dst[i] = Exp2(_src[i]);
+	}
+	//----------------------------------------------------------------------------//
+	void Log2(const float* _src, float* _dst, uint _count)
+	{
+		uint i = 0;
+		for (; i + 4 <= _count; i += 4)
+			_V4Store(_dst + i, _V4Log2(_V4Load(_src + i)));
+		for (; i < _count; ++i)
+			_dst[i] = Log2(_src[i]);
+	}
+
+	//----------------------------------------------------------------------------//
+	//
+	//----------------------------------------------------------------------------//
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Math.hpp"
+#include "Container.hpp"
+
+namespace Reax
+{
+	//!\addtogroup Math
+	//!\{
+
+	//----------------------------------------------------------------------------//
+	// Vector3Array
+	//----------------------------------------------------------------------------//
+
+	//! Array of vectors as separate streams of coordinates (structure of arrays).
+	class RX_API Vector3Array
+	{
+	public:
+		//!
+		Vector3Array(void) = default;
+		//!
+		explicit Vector3Array(uint _size) { Resize(_size); }
+
+		//!
+		uint Size(void) const { return m_x.Size(); }
+		//!
+		bool IsEmpty(void) const { return m_x.IsEmpty(); }
+		//!
+		bool NonEmpty(void) const { return m_x.NonEmpty(); }
+		//!
+		Vector3Array& Resize(uint _size)
+		{
+			m_x.Resize(_size);
+			m_y.Resize(_size);
+			m_z.Resize(_size);
+			return *this;
+		}
+		//!
+		Vector3Array& Reserve(uint _size)
+		{
+			m_x.Reserve(_size);
+			m_y.Reserve(_size);
+			m_z.Reserve(_size);
+			return *this;
+		}
+		//!
+		Vector3Array& Clear(void) { return Resize(0); }
+		//!
+		Vector3Array& Push(const Vector3& _v)
+		{
+			m_x.Push(_v.x);
+			m_y.Push(_v.y);
+			m_z.Push(_v.z);
+			return *this;
+		}
+		//!
+		Vector3 operator [] (uint _index) const { return Get(_index); }
+		//!
+		Vector3 Get(uint _index) const { return Vector3(m_x[_index], m_y[_index], m_z[_index]); }
+		//!
+		void Set(uint _index, const Vector3& _v) { m_x[_index] = _v.x, m_y[_index] = _v.y, m_z[_index] = _v.z; }
+
+		//!
+		float* X(void) { return m_x.Data(); }
+		//!
+		float* Y(void) { return m_y.Data(); }
+		//!
+		float* Z(void) { return m_z.Data(); }
+		//!
+		const float* X(void) const { return m_x.Data(); }
+		//!
+		const float* Y(void) const { return m_y.Data(); }
+		//!
+		const float* Z(void) const { return m_z.Data(); }
+
+	protected:
+		Array<float> m_x;
+		Array<float> m_y;
+		Array<float> m_z;
+	};
+
+	//----------------------------------------------------------------------------//
+	// Batch operations
+	//----------------------------------------------------------------------------//
+
+	// The kernels process 16 (AVX-512), 8 (AVX2) or 1 element at a time, the instruction set is selected at runtime.
+	// The AVX2 results are identical to the operations of Vector3 and Matrix3x4, AVX-512 uses fused multiply-add and can differ in the last bit.
+	// The destination can be equal to the source.
+
+	//! _dst[i] = _m.TransformPoint(_src[i])
+	RX_API void TransformPoints(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dstX, float* _dstY, float* _dstZ, uint _count);
+	//!
+	RX_API void TransformPoints(const Matrix3x4& _m, const Vector3Array& _src, Vector3Array& _dst);
+	//! _dst[i] = _m.TransformVector(_src[i])
+	RX_API void TransformVectors(const Matrix3x4& _m, const float* _x, const float* _y, const float* _z, float* _dstX, float* _dstY, float* _dstZ, uint _count);
+	//!
+	RX_API void TransformVectors(const Matrix3x4& _m, const Vector3Array& _src, Vector3Array& _dst);
+	//! Normalize vectors in place. \see Vector3::Normalize
+	RX_API void NormalizeVectors(float* _x, float* _y, float* _z, uint _count);
+	//!
+	RX_API void NormalizeVectors(Vector3Array& _v);
+	//! _dst[i] = _a[i].Dot(_b[i])
+	RX_API void DotProducts(const float* _ax, const float* _ay, const float* _az, const float* _bx, const float* _by, const float* _bz, float* _dst, uint _count);
+	//! _dst must have space for _a.Size() values.
+	RX_API void DotProducts(const Vector3Array& _a, const Vector3Array& _b, float* _dst);
+	//! Side of the plane for each box: 1 in front of the plane, -1 behind the plane, 0 intersects the plane. \see Plane::Distance
+	RX_API void ClassifyBoxes(const Plane& _plane, const Vector3Array& _min, const Vector3Array& _max, int8* _dst);
+	//! Frustum culling of boxes with AVX2, SSE or NEON. Bit i % 32 of _visible[i / 32] is set if box i intersects the frustum, _visible must have (_count + 31) / 32 words.
+	//! Only the planes of _planes mask are tested (\see Frustum). Returns the number of visible boxes. The boxes can be culled in parallel by ranges of multiples of 32 boxes.
+	RX_API uint CullBoxes(const Frustum& _frustum, const AlignedBox* _boxes, uint _count, uint* _visible, uint _planes = FRUSTUM_ALL_PLANES);
+	//! Slab test of the ray with boxes with SSE or NEON. Bit i % 32 of _hits[i / 32] is set if the ray intersects box i in [0, _maxDist],
+	//! _hits must have (_count + 31) / 32 words. Returns the number of intersected boxes. \see PreparedRay::Intersects
+	RX_API uint RayBoxes(const PreparedRay& _ray, float _maxDist, const AlignedBox* _boxes, uint _count, uint* _hits);
+	//! Watertight test of the ray with triangles (_v0[i], _v1[i], _v2[i]) with SSE or NEON. Returns the index of the nearest triangle intersected
+	//! in (0, _maxDist) and its distance in _dist, or (uint)-1 if the ray does not intersect the triangles. \see PreparedRay::Intersects
+	RX_API uint RayTriangles(const PreparedRay& _ray, float _maxDist, const Vector3Array& _v0, const Vector3Array& _v1, const Vector3Array& _v2, float& _dist);
+	//! Convert floats to half-floats with AVX-512, F16C or SSE2. \see FloatToHalf
+	RX_API void FloatToHalf(const float* _src, uint16* _dst, uint _count);
+	//! Convert half-floats to floats with AVX-512, F16C or SSE2. \see HalfToFloat
+	RX_API void HalfToFloat(const uint16* _src, float* _dst, uint _count);
+	//! Convert floats to fixed-point values with SSE2. \see FloatToFixed
+	RX_API void FloatToFixed(const float* _src, uint* _dst, uint _count, uint _bits);
+	//! Convert fixed-point values to floats with SSE2. \see FixedToFloat
+	RX_API void FixedToFloat(const uint* _src, float* _dst, uint _count, uint _bits, float _default = 0.0f);
+	//! Convert floats to bytes with SSE2. Unlike the scalar FloatToByte, values are clamped to [0, 1]. \see FloatToByte
+	RX_API void FloatToByte(const float* _src, uint8* _dst, uint _count);
+
+	//----------------------------------------------------------------------------//
+	// Batch functions
+	//----------------------------------------------------------------------------//
+
+	// Four values at a time with SSE or NEON. The results are identical to the scalar functions. The destination can be equal to the source.
+
+	//! _dst[i] = RSqrt(_src[i])
+	RX_API void RSqrt(const float* _src, float* _dst, uint _count);
+	//! SinCos(_src[i], _sin[i], _cos[i])
+	RX_API void SinCos(const float* _src, float* _sin, float* _cos, uint _count);
+	//! _dst[i] = ATan2(_y[i], _x[i])
+	RX_API void ATan2(const float* _y, const float* _x, float* _dst, uint _count);
+	//! _dst[i] = Exp2(_src[i])
+	RX_API void Exp2(const float* _src, float* _dst, uint _count);
+	//! _dst[i] = Log2(_src[i])
+	RX_API void Log2(const float* _src, float* _dst, uint _count);
+
+	//----------------------------------------------------------------------------//
+	//
+	//----------------------------------------------------------------------------//
+
+	//!\} Math
+}
@@ -0,0 +1,200 @@
+#include "Object.hpp"
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// TypeInfo
+	//----------------------------------------------------------------------------//
+
+	TypeInfo* TypeInfo::s_first = nullptr;
+
+	//----------------------------------------------------------------------------//
+	TypeInfo::TypeInfo(const char* _name, uint _size, TypeInfo* _base, Factory _factory, Register _register) :
+		m_next(s_first),
+		m_typeName(_name),
+		m_base(_base),
+		m_factory(_factory),
+		m_register(_register),
+		m_size(_size)
+	{
+		// don't touch other static objects here, they can be uninitialized yet
+		s_first = this;
+	}
+	//----------------------------------------------------------------------------//
+	Attribute& TypeInfo::_Add(const char* _name, Attribute::Type _type, uint _flags)
+	{
+		StringId _id(_name);
+		Attribute* _attr = nullptr;
+
+		for (Attribute& i : m_attributes)
+		{
+			if (i.name == _id)
+			{
+				// override an attribute of base type
+				_attr = &i;
+				*_attr = Attribute();
+				break;
+			}
+		}
+
+		if (!_attr)
+		{
+			ASSERT(m_attributes.Size() < NONE, "Too many attributes");
+			m_attributes.Resize(m_attributes.Size() + 1);
+			_attr = &m_attributes.Back();
+		}
+
+		_attr->name = _id;
+		_attr->type = _type;
+		_attr->flags = _flags;
+		_attr->owner = this;
+
+		return *_attr;
+	}
+	//----------------------------------------------------------------------------//
+	void TypeInfo::_BuildTable(void)
+	{
+		uint _size = FirstPow2(m_attributes.Size() * 2 + 1);
+		m_mask = _size - 1;
+		m_table.Clear();
+		m_table.Resize(_size, (uint16)NONE);
+
+		for (uint i = 0; i < m_attributes.Size(); ++i)
+		{
+			uint _slot = m_attributes[i].name.Hash() & m_mask;
+			while (m_table[_slot] != NONE)
+				_slot = (_slot + 1) & m_mask;
+			m_table[_slot] = (uint16)i;
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	// Object
+	//----------------------------------------------------------------------------//
+
+	TypeInfo Object::s_typeInfo("Object", sizeof(Object), nullptr, nullptr, &Object::_RegisterType);
+
+	//----------------------------------------------------------------------------//
+	void Object::_RegisterType(TypeInfo&)
+	{
+	}
+
+	//----------------------------------------------------------------------------//
+	// ReflectionSystem
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	ReflectionSystem::ReflectionSystem(void)
+	{
+		for (TypeInfo* i = TypeInfo::s_first; i; i = i->m_next)
+			_Register(i);
+
+		_Enumerate();
+	}
+	//----------------------------------------------------------------------------//
+	ReflectionSystem::~ReflectionSystem(void)
+	{
+		for (TypeInfo* i : m_types)
+		{
+			i->m_attributes.Clear();
+			i->m_table.Clear();
+			i->m_mask = 0;
+			i->m_id = 0;
+			i->m_numDerived = 0;
+			i->m_registered = false;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	const TypeInfo* ReflectionSystem::GetType(const StringId& _name) const
+	{
+		auto _it = m_names.Find(_name);
+		return _it != m_names.End() ? _it->second : nullptr;
+	}
+	//----------------------------------------------------------------------------//
+	ObjectPtr ReflectionSystem::Create(const StringId& _type) const
+	{
+		const TypeInfo* _info = GetType(_type);
+		return _info ? _info->Create() : nullptr;
+	}
+	//----------------------------------------------------------------------------//
+	void ReflectionSystem::_Register(TypeInfo* _type)
+	{
+		if (_type->m_registered)
+			return;
+
+		if (_type->m_base)
+		{
+			_Register(_type->m_base);
+			_type->m_attributes = _type->m_base->m_attributes;
+		}
+
+		_type->m_name = _type->m_typeName;
+		ASSERT(m_names.Find(_type->m_name) == m_names.End(), "Type '%s' is already registered", _type->m_typeName);
+
+		_type->m_id = m_types.Size();
+		_type->m_registered = true;
+		_type->m_register(*_type);
+		_type->_BuildTable();
+
+		m_types.Push(_type);
+		m_names[_type->m_name] = _type;
+	}
+	//----------------------------------------------------------------------------//
+	void ReflectionSystem::_Enumerate(void)
+	{
+		// m_types is in order of registration where base goes before derived.
+		// Lists of children are built in reverse order, so the stack pops them in order of registration.
+		const uint _none = ~0u;
+		uint _count = m_types.Size();
+		Array<uint> _firstChild(_count, _none);
+		Array<uint> _nextSibling(_count, _none);
+		for (uint i = 0; i < _count; ++i)
+		{
+			TypeInfo* _base = m_types[i]->m_base;
+			if (_base)
+			{
+				_nextSibling[i] = _firstChild[_base->m_id];
+				_firstChild[_base->m_id] = i;
+			}
+		}
+
+		// depth-first traversal of all roots
+		Array<TypeInfo*> _types;
+		Array<uint> _stack;
+		_types.Reserve(_count);
+		for (uint r = 0; r < _count; ++r)
+		{
+			if (m_types[r]->m_base)
+				continue;
+
+			_stack.Push(r);
+			while (_stack.NonEmpty())
+			{
+				uint _index = _stack.Back();
+				_stack.Pop();
+				_types.Push(m_types[_index]);
+
+				for (uint c = _firstChild[_index]; c != _none; c = _nextSibling[c])
+					_stack.Push(c);
+			}
+		}
+		ASSERT(_types.Size() == _count);
+
+		for (uint i = 0; i < _count; ++i)
+			_types[i]->m_id = i;
+
+		// the subtree of a type ends where the next type which is not derived from it starts
+		for (uint i = _count; i-- > 0;)
+		{
+			TypeInfo* _type = _types[i];
+			_type->m_numDerived = 0;
+			for (uint c = i + 1; c < _count && _types[c]->m_base == _type;)
+			{
+				_type->m_numDerived += _types[c]->m_numDerived + 1;
+				c += _types[c]->m_numDerived + 1;
+			}
+		}
+
+		m_types = Move(_types);
+	}
+}
@@ -2,41 +2,388 @@
 
 #include "RefCounting.hpp"
 #include "Container.hpp"
+#include "String.hpp"
+#include "Math.hpp"
+#include <type_traits>
+#include <utility>
 
 namespace Reax
 {
+	//!\addtogroup Base
+	//!\{
+
 	typedef SharedPtr<class Object> ObjectPtr;
+	struct TypeInfo;
+
+	//----------------------------------------------------------------------------//
+	// Attribute
+	//----------------------------------------------------------------------------//
 
+	//! Reflected property of an object. It is either a data member with known offset or a pair of accessors.
 	struct Attribute
 	{
 		enum Flags
 		{
-
+			F_Default = 0,
+			//! The attribute has no setter.
+			F_ReadOnly = 0x1,
+			//! Skip the attribute in serialization.
+			F_NoSerialize = 0x2,
+			//! Don't show the attribute in the editor.
+			F_Hidden = 0x4,
 		};
 
-		enum class Type
+		enum class Type : uint8
 		{
 			Null,
+			Bool,
+			Int,
+			UInt,
+			Float,
+			IntVector2,
+			IntVector3,
+			IntVector4,
+			Vector2,
+			Vector3,
+			Vector4,
+			Quaternion,
+			Matrix4x4,
+			String,
+			StringId,
+			Object,
 		};
+
+		//! Copy the value of the attribute from _object to _value.
+		typedef void(*Getter)(const Attribute& _attr, const Object* _object, void* _value);
+		//! Copy the value of the attribute from _value to _object.
+		typedef void(*Setter)(const Attribute& _attr, Object* _object, const void* _value);
+
+		//! Offset of a data member from the beginning of the owner class. NO_OFFSET for accessors.
+		static const uint NO_OFFSET = ~0u;
+
+		//!
+		bool IsMember(void) const { return offset != NO_OFFSET; }
+		//!
+		bool IsReadOnly(void) const { return (flags & F_ReadOnly) != 0; }
+
+		//! Get the value. Returns false if type of the attribute differs from T.
+		template <class T> bool Get(const Object* _object, T& _value) const;
+		//! Set the value. Returns false if type of the attribute differs from T or the attribute is read-only.
+		template <class T> bool Set(Object* _object, const T& _value) const;
+
+		//!
+		StringId name;
+		//!
+		Type type = Type::Null;
+		//! Combination of Flags.
+		uint flags = F_Default;
+		//!
+		uint offset = NO_OFFSET;
+		//! Type which declares the attribute.
+		const TypeInfo* owner = nullptr;
+		//!
+		Getter getter = nullptr;
+		//! Null for read-only attributes.
+		Setter setter = nullptr;
 	};
 
-	struct TypeInfo
+	//! Attribute::Type of T. Null for unsupported types.
+	template <class T> struct AttributeType { static const Attribute::Type Value = Attribute::Type::Null; };
+
+#define RX_ATTRIBUTE_TYPE(T, E) template <> struct AttributeType<T> { static const Attribute::Type Value = Attribute::Type::E; }
+	RX_ATTRIBUTE_TYPE(bool, Bool);
+	RX_ATTRIBUTE_TYPE(int, Int);
+	RX_ATTRIBUTE_TYPE(uint, UInt);
+	RX_ATTRIBUTE_TYPE(float, Float);
+	RX_ATTRIBUTE_TYPE(IntVector2, IntVector2);
+	RX_ATTRIBUTE_TYPE(IntVector3, IntVector3);
+	RX_ATTRIBUTE_TYPE(IntVector4, IntVector4);
+	RX_ATTRIBUTE_TYPE(Vector2, Vector2);
+	RX_ATTRIBUTE_TYPE(Vector3, Vector3);
+	RX_ATTRIBUTE_TYPE(Vector4, Vector4);
+	RX_ATTRIBUTE_TYPE(Quaternion, Quaternion);
+	RX_ATTRIBUTE_TYPE(Matrix4x4, Matrix4x4);
+	RX_ATTRIBUTE_TYPE(String, String);
+	RX_ATTRIBUTE_TYPE(StringId, StringId);
+	RX_ATTRIBUTE_TYPE(ObjectPtr, Object);
+#undef RX_ATTRIBUTE_TYPE
+
+	//----------------------------------------------------------------------------//
+	// TypeInfo
+	//----------------------------------------------------------------------------//
+
+	//! Description of a class derived from Object. Instances are static and created by RX_OBJECT/RX_TYPE,
+	//! the attributes are filled in by ReflectionSystem.
+	struct RX_API TypeInfo : public NonCopyable
 	{
+		//! Create a new instance of the type. Null for abstract types.
+		typedef Object*(*Factory)(void);
+		//! Add attributes of the type. \see RX_TYPE
+		typedef void(*Register)(TypeInfo& _type);
+
+		//!
+		static const uint16 NONE = 0xffff;
+
+		//!
+		TypeInfo(const char* _name, uint _size, TypeInfo* _base, Factory _factory, Register _register);
+
+		//! Find an attribute by name including attributes of base types. Returns nullptr if not found or if ReflectionSystem doesn't exist.
+		//! The table is open-addressing on the precomputed hash of StringId with load factor at most 1/2,
+		//! so a lookup is usually one probe and one pointer compare.
+		const Attribute* FindAttribute(const StringId& _name) const
+		{
+			if (m_table.IsEmpty())
+				return nullptr;
+			for (uint i = _name.Hash() & m_mask;; i = (i + 1) & m_mask)
+			{
+				uint _index = m_table[i];
+				if (_index == NONE)
+					return nullptr;
+				if (m_attributes[_index].name == _name)
+					return m_attributes.Data() + _index;
+			}
+		}
+		//! All attributes. Attributes of base types come first.
+		const Array<Attribute>& Attributes(void) const { return m_attributes; }
+
+		//!
+		Object* Create(void) const { return m_factory ? m_factory() : nullptr; }
+		//!
+		bool IsAbstract(void) const { return m_factory == nullptr; }
+		//!
+		const StringId& Name(void) const { return m_name; }
+		//! Index of the type in ReflectionSystem. Types are numbered in depth-first order of the hierarchy,
+		//! so ids of all types derived from this one are in range [Id() + 1, Id() + NumDerived()].
+		uint Id(void) const { return m_id; }
+		//! Number of all types derived from this type directly or indirectly.
+		uint NumDerived(void) const { return m_numDerived; }
+		//! Check if this type is _base or derived from it. Constant time if both types are registered in ReflectionSystem,
+		//! otherwise walks the chain of base types.
+		bool IsA(const TypeInfo* _base) const
+		{
+			if (m_registered && _base->m_registered)
+				return m_id - _base->m_id <= _base->m_numDerived; // unsigned, false if m_id < _base->m_id
+			for (const TypeInfo* i = this; i; i = i->m_base)
+			{
+				if (i == _base)
+					return true;
+			}
+			return false;
+		}
+		//!
+		template <class T> bool IsA(void) const { return IsA(T::StaticTypeInfo()); }
+		//! sizeof of the type.
+		uint Size(void) const { return m_size; }
+		//!
+		const TypeInfo* Base(void) const { return m_base; }
+
+		//! Add a data member. Use RX_ATTRIBUTE.
+		template <class C, class T> Attribute& AddMember(const char* _name, T C::*_member, uint _flags = Attribute::F_Default)
+		{
+			static_assert(AttributeType<T>::Value != Attribute::Type::Null, "Unsupported type of attribute");
+			Attribute& _attr = _Add(_name, AttributeType<T>::Value, _flags);
+			_attr.offset = (uint)(reinterpret_cast<size_t>(&(reinterpret_cast<const C*>(16)->*_member)) - 16);
+			_attr.getter = &_GetMember<C, T>;
+			_attr.setter = (_flags & Attribute::F_ReadOnly) ? nullptr : &_SetMember<C, T>;
+			return _attr;
+		}
+		//! Add a property with accessors. Use RX_ACCESSOR or RX_READONLY_ACCESSOR.
+		template <class T> Attribute& AddAccessor(const char* _name, Attribute::Getter _getter, Attribute::Setter _setter, uint _flags = Attribute::F_Default)
+		{
+			static_assert(AttributeType<T>::Value != Attribute::Type::Null, "Unsupported type of attribute");
+			Attribute& _attr = _Add(_name, AttributeType<T>::Value, _setter ? _flags : (_flags | Attribute::F_ReadOnly));
+			_attr.getter = _getter;
+			_attr.setter = _setter;
+			return _attr;
+		}
+
+	protected:
+		friend class ReflectionSystem;
+
+		//!
+		template <class C, class T> static void _GetMember(const Attribute& _attr, const Object* _object, void* _value)
+		{
+			*reinterpret_cast<T*>(_value) = *reinterpret_cast<const T*>(reinterpret_cast<const uint8*>(static_cast<const C*>(_object)) + _attr.offset);
+		}
+		//!
+		template <class C, class T> static void _SetMember(const Attribute& _attr, Object* _object, const void* _value)
+		{
+			*reinterpret_cast<T*>(reinterpret_cast<uint8*>(static_cast<C*>(_object)) + _attr.offset) = *reinterpret_cast<const T*>(_value);
+		}
+
+		//! Add or override an attribute.
+		Attribute& _Add(const char* _name, Attribute::Type _type, uint _flags);
+		//! Rebuild the lookup table.
+		void _BuildTable(void);
+
+		//! Registered types. The list is filled in by constructors of static instances, before main.
+		static TypeInfo* s_first;
+
+		TypeInfo* m_next;
+		const char* m_typeName;
+		TypeInfo* m_base;
+		Factory m_factory;
+		Register m_register;
+		StringId m_name;
+		uint m_id = 0;
+		uint m_numDerived = 0;
+		uint m_size;
+		bool m_registered = false;
 
-		HashMap<uint, Attribute> attributes;
+		Array<Attribute> m_attributes;
+		Array<uint16> m_table;
+		uint m_mask = 0;
 	};
 
+	//! Factory of TypeInfo. Null for abstract or not default-constructible types.
+	template <class T, bool Creatable = !std::is_abstract<T>::value && std::is_default_constructible<T>::value> struct ObjectFactory
+	{
+		static Object* Create(void) { return new T; }
+		static constexpr TypeInfo::Factory Get(void) { return &Create; }
+	};
+	template <class T> struct ObjectFactory<T, false>
+	{
+		static constexpr TypeInfo::Factory Get(void) { return nullptr; }
+	};
+
+	//----------------------------------------------------------------------------//
+	// Object
+	//----------------------------------------------------------------------------//
+
+	//! Declare reflection of a class derived from Object. Must be placed in the class declaration.
+#define RX_OBJECT(_class, _base) \
+	public: \
+		typedef _class Self; \
+		typedef _base Base; \
+		static Reax::TypeInfo s_typeInfo; \
+		static const Reax::TypeInfo* StaticTypeInfo(void) { return &s_typeInfo; } \
+		const Reax::TypeInfo* GetTypeInfo(void) const override { return &s_typeInfo; } \
+	private: \
+		static void _RegisterType(Reax::TypeInfo& _type)
+
+	//! Define reflection of a class declared with RX_OBJECT. Must be followed by the body of the function which adds attributes:
+	//! RX_TYPE(MyClass)
+	//! {
+	//!		RX_ATTRIBUTE("Position", m_position);
+	//!		RX_ACCESSOR("Name", GetName, SetName);
+	//! }
+#define RX_TYPE(_class) \
+	Reax::TypeInfo _class::s_typeInfo(#_class, sizeof(_class), &_class::Base::s_typeInfo, Reax::ObjectFactory<_class>::Get(), &_class::_RegisterType); \
+	void _class::_RegisterType(Reax::TypeInfo& _type)
+
+	//! Add a data member to the type. Used inside of RX_TYPE. The optional argument is a combination of Attribute::Flags.
+#define RX_ATTRIBUTE(_name, _member, ...) _type.AddMember(_name, &Self::_member, ##__VA_ARGS__)
+
+	//! Add a property with accessors to the type. Used inside of RX_TYPE. The getter returns the value, the setter takes it by value or const reference.
+#define RX_ACCESSOR(_name, _getter, _setter, ...) _type.AddAccessor<typename std::decay<decltype(std::declval<const Self&>()._getter())>::type>(_name, \
+	[](const Reax::Attribute&, const Reax::Object* _object, void* _value) { typedef typename std::decay<decltype(std::declval<const Self&>()._getter())>::type T; *reinterpret_cast<T*>(_value) = static_cast<const Self*>(_object)->_getter(); }, \
+	[](const Reax::Attribute&, Reax::Object* _object, const void* _value) { typedef typename std::decay<decltype(std::declval<const Self&>()._getter())>::type T; static_cast<Self*>(_object)->_setter(*reinterpret_cast<const T*>(_value)); }, ##__VA_ARGS__)
+
+	//! Add a read-only property to the type. Used inside of RX_TYPE.
+#define RX_READONLY_ACCESSOR(_name, _getter, ...) _type.AddAccessor<typename std::decay<decltype(std::declval<const Self&>()._getter())>::type>(_name, \
+	[](const Reax::Attribute&, const Reax::Object* _object, void* _value) { typedef typename std::decay<decltype(std::declval<const Self&>()._getter())>::type T; *reinterpret_cast<T*>(_value) = static_cast<const Self*>(_object)->_getter(); }, \
+	nullptr, ##__VA_ARGS__)
+
+	//! Base class of reflected objects.
+	//!\note Object::Cast and SharedPtr::Cast are checked casts, use StaticCast for objects which known to be of the type.
 	class RX_API Object : public RefCounted
 	{
 	public:
+		typedef Object Self;
+
+		//!
+		Object(void) = default;
+		//!
+		virtual ~Object(void) = default;
+
+		//!
+		static TypeInfo s_typeInfo;
+		//!
+		static const TypeInfo* StaticTypeInfo(void) { return &s_typeInfo; }
+		//!
+		virtual const TypeInfo* GetTypeInfo(void) const { return &s_typeInfo; }
+		//!
+		const StringId& GetTypeName(void) const { return GetTypeInfo()->Name(); }
+
+		//! Find an attribute by name. Returns nullptr if not found.
+		const Attribute* FindAttribute(const StringId& _name) const { return GetTypeInfo()->FindAttribute(_name); }
+
+		//! Check if the object is instance of _type or of type derived from _type. Constant time.
+		bool IsA(const TypeInfo* _type) const { return GetTypeInfo()->IsA(_type); }
+		//!
+		template <class T> bool IsA(void) const { return GetTypeInfo()->IsA(T::StaticTypeInfo()); }
+		//! Checked cast. Returns nullptr if the object is not T.
+		template <class T> T* Cast(void) { return IsA<T>() ? static_cast<T*>(this) : nullptr; }
+		//!
+		template <class T> const T* Cast(void) const { return IsA<T>() ? static_cast<const T*>(this) : nullptr; }
 
 	protected:
+		//!
+		void _DeleteThis(void) override
+		{
+			_ResetRef();
+			delete this;
+		}
+
+	private:
+		static void _RegisterType(TypeInfo& _type);
 	};
 
+	//----------------------------------------------------------------------------//
+	// Attribute
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	template <class T> bool Attribute::Get(const Object* _object, T& _value) const
+	{
+		if (type != AttributeType<T>::Value)
+			return false;
+		getter(*this, _object, &_value);
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	template <class T> bool Attribute::Set(Object* _object, const T& _value) const
+	{
+		if (type != AttributeType<T>::Value || !setter)
+			return false;
+		setter(*this, _object, &_value);
+		return true;
+	}
+
+	//----------------------------------------------------------------------------//
+	// ReflectionSystem
+	//----------------------------------------------------------------------------//
+
 #define gReflection ReflectionSystem::Instance
 
-	class RX_API ReflectionSystem : public Singleton<ReflectionSystem>
+	//! Registry of types. The constructor registers attributes of all types declared with RX_TYPE.
+	class RX_API ReflectionSystem : public Singleton<ReflectionSystem>, public NonCopyable
 	{
+	public:
+		//!
+		ReflectionSystem(void);
+		//!
+		~ReflectionSystem(void);
+
+		//! Find a type by name. Returns nullptr if not found.
+		const TypeInfo* GetType(const StringId& _name) const;
+		//! Get a type by TypeInfo::Id.
+		const TypeInfo* GetType(uint _id) const { return _id < m_types.Size() ? m_types[_id] : nullptr; }
+		//! All types in order of TypeInfo::Id. The base type always goes before the derived types.
+		const Array<TypeInfo*>& GetTypes(void) const { return m_types; }
+
+		//! Create an object by type name. Returns null if the type is not found or is abstract.
+		ObjectPtr Create(const StringId& _type) const;
 
+	protected:
+		//! Register the type and its base types.
+		void _Register(TypeInfo* _type);
+		//! Number types in depth-first order.
+		void _Enumerate(void);
+
+		Array<TypeInfo*> m_types;
+		HashMap<StringId, TypeInfo*> m_names;
 	};
+
+	//!\} Base
 }
@@ -166,17 +166,18 @@ namespace Reax
 		//!
 		SharedPtr& operator = (const T* _ptr)
 		{
-			if (_ptr)
-				_ptr->AddRef();
+			T* _newPtr = const_cast<T*>(_ptr);
+			if (_newPtr)
+				_newPtr->AddRef();
 			if (m_ptr)
 				m_ptr->Release();
-			m_ptr = const_cast<T*>(_ptr);
+			m_ptr = _newPtr;
 			return *this;
 		}
 		//!
 		SharedPtr& operator = (const SharedPtr& _ptr)
 		{
-			return *this = _p.m_ptr;
+			return *this = _ptr.m_ptr;
 		}
 		//!
 		SharedPtr& operator = (SharedPtr&& _ptr)
@@ -190,14 +191,24 @@ namespace Reax
 		//!
 		T* operator -> (void) const { return const_cast<T*>(m_ptr); }
 		//!
-		T& operator * (void) const { return *const_cast<T*>(p); }
+		T& operator * (void) const { return *const_cast<T*>(m_ptr); }
 
 		//!
 		T* Get(void) const { return const_cast<T*>(m_ptr); }
+		//! Checked cast if T has IsA<X> (see Object), otherwise same as StaticCast. Returns nullptr if the pointer is not X.
+		template <class X> X* Cast(void) const { return _Cast<X>(const_cast<T*>(m_ptr), 0); }
 		//!
-		template <class X> X* Cast(void) const { return static_cast<X*>(const_cast<T*>(m_ptr)); }
+		template <class X> X* StaticCast(void) const { return static_cast<X*>(const_cast<T*>(m_ptr)); }
 
 	protected:
+		//!
+		template <class X, class Y> static auto _Cast(Y* _ptr, int) -> decltype(_ptr->template IsA<X>(), (X*)nullptr)
+		{
+			return _ptr && _ptr->template IsA<X>() ? static_cast<X*>(_ptr) : nullptr;
+		}
+		//!
+		template <class X, class Y> static X* _Cast(Y* _ptr, long) { return static_cast<X*>(_ptr); }
+
 		T* m_ptr = nullptr;
 	};
 
@@ -0,0 +1,363 @@
+#include "Serializer.hpp"
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// BlobWriter
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	uint BlobWriter::Allocate(uint _size, uint _align)
+	{
+		ASSERT(IsPow2(_align));
+		uint _offset = (m_data.Size() + _align - 1) & ~(_align - 1);
+		m_data.Resize(_offset + _size, 0);
+		return _offset;
+	}
+	//----------------------------------------------------------------------------//
+	void BlobWriter::Link(uint _at, uint _target)
+	{
+		Ptr<BlobPtr<uint8>>(_at)->m_offset = (int32)(_target - _at);
+	}
+	//----------------------------------------------------------------------------//
+	uint BlobWriter::AllocateArray(uint _at, uint _count, uint _elementSize, uint _align)
+	{
+		if (!_count)
+			return 0;
+
+		uint _offset = Allocate(_count * _elementSize, _align);
+		Link(_at + offsetof(BlobArray<uint8>, m_data), _offset);
+		Ptr<BlobArray<uint8>>(_at)->m_size = _count;
+		return _offset;
+	}
+	//----------------------------------------------------------------------------//
+	void BlobWriter::SetString(uint _at, const char* _str, uint _length)
+	{
+		if (!_length)
+			return;
+
+		uint _offset = Allocate(_length + 1, 1);
+		memcpy(m_data.Data() + _offset, _str, _length);
+		Link(_at + offsetof(BlobString, m_data), _offset);
+		Ptr<BlobString>(_at)->m_length = _length;
+	}
+
+	//----------------------------------------------------------------------------//
+	// BlobView
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	BlobView::BlobView(const void* _data, uint _size)
+	{
+		const BlobHeader* _header = reinterpret_cast<const BlobHeader*>(_data);
+		if (!_data || ((size_t)_data & 3) || _size < sizeof(BlobHeader))
+			return;
+		if (_header->magic != BlobHeader::MAGIC || _header->format != BlobHeader::FORMAT || _header->size > _size)
+			return;
+
+		// the values are trusted, only the top-level tables are checked
+		const uint8* _end = reinterpret_cast<const uint8*>(_data) + _header->size;
+		if (reinterpret_cast<const uint8*>(_header->types.Data() + _header->types.Size()) > _end ||
+			reinterpret_cast<const uint8*>(_header->objects.Data() + _header->objects.Size()) > _end ||
+			_header->numRoots > _header->objects.Size())
+			return;
+
+		m_header = _header;
+	}
+	//----------------------------------------------------------------------------//
+	const BlobHeader::Attribute* BlobView::FindAttribute(uint _object, const StringView& _name) const
+	{
+		for (const BlobHeader::Attribute& i : ObjectType(_object).attributes)
+		{
+			if (i.name.View() == _name)
+				return &i;
+		}
+		return nullptr;
+	}
+
+	//----------------------------------------------------------------------------//
+	// BinarySerializer
+	//----------------------------------------------------------------------------//
+
+	//! Size of value of attribute in blob.
+	static uint _BlobValueSize(Attribute::Type _type)
+	{
+		switch (_type)
+		{
+		case Attribute::Type::Bool:
+			return sizeof(bool);
+		case Attribute::Type::Int:
+		case Attribute::Type::UInt:
+		case Attribute::Type::Float:
+			return 4;
+		case Attribute::Type::IntVector2:
+		case Attribute::Type::Vector2:
+			return 8;
+		case Attribute::Type::IntVector3:
+		case Attribute::Type::Vector3:
+			return 12;
+		case Attribute::Type::IntVector4:
+		case Attribute::Type::Vector4:
+		case Attribute::Type::Quaternion:
+			return 16;
+		case Attribute::Type::Matrix4x4:
+			return sizeof(Matrix4x4);
+		case Attribute::Type::String:
+		case Attribute::Type::StringId:
+			return sizeof(BlobString);
+		case Attribute::Type::Object:
+			return sizeof(BlobRef);
+		default:
+			return 0;
+		}
+	}
+
+	//! Layout of objects of one type in blob.
+	struct _BlobLayout
+	{
+		const TypeInfo* type;
+		Array<Pair<const Attribute*, uint>> attributes;
+		uint size;
+	};
+
+	//----------------------------------------------------------------------------//
+	void BinarySerializer::Save(Array<uint8>& _dst, const Object* const* _objects, uint _count, uint _version)
+	{
+		Array<const Object*> _list;
+		HashMap<const Object*, uint> _indices;
+		Array<_BlobLayout> _layouts;
+		HashMap<const TypeInfo*, uint> _layoutIndices;
+		Array<uint> _objectLayouts;
+
+		// collect the objects and layouts of their types
+		for (uint i = 0; i < _count; ++i)
+		{
+			if (_objects[i] && _indices.Find(_objects[i]) == _indices.End())
+			{
+				_indices[_objects[i]] = _list.Size();
+				_list.Push(_objects[i]);
+			}
+		}
+		uint _numRoots = _list.Size();
+
+		for (uint i = 0; i < _list.Size(); ++i)
+		{
+			const Object* _object = _list[i];
+			const TypeInfo* _type = _object->GetTypeInfo();
+
+			auto _layoutIter = _layoutIndices.Find(_type);
+			uint _layoutIndex;
+			if (_layoutIter == _layoutIndices.End())
+			{
+				_layoutIndex = _layouts.Size();
+				_layoutIndices[_type] = _layoutIndex;
+				_layouts.Resize(_layoutIndex + 1);
+
+				// bools go last, so all other values are aligned to 4
+				_BlobLayout& _layout = _layouts.Back();
+				_layout.type = _type;
+				_layout.size = 0;
+				for (uint _pass = 0; _pass < 2; ++_pass)
+				{
+					for (const Attribute& a : _type->Attributes())
+					{
+						if ((a.flags & Attribute::F_NoSerialize) || (a.type == Attribute::Type::Bool) != (_pass == 1))
+							continue;
+						_layout.attributes.Push({ &a, _layout.size });
+						_layout.size += _BlobValueSize(a.type);
+					}
+				}
+			}
+			else
+				_layoutIndex = _layoutIter->second;
+			_objectLayouts.Push(_layoutIndex);
+
+			for (const Pair<const Attribute*, uint>& a : _layouts[_layoutIndex].attributes)
+			{
+				if (a.first->type == Attribute::Type::Object)
+				{
+					ObjectPtr _ref;
+					a.first->getter(*a.first, _object, &_ref);
+					if (_ref && _indices.Find(_ref) == _indices.End())
+					{
+						_indices[_ref] = _list.Size();
+						_list.Push(_ref);
+					}
+				}
+			}
+		}
+
+		// header
+		BlobWriter _writer;
+		_writer.Allocate(sizeof(BlobHeader));
+
+		// types
+		uint _types = _writer.AllocateArray(offsetof(BlobHeader, types), _layouts.Size(), sizeof(BlobHeader::Type));
+		for (uint i = 0; i < _layouts.Size(); ++i)
+		{
+			const _BlobLayout& _layout = _layouts[i];
+			uint _type = _types + i * sizeof(BlobHeader::Type);
+
+			_writer.SetString(_type + offsetof(BlobHeader::Type, name), _layout.type->Name().CStr(), _layout.type->Name().Length());
+			_writer.Ptr<BlobHeader::Type>(_type)->size = _layout.size;
+
+			uint _attributes = _writer.AllocateArray(_type + offsetof(BlobHeader::Type, attributes), _layout.attributes.Size(), sizeof(BlobHeader::Attribute));
+			for (uint j = 0; j < _layout.attributes.Size(); ++j)
+			{
+				const Attribute* _src = _layout.attributes[j].first;
+				uint _attr = _attributes + j * sizeof(BlobHeader::Attribute);
+				_writer.SetString(_attr + offsetof(BlobHeader::Attribute, name), _src->name.CStr(), _src->name.Length());
+				_writer.Ptr<BlobHeader::Attribute>(_attr)->offset = _layout.attributes[j].second;
+				_writer.Ptr<BlobHeader::Attribute>(_attr)->type = _src->type;
+			}
+		}
+
+		// objects
+		uint _objectsTable = _writer.AllocateArray(offsetof(BlobHeader, objects), _list.Size(), sizeof(BlobHeader::Object));
+		for (uint i = 0; i < _list.Size(); ++i)
+		{
+			const Object* _object = _list[i];
+			const _BlobLayout& _layout = _layouts[_objectLayouts[i]];
+			uint _entry = _objectsTable + i * sizeof(BlobHeader::Object);
+			uint _data = _writer.Allocate(_layout.size);
+
+			_writer.Ptr<BlobHeader::Object>(_entry)->type = _objectLayouts[i];
+			_writer.Link(_entry + offsetof(BlobHeader::Object, data), _data);
+
+			for (const Pair<const Attribute*, uint>& a : _layout.attributes)
+			{
+				const Attribute& _attr = *a.first;
+				uint _at = _data + a.second;
+
+				switch (_attr.type)
+				{
+				case Attribute::Type::String:
+				{
+					String _value;
+					_attr.getter(_attr, _object, &_value);
+					_writer.SetString(_at, _value.CStr(), _value.Length());
+				} break;
+
+				case Attribute::Type::StringId:
+				{
+					StringId _value;
+					_attr.getter(_attr, _object, &_value);
+					_writer.SetString(_at, _value.CStr(), _value.Length());
+				} break;
+
+				case Attribute::Type::Object:
+				{
+					ObjectPtr _value;
+					_attr.getter(_attr, _object, &_value);
+					_writer.Ptr<BlobRef>(_at)->m_index = _value ? (int32)_indices[_value] : -1;
+				} break;
+
+				default:
+				{
+					alignas(16) uint8 _value[sizeof(Matrix4x4)];
+					_attr.getter(_attr, _object, _value);
+					memcpy(_writer.Ptr<uint8>(_at), _value, _BlobValueSize(_attr.type));
+				} break;
+				}
+			}
+		}
+
+		BlobHeader* _header = _writer.Ptr<BlobHeader>(0);
+		_header->magic = BlobHeader::MAGIC;
+		_header->format = BlobHeader::FORMAT;
+		_header->version = _version;
+		_header->size = _writer.Size();
+		_header->numRoots = _numRoots;
+
+		_dst = Move(_writer.Data());
+	}
+	//----------------------------------------------------------------------------//
+	bool BinarySerializer::Load(const BlobView& _blob, Array<ObjectPtr>& _dst)
+	{
+		ASSERT(gReflection != nullptr);
+
+		if (!_blob.IsValid())
+			return false;
+
+		const BlobHeader* _header = _blob.Header();
+		uint _numTypes = _header->types.Size();
+		uint _numObjects = _header->objects.Size();
+
+		// match the stored layouts with the current types
+		Array<const TypeInfo*> _types(_numTypes, nullptr);
+		Array<Array<Pair<const Attribute*, uint>>> _attributes(_numTypes);
+		for (uint i = 0; i < _numTypes; ++i)
+		{
+			const BlobHeader::Type& _src = _header->types[i];
+			const TypeInfo* _type = gReflection->GetType(StringId(_src.name.View()));
+			if (!_type || _type->IsAbstract())
+				continue;
+
+			_types[i] = _type;
+			for (const BlobHeader::Attribute& a : _src.attributes)
+			{
+				const Attribute* _attr = _type->FindAttribute(StringId(a.name.View()));
+				if (_attr && _attr->type == a.type && _attr->setter && !(_attr->flags & Attribute::F_NoSerialize) && a.offset + _BlobValueSize(a.type) <= _src.size)
+					_attributes[i].Push({ _attr, a.offset });
+			}
+		}
+
+		// create all objects first, so references can be resolved
+		Array<ObjectPtr> _objects(_numObjects);
+		for (uint i = 0; i < _numObjects; ++i)
+		{
+			uint _type = _header->objects[i].type;
+			if (_type < _numTypes && _types[_type])
+				_objects[i] = ObjectPtr(_types[_type]->Create());
+		}
+
+		for (uint i = 0; i < _numObjects; ++i)
+		{
+			Object* _object = _objects[i];
+			if (!_object)
+				continue;
+
+			const uint8* _data = _header->objects[i].data.Get();
+			for (const Pair<const Attribute*, uint>& a : _attributes[_header->objects[i].type])
+			{
+				const Attribute& _attr = *a.first;
+				const uint8* _src = _data + a.second;
+
+				switch (_attr.type)
+				{
+				case Attribute::Type::String:
+				{
+					const BlobString* _str = reinterpret_cast<const BlobString*>(_src);
+					String _value(_str->CStr(), _str->Length());
+					_attr.setter(_attr, _object, &_value);
+				} break;
+
+				case Attribute::Type::StringId:
+				{
+					StringId _value(reinterpret_cast<const BlobString*>(_src)->View());
+					_attr.setter(_attr, _object, &_value);
+				} break;
+
+				case Attribute::Type::Object:
+				{
+					const BlobRef* _ref = reinterpret_cast<const BlobRef*>(_src);
+					ObjectPtr _value = !_ref->IsNull() && _ref->Index() < _numObjects ? _objects[_ref->Index()] : nullptr;
+					_attr.setter(_attr, _object, &_value);
+				} break;
+
+				default:
+				{
+					alignas(16) uint8 _value[sizeof(Matrix4x4)];
+					memcpy(_value, _src, _BlobValueSize(_attr.type));
+					_attr.setter(_attr, _object, _value);
+				} break;
+				}
+			}
+		}
+
+		for (uint i = 0; i < _header->numRoots; ++i)
+			_dst.Push(_objects[i]);
+
+		return true;
+	}
+}
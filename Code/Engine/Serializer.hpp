@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Object.hpp"
+
+namespace Reax
+{
+	//!\addtogroup Base
+	//!\{
+
+	//----------------------------------------------------------------------------//
+	// Blob primitives
+	//----------------------------------------------------------------------------//
+
+	//! Pointer stored as offset from its own address, so a blob can be used at any address without fixups.
+	template <class T> struct BlobPtr
+	{
+		//!
+		const T* Get(void) const { return m_offset ? reinterpret_cast<const T*>(reinterpret_cast<const uint8*>(this) + m_offset) : nullptr; }
+		//!
+		const T* operator -> (void) const { return Get(); }
+		//!
+		const T& operator * (void) const { return *Get(); }
+
+		int32 m_offset;
+	};
+
+	//! Array view of a blob.
+	template <class T> struct BlobArray
+	{
+		//!
+		typedef ArrayIterator<const T> ConstIterator;
+
+		//!
+		const T& operator [] (uint _index) const { ASSERT(_index < m_size); return m_data.Get()[_index]; }
+		//!
+		const T* Data(void) const { return m_data.Get(); }
+		//!
+		uint Size(void) const { return m_size; }
+		//!
+		bool IsEmpty(void) const { return m_size == 0; }
+		//!
+		ConstIterator Begin(void) const { return m_data.Get(); }
+		//!
+		ConstIterator End(void) const { return m_data.Get() + m_size; }
+
+		BlobPtr<T> m_data;
+		uint32 m_size;
+	};
+
+	//!
+	template <class T> ArrayIterator<const T> begin(const BlobArray<T>& _array) { return _array.Begin(); }
+	//!
+	template <class T> ArrayIterator<const T> end(const BlobArray<T>& _array) { return _array.End(); }
+
+	//! Null-terminated string of a blob.
+	struct BlobString
+	{
+		//!
+		const char* CStr(void) const { return m_length ? m_data.Get() : ""; }
+		//!
+		uint Length(void) const { return m_length; }
+		//!
+		StringView View(void) const { return StringView(CStr(), m_length); }
+		//!
+		operator StringView (void) const { return View(); }
+
+		BlobPtr<char> m_data;
+		uint32 m_length;
+	};
+
+	//! Reference to an object of a blob.
+	struct BlobRef
+	{
+		//!
+		bool IsNull(void) const { return m_index < 0; }
+		//!
+		uint Index(void) const { return (uint)m_index; }
+
+		//! Index in BlobHeader::objects, -1 for null.
+		int32 m_index;
+	};
+
+	//----------------------------------------------------------------------------//
+	// BlobWriter
+	//----------------------------------------------------------------------------//
+
+	//! Builder of blobs. Pointers to the data are invalidated by Allocate, so all references are offsets from the beginning of the blob.
+	class RX_API BlobWriter : public NonCopyable
+	{
+	public:
+		//! Add zeroed block and return its offset.
+		uint Allocate(uint _size, uint _align = 4);
+		//! Set BlobPtr at offset _at to _target.
+		void Link(uint _at, uint _target);
+		//! Allocate _count elements for BlobArray at offset _at and return offset of the elements.
+		uint AllocateArray(uint _at, uint _count, uint _elementSize, uint _align = 4);
+		//! Copy a string to the blob and set BlobString at offset _at.
+		void SetString(uint _at, const char* _str, uint _length);
+
+		//!
+		template <class T> T* Ptr(uint _offset) { ASSERT(_offset + sizeof(T) <= m_data.Size()); return reinterpret_cast<T*>(m_data.Data() + _offset); }
+		//!
+		Array<uint8>& Data(void) { return m_data; }
+		//!
+		uint Size(void) const { return m_data.Size(); }
+
+	protected:
+		Array<uint8> m_data;
+	};
+
+	//----------------------------------------------------------------------------//
+	// BinarySerializer
+	//----------------------------------------------------------------------------//
+
+	//! Layout of a serialized blob. All pointers are relative, all values are in native byte order.
+	struct BlobHeader
+	{
+		static const uint32 MAGIC = 0x4c425852; // "RXBL"
+		static const uint16 FORMAT = 1;
+
+		//! Serialized attribute. The value is stored at offset in the data of object.
+		struct Attribute
+		{
+			BlobString name;
+			uint32 offset;
+			Reax::Attribute::Type type;
+			uint8 reserved[3];
+		};
+		//! Layout of the objects of one type at the time of saving.
+		struct Type
+		{
+			BlobString name;
+			BlobArray<Attribute> attributes;
+			//! Size of data of an object.
+			uint32 size;
+		};
+		//!
+		struct Object
+		{
+			uint32 type;
+			BlobPtr<uint8> data;
+		};
+
+		uint32 magic;
+		uint16 format;
+		uint16 reserved;
+		//! User version of the data.
+		uint32 version;
+		//! Size of whole blob.
+		uint32 size;
+		BlobArray<Type> types;
+		//! Objects. The saved objects go first, then the objects referenced by them.
+		BlobArray<Object> objects;
+		//! Number of saved objects.
+		uint32 numRoots;
+	};
+
+	//! Read-only view of a blob created by BinarySerializer::Save. Values are accessed in place, without parsing.
+	//! Strings and string ids are stored as BlobString, references to objects as BlobRef.
+	class RX_API BlobView
+	{
+	public:
+		//!
+		BlobView(void) = default;
+		//! Check the header. The blob must be aligned to 4 bytes and alive while the view is in use.
+		BlobView(const void* _data, uint _size);
+
+		//! Returns false if the blob is not valid.
+		bool IsValid(void) const { return m_header != nullptr; }
+		//!
+		const BlobHeader* Header(void) const { return m_header; }
+		//!
+		uint Version(void) const { return m_header ? m_header->version : 0; }
+		//!
+		uint NumObjects(void) const { return m_header ? m_header->objects.Size() : 0; }
+		//!
+		uint NumRoots(void) const { return m_header ? m_header->numRoots : 0; }
+		//!
+		const BlobHeader::Type& ObjectType(uint _object) const { return m_header->types[m_header->objects[_object].type]; }
+		//! Find attribute of the type of object. Returns nullptr if not found.
+		const BlobHeader::Attribute* FindAttribute(uint _object, const StringView& _name) const;
+		//! Get value of an attribute in place. Returns nullptr if type of the attribute differs from T.
+		template <class T> const T* Get(uint _object, const BlobHeader::Attribute* _attr) const
+		{
+			static_assert(_BlobType<T>::Value != Attribute::Type::Null, "Unsupported type, use BlobString for strings and BlobRef for objects");
+			if (!_attr || _StorageType(_attr->type) != _BlobType<T>::Value)
+				return nullptr;
+			return reinterpret_cast<const T*>(m_header->objects[_object].data.Get() + _attr->offset);
+		}
+		//!
+		template <class T> const T* Get(uint _object, const StringView& _name) const { return Get<T>(_object, FindAttribute(_object, _name)); }
+
+	protected:
+		//! Type of attribute in a blob.
+		template <class T> struct _BlobType { static const Attribute::Type Value = AttributeType<T>::Value; };
+		//!
+		static Attribute::Type _StorageType(Attribute::Type _type) { return _type == Attribute::Type::StringId ? Attribute::Type::String : _type; }
+
+		const BlobHeader* m_header = nullptr;
+	};
+
+	template <> struct BlobView::_BlobType<BlobString> { static const Attribute::Type Value = Attribute::Type::String; };
+	template <> struct BlobView::_BlobType<BlobRef> { static const Attribute::Type Value = Attribute::Type::Object; };
+	template <> struct BlobView::_BlobType<String> { static const Attribute::Type Value = Attribute::Type::Null; };
+	template <> struct BlobView::_BlobType<StringId> { static const Attribute::Type Value = Attribute::Type::Null; };
+	template <> struct BlobView::_BlobType<ObjectPtr> { static const Attribute::Type Value = Attribute::Type::Null; };
+
+	//! Binary serialization of objects through reflection.
+	//! The blob contains layout of each serialized type, so data saved by an older version of type can be loaded:
+	//! attributes are matched by name, and missing or changed attributes are skipped.
+	class RX_API BinarySerializer
+	{
+	public:
+		//! Serialize the objects and all objects referenced by them. Attributes with F_NoSerialize are skipped.
+		static void Save(Array<uint8>& _dst, const Object* const* _objects, uint _count, uint _version = 0);
+		//!
+		static void Save(Array<uint8>& _dst, const ObjectPtr& _object, uint _version = 0) { const Object* _ptr = _object; Save(_dst, &_ptr, 1, _version); }
+
+		//! Create objects of a blob. The saved objects are added to _dst. Returns false if the blob is not valid.
+		//! The mapping of attributes is built once per type, values are copied to the objects without parsing.
+		static bool Load(const BlobView& _blob, Array<ObjectPtr>& _dst);
+		//!
+		static bool Load(const void* _data, uint _size, Array<ObjectPtr>& _dst) { return Load(BlobView(_data, _size), _dst); }
+	};
+
+	//!\} Base
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Common.hpp"
+
+//----------------------------------------------------------------------------//
+// Instruction sets
+//----------------------------------------------------------------------------//
+
+// RX_SSE2 - SSE2 is available at compile time (all x64 targets).
+// RX_NEON - NEON is available at compile time.
+// Other extensions are checked at runtime with Reax::GetCpuFeatures and used only in functions marked with RX_TARGET.
+// Define RX_NO_SIMD to compile the scalar versions only.
+
+#if !defined(RX_NO_SIMD)
+#	if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#		define RX_X86
+#		include <immintrin.h>
+#		if defined(_MSC_VER)
+#			include <intrin.h>
+#		else
+#			include <cpuid.h>
+#		endif
+#		if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#			define RX_SSE2
+#		endif
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#		define RX_NEON
+#		include <arm_neon.h>
+#	endif
+#endif
+
+#ifdef _MSC_VER
+#	define RX_TARGET(_isa) // intrinsics of all instruction sets are available without compiler options
+#	define RX_ALIGN(_n) __declspec(align(_n))
+#	define RX_CTZ(_x) _RxCtz(_x)
+#	define RX_CLZ(_x) _RxClz(_x)
+#else
+#	define RX_TARGET(_isa) __attribute__((target(_isa)))
+#	define RX_ALIGN(_n) __attribute__((aligned(_n)))
+#	define RX_CTZ(_x) ((uint)__builtin_ctz(_x))
+#	define RX_CLZ(_x) ((uint)__builtin_clz(_x))
+#endif
+
+namespace Reax
+{
+	//!\addtogroup Base
+	//!\{
+
+	//----------------------------------------------------------------------------//
+	// CpuFeatures
+	//----------------------------------------------------------------------------//
+
+	//! Instruction sets supported by processor and operating system.
+	struct CpuFeatures
+	{
+		bool sse2 = false;
+		bool sse3 = false;
+		bool ssse3 = false;
+		bool sse41 = false;
+		bool sse42 = false;
+		bool avx = false;
+		bool avx2 = false;
+		bool fma = false;
+		bool f16c = false;
+		bool avx512f = false;
+		bool avx512bw = false;
+		bool avx512vl = false;
+		bool neon = false;
+	};
+
+#ifdef _MSC_VER
+	//! Number of trailing zero bits. \note _x must be non-zero.
+	inline uint _RxCtz(uint _x)
+	{
+		unsigned long _index;
+		_BitScanForward(&_index, _x);
+		return (uint)_index;
+	}
+	//! Number of leading zero bits. \note _x must be non-zero.
+	inline uint _RxClz(uint _x)
+	{
+		unsigned long _index;
+		_BitScanReverse(&_index, _x);
+		return 31 - (uint)_index;
+	}
+#endif
+
+	//!
+	inline CpuFeatures _DetectCpuFeatures(void)
+	{
+		CpuFeatures _f;
+#if defined(RX_X86)
+		uint _r[4] = { 0, 0, 0, 0 }; // eax, ebx, ecx, edx
+#	ifdef _MSC_VER
+#		define RX_CPUID(_leaf, _subleaf) __cpuidex(reinterpret_cast<int*>(_r), _leaf, _subleaf)
+#	else
+#		define RX_CPUID(_leaf, _subleaf) __cpuid_count(_leaf, _subleaf, _r[0], _r[1], _r[2], _r[3])
+#	endif
+		RX_CPUID(0, 0);
+		uint _maxLeaf = _r[0];
+		if (_maxLeaf < 1)
+			return _f;
+
+		RX_CPUID(1, 0);
+		_f.sse2 = (_r[3] & (1 << 26)) != 0;
+		_f.sse3 = (_r[2] & (1 << 0)) != 0;
+		_f.ssse3 = (_r[2] & (1 << 9)) != 0;
+		_f.sse41 = (_r[2] & (1 << 19)) != 0;
+		_f.sse42 = (_r[2] & (1 << 20)) != 0;
+		bool _fma = (_r[2] & (1 << 12)) != 0;
+		bool _f16c = (_r[2] & (1 << 29)) != 0;
+
+		// the OS must save the AVX state on context switch
+		bool _avxState = false, _avx512State = false;
+		if ((_r[2] & (1 << 27)) && (_r[2] & (1 << 28))) // osxsave, avx
+		{
+#	ifdef _MSC_VER
+			uint64 _xcr0 = _xgetbv(0);
+#	else
+			uint _lo, _hi;
+			__asm__ __volatile__("xgetbv" : "=a"(_lo), "=d"(_hi) : "c"(0));
+			uint64 _xcr0 = ((uint64)_hi << 32) | _lo;
+#	endif
+			_avxState = (_xcr0 & 0x06) == 0x06; // xmm, ymm
+			_avx512State = (_xcr0 & 0xe6) == 0xe6; // xmm, ymm, opmask, zmm
+		}
+		_f.avx = _avxState;
+		_f.fma = _avxState && _fma;
+		_f.f16c = _avxState && _f16c;
+
+		if (_maxLeaf >= 7)
+		{
+			RX_CPUID(7, 0);
+			_f.avx2 = _avxState && (_r[1] & (1 << 5)) != 0;
+			_f.avx512f = _avx512State && (_r[1] & (1 << 16)) != 0;
+			_f.avx512bw = _avx512State && (_r[1] & (1 << 30)) != 0;
+			_f.avx512vl = _avx512State && (_r[1] & (1u << 31)) != 0;
+		}
+#	undef RX_CPUID
+#elif defined(RX_NEON)
+		_f.neon = true;
+#endif
+		return _f;
+	}
+
+	//! Get instruction sets supported by processor. Detected once.
+	inline const CpuFeatures& GetCpuFeatures(void)
+	{
+		static const CpuFeatures _features = _DetectCpuFeatures();
+		return _features;
+	}
+
+	//----------------------------------------------------------------------------//
+	//
+	//----------------------------------------------------------------------------//
+
+	//!\} Base
+}
@@ -0,0 +1,1129 @@
+#include "Spatial.hpp"
+#include "Concurrency.hpp"
+
+namespace Reax
+{
+	//----------------------------------------------------------------------------//
+	// DbvTree
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	DbvTree::DbvTree(float _margin) :
+		m_margin(_margin)
+	{
+	}
+	//----------------------------------------------------------------------------//
+	DbvTree::~DbvTree(void)
+	{
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::Clear(void)
+	{
+		m_nodes.Clear();
+		m_bounds.Clear();
+		m_leaves.Clear();
+		m_root = DBV_NULL;
+		m_free = DBV_NULL;
+		m_freeLeaf = DBV_NULL;
+		m_size = 0;
+	}
+	//----------------------------------------------------------------------------//
+	uint DbvTree::Insert(const AlignedBox& _bounds, void* _object)
+	{
+		uint _leaf = m_freeLeaf;
+		if (_leaf != DBV_NULL)
+			m_freeLeaf = m_leaves[_leaf].node;
+		else
+		{
+			_leaf = m_leaves.Size();
+			m_leaves.Push({ DBV_NULL, nullptr });
+		}
+		m_leaves[_leaf].object = _object;
+		_InsertLeaf(_leaf, _bounds.Expand(m_margin));
+		++m_size;
+		return _leaf;
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::Remove(uint _leaf)
+	{
+		ASSERT(_leaf < m_leaves.Size());
+		_RemoveLeaf(_leaf);
+		m_leaves[_leaf].node = m_freeLeaf;
+		m_leaves[_leaf].object = nullptr;
+		m_freeLeaf = _leaf;
+		--m_size;
+	}
+	//----------------------------------------------------------------------------//
+	bool DbvTree::Update(uint _leaf, const AlignedBox& _bounds, const Vector3& _displacement)
+	{
+		ASSERT(_leaf < m_leaves.Size());
+		if (LeafBounds(_leaf).Contains(_bounds))
+			return false;
+
+		AlignedBox _box = _bounds.Expand(m_margin);
+		for (uint i = 0; i < 3; ++i)
+		{
+			if (_displacement.v[i] < 0)
+				_box.mn.v[i] += _displacement.v[i];
+			else
+				_box.mx.v[i] += _displacement.v[i];
+		}
+
+		_RemoveLeaf(_leaf);
+		_InsertLeaf(_leaf, _box);
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::Reorder(void)
+	{
+		m_free = DBV_NULL;
+		if (m_root == DBV_NULL)
+		{
+			m_nodes.Clear();
+			m_bounds.Clear();
+			return;
+		}
+
+		Array<DbvNode> _nodes(m_size * 2 - 1);
+		Array<AlignedBox> _bounds(m_size * 2 - 1);
+		struct Item { uint src, dst; };
+		_TraversalStack<Item> _stack;
+		_stack.Push({ m_root, 0 });
+		_nodes[0].parent = DBV_NULL;
+		uint _next = 1;
+		while (_stack.NonEmpty())
+		{
+			Item _item = _stack.Pop();
+			const DbvNode& _src = m_nodes[_item.src];
+			DbvNode& _dst = _nodes[_item.dst];
+			_dst.leaf = _src.leaf;
+			_dst.height = _src.height;
+			_bounds[_item.dst] = m_bounds[_item.src];
+			if (_src.IsLeaf())
+			{
+				_dst.child = DBV_NULL;
+				m_leaves[_src.leaf].node = _item.dst;
+			}
+			else
+			{
+				// children are placed right after the parent, the first subtree follows them
+				_dst.child = _next;
+				_nodes[_next].parent = _item.dst;
+				_nodes[_next + 1].parent = _item.dst;
+				_stack.Push({ _src.child + 1, _next + 1 });
+				_stack.Push({ _src.child, _next });
+				_next += 2;
+			}
+		}
+		ASSERT(_next == _nodes.Size());
+
+		m_nodes = Move(_nodes);
+		m_bounds = Move(_bounds);
+		m_root = 0;
+	}
+	//----------------------------------------------------------------------------//
+	float DbvTree::Cost(void) const
+	{
+		if (m_root == DBV_NULL || m_nodes[m_root].IsLeaf())
+			return 0;
+		float _cost = 0;
+		_TraversalStack<uint> _stack;
+		_stack.Push(m_root);
+		while (_stack.NonEmpty())
+		{
+			uint _node = _stack.Pop();
+			const DbvNode& _n = m_nodes[_node];
+			if (!_n.IsLeaf())
+			{
+				_cost += m_bounds[_node].Area();
+				_stack.Push(_n.child);
+				_stack.Push(_n.child + 1);
+			}
+		}
+		float _area = m_bounds[m_root].Area();
+		return _area > 0 ? _cost / _area : 0;
+	}
+	//----------------------------------------------------------------------------//
+	uint DbvTree::_AllocPair(void)
+	{
+		uint _first = m_free;
+		if (_first != DBV_NULL)
+		{
+			m_free = m_nodes[_first].parent;
+			return _first;
+		}
+		_first = m_nodes.Size();
+		m_nodes.Resize(_first + 2);
+		m_bounds.Resize(_first + 2);
+		return _first;
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_FreePair(uint _first)
+	{
+		m_nodes[_first].parent = m_free;
+		m_free = _first;
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_InsertLeaf(uint _leaf, const AlignedBox& _bounds)
+	{
+		if (m_root == DBV_NULL)
+		{
+			// the root is always the node 0, pairs of children follow it
+			if (m_nodes.IsEmpty())
+			{
+				m_nodes.Resize(1);
+				m_bounds.Resize(1);
+			}
+			m_root = 0;
+			m_nodes[0] = { DBV_NULL, DBV_NULL, _leaf, 0 };
+			m_bounds[0] = _bounds;
+			m_leaves[_leaf].node = 0;
+			return;
+		}
+
+		// find the sibling: go down while it is cheaper to insert the leaf into a child than to make a new parent here
+		uint _sibling = m_root;
+		while (!m_nodes[_sibling].IsLeaf())
+		{
+			float _area = (m_bounds[_sibling] + _bounds).Area();
+			float _cost = 2 * _area; // new parent of the sibling and the leaf
+			float _inheritance = 2 * (_area - m_bounds[_sibling].Area()); // all parents will be enlarged if the leaf goes down
+			uint _child = m_nodes[_sibling].child;
+			float _childCost[2];
+			for (uint i = 0; i < 2; ++i)
+			{
+				_childCost[i] = (m_bounds[_child + i] + _bounds).Area() + _inheritance;
+				if (!m_nodes[_child + i].IsLeaf())
+					_childCost[i] -= m_bounds[_child + i].Area();
+			}
+			if (_cost < _childCost[0] && _cost < _childCost[1])
+				break;
+			uint _next = _childCost[1] < _childCost[0] || (_childCost[1] == _childCost[0] && m_nodes[_child + 1].height < m_nodes[_child].height);
+			_sibling = _child + _next;
+		}
+
+		// the sibling moves down to a new pair with the leaf, its place becomes the new parent
+		uint _pair = _AllocPair();
+		_Move(_sibling, _pair);
+		m_nodes[_pair].parent = _sibling;
+		m_nodes[_pair + 1] = { _sibling, DBV_NULL, _leaf, 0 };
+		m_bounds[_pair + 1] = _bounds;
+		m_leaves[_leaf].node = _pair + 1;
+		m_nodes[_sibling].child = _pair;
+		m_nodes[_sibling].leaf = DBV_NULL;
+		_Refit(_sibling);
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_RemoveLeaf(uint _leaf)
+	{
+		uint _node = m_leaves[_leaf].node;
+		uint _parent = m_nodes[_node].parent;
+		if (_parent == DBV_NULL)
+		{
+			ASSERT(_node == m_root);
+			m_root = DBV_NULL;
+			return;
+		}
+
+		// the sibling takes the place of the parent
+		uint _first = m_nodes[_parent].child;
+		_Move(_first + (_node == _first), _parent);
+		_FreePair(_first);
+		_Refit(m_nodes[_parent].parent);
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_Refit(uint _node)
+	{
+		for (; _node != DBV_NULL; _node = m_nodes[_node].parent)
+		{
+			_Rotate(_node);
+			_UpdateNode(_node);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_Rotate(uint _node)
+	{
+		// the children of _node are up to date, _node is not.
+		// both rotations exchange a child with a grandchild of the other child.
+		uint _child = m_nodes[_node].child;
+		int _balance = m_nodes[_child + 1].height - m_nodes[_child].height;
+
+		if (_balance > 1 || _balance < -1)
+		{
+			// AVL rotation: the lower child goes down in place of the higher grandchild
+			uint _high = _child + (_balance > 1);
+			uint _low = _child + (_balance < -1);
+			uint _grandChild = m_nodes[_high].child;
+			_grandChild += m_nodes[_grandChild + 1].height > m_nodes[_grandChild].height;
+			_Swap(_low, _grandChild);
+			_UpdateNode(_high);
+			return;
+		}
+
+		// SAH rotation: the swap must reduce the area of the other child and keep the balance
+		float _bestCost = 0;
+		uint _bestX = DBV_NULL, _bestY = DBV_NULL;
+		for (uint i = 0; i < 2; ++i)
+		{
+			uint _x = _child + i; // child to go down
+			uint _s = _child + 1 - i;
+			if (m_nodes[_s].IsLeaf())
+				continue;
+			for (uint j = 0; j < 2; ++j)
+			{
+				uint _y = m_nodes[_s].child + j; // grandchild to go up
+				uint _z = m_nodes[_s].child + 1 - j;
+				int _hx = m_nodes[_x].height, _hy = m_nodes[_y].height, _hz = m_nodes[_z].height;
+				if (Abs(_hx - _hz) > 1 || Abs(1 + Max(_hx, _hz) - _hy) > 1)
+					continue;
+				float _cost = (m_bounds[_x] + m_bounds[_z]).Area() - m_bounds[_s].Area();
+				if (_cost < _bestCost)
+				{
+					_bestCost = _cost;
+					_bestX = _x;
+					_bestY = _y;
+				}
+			}
+		}
+		if (_bestX != DBV_NULL)
+		{
+			_Swap(_bestX, _bestY);
+			_UpdateNode(m_nodes[_bestY].parent);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_UpdateNode(uint _node)
+	{
+		uint _child = m_nodes[_node].child;
+		m_bounds[_node] = m_bounds[_child] + m_bounds[_child + 1];
+		m_nodes[_node].height = 1 + Max(m_nodes[_child].height, m_nodes[_child + 1].height);
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_Move(uint _src, uint _dst)
+	{
+		DbvNode& _d = m_nodes[_dst];
+		const DbvNode& _s = m_nodes[_src];
+		_d.child = _s.child;
+		_d.leaf = _s.leaf;
+		_d.height = _s.height;
+		m_bounds[_dst] = m_bounds[_src];
+		_Link(_dst);
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_Swap(uint _a, uint _b)
+	{
+		DbvNode& _na = m_nodes[_a];
+		DbvNode& _nb = m_nodes[_b];
+		Swap(_na.child, _nb.child);
+		Swap(_na.leaf, _nb.leaf);
+		Swap(_na.height, _nb.height);
+		Swap(m_bounds[_a], m_bounds[_b]);
+		_Link(_a);
+		_Link(_b);
+	}
+	//----------------------------------------------------------------------------//
+	void DbvTree::_Link(uint _node)
+	{
+		const DbvNode& _n = m_nodes[_node];
+		if (_n.IsLeaf())
+			m_leaves[_n.leaf].node = _node;
+		else
+		{
+			m_nodes[_n.child].parent = _node;
+			m_nodes[_n.child + 1].parent = _node;
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	// DbvTree build
+	//----------------------------------------------------------------------------//
+
+	//! Spread the low 10 bits of _x to every third bit.
+	static uint _SpreadBits(uint _x)
+	{
+		_x &= 0x3ff;
+		_x = (_x | (_x << 16)) & 0xff0000ff;
+		_x = (_x | (_x << 8)) & 0x0300f00f;
+		_x = (_x | (_x << 4)) & 0x030c30c3;
+		_x = (_x | (_x << 2)) & 0x09249249;
+		return _x;
+	}
+	//! Spread the low 21 bits of _x to every third bit.
+	static uint64 _SpreadBits(uint64 _x)
+	{
+		_x &= 0x1fffff;
+		_x = (_x | (_x << 32)) & 0x001f00000000ffffull;
+		_x = (_x | (_x << 16)) & 0x001f0000ff0000ffull;
+		_x = (_x | (_x << 8)) & 0x100f00f00f00f00full;
+		_x = (_x | (_x << 4)) & 0x10c30c30c30c30c3ull;
+		_x = (_x | (_x << 2)) & 0x1249249249249249ull;
+		return _x;
+	}
+	//! Index of the highest set bit. _x must be non-zero.
+	static uint _HighestBit(uint64 _x)
+	{
+		uint _hi = (uint)(_x >> 32);
+		return _hi ? 63 - RX_CLZ(_hi) : 31 - RX_CLZ((uint)_x);
+	}
+	//! The first element of i-th of _count equal parts of _size elements.
+	static uint _PartStart(uint _size, uint _index, uint _count)
+	{
+		return (uint)((uint64)_size * _index / _count);
+	}
+
+	//! Stable parallel LSD radix sort of 64-bit keys with values by 8-bit digits. Only _bits low bits of the keys are sorted.
+	static void _RadixSort(Array<uint64>& _keys, Array<uint>& _values, uint _bits, uint _threads)
+	{
+		uint _size = _keys.Size();
+		Array<uint64> _keys2(_size);
+		Array<uint> _values2(_size);
+		Array<uint> _offsets(_threads * 256);
+		for (uint _shift = 0; _shift < _bits; _shift += 8)
+		{
+			const uint64* _srcKeys = _keys.Data();
+			RunParallel(_threads, [&](uint _thread)
+			{
+				uint* _count = _offsets.Data() + _thread * 256;
+				memset(_count, 0, 256 * sizeof(uint));
+				for (uint i = _PartStart(_size, _thread, _threads), _end = _PartStart(_size, _thread + 1, _threads); i < _end; ++i)
+					++_count[(_srcKeys[i] >> _shift) & 0xff];
+			});
+
+			// digits go in order, threads go in order within a digit
+			uint _sum = 0;
+			bool _skip = false;
+			for (uint _digit = 0; _digit < 256; ++_digit)
+			{
+				uint _start = _sum;
+				for (uint t = 0; t < _threads; ++t)
+				{
+					uint _count = _offsets[t * 256 + _digit];
+					_offsets[t * 256 + _digit] = _sum;
+					_sum += _count;
+				}
+				if (_sum - _start == _size)
+					_skip = true; // all keys have the same digit
+			}
+			if (_skip)
+				continue;
+
+			const uint* _srcValues = _values.Data();
+			uint64* _dstKeys = _keys2.Data();
+			uint* _dstValues = _values2.Data();
+			RunParallel(_threads, [&](uint _thread)
+			{
+				uint* _offset = _offsets.Data() + _thread * 256;
+				for (uint i = _PartStart(_size, _thread, _threads), _end = _PartStart(_size, _thread + 1, _threads); i < _end; ++i)
+				{
+					uint _dst = _offset[(_srcKeys[i] >> _shift) & 0xff]++;
+					_dstKeys[_dst] = _srcKeys[i];
+					_dstValues[_dst] = _srcValues[i];
+				}
+			});
+			Swap(_keys, _keys2);
+			Swap(_values, _values2);
+		}
+	}
+
+	//! Bulk builder of DbvTree.
+	//! Descendants of a node with n leaves occupy 2n - 2 nodes starting from its pair of children, the first subtree goes right after the pair.
+	//! So the place of each subtree is known before its build and subtrees are built in parallel without synchronization.
+	struct _DbvBuilder
+	{
+		static const uint SAH_BINS = 16;
+		static const uint SAH_MIN_BINNING = 8; // smaller ranges are split in the middle along the largest axis
+		static const uint PARALLEL_BINNING = 1 << 16; // minimal number of objects to bin them in parallel
+
+		struct Task { uint node, begin, end, next; };
+		//! Bounds of object packed for SIMD loads, the fourth lanes are ignored.
+		struct Item
+		{
+			Vector3 mn;
+			uint object;
+			Vector3 mx;
+			uint pad;
+		};
+		struct Bins
+		{
+			_V4 mn[3][SAH_BINS];
+			_V4 mx[3][SAH_BINS];
+			uint count[3][SAH_BINS];
+		};
+
+		DbvNode* nodes;
+		AlignedBox* bounds;
+		DbvLeaf* leaves;
+		float margin;
+		DbvBuildMethod method;
+		uint threads;
+		Item* items; // objects in order of leaves, partitioned by BinnedSah
+		const uint64* codes; // sorted Morton codes of items for Lbvh
+
+		//!
+		void MakeLeaf(uint _node, const Item& _item)
+		{
+			nodes[_node].child = DBV_NULL;
+			nodes[_node].leaf = _item.object;
+			nodes[_node].height = 0;
+			bounds[_node] = AlignedBox(_item.mn, _item.mx).Expand(margin);
+			leaves[_item.object].node = _node;
+		}
+		//!
+		void MakeInternal(uint _node, uint _pair)
+		{
+			nodes[_node].child = _pair;
+			nodes[_node].leaf = DBV_NULL;
+			nodes[_pair].parent = _node;
+			nodes[_pair + 1].parent = _node;
+		}
+		//!
+		void UpdateNode(uint _node)
+		{
+			uint _child = nodes[_node].child;
+			bounds[_node] = bounds[_child] + bounds[_child + 1];
+			nodes[_node].height = 1 + Max(nodes[_child].height, nodes[_child + 1].height);
+		}
+
+		//! Split the task into two tasks.
+		void Split(const Task& _task, Task& _first, Task& _second, bool _parallel)
+		{
+			uint _mid = method == DbvBuildMethod::BinnedSah ? SplitSah(_task.begin, _task.end, _parallel) : SplitLbvh(_task.begin, _task.end);
+			MakeInternal(_task.node, _task.next);
+			_first = { _task.next, _task.begin, _mid, _task.next + 2 };
+			_second = { _task.next + 1, _mid, _task.end, _task.next + 2 * (_mid - _task.begin) };
+		}
+
+		//! Split at the highest different bit of Morton codes. Returns the beginning of the second half.
+		uint SplitLbvh(uint _begin, uint _end)
+		{
+			uint64 _first = codes[_begin], _last = codes[_end - 1];
+			if (_first == _last)
+				return (_begin + _end) >> 1;
+			uint64 _bit = (uint64)1 << _HighestBit(_first ^ _last);
+			uint _lo = _begin, _hi = _end - 1; // the bit is clear at _lo and set at _hi
+			while (_hi - _lo > 1)
+			{
+				uint _mid = (_lo + _hi) >> 1;
+				if (codes[_mid] & _bit)
+					_hi = _mid;
+				else
+					_lo = _mid;
+			}
+			return _hi;
+		}
+
+		//! Half of surface area of the box.
+		static float Area(_V4 _mn, _V4 _mx)
+		{
+			float _size[4];
+			_V4Store(_size, _V4Sub(_mx, _mn));
+			return _size[0] * _size[1] + _size[1] * _size[2] + _size[2] * _size[0];
+		}
+		//! Doubled center of the item.
+		_V4 Center(uint _item) const { return _V4Add(_V4Load(&items[_item].mn.x), _V4Load(&items[_item].mx.x)); }
+		//! Indices of bins of the item on each axis.
+		void BinIndex(uint _item, _V4 _origin, _V4 _scale, uint _bin[3]) const
+		{
+			float _index[4];
+			_V4Store(_index, _V4Min(_V4Mul(_V4Sub(Center(_item), _origin), _scale), _V4Splat(SAH_BINS - 1)));
+			_bin[0] = (uint)_index[0];
+			_bin[1] = (uint)_index[1];
+			_bin[2] = (uint)_index[2];
+		}
+		//! Bounds of doubled centers.
+		void CenterBounds(uint _begin, uint _end, _V4& _mn, _V4& _mx) const
+		{
+			for (uint i = _begin; i < _end; ++i)
+			{
+				_V4 _center = Center(i);
+				_mn = _V4Min(_mn, _center);
+				_mx = _V4Max(_mx, _center);
+			}
+		}
+		//!
+		void Binning(uint _begin, uint _end, _V4 _origin, _V4 _scale, Bins& _bins) const
+		{
+			for (uint _axis = 0; _axis < 3; ++_axis)
+			{
+				for (uint _bin = 0; _bin < SAH_BINS; ++_bin)
+				{
+					_bins.mn[_axis][_bin] = _V4Splat(1e30f);
+					_bins.mx[_axis][_bin] = _V4Splat(-1e30f);
+					_bins.count[_axis][_bin] = 0;
+				}
+			}
+			for (uint i = _begin; i < _end; ++i)
+			{
+				_V4 _mn = _V4Load(&items[i].mn.x), _mx = _V4Load(&items[i].mx.x);
+				uint _bin[3];
+				BinIndex(i, _origin, _scale, _bin);
+				for (uint _axis = 0; _axis < 3; ++_axis)
+				{
+					_bins.mn[_axis][_bin[_axis]] = _V4Min(_bins.mn[_axis][_bin[_axis]], _mn);
+					_bins.mx[_axis][_bin[_axis]] = _V4Max(_bins.mx[_axis][_bin[_axis]], _mx);
+					++_bins.count[_axis][_bin[_axis]];
+				}
+			}
+		}
+
+		//! Split by the plane of bins with minimal surface area heuristic. Returns the beginning of the second half.
+		uint SplitSah(uint _begin, uint _end, bool _parallel)
+		{
+			uint _parts = _parallel && _end - _begin >= PARALLEL_BINNING ? threads : 1;
+			_V4 _partMin[64], _partMax[64];
+			Bins _localBins;
+			Bins* _partBins = &_localBins;
+			Array<Bins> _heapBins;
+			if (_parts > 1)
+			{
+				_heapBins.Resize(_parts);
+				_partBins = _heapBins.Data();
+			}
+
+			for (uint i = 0; i < _parts; ++i)
+				_partMin[i] = _partMax[i] = Center(_begin);
+			RunParallel(_parts, [&](uint _part)
+			{
+				CenterBounds(_begin + _PartStart(_end - _begin, _part, _parts), _begin + _PartStart(_end - _begin, _part + 1, _parts), _partMin[_part], _partMax[_part]);
+			});
+			_V4 _origin = _partMin[0], _last = _partMax[0];
+			for (uint i = 1; i < _parts; ++i)
+			{
+				_origin = _V4Min(_origin, _partMin[i]);
+				_last = _V4Max(_last, _partMax[i]);
+			}
+
+			float _size[4];
+			_V4Store(_size, _V4Sub(_last, _origin));
+			if (_size[0] <= 0 && _size[1] <= 0 && _size[2] <= 0)
+				return (_begin + _end) >> 1; // all centers are at one point
+
+			if (_end - _begin <= SAH_MIN_BINNING)
+			{
+				uint _axis = _size[0] > _size[1] ? (_size[0] > _size[2] ? 0 : 2) : (_size[1] > _size[2] ? 1 : 2);
+				for (uint i = _begin + 1; i < _end; ++i)
+				{
+					for (uint j = i; j > _begin && items[j].mn.v[_axis] + items[j].mx.v[_axis] < items[j - 1].mn.v[_axis] + items[j - 1].mx.v[_axis]; --j)
+						Swap(items[j], items[j - 1]);
+				}
+				return (_begin + _end) >> 1;
+			}
+
+			float _axisScale[4] = { 0, 0, 0, 0 };
+			for (uint _axis = 0; _axis < 3; ++_axis)
+				_axisScale[_axis] = _size[_axis] > 0 ? SAH_BINS / _size[_axis] : 0;
+			_V4 _scale = _V4Load(_axisScale);
+
+			RunParallel(_parts, [&](uint _part)
+			{
+				Binning(_begin + _PartStart(_end - _begin, _part, _parts), _begin + _PartStart(_end - _begin, _part + 1, _parts), _origin, _scale, _partBins[_part]);
+			});
+			Bins& _bins = _partBins[0];
+			for (uint i = 1; i < _parts; ++i)
+			{
+				for (uint _axis = 0; _axis < 3; ++_axis)
+				{
+					for (uint _bin = 0; _bin < SAH_BINS; ++_bin)
+					{
+						_bins.mn[_axis][_bin] = _V4Min(_bins.mn[_axis][_bin], _partBins[i].mn[_axis][_bin]);
+						_bins.mx[_axis][_bin] = _V4Max(_bins.mx[_axis][_bin], _partBins[i].mx[_axis][_bin]);
+						_bins.count[_axis][_bin] += _partBins[i].count[_axis][_bin];
+					}
+				}
+			}
+
+			// cost of split after the bin: area of the left part * count + area of the right part * count
+			float _bestCost = 0;
+			uint _bestAxis = 3, _bestBin = 0;
+			for (uint _axis = 0; _axis < 3; ++_axis)
+			{
+				if (_axisScale[_axis] == 0)
+					continue;
+				float _rightCost[SAH_BINS];
+				_V4 _mn = _V4Splat(1e30f), _mx = _V4Splat(-1e30f);
+				uint _count = 0;
+				for (uint _bin = SAH_BINS - 1; _bin > 0; --_bin)
+				{
+					_mn = _V4Min(_mn, _bins.mn[_axis][_bin]);
+					_mx = _V4Max(_mx, _bins.mx[_axis][_bin]);
+					_count += _bins.count[_axis][_bin];
+					_rightCost[_bin] = _count ? Area(_mn, _mx) * _count : -1;
+				}
+				_mn = _V4Splat(1e30f), _mx = _V4Splat(-1e30f);
+				_count = 0;
+				for (uint _bin = 0; _bin < SAH_BINS - 1; ++_bin)
+				{
+					_mn = _V4Min(_mn, _bins.mn[_axis][_bin]);
+					_mx = _V4Max(_mx, _bins.mx[_axis][_bin]);
+					_count += _bins.count[_axis][_bin];
+					if (!_count || _rightCost[_bin + 1] < 0)
+						continue;
+					float _cost = Area(_mn, _mx) * _count + _rightCost[_bin + 1];
+					if (_bestAxis == 3 || _cost < _bestCost)
+					{
+						_bestCost = _cost;
+						_bestAxis = _axis;
+						_bestBin = _bin;
+					}
+				}
+			}
+			ASSERT(_bestAxis < 3);
+
+			uint _mid = _begin;
+			for (uint _last = _end; _mid < _last;)
+			{
+				uint _bin[3];
+				BinIndex(_mid, _origin, _scale, _bin);
+				if (_bin[_bestAxis] <= _bestBin)
+					++_mid;
+				else
+					Swap(items[_mid], items[--_last]);
+			}
+			return _mid;
+		}
+
+		//! Build the subtree on this thread.
+		void BuildSubtree(const Task& _root)
+		{
+			_TraversalStack<Task> _stack;
+			_stack.Push(_root);
+			while (_stack.NonEmpty())
+			{
+				Task _task = _stack.Pop(), _first, _second;
+				if (_task.end - _task.begin == 1)
+				{
+					MakeLeaf(_task.node, items[_task.begin]);
+					continue;
+				}
+				Split(_task, _first, _second, false);
+				_stack.Push(_second);
+				_stack.Push(_first);
+			}
+
+			// the children are placed after their parents
+			for (uint i = _root.next + 2 * (_root.end - _root.begin) - 2; i-- > _root.next;)
+			{
+				if (!nodes[i].IsLeaf())
+					UpdateNode(i);
+			}
+			if (!nodes[_root.node].IsLeaf())
+				UpdateNode(_root.node);
+		}
+
+		//! Split the top of the tree into tasks and build them in parallel.
+		void Build(uint _count)
+		{
+			nodes[0].parent = DBV_NULL;
+			uint _taskSize = threads > 1 ? Max(_count / (threads * 8), 1024u) : _count;
+			Array<Task> _tasks;
+			Array<uint> _top;
+			_TraversalStack<Task> _stack;
+			_stack.Push({ 0, 0, _count, 1 });
+			while (_stack.NonEmpty())
+			{
+				Task _task = _stack.Pop(), _first, _second;
+				if (_task.end - _task.begin <= _taskSize)
+				{
+					_tasks.Push(_task);
+					continue;
+				}
+				Split(_task, _first, _second, true);
+				_top.Push(_task.node);
+				_stack.Push(_second);
+				_stack.Push(_first);
+			}
+
+			Atomic<uint> _next = 0;
+			RunParallel(Min(threads, _tasks.Size()), [&](uint)
+			{
+				for (uint i; (i = _next++) < _tasks.Size();)
+					BuildSubtree(_tasks[i]);
+			});
+
+			// the top nodes were added before their descendants
+			for (uint i = _top.Size(); i-- > 0;)
+				UpdateNode(_top[i]);
+		}
+	};
+
+	//----------------------------------------------------------------------------//
+	void DbvTree::Build(const AlignedBox* _bounds, uint _count, void* const* _objects, DbvBuildMethod _method, uint _threads)
+	{
+		Clear();
+		if (!_count)
+			return;
+
+		if (!_threads)
+			_threads = CpuCount();
+		if (_threads > 64)
+			_threads = 64;
+		if (_count < 4096)
+			_threads = 1; // small trees are built on the calling thread
+
+		m_nodes.Resize(_count * 2 - 1);
+		m_bounds.Resize(_count * 2 - 1);
+		m_leaves.Resize(_count);
+		for (uint i = 0; i < _count; ++i)
+			m_leaves[i].object = _objects ? _objects[i] : nullptr;
+
+		Array<_DbvBuilder::Item> _items(_count);
+		Array<uint64> _codes;
+		if (_method == DbvBuildMethod::BinnedSah)
+		{
+			RunParallel(_threads, [&](uint _thread)
+			{
+				for (uint i = _PartStart(_count, _thread, _threads), _end = _PartStart(_count, _thread + 1, _threads); i < _end; ++i)
+					_items[i] = { _bounds[i].mn, i, _bounds[i].mx, 0 };
+			});
+		}
+		else
+		{
+			AlignedBox _parts[64];
+			RunParallel(_threads, [&](uint _thread)
+			{
+				AlignedBox& _box = _parts[_thread];
+				_box = AlignedBox(_bounds[0].Center(), _bounds[0].Center());
+				for (uint i = _PartStart(_count, _thread, _threads), _end = _PartStart(_count, _thread + 1, _threads); i < _end; ++i)
+				{
+					Vector3 _center = _bounds[i].Center();
+					_box.mn = _box.mn.Min(_center);
+					_box.mx = _box.mx.Max(_center);
+				}
+			});
+			AlignedBox _centerBounds = _parts[0];
+			for (uint i = 1; i < _threads; ++i)
+				_centerBounds += _parts[i];
+
+			bool _long = _method == DbvBuildMethod::Lbvh63;
+			float _cells = _long ? (float)(1 << 21) : (float)(1 << 10);
+			Vector3 _size = _centerBounds.mx - _centerBounds.mn;
+			Vector3 _scale;
+			for (uint _axis = 0; _axis < 3; ++_axis)
+				_scale.v[_axis] = _size.v[_axis] > 0 ? _cells / _size.v[_axis] : 0;
+
+			_codes.Resize(_count);
+			Array<uint> _order(_count);
+			RunParallel(_threads, [&](uint _thread)
+			{
+				for (uint i = _PartStart(_count, _thread, _threads), _end = _PartStart(_count, _thread + 1, _threads); i < _end; ++i)
+				{
+					Vector3 _center = _bounds[i].Center();
+					uint _cell[3];
+					for (uint _axis = 0; _axis < 3; ++_axis)
+						_cell[_axis] = (uint)Min((_center.v[_axis] - _centerBounds.mn.v[_axis]) * _scale.v[_axis], _cells - 1);
+					if (_long)
+						_codes[i] = (_SpreadBits((uint64)_cell[0]) << 2) | (_SpreadBits((uint64)_cell[1]) << 1) | _SpreadBits((uint64)_cell[2]);
+					else
+						_codes[i] = (_SpreadBits(_cell[0]) << 2) | (_SpreadBits(_cell[1]) << 1) | _SpreadBits(_cell[2]);
+					_order[i] = i;
+				}
+			});
+			_RadixSort(_codes, _order, _long ? 63 : 30, _threads);
+
+			RunParallel(_threads, [&](uint _thread)
+			{
+				for (uint i = _PartStart(_count, _thread, _threads), _end = _PartStart(_count, _thread + 1, _threads); i < _end; ++i)
+					_items[i] = { _bounds[_order[i]].mn, _order[i], _bounds[_order[i]].mx, 0 };
+			});
+		}
+
+		_DbvBuilder _builder;
+		_builder.nodes = m_nodes.Data();
+		_builder.bounds = m_bounds.Data();
+		_builder.leaves = m_leaves.Data();
+		_builder.margin = m_margin;
+		_builder.method = _method;
+		_builder.threads = _threads;
+		_builder.items = _items.Data();
+		_builder.codes = _codes.Data();
+		_builder.Build(_count);
+
+		m_root = 0;
+		m_size = _count;
+	}
+
+	//----------------------------------------------------------------------------//
+	// WideBvh
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	void WideBvh::Build(const DbvTree& _tree)
+	{
+		m_nodes.Clear();
+		if (_tree.IsEmpty())
+			return;
+
+		struct Item { uint src, dst; };
+		_TraversalStack<Item> _stack;
+		m_nodes.Push(WideBvhNode());
+		_stack.Push({ _tree.Root(), 0 });
+		while (_stack.NonEmpty())
+		{
+			Item _item = _stack.Pop();
+
+			// open the largest internal nodes until there are four children
+			uint _children[4];
+			uint _count = 0;
+			const DbvNode& _src = _tree.Node(_item.src);
+			if (_src.IsLeaf())
+				_children[_count++] = _item.src; // the tree has one leaf
+			else
+			{
+				_children[_count++] = _src.child;
+				_children[_count++] = _src.child + 1;
+			}
+			while (_count < 4)
+			{
+				uint _largest = _count;
+				float _largestArea = -1;
+				for (uint i = 0; i < _count; ++i)
+				{
+					float _area = _tree.Bounds(_children[i]).Area();
+					if (!_tree.Node(_children[i]).IsLeaf() && _area > _largestArea)
+					{
+						_largest = i;
+						_largestArea = _area;
+					}
+				}
+				if (_largest == _count)
+					break;
+				uint _child = _tree.Node(_children[_largest]).child;
+				_children[_largest] = _child;
+				_children[_count++] = _child + 1;
+			}
+
+			WideBvhNode _node;
+			memset(&_node, 0, sizeof(_node));
+			_node.count = _count;
+			for (uint i = 0; i < _count; ++i)
+			{
+				const AlignedBox& _bounds = _tree.Bounds(_children[i]);
+				_node.mnX[i] = _bounds.mn.x;
+				_node.mnY[i] = _bounds.mn.y;
+				_node.mnZ[i] = _bounds.mn.z;
+				_node.mxX[i] = _bounds.mx.x;
+				_node.mxY[i] = _bounds.mx.y;
+				_node.mxZ[i] = _bounds.mx.z;
+
+				const DbvNode& _child = _tree.Node(_children[i]);
+				if (_child.IsLeaf())
+					_node.child[i] = _child.leaf | WIDE_BVH_LEAF;
+				else
+				{
+					_node.child[i] = m_nodes.Size();
+					_stack.Push({ _children[i], m_nodes.Size() });
+					m_nodes.Push(WideBvhNode());
+				}
+			}
+			m_nodes[_item.dst] = _node;
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	// SpatialHashGrid
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	SpatialHashGrid::SpatialHashGrid(float _cellSize) :
+		m_cellSize(_cellSize),
+		m_invCellSize(1 / _cellSize)
+	{
+		ASSERT(_cellSize > 0);
+	}
+	//----------------------------------------------------------------------------//
+	SpatialHashGrid::~SpatialHashGrid(void)
+	{
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::Clear(void)
+	{
+		m_objects.Clear();
+		for (HashCell& _cell : m_cells)
+		{
+			_cell.used = false;
+			_cell.objects.Clear();
+		}
+		m_usedCells = 0;
+		m_freeObject = NONE;
+		m_size = 0;
+	}
+	//----------------------------------------------------------------------------//
+	uint SpatialHashGrid::Insert(const AlignedBox& _bounds, void* _object)
+	{
+		uint _id = m_freeObject;
+		if (_id != NONE)
+			m_freeObject = m_objects[_id].next;
+		else
+		{
+			_id = m_objects.Size();
+			m_objects.Push(HashObject());
+		}
+		HashObject& _obj = m_objects[_id];
+		_obj.bounds = _bounds;
+		_obj.mn = Cell(_bounds.mn);
+		_obj.mx = Cell(_bounds.mx);
+		_obj.object = _object;
+		_obj.next = NONE;
+		_Link(_id);
+		++m_size;
+		return _id;
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::Remove(uint _id)
+	{
+		ASSERT(_id < m_objects.Size());
+		_Unlink(_id);
+		m_objects[_id].object = nullptr;
+		m_objects[_id].next = m_freeObject;
+		m_freeObject = _id;
+		--m_size;
+	}
+	//----------------------------------------------------------------------------//
+	bool SpatialHashGrid::Update(uint _id, const AlignedBox& _bounds)
+	{
+		ASSERT(_id < m_objects.Size());
+		HashObject& _obj = m_objects[_id];
+		_obj.bounds = _bounds;
+		IntVector3 _mn = Cell(_bounds.mn), _mx = Cell(_bounds.mx);
+		if (_Equal(_mn, _obj.mn) && _Equal(_mx, _obj.mx))
+			return false;
+		_Unlink(_id);
+		m_objects[_id].mn = _mn;
+		m_objects[_id].mx = _mx;
+		_Link(_id);
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::FindPairs(Array<Pair<uint, uint>>& _pairs, uint _threads) const
+	{
+		_pairs.Clear();
+		if (!_threads)
+			_threads = CpuCount();
+		if (_threads > 64)
+			_threads = 64;
+		if (m_size < 4096)
+			_threads = 1; // small grids are processed on the calling thread
+
+		if (_threads == 1)
+		{
+			auto _push = [&](uint _a, uint _b) { _pairs.Push({ _a, _b }); return true; };
+			_FindPairs(0, m_cells.Size(), _push);
+			return;
+		}
+
+		Array<Pair<uint, uint>> _parts[64];
+		RunParallel(_threads, [&](uint _thread)
+		{
+			Array<Pair<uint, uint>>& _dst = _parts[_thread];
+			auto _push = [&](uint _a, uint _b) { _dst.Push({ _a, _b }); return true; };
+			_FindPairs(_PartStart(m_cells.Size(), _thread, _threads), _PartStart(m_cells.Size(), _thread + 1, _threads), _push);
+		});
+		uint _size = 0;
+		for (uint i = 0; i < _threads; ++i)
+			_size += _parts[i].Size();
+		_pairs.Reserve(_size);
+		for (uint i = 0; i < _threads; ++i)
+			_pairs.Push(_parts[i].Data(), _parts[i].Size());
+	}
+	//----------------------------------------------------------------------------//
+	uint SpatialHashGrid::_FindCell(const IntVector3& _key) const
+	{
+		if (m_cells.IsEmpty())
+			return NONE;
+		uint _mask = m_cells.Size() - 1;
+		for (uint i = _Hash(_key) & _mask;; i = (i + 1) & _mask)
+		{
+			const HashCell& _cell = m_cells[i];
+			if (!_cell.used)
+				return NONE;
+			if (_Equal(_cell.key, _key))
+				return i;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	uint SpatialHashGrid::_AddCell(const IntVector3& _key)
+	{
+		// the load is kept at most 1/2
+		if ((m_usedCells + 1) * 2 > m_cells.Size())
+			_Rehash();
+		uint _mask = m_cells.Size() - 1;
+		for (uint i = _Hash(_key) & _mask;; i = (i + 1) & _mask)
+		{
+			HashCell& _cell = m_cells[i];
+			if (!_cell.used)
+			{
+				_cell.key = _key;
+				_cell.used = true;
+				++m_usedCells;
+				return i;
+			}
+			if (_Equal(_cell.key, _key))
+				return i;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::_Rehash(void)
+	{
+		Array<HashCell> _cells;
+		Swap(_cells, m_cells);
+		uint _count = 0;
+		for (const HashCell& _cell : _cells)
+		{
+			if (_cell.objects.NonEmpty())
+				++_count;
+		}
+
+		// the empty cells are dropped, the table grows if more than 1/4 of slots are occupied
+		uint _size = Max(FirstPow2((_count + 1) * 4), 64u);
+		m_cells.Resize(_size);
+		for (HashCell& _cell : m_cells)
+			_cell.used = false;
+		m_usedCells = _count;
+		uint _mask = _size - 1;
+		for (HashCell& _cell : _cells)
+		{
+			if (_cell.objects.IsEmpty())
+				continue;
+			uint i = _Hash(_cell.key) & _mask;
+			while (m_cells[i].used)
+				i = (i + 1) & _mask;
+			m_cells[i].key = _cell.key;
+			m_cells[i].used = true;
+			m_cells[i].objects = Move(_cell.objects);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::_Link(uint _id)
+	{
+		IntVector3 _mn = m_objects[_id].mn, _mx = m_objects[_id].mx, _key;
+		for (_key.z = _mn.z; _key.z <= _mx.z; ++_key.z)
+		{
+			for (_key.y = _mn.y; _key.y <= _mx.y; ++_key.y)
+			{
+				for (_key.x = _mn.x; _key.x <= _mx.x; ++_key.x)
+					m_cells[_AddCell(_key)].objects.Push(_id);
+			}
+		}
+	}
+	//----------------------------------------------------------------------------//
+	void SpatialHashGrid::_Unlink(uint _id)
+	{
+		IntVector3 _mn = m_objects[_id].mn, _mx = m_objects[_id].mx, _key;
+		for (_key.z = _mn.z; _key.z <= _mx.z; ++_key.z)
+		{
+			for (_key.y = _mn.y; _key.y <= _mx.y; ++_key.y)
+			{
+				for (_key.x = _mn.x; _key.x <= _mx.x; ++_key.x)
+				{
+					uint _slot = _FindCell(_key);
+					ASSERT(_slot != NONE);
+					m_cells[_slot].objects.FastRemove(_id);
+				}
+			}
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	//
+	//----------------------------------------------------------------------------//
+}
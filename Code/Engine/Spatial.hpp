@@ -0,0 +1,822 @@
+#pragma once
+
+#include "Math.hpp"
+#include "Container.hpp"
+
+namespace Reax
+{
+	//!\addtogroup Math
+	//!\{
+
+	//----------------------------------------------------------------------------//
+	// _TraversalStack
+	//----------------------------------------------------------------------------//
+
+	//! Stack of tree traversal. The local storage is enough for balanced trees, the heap is used only for very deep trees.
+	template <class T, uint N = 64> class _TraversalStack : public NonCopyable
+	{
+	public:
+		//!
+		_TraversalStack(void) = default;
+		//!
+		~_TraversalStack(void)
+		{
+			if (m_data != m_local)
+				Deallocate(m_data);
+		}
+		//!
+		void Push(const T& _value)
+		{
+			if (m_size == m_capacity)
+				_Grow();
+			m_data[m_size++] = _value;
+		}
+		//!
+		T Pop(void) { return m_data[--m_size]; }
+		//!
+		bool NonEmpty(void) const { return m_size != 0; }
+
+	protected:
+		//!
+		void _Grow(void)
+		{
+			T* _data = Allocate<T>(m_capacity * 2);
+			memcpy(_data, m_data, m_size * sizeof(T));
+			if (m_data != m_local)
+				Deallocate(m_data);
+			m_data = _data;
+			m_capacity *= 2;
+		}
+
+		T m_local[N];
+		T* m_data = m_local;
+		uint m_size = 0;
+		uint m_capacity = N;
+	};
+
+	//----------------------------------------------------------------------------//
+	// DbvNode
+	//----------------------------------------------------------------------------//
+
+	//! Null index of DbvTree.
+	static const uint DBV_NULL = (uint)-1;
+
+	//! Node of dynamic bounding volume tree. The bounds of nodes are stored in a separate array.
+	struct DbvNode
+	{
+		//!
+		bool IsLeaf(void) const { return child == DBV_NULL; }
+
+		uint parent; // next free pair in the free list
+		uint child; // the first child, the second child is next to it; DBV_NULL in the leaves
+		uint leaf; // id of the leaf
+		int height; // 0 in the leaves
+	};
+
+	//! Leaf of dynamic bounding volume tree.
+	struct DbvLeaf
+	{
+		uint node; // next free leaf in the free list
+		void* object;
+	};
+
+	//----------------------------------------------------------------------------//
+	// DbvTree
+	//----------------------------------------------------------------------------//
+
+	//! Method of bulk build of DbvTree.
+	enum class DbvBuildMethod
+	{
+		Lbvh30, //!< Linear BVH: objects are sorted by 30-bit Morton codes of centers. Fastest.
+		Lbvh63, //!< Linear BVH with 63-bit Morton codes, better for large scenes with many small objects.
+		BinnedSah, //!< Top-down build by surface area heuristic with binning. Slower, best for queries.
+	};
+
+	//! Dynamic bounding volume tree.
+	//! Leaves are inserted by the surface area heuristic, the tree is kept balanced and compact by rotations on the way up.
+	//! Nodes live in one array and are addressed by 32-bit indices: the root is the node 0, two children of a node are stored next to each other,
+	//! the bounds are kept in a separate array for traversal. Freed pairs of nodes are reused through a free list.
+	//! Leaves are addressed by stable ids which are not changed by rotations and Reorder.
+	//! The callbacks of queries return false to stop the query.
+	class RX_API DbvTree : public NonCopyable
+	{
+	public:
+		//! Leaves are enlarged by _margin, so small movements of objects do not change the tree.
+		DbvTree(float _margin = 0.1f);
+		//!
+		~DbvTree(void);
+
+		//! Remove all leaves. The memory is kept for reuse.
+		void Clear(void);
+		//! Add the object with the bounds. Returns id of the leaf.
+		uint Insert(const AlignedBox& _bounds, void* _object);
+		//! Remove the leaf.
+		void Remove(uint _leaf);
+		//! Move the leaf to new bounds. The leaf is reinserted only if _bounds is not in the enlarged bounds of the leaf,
+		//! then the bounds are also extended by _displacement (predicted movement). Returns true if the leaf was reinserted.
+		bool Update(uint _leaf, const AlignedBox& _bounds, const Vector3& _displacement = Vector3(0));
+		//! Replace the tree by a tree of _count objects built at once, much faster than insertion one by one.
+		//! The id of the leaf of i-th object is i. _objects may be null. The nodes are placed in depth-first order.
+		//! _threads is a number of threads including the calling thread, 0 to use all processors.
+		void Build(const AlignedBox* _bounds, uint _count, void* const* _objects = nullptr, DbvBuildMethod _method = DbvBuildMethod::BinnedSah, uint _threads = 0);
+		//!
+		void Build(const Array<AlignedBox>& _bounds, DbvBuildMethod _method = DbvBuildMethod::BinnedSah, uint _threads = 0) { Build(_bounds.Data(), _bounds.Size(), nullptr, _method, _threads); }
+		//! Place the nodes in depth-first order and release unused memory.
+		//! Insertions and removals scatter the nodes over the array, call it periodically (e.g. after many updates) to keep traversal cache-friendly.
+		void Reorder(void);
+
+		//! Index of the root node, DBV_NULL if the tree is empty.
+		uint Root(void) const { return m_root; }
+		//!
+		const DbvNode& Node(uint _node) const { return m_nodes[_node]; }
+		//!
+		const AlignedBox& Bounds(uint _node) const { return m_bounds[_node]; }
+		//!
+		void* Object(uint _leaf) const { return m_leaves[_leaf].object; }
+		//! Enlarged bounds of the leaf.
+		const AlignedBox& LeafBounds(uint _leaf) const { return m_bounds[m_leaves[_leaf].node]; }
+		//! Number of leaves.
+		uint Size(void) const { return m_size; }
+		//!
+		bool IsEmpty(void) const { return m_root == DBV_NULL; }
+		//!
+		int Height(void) const { return m_root != DBV_NULL ? m_nodes[m_root].height : 0; }
+		//!
+		float Margin(void) const { return m_margin; }
+		//! Sum of areas of internal nodes relative to the area of the root, less is better.
+		float Cost(void) const;
+
+		//! Find leaves intersecting the box. _callback(uint _leaf) -> bool.
+		template <class F> void Query(const AlignedBox& _box, F&& _callback) const
+		{
+			if (m_root == DBV_NULL)
+				return;
+			_TraversalStack<uint> _stack;
+			_stack.Push(m_root);
+			while (_stack.NonEmpty())
+			{
+				uint _node = _stack.Pop();
+				if (!m_bounds[_node].Intersects(_box))
+					continue;
+				const DbvNode& _n = m_nodes[_node];
+				if (_n.IsLeaf())
+				{
+					if (!_callback(_n.leaf))
+						return;
+				}
+				else
+				{
+					_stack.Push(_n.child + 1);
+					_stack.Push(_n.child);
+				}
+			}
+		}
+
+		//! Find leaves intersecting the frustum. _callback(uint _leaf) -> bool.
+		//! Planes that fully contain a node are not tested for its children, leaves of nodes inside the frustum are reported without tests.
+		//! The plane that rejected the previous node is tested first. \see Frustum
+		template <class F> void Query(const Frustum& _frustum, F&& _callback) const
+		{
+			if (m_root == DBV_NULL)
+				return;
+			struct Item { uint node; uint planes; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ m_root, FRUSTUM_ALL_PLANES });
+			uint _last = 0;
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				if (!_frustum.Intersects(m_bounds[_item.node], _item.planes, _last))
+					continue;
+				const DbvNode& _n = m_nodes[_item.node];
+				if (_n.IsLeaf())
+				{
+					if (!_callback(_n.leaf))
+						return;
+				}
+				else if (!_item.planes)
+				{
+					if (!_ForEachLeaf(_item.node, _callback))
+						return;
+				}
+				else
+				{
+					_stack.Push({ _n.child + 1, _item.planes });
+					_stack.Push({ _n.child, _item.planes });
+				}
+			}
+		}
+
+		//! Find leaves intersecting the ray in [0, _maxDist] (in units of the ray direction), the nearest nodes are visited first.
+		//! _callback(uint _leaf, float _maxDist) -> float returns new maximal distance: the distance of the hit to find the nearest hit,
+		//! _maxDist to find all hits, a negative value to stop.
+		template <class F> void RayCast(const PreparedRay& _ray, float _maxDist, F&& _callback) const
+		{
+			float _dist;
+			if (m_root == DBV_NULL || !_ray.Intersects(m_bounds[m_root], _maxDist, _dist))
+				return;
+			struct Item { uint node; float dist; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ m_root, _dist });
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				if (_item.dist > _maxDist)
+					continue;
+				const DbvNode& _n = m_nodes[_item.node];
+				if (_n.IsLeaf())
+				{
+					_maxDist = _callback(_n.leaf, _maxDist);
+					if (_maxDist < 0)
+						return;
+					continue;
+				}
+				uint _c0 = _n.child, _c1 = _n.child + 1;
+				float _d0, _d1;
+				bool _h0 = _ray.Intersects(m_bounds[_c0], _maxDist, _d0);
+				bool _h1 = _ray.Intersects(m_bounds[_c1], _maxDist, _d1);
+				if (_h0 && _h1)
+				{
+					if (_d0 > _d1)
+						Swap(_c0, _c1), Swap(_d0, _d1);
+					_stack.Push({ _c1, _d1 });
+					_stack.Push({ _c0, _d0 });
+				}
+				else if (_h0)
+					_stack.Push({ _c0, _d0 });
+				else if (_h1)
+					_stack.Push({ _c1, _d1 });
+			}
+		}
+
+		//! Find leaves intersecting rays of the packet in [0, _packet.maxDist], only rays of _rays mask are traced. A node is fetched once for all rays
+		//! intersecting it and the nearest of children is visited first. _callback(uint _leaf, uint _rays) -> bool, _rays is the mask of rays intersecting
+		//! bounds of the leaf. The callback can shorten _packet.maxDist of the rays (to the distance of the hit to find the nearest hits), returns false to stop.
+		template <uint N, class F> void RayCast(RayPacket<N>& _packet, F&& _callback, uint _rays = RayPacket<N>::ALL) const
+		{
+			float _dist;
+			if (m_root == DBV_NULL || !(_rays = _packet.Intersects(m_bounds[m_root], _rays, _dist)))
+				return;
+			struct Item { uint node; uint rays; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ m_root, _rays });
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				const DbvNode& _n = m_nodes[_item.node];
+				if (_n.IsLeaf())
+				{
+					// the rays could be shortened after the test of the parent
+					if ((_item.rays = _packet.Intersects(m_bounds[_item.node], _item.rays, _dist)) != 0 && !_callback(_n.leaf, _item.rays))
+						return;
+					continue;
+				}
+				uint _c0 = _n.child, _c1 = _n.child + 1;
+				float _d0, _d1;
+				uint _r0 = _packet.Intersects(m_bounds[_c0], _item.rays, _d0);
+				uint _r1 = _packet.Intersects(m_bounds[_c1], _item.rays, _d1);
+				if (_r0 && _r1 && _d0 > _d1)
+					Swap(_c0, _c1), Swap(_r0, _r1);
+				if (_r1)
+					_stack.Push({ _c1, _r1 });
+				if (_r0)
+					_stack.Push({ _c0, _r0 });
+			}
+		}
+
+		//! Find pairs of intersecting leaves. _callback(uint _a, uint _b) -> bool.
+		template <class F> void FindPairs(F&& _callback) const
+		{
+			if (m_root != DBV_NULL)
+				_FindPairs(*this, _callback);
+		}
+
+		//! Find pairs of intersecting leaves of this tree and _other tree. _callback(uint _a, uint _b) -> bool, _b is the leaf of _other.
+		template <class F> void FindPairs(const DbvTree& _other, F&& _callback) const
+		{
+			if (m_root != DBV_NULL && _other.m_root != DBV_NULL)
+				_FindPairs(_other, _callback);
+		}
+
+	protected:
+		//! Report all leaves of the node.
+		template <class F> bool _ForEachLeaf(uint _node, F& _callback) const
+		{
+			_TraversalStack<uint> _stack;
+			_stack.Push(_node);
+			while (_stack.NonEmpty())
+			{
+				const DbvNode& _n = m_nodes[_stack.Pop()];
+				if (_n.IsLeaf())
+				{
+					if (!_callback(_n.leaf))
+						return false;
+				}
+				else
+				{
+					_stack.Push(_n.child + 1);
+					_stack.Push(_n.child);
+				}
+			}
+			return true;
+		}
+
+		//! Find pairs of intersecting leaves of two trees, or in one tree if &_other == this.
+		template <class F> void _FindPairs(const DbvTree& _other, F& _callback) const
+		{
+			const bool _self = &_other == this;
+			struct Item { uint a, b; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ m_root, _other.m_root });
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				const DbvNode& _a = m_nodes[_item.a];
+				const DbvNode& _b = _other.m_nodes[_item.b];
+				if (_self && _item.a == _item.b)
+				{
+					if (!_a.IsLeaf())
+					{
+						_stack.Push({ _a.child, _a.child + 1 });
+						_stack.Push({ _a.child + 1, _a.child + 1 });
+						_stack.Push({ _a.child, _a.child });
+					}
+				}
+				else if (m_bounds[_item.a].Intersects(_other.m_bounds[_item.b]))
+				{
+					if (_a.IsLeaf() && _b.IsLeaf())
+					{
+						if (!_callback(_a.leaf, _b.leaf))
+							return;
+					}
+					else if (_b.IsLeaf() || (!_a.IsLeaf() && _a.height > _b.height)) // descend into the greater node
+					{
+						_stack.Push({ _a.child + 1, _item.b });
+						_stack.Push({ _a.child, _item.b });
+					}
+					else
+					{
+						_stack.Push({ _item.a, _b.child + 1 });
+						_stack.Push({ _item.a, _b.child });
+					}
+				}
+			}
+		}
+
+		//! Get a free pair of nodes.
+		uint _AllocPair(void);
+		//!
+		void _FreePair(uint _first);
+		//! Insert the leaf at the best place.
+		void _InsertLeaf(uint _leaf, const AlignedBox& _bounds);
+		//! Remove the leaf from hierarchy.
+		void _RemoveLeaf(uint _leaf);
+		//! Update bounds and heights from the node to the root and rotate the nodes.
+		void _Refit(uint _node);
+		//! Rotate the node to keep the tree balanced and compact.
+		void _Rotate(uint _node);
+		//! Update bounds and height of internal node from its children.
+		void _UpdateNode(uint _node);
+		//! Move a subtree to other place. The parent of the destination is kept.
+		void _Move(uint _src, uint _dst);
+		//! Exchange places of two subtrees.
+		void _Swap(uint _a, uint _b);
+		//! Update the references to the node from its children or its leaf.
+		void _Link(uint _node);
+
+		Array<DbvNode> m_nodes;
+		Array<AlignedBox> m_bounds;
+		Array<DbvLeaf> m_leaves;
+		uint m_root = DBV_NULL;
+		uint m_free = DBV_NULL;
+		uint m_freeLeaf = DBV_NULL;
+		uint m_size = 0;
+		float m_margin;
+	};
+
+	//----------------------------------------------------------------------------//
+	// WideBvh
+	//----------------------------------------------------------------------------//
+
+	//! Flag of leaf in WideBvhNode::child.
+	static const uint WIDE_BVH_LEAF = 0x80000000;
+
+	//! Node of WideBvh with up to four children. The bounds of children are stored by components to test all children at once.
+	struct WideBvhNode
+	{
+		float mnX[4], mnY[4], mnZ[4];
+		float mxX[4], mxY[4], mxZ[4];
+		uint child[4]; // index of node or id of leaf with WIDE_BVH_LEAF flag
+		uint count; // number of children, the unused slots are at the end
+	};
+
+	//! Static bounding volume hierarchy with four children in node, collapsed from DbvTree.
+	//! Each step of a query tests all children of a node with one sequence of SIMD instructions.
+	//! It is not updated with the source tree: build it again after changes. Queries report ids of leaves of the source tree.
+	//! The callbacks of queries return false to stop the query.
+	class RX_API WideBvh : public NonCopyable
+	{
+	public:
+		//!
+		WideBvh(void) = default;
+		//!
+		~WideBvh(void) = default;
+
+		//! Collapse the tree. The largest nodes are opened first to fill the children of a wide node.
+		void Build(const DbvTree& _tree);
+		//!
+		void Clear(void) { m_nodes.Clear(); }
+		//!
+		bool IsEmpty(void) const { return m_nodes.IsEmpty(); }
+		//! Number of nodes.
+		uint Size(void) const { return m_nodes.Size(); }
+		//! The root is the node 0.
+		const WideBvhNode& Node(uint _node) const { return m_nodes[_node]; }
+
+		//! Find leaves intersecting the box. _callback(uint _leaf) -> bool.
+		template <class F> void Query(const AlignedBox& _box, F&& _callback) const
+		{
+			if (m_nodes.IsEmpty())
+				return;
+			_V4 _mnX = _V4Splat(_box.mn.x), _mnY = _V4Splat(_box.mn.y), _mnZ = _V4Splat(_box.mn.z);
+			_V4 _mxX = _V4Splat(_box.mx.x), _mxY = _V4Splat(_box.mx.y), _mxZ = _V4Splat(_box.mx.z);
+			_TraversalStack<uint> _stack;
+			_stack.Push(0);
+			while (_stack.NonEmpty())
+			{
+				const WideBvhNode& _node = m_nodes[_stack.Pop()];
+				_V4 _out = _V4Or(_V4Or(
+					_V4Or(_V4Greater(_V4Load(_node.mnX), _mxX), _V4Greater(_mnX, _V4Load(_node.mxX))),
+					_V4Or(_V4Greater(_V4Load(_node.mnY), _mxY), _V4Greater(_mnY, _V4Load(_node.mxY)))),
+					_V4Or(_V4Greater(_V4Load(_node.mnZ), _mxZ), _V4Greater(_mnZ, _V4Load(_node.mxZ))));
+				for (uint _hits = ~_V4Mask(_out) & ((1 << _node.count) - 1); _hits; _hits &= _hits - 1)
+				{
+					uint _child = _node.child[RX_CTZ(_hits)];
+					if (!(_child & WIDE_BVH_LEAF))
+						_stack.Push(_child);
+					else if (!_callback(_child & ~WIDE_BVH_LEAF))
+						return;
+				}
+			}
+		}
+
+		//! Find leaves intersecting the frustum. _callback(uint _leaf) -> bool.
+		//! Planes that fully contain a child are not tested for its subtree, leaves of nodes inside the frustum are reported without tests.
+		template <class F> void Query(const Frustum& _frustum, F&& _callback) const
+		{
+			if (m_nodes.IsEmpty())
+				return;
+			struct Item { uint node; uint planes; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ 0, FRUSTUM_ALL_PLANES });
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				const WideBvhNode& _node = m_nodes[_item.node];
+				uint _visible = (1 << _node.count) - 1;
+				uint _planes[4] = { _item.planes, _item.planes, _item.planes, _item.planes };
+				for (uint i = 0; i < 6 && _visible; ++i)
+				{
+					if (!(_item.planes & (1 << i)))
+						continue;
+					// the corner of box farthest along the normal is tested for outside, the nearest corner for inside
+					const Plane& _plane = _frustum.planes[i];
+					_V4 _nx = _V4Splat(_plane.normal.x), _ny = _V4Splat(_plane.normal.y), _nz = _V4Splat(_plane.normal.z), _d = _V4Splat(_plane.dist);
+					const float* _farX = _plane.normal.x > 0 ? _node.mxX : _node.mnX;
+					const float* _farY = _plane.normal.y > 0 ? _node.mxY : _node.mnY;
+					const float* _farZ = _plane.normal.z > 0 ? _node.mxZ : _node.mnZ;
+					const float* _nearX = _plane.normal.x > 0 ? _node.mnX : _node.mxX;
+					const float* _nearY = _plane.normal.y > 0 ? _node.mnY : _node.mxY;
+					const float* _nearZ = _plane.normal.z > 0 ? _node.mnZ : _node.mxZ;
+					_V4 _far = _V4Add(_V4Add(_V4Mul(_nx, _V4Load(_farX)), _V4Mul(_ny, _V4Load(_farY))), _V4Add(_V4Mul(_nz, _V4Load(_farZ)), _d));
+					_V4 _near = _V4Add(_V4Add(_V4Mul(_nx, _V4Load(_nearX)), _V4Mul(_ny, _V4Load(_nearY))), _V4Add(_V4Mul(_nz, _V4Load(_nearZ)), _d));
+					_visible &= ~_V4Mask(_V4Less(_far, _V4Splat(0)));
+					for (uint _inside = _V4Mask(_V4Greater(_near, _V4Splat(0))) & _visible; _inside; _inside &= _inside - 1)
+						_planes[RX_CTZ(_inside)] &= ~(1 << i);
+				}
+				for (; _visible; _visible &= _visible - 1)
+				{
+					uint _index = RX_CTZ(_visible);
+					uint _child = _node.child[_index];
+					if (_child & WIDE_BVH_LEAF)
+					{
+						if (!_callback(_child & ~WIDE_BVH_LEAF))
+							return;
+					}
+					else if (!_planes[_index])
+					{
+						if (!_ForEachLeaf(_child, _callback))
+							return;
+					}
+					else
+						_stack.Push({ _child, _planes[_index] });
+				}
+			}
+		}
+
+		//! Find leaves intersecting the ray in [0, _maxDist] (in units of the ray direction), the nearest nodes are visited first.
+		//! _callback(uint _leaf, float _maxDist) -> float returns new maximal distance: the distance of the hit to find the nearest hit,
+		//! _maxDist to find all hits, a negative value to stop.
+		template <class F> void RayCast(const PreparedRay& _ray, float _maxDist, F&& _callback) const
+		{
+			if (m_nodes.IsEmpty())
+				return;
+			// the planes of the entry are chosen by the signs of the direction
+			const Vector3& _invDir = _ray.invDir;
+			bool _negX = _invDir.x < 0, _negY = _invDir.y < 0, _negZ = _invDir.z < 0;
+			_V4 _ox = _V4Splat(_ray.origin.x), _oy = _V4Splat(_ray.origin.y), _oz = _V4Splat(_ray.origin.z);
+			_V4 _ix = _V4Splat(_invDir.x), _iy = _V4Splat(_invDir.y), _iz = _V4Splat(_invDir.z);
+			struct Item { uint node; float dist; };
+			_TraversalStack<Item> _stack;
+			_stack.Push({ 0, 0 });
+			while (_stack.NonEmpty())
+			{
+				Item _item = _stack.Pop();
+				if (_item.dist > _maxDist)
+					continue;
+				if (_item.node & WIDE_BVH_LEAF)
+				{
+					_maxDist = _callback(_item.node & ~WIDE_BVH_LEAF, _maxDist);
+					if (_maxDist < 0)
+						return;
+					continue;
+				}
+
+				const WideBvhNode& _node = m_nodes[_item.node];
+				_V4 _nearX = _V4Mul(_V4Sub(_V4Load(_negX ? _node.mxX : _node.mnX), _ox), _ix);
+				_V4 _nearY = _V4Mul(_V4Sub(_V4Load(_negY ? _node.mxY : _node.mnY), _oy), _iy);
+				_V4 _nearZ = _V4Mul(_V4Sub(_V4Load(_negZ ? _node.mxZ : _node.mnZ), _oz), _iz);
+				_V4 _farX = _V4Mul(_V4Sub(_V4Load(_negX ? _node.mnX : _node.mxX), _ox), _ix);
+				_V4 _farY = _V4Mul(_V4Sub(_V4Load(_negY ? _node.mnY : _node.mxY), _oy), _iy);
+				_V4 _farZ = _V4Mul(_V4Sub(_V4Load(_negZ ? _node.mnZ : _node.mxZ), _oz), _iz);
+				_V4 _near = _V4Max(_V4Max(_nearX, _nearY), _V4Max(_nearZ, _V4Splat(0)));
+				_V4 _far = _V4Min(_V4Min(_farX, _farY), _V4Min(_farZ, _V4Splat(_maxDist)));
+				uint _hits = ~_V4Mask(_V4Greater(_near, _far)) & ((1 << _node.count) - 1);
+				if (!_hits)
+					continue;
+
+				// push the hits from far to near
+				RX_ALIGN(16) float _dist[4];
+				_V4Store(_dist, _near);
+				Item _items[4];
+				uint _num = 0;
+				for (; _hits; _hits &= _hits - 1)
+				{
+					uint _index = RX_CTZ(_hits);
+					Item _hit = { _node.child[_index], _dist[_index] };
+					uint j = _num++;
+					for (; j > 0 && _items[j - 1].dist < _hit.dist; --j)
+						_items[j] = _items[j - 1];
+					_items[j] = _hit;
+				}
+				for (uint i = 0; i < _num; ++i)
+					_stack.Push(_items[i]);
+			}
+		}
+
+	protected:
+		//! Report all leaves of the node.
+		template <class F> bool _ForEachLeaf(uint _node, F& _callback) const
+		{
+			_TraversalStack<uint> _stack;
+			_stack.Push(_node);
+			while (_stack.NonEmpty())
+			{
+				const WideBvhNode& _n = m_nodes[_stack.Pop()];
+				for (uint i = 0; i < _n.count; ++i)
+				{
+					if (!(_n.child[i] & WIDE_BVH_LEAF))
+						_stack.Push(_n.child[i]);
+					else if (!_callback(_n.child[i] & ~WIDE_BVH_LEAF))
+						return false;
+				}
+			}
+			return true;
+		}
+
+		Array<WideBvhNode> m_nodes;
+	};
+
+	//----------------------------------------------------------------------------//
+	// SpatialHashGrid
+	//----------------------------------------------------------------------------//
+
+	//! Uniform grid of cubic cells for many objects of similar size (particles, agents), an alternative to DbvTree without hierarchy to maintain.
+	//! An object is registered in all cells overlapped by its bounds, so movement inside the cells costs nothing and movement to other cells
+	//! relinks only this object. The best size of cell is about twice the size of typical object: smaller cells register objects
+	//! in more cells and find the same pairs in several cells, larger cells test more pairs.
+	//! Only cells with objects are stored, in a flat open-addressing table keyed by IntVector3 coordinates of cell (linear probing).
+	//! Each cell keeps ids of its objects in an array, emptied cells keep the memory until the table is rebuilt. Objects are addressed by stable ids.
+	//! An object overlapping several cells of a query (or shared by two objects) is reported only in the first of these cells.
+	//! The callbacks of queries return false to stop the query.
+	class RX_API SpatialHashGrid : public NonCopyable
+	{
+	public:
+		//!
+		SpatialHashGrid(float _cellSize = 1.0f);
+		//!
+		~SpatialHashGrid(void);
+
+		//! Remove all objects. The memory is kept for reuse.
+		void Clear(void);
+		//! Add the object with the bounds. Returns id of the object.
+		uint Insert(const AlignedBox& _bounds, void* _object);
+		//!
+		void Remove(uint _id);
+		//! Move the object to new bounds. Returns true if the object was moved to other cells.
+		bool Update(uint _id, const AlignedBox& _bounds);
+
+		//!
+		void* Object(uint _id) const { return m_objects[_id].object; }
+		//!
+		const AlignedBox& Bounds(uint _id) const { return m_objects[_id].bounds; }
+		//! Number of objects.
+		uint Size(void) const { return m_size; }
+		//!
+		bool IsEmpty(void) const { return m_size == 0; }
+		//!
+		float CellSize(void) const { return m_cellSize; }
+		//! Coordinates of the cell containing the point.
+		IntVector3 Cell(const Vector3& _point) const { return { { { (int)floorf(_point.x * m_invCellSize), (int)floorf(_point.y * m_invCellSize), (int)floorf(_point.z * m_invCellSize) } } }; }
+
+		//! Find objects intersecting the box. _callback(uint _id) -> bool.
+		template <class F> void Query(const AlignedBox& _box, F&& _callback) const
+		{
+			IntVector3 _mn = Cell(_box.mn), _mx = Cell(_box.mx);
+			_ForEachCell(_mn, _mx, [&](const HashCell& _cell)
+			{
+				for (uint _id : _cell.objects)
+				{
+					const HashObject& _obj = m_objects[_id];
+					if (_IsFirstCell(_cell.key, _obj.mn, _mn) && _obj.bounds.Intersects(_box) && !_callback(_id))
+						return false;
+				}
+				return true;
+			});
+		}
+
+		//! Find objects intersecting the sphere. _callback(uint _id) -> bool.
+		template <class F> void Query(const Sphere& _sphere, F&& _callback) const
+		{
+			Vector3 _radius(_sphere.radius);
+			IntVector3 _mn = Cell(_sphere.center - _radius), _mx = Cell(_sphere.center + _radius);
+			float _radiusSq = _sphere.radius * _sphere.radius;
+			_ForEachCell(_mn, _mx, [&](const HashCell& _cell)
+			{
+				for (uint _id : _cell.objects)
+				{
+					const HashObject& _obj = m_objects[_id];
+					if (_IsFirstCell(_cell.key, _obj.mn, _mn) && (_sphere.center - _sphere.center.Max(_obj.bounds.mn).Min(_obj.bounds.mx)).LengthSq() <= _radiusSq &&
+						!_callback(_id))
+						return false;
+				}
+				return true;
+			});
+		}
+
+		//! Find pairs of intersecting objects. _callback(uint _a, uint _b) -> bool, _a < _b.
+		template <class F> void FindPairs(F&& _callback) const { _FindPairs(0, m_cells.Size(), _callback); }
+
+		//! Find pairs of intersecting objects on _threads threads including the calling thread (0 to use all processors), the table of cells
+		//! is split between the threads. The pairs replace the content of _pairs, first < second. The order of pairs depends on the number of threads.
+		void FindPairs(Array<Pair<uint, uint>>& _pairs, uint _threads = 0) const;
+
+	protected:
+		//! Not found.
+		static const uint NONE = (uint)-1;
+
+		//!
+		struct HashObject
+		{
+			AlignedBox bounds;
+			IntVector3 mn, mx; // range of cells
+			void* object;
+			uint next; // free list
+		};
+		//! Slot of the table.
+		struct HashCell
+		{
+			IntVector3 key;
+			bool used;
+			Array<uint> objects;
+		};
+
+		//!
+		static uint _Hash(const IntVector3& _key) { return ((uint)_key.x * 73856093u) ^ ((uint)_key.y * 19349663u) ^ ((uint)_key.z * 83492791u); }
+		//!
+		static bool _Equal(const IntVector3& _a, const IntVector3& _b) { return _a.x == _b.x && _a.y == _b.y && _a.z == _b.z; }
+		//! The cell is the first cell of intersection of two ranges of cells.
+		static bool _IsFirstCell(const IntVector3& _cell, const IntVector3& _a, const IntVector3& _b)
+		{
+			return _cell.x == Max(_a.x, _b.x) && _cell.y == Max(_a.y, _b.y) && _cell.z == Max(_a.z, _b.z);
+		}
+
+		//! Index of the slot of the cell, NONE if the cell is not in the table.
+		uint _FindCell(const IntVector3& _key) const;
+		//! Index of the slot of the cell, the cell is added if it is not in the table.
+		uint _AddCell(const IntVector3& _key);
+		//! Rebuild the table without empty cells.
+		void _Rehash(void);
+		//! Add the object to its cells.
+		void _Link(uint _id);
+		//! Remove the object from its cells.
+		void _Unlink(uint _id);
+
+		//! Call _func(const HashCell&) -> bool for cells with objects in the range. The table is scanned if the range has more cells than the table.
+		template <class F> bool _ForEachCell(const IntVector3& _mn, const IntVector3& _mx, F&& _func) const
+		{
+			if (!m_size)
+				return true;
+			int64 _volume = ((int64)_mx.x - _mn.x + 1) * ((int64)_mx.y - _mn.y + 1) * ((int64)_mx.z - _mn.z + 1);
+			if (_volume > (int64)m_cells.Size())
+			{
+				for (const HashCell& _cell : m_cells)
+				{
+					if (_cell.objects.NonEmpty() && _cell.key.x >= _mn.x && _cell.key.y >= _mn.y && _cell.key.z >= _mn.z &&
+						_cell.key.x <= _mx.x && _cell.key.y <= _mx.y && _cell.key.z <= _mx.z && !_func(_cell))
+						return false;
+				}
+				return true;
+			}
+			IntVector3 _key;
+			for (_key.z = _mn.z; _key.z <= _mx.z; ++_key.z)
+			{
+				for (_key.y = _mn.y; _key.y <= _mx.y; ++_key.y)
+				{
+					for (_key.x = _mn.x; _key.x <= _mx.x; ++_key.x)
+					{
+						uint _slot = _FindCell(_key);
+						if (_slot != NONE && !_func(m_cells[_slot]))
+							return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		//! Find pairs in the slots [_begin, _end) of the table.
+		//! The bounds of objects of a cell are gathered to local arrays of coordinates first, then each object is tested with four others at once.
+		template <class F> bool _FindPairs(uint _begin, uint _end, F& _callback) const
+		{
+			Array<float> _coords;
+			Array<IntVector3> _cells;
+			for (uint _slot = _begin; _slot < _end; ++_slot)
+			{
+				const HashCell& _cell = m_cells[_slot];
+				uint _count = _cell.objects.Size();
+				if (_count < 2)
+					continue;
+				uint _stride = _count + 3; // the last group reads up to three values after the end
+				_coords.Resize(_stride * 6);
+				_cells.Resize(_count);
+				float* _c[6] = { _coords.Data(), _c[0] + _stride, _c[1] + _stride, _c[2] + _stride, _c[3] + _stride, _c[4] + _stride };
+				for (uint i = 0; i < _stride; ++i)
+				{
+					const HashObject& _obj = m_objects[_cell.objects[i < _count ? i : _count - 1]];
+					_c[0][i] = _obj.bounds.mn.x, _c[1][i] = _obj.bounds.mn.y, _c[2][i] = _obj.bounds.mn.z;
+					_c[3][i] = _obj.bounds.mx.x, _c[4][i] = _obj.bounds.mx.y, _c[5][i] = _obj.bounds.mx.z;
+					if (i < _count)
+						_cells[i] = _obj.mn;
+				}
+				for (uint i = 0; i < _count - 1; ++i)
+				{
+					_V4 _mnX = _V4Splat(_c[0][i]), _mnY = _V4Splat(_c[1][i]), _mnZ = _V4Splat(_c[2][i]);
+					_V4 _mxX = _V4Splat(_c[3][i]), _mxY = _V4Splat(_c[4][i]), _mxZ = _V4Splat(_c[5][i]);
+					uint _a = _cell.objects[i];
+					const IntVector3& _cellA = _cells[i];
+					for (uint j = i + 1; j < _count; j += 4)
+					{
+						_V4 _out = _V4Or(_V4Or(
+							_V4Or(_V4Greater(_mnX, _V4Load(_c[3] + j)), _V4Greater(_V4Load(_c[0] + j), _mxX)),
+							_V4Or(_V4Greater(_mnY, _V4Load(_c[4] + j)), _V4Greater(_V4Load(_c[1] + j), _mxY))),
+							_V4Or(_V4Greater(_mnZ, _V4Load(_c[5] + j)), _V4Greater(_V4Load(_c[2] + j), _mxZ)));
+						uint _hits = ~_V4Mask(_out) & 0xf;
+						if (_count - j < 4)
+							_hits &= (1 << (_count - j)) - 1;
+						for (; _hits; _hits &= _hits - 1)
+						{
+							uint _index = j + RX_CTZ(_hits), _b = _cell.objects[_index];
+							if (_IsFirstCell(_cell.key, _cellA, _cells[_index]) && !(_a < _b ? _callback(_a, _b) : _callback(_b, _a)))
+								return false;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		Array<HashObject> m_objects;
+		Array<HashCell> m_cells;
+		uint m_usedCells = 0; // used slots of the table including empty cells
+		uint m_freeObject = NONE;
+		uint m_size = 0;
+		float m_cellSize;
+		float m_invCellSize;
+	};
+
+	//----------------------------------------------------------------------------//
+	//
+	//----------------------------------------------------------------------------//
+
+	//!\} Math
+}
@@ -1,585 +1,3728 @@
 #include "String.hpp"
+#include "Concurrency.hpp"
+#include "Simd.hpp"
+#include <math.h>
+#include <errno.h>
+#ifdef _WIN32
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
 
 namespace Reax
 {
 	//----------------------------------------------------------------------------//
-	// String
+	// String utilities
 	//----------------------------------------------------------------------------//
 
-	const String String::Empty;
+	//! 65599^i mod 2^32. The hash is h = h * 65599 + c, so a block of n characters gives h * 65599^n + sum(c[i] * 65599^(n-1-i)),
+	//! where all multiplications are independent.
+	static const uint s_hashPow[17] =
+	{
+		0x00000001u, 0x0001003fu, 0x007e0f81u, 0x2e86d0bfu, 0x43ec5f01u, 0x162c613fu, 0xd62aee81u, 0xa311b1bfu, 0xd319be01u,
+		0xb156c23fu, 0x6698cd81u, 0x0d1b92bfu, 0xcc881d01u, 0x7280233fu, 0x50c7ac81u, 0x8da473bfu, 0x4f377c01u,
+	};
 
-	//----------------------------------------------------------------------------//
-	String::String(const char* _str1, int _length1, const char* _str2, int _length2)
+#ifdef RX_X86
+	//! Is initialized before main. Zero during static initialization of other modules, so they use SSE2 only.
+	static const bool s_hasAvx2 = GetCpuFeatures().avx2;
+#endif
+
+	//!
+	template <bool IgnoreCase> FORCEINLINE char _FoldCase(char _ch) { return IgnoreCase ? String::Lower(_ch) : _ch; }
+
+	//!
+	static FORCEINLINE uint _HashBlock16(const char* _str, uint _hash)
 	{
-		_length1 = Length(_str1, _length1);
-		_length2 = Length(_str2, _length2);
-		Reserve(_length1 + _length2);
-		Append(_str1, _length1);
-		Append(_str2, _length2);
+		uint _sum = 0;
+		for (uint i = 0; i < 16; ++i)
+			_sum += (uint)_str[i] * s_hashPow[15 - i];
+		return _hash * s_hashPow[16] + _sum;
 	}
-	//----------------------------------------------------------------------------//
-	String& String::operator = (const String& _rhs)
+
+#ifdef RX_SSE2
+	//! Mask of characters for which String::IsAlpha is true.
+	static FORCEINLINE __m128i _AlphaMask16(__m128i _v)
 	{
-		if (_rhs.m_data != m_data)
-		{
-			Reserve(_rhs.m_length);
-			memmove(m_data, _rhs.m_data, _rhs.m_length);
-			m_data[_rhs.m_length] = 0;
-			m_length = _rhs.m_length;
-		}
-		return *this;
+		__m128i _t = _mm_sub_epi8(_mm_or_si128(_v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')); // [A-Z, a-z] -> [0, 25]
+		__m128i _az = _mm_cmpeq_epi8(_mm_min_epu8(_t, _mm_set1_epi8(25)), _t);
+		__m128i _hi = _mm_cmpeq_epi8(_mm_max_epu8(_v, _mm_set1_epi8((char)0xc0)), _v); // >= 0xc0
+		return _mm_or_si128(_az, _hi);
 	}
-	//----------------------------------------------------------------------------//
-	String& String::operator = (String&& _rhs)
+	//! Same as String::Lower for each character.
+	static FORCEINLINE __m128i _Lower16(__m128i _v) { return _mm_or_si128(_v, _mm_and_si128(_AlphaMask16(_v), _mm_set1_epi8(0x20))); }
+	//! Same as String::Upper for each character.
+	static FORCEINLINE __m128i _Upper16(__m128i _v) { return _mm_andnot_si128(_mm_and_si128(_AlphaMask16(_v), _mm_set1_epi8(0x20)), _v); }
+	//!
+	template <bool IgnoreCase> FORCEINLINE __m128i _Load16(const char* _str)
 	{
-		Swap(m_length, _rhs.m_length);
-		Swap(m_capacity, _rhs.m_capacity);
-		Swap(m_data, _rhs.m_data);
-		return *this;
+		__m128i _v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_str));
+		return IgnoreCase ? _Lower16(_v) : _v;
 	}
-	//----------------------------------------------------------------------------//
-	String& String::operator = (const char* _str)
+	//! Can 16 bytes be read from the address without crossing a page boundary.
+	static FORCEINLINE bool _CanLoad16(const char* _str) { return ((size_t)_str & 4095) <= 4096 - 16; }
+#endif
+
+#ifdef RX_X86
+	//!
+	RX_TARGET("avx2") static inline __m256i _AlphaMask32(__m256i _v)
 	{
-		uint _length = Length(_str);
-		Reserve(_length);
-		memmove(m_data, _str, _length);
-		m_data[_length] = 0;
-		m_length = _length;
-		return *this;
+		__m256i _t = _mm256_sub_epi8(_mm256_or_si256(_v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+		__m256i _az = _mm256_cmpeq_epi8(_mm256_min_epu8(_t, _mm256_set1_epi8(25)), _t);
+		__m256i _hi = _mm256_cmpeq_epi8(_mm256_max_epu8(_v, _mm256_set1_epi8((char)0xc0)), _v);
+		return _mm256_or_si256(_az, _hi);
 	}
-	//----------------------------------------------------------------------------//
-	String& String::Reserve(uint _maxLength)
+	//!
+	template <bool IgnoreCase> RX_TARGET("avx2") static inline __m256i _Load32(const char* _str)
 	{
-		if (m_capacity < _maxLength)
+		__m256i _v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_str));
+		return IgnoreCase ? _mm256_or_si256(_v, _mm256_and_si256(_AlphaMask32(_v), _mm256_set1_epi8(0x20))) : _v;
+	}
+	//! \return end of processed part.
+	template <bool ToLower> RX_TARGET("avx2") static char* _ConvertCaseAvx2(char* _str, char* _end)
+	{
+		for (; _end - _str >= 32; _str += 32)
 		{
-			_maxLength = GrowTo(m_capacity, _maxLength) | 15;
-			char* _newData = Allocate<char>(_maxLength + 1);
-			memcpy(_newData, m_data, m_length);
-			_newData[m_length] = 0;
-			Deallocate(m_data);
-			m_data = _newData;
-			m_capacity = _maxLength;
+			__m256i _v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_str));
+			__m256i _m = _mm256_and_si256(_AlphaMask32(_v), _mm256_set1_epi8(0x20));
+			_v = ToLower ? _mm256_or_si256(_v, _m) : _mm256_andnot_si256(_m, _v);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(_str), _v);
 		}
-		return *this;
+		return _str;
 	}
-	//----------------------------------------------------------------------------//
-	String& String::Resize(uint _newLength, char _ch)
+#endif
+
+	//!
+	template <bool ToLower> static void _ConvertCase(char* _str, char* _end)
 	{
-		if (m_length < _newLength)
+#ifdef RX_X86
+		if (s_hasAvx2 && _end - _str >= 64)
+			_str = _ConvertCaseAvx2<ToLower>(_str, _end);
+#endif
+#ifdef RX_SSE2
+		for (; _end - _str >= 16; _str += 16)
 		{
-			Append(_newLength - m_length, _ch);
+			__m128i _v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_str));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_str), ToLower ? _Lower16(_v) : _Upper16(_v));
 		}
-		else if (m_length > _newLength)
+#endif
+		for (; _str < _end; ++_str)
+			*_str = ToLower ? String::Lower(*_str) : String::Upper(*_str);
+	}
+
+	//! Hash of range.
+	template <bool IgnoreCase> static uint _HashRange(const char* _str, const char* _end, uint _hash)
+	{
+		RX_ALIGN(16) char _block[16];
+		for (; _end - _str >= 16; _str += 16)
 		{
-			m_data[_newLength] = 0;
-			m_length = _newLength;
+			if (IgnoreCase)
+			{
+#ifdef RX_SSE2
+				_mm_store_si128(reinterpret_cast<__m128i*>(_block), _Load16<true>(_str));
+#else
+				for (uint i = 0; i < 16; ++i)
+					_block[i] = String::Lower(_str[i]);
+#endif
+				_hash = _HashBlock16(_block, _hash);
+			}
+			else
+				_hash = _HashBlock16(_str, _hash);
 		}
-		return *this;
+		for (; _str < _end; ++_str)
+			_hash = _FoldCase<IgnoreCase>(*_str) + (_hash << 6) + (_hash << 16) - _hash;
+		return _hash;
 	}
-	//----------------------------------------------------------------------------//
-	String& String::Append(const char* _str, int _length)
+
+	//! Hash of null-terminated string.
+	template <bool IgnoreCase> static uint _HashStr(const char* _str, uint _hash)
 	{
-		_length = Length(_str, _length);
-		if (_length)
+#ifdef RX_SSE2
+		RX_ALIGN(16) char _block[16];
+		for (;;)
 		{
-			uint _newLength = m_length + _length;
-			Reserve(_newLength);
-			memmove(m_data + m_length, _str, _length);
-			m_length = _newLength;
-			m_data[m_length] = 0;
+			if (!_CanLoad16(_str))
+			{
+				if (!*_str)
+					return _hash;
+				_hash = _FoldCase<IgnoreCase>(*_str++) + (_hash << 6) + (_hash << 16) - _hash;
+				continue;
+			}
+			__m128i _v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_str));
+			uint _zero = _mm_movemask_epi8(_mm_cmpeq_epi8(_v, _mm_setzero_si128()));
+			if (_zero)
+				return _HashRange<IgnoreCase>(_str, _str + RX_CTZ(_zero), _hash);
+			_mm_store_si128(reinterpret_cast<__m128i*>(_block), IgnoreCase ? _Lower16(_v) : _v);
+			_hash = _HashBlock16(_block, _hash);
+			_str += 16;
 		}
-		return *this;
+#else
+		return _HashRange<IgnoreCase>(_str, _str + strlen(_str), _hash);
+#endif
 	}
-	//----------------------------------------------------------------------------//
-	String& String::Append(char _ch)
+
+	//! Index of first different character or _length.
+	template <bool IgnoreCase> static uint _Mismatch(const char* _lhs, const char* _rhs, uint _length)
 	{
-		uint _newLength = m_length + 1;
-		Reserve(_newLength);
-		m_data[m_length] = _ch;
-		m_data[_newLength] = 0;
-		m_length = _newLength;
-		return *this;
+		uint i = 0;
+#ifdef RX_SSE2
+		for (; i + 16 <= _length; i += 16)
+		{
+			uint _neq = _mm_movemask_epi8(_mm_cmpeq_epi8(_Load16<IgnoreCase>(_lhs + i), _Load16<IgnoreCase>(_rhs + i))) ^ 0xffff;
+			if (_neq)
+				return i + RX_CTZ(_neq);
+		}
+#endif
+		while (i < _length && _FoldCase<IgnoreCase>(_lhs[i]) == _FoldCase<IgnoreCase>(_rhs[i]))
+			++i;
+		return i;
 	}
-	//----------------------------------------------------------------------------//
-	String& String::Append(uint _count, char _ch)
+
+	//! Compare ranges of equal length.
+	template <bool IgnoreCase> static int _CompareRange(const char* _lhs, const char* _rhs, uint _length)
 	{
-		uint _newLength = m_length + _count;
-		Reserve(_newLength);
-		memset(m_data + m_length, _ch, _count);
-		m_length = _newLength;
-		m_data[m_length] = 0;
-		return *this;
+		if (!IgnoreCase)
+			return _length ? memcmp(_lhs, _rhs, _length) : 0;
+		uint i = _Mismatch<true>(_lhs, _rhs, _length);
+		return i < _length ? (uint8)String::Lower(_lhs[i]) - (uint8)String::Lower(_rhs[i]) : 0;
 	}
-	//----------------------------------------------------------------------------//
-	String String::SubStr(uint _offset, int _length) const
+
+	//! Case-insensitive compare of null-terminated strings.
+	static int _CompareStrIgnoreCase(const char* _lhs, const char* _rhs)
 	{
-		if (_offset > m_length)
-			_offset = m_length;
-		if (_length < 0 || _offset + _length > m_length)
-			_length = m_length - _offset;
-		return String(m_data + _offset, _length);
+#ifdef RX_SSE2
+		for (;;)
+		{
+			if (_CanLoad16(_lhs) && _CanLoad16(_rhs))
+			{
+				__m128i _l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_lhs));
+				__m128i _r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_rhs));
+				uint _neq = _mm_movemask_epi8(_mm_cmpeq_epi8(_Lower16(_l), _Lower16(_r))) ^ 0xffff;
+				uint _zero = _mm_movemask_epi8(_mm_cmpeq_epi8(_l, _mm_setzero_si128()));
+				if (_neq | _zero)
+				{
+					uint i = RX_CTZ(_neq | _zero);
+					return (uint8)String::Lower(_lhs[i]) - (uint8)String::Lower(_rhs[i]);
+				}
+				_lhs += 16;
+				_rhs += 16;
+			}
+			else
+			{
+				int _d = (uint8)String::Lower(*_lhs) - (uint8)String::Lower(*_rhs);
+				if (_d || !*_lhs)
+					return _d;
+				++_lhs;
+				++_rhs;
+			}
+		}
+#else
+		for (;; ++_lhs, ++_rhs)
+		{
+			int _d = (uint8)String::Lower(*_lhs) - (uint8)String::Lower(*_rhs);
+			if (_d || !*_lhs)
+				return _d;
+		}
+#endif
 	}
-	//----------------------------------------------------------------------------//
-	uint String::Hash(const char* _str, uint _hash)
+
+#ifdef RX_X86
+	//! \return found position or nullptr, _pos is set to the first unchecked position.
+	template <bool IgnoreCase> RX_TARGET("avx2") static const char* _FindRangeAvx2(const char*& _pos, const char* _last, const char* _sub, uint _subLength)
 	{
-		if (_str) while (*_str)
-			_hash = *_str++ + (_hash << 6) + (_hash << 16) - _hash;
-		return _hash;
+		__m256i _first = _mm256_set1_epi8(_FoldCase<IgnoreCase>(_sub[0]));
+		__m256i _lastCh = _mm256_set1_epi8(_FoldCase<IgnoreCase>(_sub[_subLength - 1]));
+		uint _middle = _subLength > 2 ? _subLength - 2 : 0;
+		for (; _last - _pos >= 31; _pos += 32)
+		{
+			__m256i _a = _Load32<IgnoreCase>(_pos);
+			__m256i _b = _Load32<IgnoreCase>(_pos + _subLength - 1);
+			uint _mask = (uint)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(_a, _first), _mm256_cmpeq_epi8(_b, _lastCh)));
+			for (; _mask; _mask &= _mask - 1)
+			{
+				const char* _candidate = _pos + RX_CTZ(_mask);
+				if (_Mismatch<IgnoreCase>(_candidate + 1, _sub + 1, _middle) == _middle)
+					return _candidate;
+			}
+		}
+		return nullptr;
 	}
-	//----------------------------------------------------------------------------//
-	uint String::IHash(const char* _str, uint _hash)
+#endif
+
+	//! Search of substring. Compares first and last characters of the substring with 16 or 32 positions at once.
+	template <bool IgnoreCase> static const char* _FindRange(const char* _str, uint _length, const char* _sub, uint _subLength)
 	{
-		if (_str) while (*_str)
-			_hash = Lower(*_str++) + (_hash << 6) + (_hash << 16) - _hash;
-		return _hash;
+		if (_subLength > _length)
+			return nullptr;
+		if (!_subLength)
+			return _str;
+
+		const char* _pos = _str;
+		const char* _last = _str + (_length - _subLength); // last possible position
+		uint _middle = _subLength > 2 ? _subLength - 2 : 0;
+
+#ifdef RX_X86
+		if (s_hasAvx2)
+		{
+			const char* _found = _FindRangeAvx2<IgnoreCase>(_pos, _last, _sub, _subLength);
+			if (_found)
+				return _found;
+		}
+#endif
+#ifdef RX_SSE2
+		__m128i _first = _mm_set1_epi8(_FoldCase<IgnoreCase>(_sub[0]));
+		__m128i _lastCh = _mm_set1_epi8(_FoldCase<IgnoreCase>(_sub[_subLength - 1]));
+		for (; _last - _pos >= 15; _pos += 16)
+		{
+			__m128i _a = _Load16<IgnoreCase>(_pos);
+			__m128i _b = _Load16<IgnoreCase>(_pos + _subLength - 1);
+			uint _mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(_a, _first), _mm_cmpeq_epi8(_b, _lastCh)));
+			for (; _mask; _mask &= _mask - 1)
+			{
+				const char* _candidate = _pos + RX_CTZ(_mask);
+				if (_Mismatch<IgnoreCase>(_candidate + 1, _sub + 1, _middle) == _middle)
+					return _candidate;
+			}
+		}
+#endif
+		char _firstCh = _FoldCase<IgnoreCase>(_sub[0]);
+		for (; _pos <= _last; ++_pos)
+		{
+			if (_FoldCase<IgnoreCase>(*_pos) == _firstCh && _Mismatch<IgnoreCase>(_pos + 1, _sub + 1, _subLength - 1) == _subLength - 1)
+				return _pos;
+		}
+		return nullptr;
 	}
+
 	//----------------------------------------------------------------------------//
-	char* String::Lower(char* _str, int _length)
+	// Formatting utilities
+	//----------------------------------------------------------------------------//
+
+	//! Two-digit groups "00".."99". Halves the number of divisions.
+	static const char s_digitPairs[201] =
+		"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+		"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+	//! Write decimal digits of the value backward from _end. \return Number of digits.
+	static uint _UIntToStr(uint64 _value, char* _end)
 	{
-		ASSERT(_length < (int)Length(_str, _length));
-		for (const char* _end = _str + Length(_str, _length); _str < _end; ++_str)
-			*_str = Lower(*_str);
-		return _str;
+		char* _p = _end;
+		while (_value > 0xffffffffu) // 64-bit division is slow on 32-bit targets
+		{
+			uint _i = (uint)(_value % 100) << 1;
+			_value /= 100;
+			*--_p = s_digitPairs[_i + 1];
+			*--_p = s_digitPairs[_i];
+		}
+		uint _v = (uint)_value;
+		while (_v >= 100)
+		{
+			uint _i = (_v % 100) << 1;
+			_v /= 100;
+			*--_p = s_digitPairs[_i + 1];
+			*--_p = s_digitPairs[_i];
+		}
+		if (_v >= 10)
+		{
+			*--_p = s_digitPairs[(_v << 1) + 1];
+			*--_p = s_digitPairs[_v << 1];
+		}
+		else
+			*--_p = (char)('0' + _v);
+		return (uint)(_end - _p);
 	}
-	//----------------------------------------------------------------------------//
-	char* String::Upper(char* _str, int _length)
+
+	//! Write hexadecimal (_shift = 4) or octal (_shift = 3) digits of the value backward from _end. \return Number of digits.
+	static uint _UIntToStr(uint64 _value, char* _end, uint _shift, bool _upper)
 	{
-		ASSERT(_length < (int)Length(_str, _length));
-		for (const char* _end = _str + Length(_str, _length); _str < _end; ++_str)
-			*_str = Upper(*_str);
-		return _str;
+		const char* _digits = _upper ? "0123456789ABCDEF" : "0123456789abcdef";
+		const uint _mask = (1u << _shift) - 1;
+		char* _p = _end;
+		do
+		{
+			*--_p = _digits[_value & _mask];
+			_value >>= _shift;
+		} while (_value);
+		return (uint)(_end - _p);
 	}
-	//----------------------------------------------------------------------------//
-	int String::Compare(const char* _lhs, const char* _rhs, bool _ignoreCase)
+
+	//! Normalized 64-bit significands and binary exponents of 10^k, k = -348 + 8 * i.
+	static const uint64 s_cachedPowersF[87] =
 	{
-		_lhs = _lhs ? _lhs : "";
-		_rhs = _rhs ? _rhs : "";
-		if (_ignoreCase)
+		0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull, 0xcf42894a5dce35eaull,
+		0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull, 0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full,
+		0xbe5691ef416bd60cull, 0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+		0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull, 0xc21094364dfb5637ull,
+		0x9096ea6f3848984full, 0xd77485cb25823ac7ull, 0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull,
+		0xb23867fb2a35b28eull, 0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+		0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull, 0xb5b5ada8aaff80b8ull,
+		0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull, 0x964e858c91ba2655ull, 0xdff9772470297ebdull,
+		0xa6dfbd9fb8e5b88full, 0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+		0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull, 0xaa242499697392d3ull,
+		0xfd87b5f28300ca0eull, 0xbce5086492111aebull, 0x8cbccc096f5088ccull, 0xd1b71758e219652cull,
+		0x9c40000000000000ull, 0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+		0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull, 0x9f4f2726179a2245ull,
+		0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull, 0x83c7088e1aab65dbull, 0xc45d1df942711d9aull,
+		0x924d692ca61be758ull, 0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+		0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull, 0x952ab45cfa97a0b3ull,
+		0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull, 0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull,
+		0x88fcf317f22241e2ull, 0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+		0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull, 0x8bab8eefb6409c1aull,
+		0xd01fef10a657842cull, 0x9b10a4e5e9913129ull, 0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull,
+		0x80444b5e7aa7cf85ull, 0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+		0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+	};
+
+	//!
+	static const int16 s_cachedPowersE[87] =
+	{
+		-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927, -901, -874, -847, -821,
+		-794, -768, -741, -715, -688, -661, -635, -608, -582, -555, -529, -502, -475, -449, -422, -396,
+		-369, -343, -316, -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+		56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+		481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+		907, 933, 960, 986, 1013, 1039, 1066,
+	};
+
+	//!
+	static const uint64 s_pow10[20] =
+	{
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+		1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+		1000000000000000000ull, 10000000000000000000ull,
+	};
+
+	//! Floating point number with 64-bit significand: f * 2^e.
+	struct _DiyFp
+	{
+		uint64 f;
+		int e;
+	};
+
+	//! Upper 64 bits of the product, rounded.
+	static FORCEINLINE _DiyFp _Mul(_DiyFp _x, _DiyFp _y)
+	{
+		const uint64 _m32 = 0xffffffffu;
+		uint64 _a = _x.f >> 32, _b = _x.f & _m32, _c = _y.f >> 32, _d = _y.f & _m32;
+		uint64 _ac = _a * _c, _bc = _b * _c, _ad = _a * _d, _bd = _b * _d;
+		uint64 _tmp = (_bd >> 32) + (_ad & _m32) + (_bc & _m32) + (1u << 31);
+		return { _ac + (_ad >> 32) + (_bc >> 32) + (_tmp >> 32), _x.e + _y.e + 64 };
+	}
+
+	//!
+	static FORCEINLINE _DiyFp _Normalize(_DiyFp _x)
+	{
+		while (!(_x.f & (1ull << 63)))
 		{
-			while (*_lhs && Lower(*_lhs++) == Upper(*_rhs++));
-			return *_lhs - *_rhs;
+			_x.f <<= 1;
+			--_x.e;
 		}
-		return strcmp(_lhs, _rhs);
+		return _x;
 	}
-	//----------------------------------------------------------------------------//
-	String String::Format(const char* _fmt, ...)
+
+	//! Round the last digit towards the value and check that the result is shortest and correct. \see _Grisu3
+	static bool _RoundWeed(char* _digits, int _length, uint64 _distanceTooHighW, uint64 _unsafeInterval, uint64 _rest, uint64 _tenKappa, uint64 _unit)
 	{
-		va_list _args;
-		va_start(_args, _fmt);
-		String _str = FormatV(_fmt, _args);
-		va_end(_args);
-		return _str;
+		uint64 _smallDistance = _distanceTooHighW - _unit;
+		uint64 _bigDistance = _distanceTooHighW + _unit;
+		while (_rest < _smallDistance && _unsafeInterval - _rest >= _tenKappa && (_rest + _tenKappa < _smallDistance || _smallDistance - _rest >= _rest + _tenKappa - _smallDistance))
+		{
+			--_digits[_length - 1];
+			_rest += _tenKappa;
+		}
+		if (_rest < _bigDistance && _unsafeInterval - _rest >= _tenKappa && (_rest + _tenKappa < _bigDistance || _bigDistance - _rest > _rest + _tenKappa - _bigDistance))
+			return false;
+		return 2 * _unit <= _rest && _rest <= _unsafeInterval - 4 * _unit;
 	}
-	//----------------------------------------------------------------------------//
-	String String::FormatV(const char* _fmt, va_list _args)
+
+	//! Shortest decimal digits of f * 2^e that are read back to the same value (Grisu3, Florian Loitsch).
+	//! The value is digits * 10^_k. Fails for about 0.5% of values, when the 64-bit arithmetic is not precise enough to prove the result.
+	//!\param _lowerCloser the lower boundary is closer (the significand is a power of two).
+	//!\return Number of digits (at most 17) or 0 on failure.
+	static int _Grisu3(uint64 _f, int _e, bool _lowerCloser, char* _digits, int& _k)
 	{
-#if 0
-		char _buff[4096];
-		vsnprintf_s(_buff, sizeof(_buff), _fmt, _args);
-		return _buff;
-#else
-		//this code from ptypes: pputf.cxx
-		struct
+		// boundaries: the middles between the value and its neighbours
+		_DiyFp _mp = _Normalize({ (_f << 1) + 1, _e - 1 });
+		_DiyFp _mm = _lowerCloser ? _DiyFp{ (_f << 2) - 1, _e - 2 } : _DiyFp{ (_f << 1) - 1, _e - 1 };
+		_mm.f <<= _mm.e - _mp.e;
+		_mm.e = _mp.e;
+
+		// cached power that moves the binary exponent to [-60, -32]
+		double _dk = (-61 - _mp.e) * 0.30102999566398114 + 347;
+		int _ik = (int)_dk;
+		if (_dk - _ik > 0)
+			++_ik;
+		uint _index = (uint)((_ik >> 3) + 1);
+		_k = -(-348 + (int)(_index << 3));
+		_DiyFp _c = { s_cachedPowersF[_index], s_cachedPowersE[_index] };
+
+		// each product has an error of at most one unit
+		_DiyFp _w = _Mul(_Normalize({ _f, _e }), _c);
+		_DiyFp _high = _Mul(_mp, _c);
+		_DiyFp _low = _Mul(_mm, _c);
+		uint64 _unit = 1;
+		uint64 _tooHigh = _high.f + _unit;
+		uint64 _unsafeInterval = _tooHigh - (_low.f - _unit);
+		const int _shift = -_w.e;
+		const uint64 _one = 1ull << _shift;
+		uint _integrals = (uint)(_tooHigh >> _shift);
+		uint64 _fractionals = _tooHigh & (_one - 1);
+
+		int _kappa = 10;
+		while (_kappa > 1 && _integrals < s_pow10[_kappa - 1])
+			--_kappa;
+
+		int _length = 0;
+		while (_kappa > 0)
 		{
-			bool operator () (char _ch) const
+			uint _divisor = (uint)s_pow10[_kappa - 1];
+			_digits[_length++] = (char)('0' + _integrals / _divisor);
+			_integrals %= _divisor;
+			--_kappa;
+			uint64 _rest = ((uint64)_integrals << _shift) + _fractionals;
+			if (_rest < _unsafeInterval)
 			{
-				return strchr(" #+-~.0123456789", _ch) != 0;
+				_k += _kappa;
+				return _RoundWeed(_digits, _length, _tooHigh - _w.f, _unsafeInterval, _rest, (uint64)_divisor << _shift, _unit) ? _length : 0;
 			}
-		} _check_fmtopts;
-		enum fmt_type_t { FMT_NONE, FMT_CHAR, FMT_SHORT, FMT_INT, FMT_LONG, FMT_LARGE, FMT_STR, FMT_PTR, FMT_DOUBLE, FMT_LONG_DOUBLE };
-
-		String _res;
-		fmt_type_t fmt_type;
-		const char *e, *p = _fmt;
-		char buf[4096], fbuf[128];
-		while (p && *p != 0)
+		}
+		for (;;)
 		{
-			// write out raw data between format specifiers
-			e = strchr(p, '%');
-			if (e == 0)
-				e = p + strlen(p);
-			if (e > p)
-				_res.Append(p, e);
-			if (*e != '%')
-				break;
-			if (*++e == '%') // write out a single '%' 
+			_fractionals *= 10;
+			_unit *= 10;
+			_unsafeInterval *= 10;
+			_digits[_length++] = (char)('0' + (_fractionals >> _shift));
+			_fractionals &= _one - 1;
+			--_kappa;
+			if (_fractionals < _unsafeInterval)
 			{
-				_res += '%';
-				p = e + 1;
-				continue;
+				_k += _kappa;
+				return _RoundWeed(_digits, _length, (_tooHigh - _w.f) * _unit, _unsafeInterval, _fractionals, _one, _unit) ? _length : 0;
 			}
+		}
+	}
 
+	//! Shortest digits by the C runtime. Slow, used when Grisu3 fails.
+	template <class T> static int _ShortestDigitsSlow(T _value, char* _digits, int& _k)
+	{
+		char _buff[32];
+		for (int _precision = 0;; ++_precision)
+		{
+			snprintf(_buff, sizeof(_buff), "%.*e", _precision, (double)_value);
+			if ((T)strtod(_buff, nullptr) == _value || _precision >= 16)
+				break;
+		}
+		int _length = 0;
+		const char* _p = _buff;
+		for (; *_p != 'e'; ++_p)
+		{
+			if (*_p != '.')
+				_digits[_length++] = *_p;
+		}
+		_k = atoi(_p + 1) - (_length - 1);
+		while (_length > 1 && _digits[_length - 1] == '0')
+			--_length, ++_k;
+		return _length;
+	}
 
-			// build a temporary buffer for the conversion specification
-			fbuf[0] = '%';
-			char* f = fbuf + 1;
-			bool modif = false;
+	//! Shortest digits of a finite positive double. \see _Grisu3
+	static int _ShortestDigits(double _value, char* _digits, int& _k)
+	{
+		union { double f; uint64 u; } _v = { _value };
+		uint64 _m = _v.u & 0x000fffffffffffffull;
+		int _e = (int)((_v.u >> 52) & 0x7ff);
+		int _length = _e ? _Grisu3(_m | 0x0010000000000000ull, _e - 1075, !_m && _e > 1, _digits, _k) : _Grisu3(_m, -1074, false, _digits, _k);
+		return _length ? _length : _ShortestDigitsSlow(_value, _digits, _k);
+	}
 
-			// formatting flags and width specifiers
-			while (_check_fmtopts(*e) && uint(f - fbuf) < sizeof(fbuf) - 5)
-				*f++ = *e++, modif = true;
+	//! Shortest digits of a finite positive float. The boundaries of float are used, so 0.1f is written as "0.1".
+	static int _ShortestDigits(float _value, char* _digits, int& _k)
+	{
+		union { float f; uint u; } _v = { _value };
+		uint _m = _v.u & 0x007fffff;
+		int _e = (int)((_v.u >> 23) & 0xff);
+		int _length = _e ? _Grisu3(_m | 0x00800000, _e - 150, !_m && _e > 1, _digits, _k) : _Grisu3(_m, -149, false, _digits, _k);
+		return _length ? _length : _ShortestDigitsSlow(_value, _digits, _k);
+	}
 
-			// prefixes
-			switch (*e)
+	//! Output of the formatting. Counts all characters, but writes only those that fit into the buffer.
+	struct _FormatOutput
+	{
+		char* buffer;
+		uint size;
+		uint length;
+
+		FORCEINLINE void Put(char _ch)
+		{
+			if (length < size)
+				buffer[length] = _ch;
+			++length;
+		}
+		void Put(const char* _str, uint _length)
+		{
+			if (length < size && _length)
+				memcpy(buffer + length, _str, size - length < _length ? size - length : _length);
+			length += _length;
+		}
+		void Fill(char _ch, uint _count)
+		{
+			if (length < size)
+				memset(buffer + length, _ch, size - length < _count ? size - length : _count);
+			length += _count;
+		}
+	};
+
+	//! Parsed format specifier.
+	struct _FormatSpec
+	{
+		bool left = false;
+		bool plus = false;
+		bool space = false;
+		bool alt = false;
+		bool zero = false;
+		uint width = 0;
+		int precision = -1;
+		char conversion = 0;
+	};
+
+	//! Write [padding][prefix][zeros][body][padding].
+	static void _FormatPadded(_FormatOutput& _out, const _FormatSpec& _spec, const char* _prefix, uint _prefixLength, uint _zeros, const char* _body, uint _bodyLength, bool _zeroPad)
+	{
+		uint _length = _prefixLength + _zeros + _bodyLength;
+		uint _padding = _spec.width > _length ? _spec.width - _length : 0;
+		if (_spec.zero && _zeroPad && !_spec.left)
+			_zeros += _padding, _padding = 0;
+		if (!_spec.left)
+			_out.Fill(' ', _padding);
+		_out.Put(_prefix, _prefixLength);
+		_out.Fill('0', _zeros);
+		_out.Put(_body, _bodyLength);
+		if (_spec.left)
+			_out.Fill(' ', _padding);
+	}
+
+	//!
+	static void _FormatInt(_FormatOutput& _out, const _FormatSpec& _spec, uint64 _value, bool _negative)
+	{
+		char _buff[32];
+		char* _end = _buff + sizeof(_buff);
+		char _prefix[2];
+		uint _prefixLength = 0;
+		uint _length;
+
+		switch (_spec.conversion)
+		{
+		case 'x':
+		case 'X':
+			_length = _UIntToStr(_value, _end, 4, _spec.conversion == 'X');
+			if (_spec.alt && _value)
+				_prefix[0] = '0', _prefix[1] = _spec.conversion, _prefixLength = 2;
+			break;
+		case 'o':
+			_length = _UIntToStr(_value, _end, 3, false);
+			if (_spec.alt && _value)
+				_prefix[0] = '0', _prefixLength = 1;
+			break;
+		default:
+			_length = _UIntToStr(_value, _end);
+			if (_negative)
+				_prefix[0] = '-', _prefixLength = 1;
+			else if (_spec.plus)
+				_prefix[0] = '+', _prefixLength = 1;
+			else if (_spec.space)
+				_prefix[0] = ' ', _prefixLength = 1;
+			break;
+		}
+
+		uint _zeros = 0;
+		if (_spec.precision >= 0)
+		{
+			if (_spec.precision == 0 && !_value)
+				_length = 0;
+			if ((uint)_spec.precision > _length)
+				_zeros = _spec.precision - _length;
+		}
+		_FormatPadded(_out, _spec, _prefix, _prefixLength, _zeros, _end - _length, _length, _spec.precision < 0);
+	}
+
+	//! Write the shortest digits in fixed ('f'), exponential ('e') or general ('g') notation. \return Length of the text.
+	static uint _FormatDigits(char* _dst, const char* _digits, int _length, int _k, char _notation, bool _upper)
+	{
+		char* _p = _dst;
+		int _kk = _length + _k; // 10^(kk-1) <= value < 10^kk
+		if (_notation == 'g')
+			_notation = (_kk > -6 && _kk <= 21) ? 'f' : 'e';
+
+		if (_notation == 'f')
+		{
+			if (_k >= 0) // 1234e7 -> 12340000000
+			{
+				memcpy(_p, _digits, _length);
+				memset(_p + _length, '0', _k);
+				_p += _kk;
+			}
+			else if (_kk > 0) // 1234e-2 -> 12.34
+			{
+				memcpy(_p, _digits, _kk);
+				_p[_kk] = '.';
+				memcpy(_p + _kk + 1, _digits + _kk, _length - _kk);
+				_p += _length + 1;
+			}
+			else // 1234e-6 -> 0.001234
+			{
+				*_p++ = '0';
+				*_p++ = '.';
+				memset(_p, '0', -_kk);
+				memcpy(_p - _kk, _digits, _length);
+				_p += _length - _kk;
+			}
+		}
+		else // 1234e30 -> 1.234e+33
+		{
+			*_p++ = _digits[0];
+			if (_length > 1)
+			{
+				*_p++ = '.';
+				memcpy(_p, _digits + 1, _length - 1);
+				_p += _length - 1;
+			}
+			*_p++ = _upper ? 'E' : 'e';
+			int _exp = _kk - 1;
+			*_p++ = _exp < 0 ? '-' : '+';
+			_exp = _exp < 0 ? -_exp : _exp;
+			if (_exp < 10)
+				*_p++ = '0';
+			char _buff[8];
+			uint _n = _UIntToStr((uint)_exp, _buff + sizeof(_buff));
+			memcpy(_p, _buff + sizeof(_buff) - _n, _n);
+			_p += _n;
+		}
+		return (uint)(_p - _dst);
+	}
+
+	//!
+	template <class T> static void _FormatFloat(_FormatOutput& _out, const _FormatSpec& _spec, T _value)
+	{
+		char _conv = _spec.conversion;
+		bool _upper = _conv == 'F' || _conv == 'E' || _conv == 'G';
+		char _notation = _conv | 0x20;
+		if (_notation != 'f' && _notation != 'e')
+			_notation = 'g';
+
+		char _prefix = 0;
+		if (signbit(_value))
+			_prefix = '-', _value = -_value;
+		else if (_spec.plus)
+			_prefix = '+';
+		else if (_spec.space)
+			_prefix = ' ';
+
+		char _buff[512];
+		uint _length;
+		bool _zeroPad = true;
+		if (isnan(_value) || isinf(_value))
+		{
+			memcpy(_buff, isnan(_value) ? (_upper ? "NAN" : "nan") : (_upper ? "INF" : "inf"), 3);
+			_length = 3;
+			_zeroPad = false;
+		}
+		else if (_spec.precision >= 0)
+		{
+			// exact rounding to the given number of digits requires big numbers, the C runtime does it well
+			char _fmt[8], *_f = _fmt;
+			*_f++ = '%';
+			if (_spec.alt)
+				*_f++ = '#';
+			*_f++ = '.';
+			*_f++ = '*';
+			*_f++ = _notation == 'g' ? 'g' : _notation;
+			*_f = 0;
+			int _r = snprintf(_buff, sizeof(_buff), _fmt, _spec.precision < 100 ? _spec.precision : 100, (double)_value);
+			_length = _r > 0 ? (uint)(_r < (int)sizeof(_buff) ? _r : sizeof(_buff) - 1) : 0;
+			if (_upper)
+				String::Upper(_buff, _length);
+		}
+		else if (_value == 0)
+		{
+			_length = _FormatDigits(_buff, "0", 1, 0, _notation, _upper);
+		}
+		else
+		{
+			char _digits[20];
+			int _k;
+			int _n = _ShortestDigits(_value, _digits, _k);
+			_length = _FormatDigits(_buff, _digits, _n, _k, _notation, _upper);
+		}
+
+		_FormatPadded(_out, _spec, &_prefix, _prefix ? 1 : 0, 0, _buff, _length, _zeroPad);
+	}
+
+	//!
+	static void _FormatString(_FormatOutput& _out, const _FormatSpec& _spec, const char* _str, uint _length)
+	{
+		if (_spec.precision >= 0 && (uint)_spec.precision < _length)
+			_length = _spec.precision;
+		_FormatPadded(_out, _spec, nullptr, 0, 0, _str, _length, false);
+	}
+
+	//!
+	static void _FormatArg(_FormatOutput& _out, const _FormatSpec& _spec, const FormatArg& _arg)
+	{
+		switch (_arg.GetType())
+		{
+		case FormatArg::T_None:
+			break;
+
+		case FormatArg::T_Bool:
+			if (_spec.conversion && strchr("diuxXoc", _spec.conversion))
+				_FormatInt(_out, _spec, _arg.UInt(), false);
+			else
+				_FormatString(_out, _spec, _arg.UInt() ? "true" : "false", _arg.UInt() ? 4 : 5);
+			break;
+
+		case FormatArg::T_Char:
+			if (_spec.conversion && strchr("diuxXo", _spec.conversion))
+				_FormatInt(_out, _spec, _arg.UInt(), false);
+			else
+			{
+				char _ch = (char)_arg.UInt();
+				_FormatString(_out, _spec, &_ch, 1);
+			}
+			break;
+
+		case FormatArg::T_Int:
+		case FormatArg::T_UInt:
+		{
+			bool _negative = _arg.GetType() == FormatArg::T_Int && _arg.Int() < 0;
+			uint64 _value = _negative ? 0 - _arg.UInt() : _arg.UInt();
+			if (_spec.conversion == 'c')
+			{
+				char _ch = (char)_arg.UInt();
+				_FormatString(_out, _spec, &_ch, 1);
+			}
+			else if (_spec.conversion && strchr("fFeEgG", _spec.conversion))
+				_FormatFloat(_out, _spec, _arg.GetType() == FormatArg::T_Int ? (double)_arg.Int() : (double)_arg.UInt());
+			else
+				_FormatInt(_out, _spec, _value, _negative);
+		} break;
+
+		case FormatArg::T_Float:
+			_FormatFloat(_out, _spec, _arg.Float());
+			break;
+
+		case FormatArg::T_Double:
+			_FormatFloat(_out, _spec, _arg.Double());
+			break;
+
+		case FormatArg::T_String:
+			if (_arg.Str())
+				_FormatString(_out, _spec, _arg.Str(), _arg.StrLength());
+			else
+				_FormatString(_out, _spec, "", 0);
+			break;
+
+		case FormatArg::T_Pointer:
+		{
+			_FormatSpec _hex = _spec;
+			_hex.conversion = 'x';
+			_hex.alt = true;
+			_hex.plus = _hex.space = false;
+			_FormatInt(_out, _hex, (uint64)(size_t)_arg.Ptr(), false);
+		} break;
+		}
+	}
+
+	//! Take the integer argument of '*' width or precision. Not integer arguments are read as zero.
+	static int64 _FormatStarArg(const FormatArg*& _args, uint& _numArgs)
+	{
+		if (!_numArgs)
+			return 0;
+		const FormatArg& _arg = *_args++;
+		--_numArgs;
+		switch (_arg.GetType())
+		{
+		case FormatArg::T_Int:
+			return _arg.Int();
+		case FormatArg::T_UInt:
+		case FormatArg::T_Bool:
+		case FormatArg::T_Char:
+			return (int64)_arg.UInt();
+		default:
+			return 0;
+		}
+	}
+
+	//! Interpreter of the format. Writes text between specifiers with one copy and formats the arguments without intermediate buffers.
+	static void _Format(_FormatOutput& _out, const char* _fmt, const FormatArg* _args, uint _numArgs)
+	{
+		static const FormatArg _none;
+		const char* _p = _fmt ? _fmt : "";
+		for (;;)
+		{
+			const char* _start = _p;
+			while (*_p && *_p != '%')
+				++_p;
+			_out.Put(_start, (uint)(_p - _start));
+			if (!*_p)
+				break;
+			if (*++_p == '%')
+			{
+				_out.Put('%');
+				++_p;
+				continue;
+			}
+
+			_FormatSpec _spec;
+			for (;; ++_p)
+			{
+				if (*_p == '-')
+					_spec.left = true;
+				else if (*_p == '+')
+					_spec.plus = true;
+				else if (*_p == ' ')
+					_spec.space = true;
+				else if (*_p == '#')
+					_spec.alt = true;
+				else if (*_p == '0')
+					_spec.zero = true;
+				else
+					break;
+			}
+			if (*_p == '*')
+			{
+				int64 _width = _FormatStarArg(_args, _numArgs);
+				if (_width < 0)
+					_spec.left = true, _width = -_width;
+				_spec.width = (uint)(_width < 0x7fffffff ? _width : 0x7fffffff);
+				++_p;
+			}
+			else
+			{
+				while (*_p >= '0' && *_p <= '9')
+					_spec.width = _spec.width * 10 + (*_p++ - '0');
+			}
+			if (*_p == '.')
+			{
+				_spec.precision = 0;
+				if (*++_p == '*')
+				{
+					int64 _precision = _FormatStarArg(_args, _numArgs);
+					_spec.precision = _precision < 0 ? -1 : (int)(_precision < 0x7fffffff ? _precision : 0x7fffffff);
+					++_p;
+				}
+				else
+				{
+					for (; *_p >= '0' && *_p <= '9'; ++_p)
+						_spec.precision = _spec.precision * 10 + (*_p - '0');
+				}
+			}
+			while (*_p == 'h' || *_p == 'l' || *_p == 'L' || *_p == 'z' || *_p == 'j' || *_p == 't' || *_p == 'q' || *_p == 'I') // length modifiers
+			{
+				if (_p[0] == 'I' && ((_p[1] == '6' && _p[2] == '4') || (_p[1] == '3' && _p[2] == '2')))
+					_p += 2;
+				++_p;
+			}
+			if (*_p)
+				_spec.conversion = *_p++;
+
+			_FormatArg(_out, _spec, _numArgs ? *_args : _none);
+			if (_numArgs)
+				++_args, --_numArgs;
+		}
+	}
+
+	//----------------------------------------------------------------------------//
+	// Number conversion
+	//----------------------------------------------------------------------------//
+
+	//! Number of leading zero bits. \note _x must be non-zero.
+	static FORCEINLINE uint _LeadingZeros(uint64 _x)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long _index;
+		_BitScanReverse64(&_index, _x);
+		return 63 - (uint)_index;
+#elif defined(_MSC_VER)
+		unsigned long _index;
+		if (_BitScanReverse(&_index, (uint)(_x >> 32)))
+			return 31 - (uint)_index;
+		_BitScanReverse(&_index, (uint)_x);
+		return 63 - (uint)_index;
+#else
+		return (uint)__builtin_clzll(_x);
+#endif
+	}
+
+	//! Full 128-bit product. \return Lower 64 bits.
+	static FORCEINLINE uint64 _Mul128(uint64 _x, uint64 _y, uint64& _high)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		return _umul128(_x, _y, &_high);
+#elif defined(__SIZEOF_INT128__)
+		unsigned __int128 _r = (unsigned __int128)_x * _y;
+		_high = (uint64)(_r >> 64);
+		return (uint64)_r;
+#else
+		const uint64 _m32 = 0xffffffffu;
+		uint64 _a = _x >> 32, _b = _x & _m32, _c = _y >> 32, _d = _y & _m32;
+		uint64 _ac = _a * _c, _bc = _b * _c, _ad = _a * _d, _bd = _b * _d;
+		uint64 _mid = (_bd >> 32) + (_ad & _m32) + (_bc & _m32);
+		_high = _ac + (_ad >> 32) + (_bc >> 32) + (_mid >> 32);
+		return (_mid << 32) | (_bd & _m32);
+#endif
+	}
+
+	//! Number of decimal digits.
+	static FORCEINLINE uint _DecimalLength(uint64 _value)
+	{
+		_value |= 1;
+		uint _n = ((64 - _LeadingZeros(_value)) * 1233) >> 12; // log10(2) ~ 1233 / 4096
+		return _n + (_value >= s_pow10[_n] ? 1 : 0);
+	}
+
+	//! Eight digits are loaded as one little-endian word.
+	static FORCEINLINE uint64 _LoadEightChars(const char* _str)
+	{
+		uint64 _v;
+		memcpy(&_v, _str, 8);
+		return _v;
+	}
+
+	//! Check that all eight chars are digits without branches.
+	static FORCEINLINE bool _IsEightDigits(uint64 _v)
+	{
+		return (((_v + 0x4646464646464646ull) | (_v - 0x3030303030303030ull)) & 0x8080808080808080ull) == 0;
+	}
+
+	//! Value of eight digits by three multiplications (SWAR).
+	static FORCEINLINE uint _ParseEightDigits(uint64 _v)
+	{
+		_v -= 0x3030303030303030ull;
+		_v = (_v * 10) + (_v >> 8);
+		_v = (((_v & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) + (((_v >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+		return (uint)_v;
+	}
+
+	//! Parse decimal digits, at most 20. \return Pointer past the digits or nullptr on overflow.
+	static const char* _ParseUInt(const char* _str, const char* _end, uint64& _value)
+	{
+		while (_str < _end && *_str == '0')
+			++_str;
+
+		// 19 digits always fit
+		const char* _limit = _end - _str > 19 ? _str + 19 : _end;
+		uint64 _v = 0;
+		while (_limit - _str >= 8 && _IsEightDigits(_LoadEightChars(_str)))
+		{
+			_v = _v * 100000000 + _ParseEightDigits(_LoadEightChars(_str));
+			_str += 8;
+		}
+		while (_str < _limit && (uint8)(*_str - '0') < 10)
+			_v = _v * 10 + (*_str++ - '0');
+
+		if (_str < _end && (uint8)(*_str - '0') < 10) // 20th digit
+		{
+			uint _d = *_str++ - '0';
+			if (_v > 1844674407370955161ull || (_v == 1844674407370955161ull && _d > 5) || (_str < _end && (uint8)(*_str - '0') < 10))
+				return nullptr;
+			_v = _v * 10 + _d;
+		}
+		_value = _v;
+		return _str;
+	}
+
+	//! Rounded powers of five: 128-bit significands of 5^q, q = -342..308. The significands of negative powers are rounded up.
+	//! Generated by script from "fast_float" (Daniel Lemire).
+	static const uint64 s_powersOfFive[651 * 2] =
+	{
+		0xeef453d6923bd65aull, 0x113faa2906a13b3full, 0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull,
+		0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull, 0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull,
+		0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull, 0xb64ec836a47146f9ull, 0x9748e2826cdee284ull,
+		0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull, 0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull,
+		0xb208ef855c969f4full, 0xbdbd2d335e51a935ull, 0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull,
+		0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull, 0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull,
+		0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull, 0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull,
+		0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull, 0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull,
+		0x84a57695fe98746dull, 0x014bb630f7604b57ull, 0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull,
+		0xcf42894a5dce35eaull, 0x52064cac828675b9ull, 0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull,
+		0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull, 0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull,
+		0xfd00b897478238d0ull, 0x8920b098955522b4ull, 0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull,
+		0xc5a890362fddbc62ull, 0xeb2189f734aa831dull, 0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull,
+		0x9a6bb0aa55653b2dull, 0x47b233c92125366eull, 0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull,
+		0xf148440a256e2c76ull, 0xc00670ea43ca250dull, 0x96cd2a865764dbcaull, 0x380406926a5e5728ull,
+		0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull, 0xeba09271e88d976bull, 0xf7864a44c633682eull,
+		0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull, 0xb8157268fdae9e4cull, 0x5960ea05bad82964ull,
+		0xe61acf033d1a45dfull, 0x6fb92487298e33bdull, 0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull,
+		0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull, 0xe0b62e2929aba83cull, 0x331acdabfe94de87ull,
+		0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull, 0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull,
+		0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull, 0x892731ac9faf056eull, 0xbe311c083a225cd2ull,
+		0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull, 0xd64d3d9db981787dull, 0x092cbbccdad5b108ull,
+		0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull, 0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull,
+		0xd1476e2c07286faaull, 0x1af5af660db4aee1ull, 0x82cca4db847945caull, 0x50d98d9fc890ed4dull,
+		0xa37fce126597973cull, 0xe50ff107bab528a0ull, 0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull,
+		0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull, 0x9faacf3df73609b1ull, 0x77b191618c54e9acull,
+		0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull, 0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull,
+		0x9becce62836ac577ull, 0x4ee367f9430aec32ull, 0xc2e801fb244576d5ull, 0x229c41f793cda73full,
+		0xf3a20279ed56d48aull, 0x6b43527578c1110full, 0x9845418c345644d6ull, 0x830a13896b78aaa9ull,
+		0xbe5691ef416bd60cull, 0x23cc986bc656d553ull, 0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull,
+		0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull, 0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull,
+		0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull, 0x91376c36d99995beull, 0x23100809b9c21fa1ull,
+		0xb58547448ffffb2dull, 0xabd40a0c2832a78aull, 0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull,
+		0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull, 0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull,
+		0xdd95317f31c7fa1dull, 0x40405643d711d583ull, 0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull,
+		0xad1c8eab5ee43b66ull, 0xda3243650005eecfull, 0xd863b256369d4a40ull, 0x90bed43e40076a82ull,
+		0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull, 0xa90de3535aaae202ull, 0x711515d0a205cb36ull,
+		0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull, 0x8412d9991ed58091ull, 0xe858790afe9486c2ull,
+		0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull, 0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full,
+		0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull, 0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull,
+		0xc987434744ac874eull, 0xa327ffb266b56220ull, 0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull,
+		0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull, 0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull,
+		0xf6019da07f549b2bull, 0x7e2a53a146606a48ull, 0x99c102844f94e0fbull, 0x2eda7444cbfc426dull,
+		0xc0314325637a1939ull, 0xfa911155fefb5308ull, 0xf03d93eebc589f88ull, 0x793555ab7eba27caull,
+		0x96267c7535b763b5ull, 0x4bc1558b2f3458deull, 0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull,
+		0xea9c227723ee8bcbull, 0x465e15a979c1cadcull, 0x92a1958a7675175full, 0x0bfacd89ec191ec9ull,
+		0xb749faed14125d36ull, 0xcef980ec671f667bull, 0xe51c79a85916f484ull, 0x82b7e12780e7401aull,
+		0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull, 0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull,
+		0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull, 0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull,
+		0xaecc49914078536dull, 0x58fae9f773886e18ull, 0xda7f5bf590966848ull, 0xaf39a475506a899eull,
+		0x888f99797a5e012dull, 0x6d8406c952429603ull, 0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull,
+		0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull, 0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full,
+		0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull, 0xd0601d8efc57b08bull, 0xf13b94daf124da26ull,
+		0x823c12795db6ce57ull, 0x76c53d08d6b70858ull, 0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull,
+		0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull, 0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull,
+		0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull, 0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull,
+		0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull, 0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull,
+		0xc21094364dfb5636ull, 0x985915fc12f542e4ull, 0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull,
+		0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull, 0xbd8430bd08277231ull, 0x50c6ff782a838353ull,
+		0xece53cec4a314ebdull, 0xa4f8bf5635246428ull, 0x940f4613ae5ed136ull, 0x871b7795e136be99ull,
+		0xb913179899f68584ull, 0x28e2557b59846e3full, 0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull,
+		0x9096ea6f3848984full, 0x3ff0d2c85def7621ull, 0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull,
+		0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull, 0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull,
+		0xb080392cc4349decull, 0xbd8d794d96aacfb3ull, 0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull,
+		0x89e42caaf9491b60ull, 0xf41686c49db57244ull, 0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull,
+		0xd77485cb25823ac7ull, 0x7d633293366b828bull, 0x86a8d39ef77164bcull, 0xae5dff9c02033197ull,
+		0xa8530886b54dbdebull, 0xd9f57f830283fdfcull, 0xd267caa862a12d66ull, 0xd072df63c324fd7bull,
+		0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull, 0xa46116538d0deb78ull, 0x52d9be85f074e608ull,
+		0xcd795be870516656ull, 0x67902e276c921f8bull, 0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull,
+		0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull, 0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull,
+		0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull, 0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull,
+		0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull, 0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull,
+		0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull, 0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull,
+		0xef340a98172aace4ull, 0x86fb897116c87c34ull, 0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull,
+		0xbae0a846d2195712ull, 0x8974836059cca109ull, 0xe998d258869facd7ull, 0x2bd1a438703fc94bull,
+		0x91ff83775423cc06ull, 0x7b6306a34627ddcfull, 0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull,
+		0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull, 0x8e938662882af53eull, 0x547eb47b7282ee9cull,
+		0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull, 0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull,
+		0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull, 0xae0b158b4738705eull, 0x9624ab50b148d445ull,
+		0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull, 0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull,
+		0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull, 0xd47487cc8470652bull, 0x7647c3200069671full,
+		0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull, 0xa5fb0a17c777cf09ull, 0xf468107100525890ull,
+		0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull, 0x81ac1fe293d599bfull, 0xc6f14cd848405530ull,
+		0xa21727db38cb002full, 0xb8ada00e5a506a7cull, 0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull,
+		0xfd442e4688bd304aull, 0x908f4a166d1da663ull, 0x9e4a9cec15763e2eull, 0x9a598e4e043287feull,
+		0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull, 0xf7549530e188c128ull, 0xd12bee59e68ef47cull,
+		0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull, 0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull,
+		0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull, 0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull,
+		0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull, 0xebdf661791d60f56ull, 0x111b495b3464ad21ull,
+		0x936b9fcebb25c995ull, 0xcab10dd900beec34ull, 0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull,
+		0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull, 0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull,
+		0xb3f4e093db73a093ull, 0x59ed216765690f56ull, 0xe0f218b8d25088b8ull, 0x306869c13ec3532cull,
+		0x8c974f7383725573ull, 0x1e414218c73a13fbull, 0xafbd2350644eeacfull, 0xe5d1929ef90898faull,
+		0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull, 0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull,
+		0xab9eb47c81f5114full, 0x066ea92f3f326564ull, 0xd686619ba27255a2ull, 0xc80a537b0efefebdull,
+		0x8613fd0145877585ull, 0xbd06742ce95f5f36ull, 0xa798fc4196e952e7ull, 0x2c48113823b73704ull,
+		0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull, 0x82ef85133de648c4ull, 0x9a984d73dbe722fbull,
+		0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull, 0xcc963fee10b7d1b3ull, 0x318df905079926a8ull,
+		0xffbbcfe994e5c61full, 0xfdf17746497f7052ull, 0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull,
+		0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull, 0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull,
+		0x9c1661a651213e2dull, 0x06bea10ca65c084eull, 0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull,
+		0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull, 0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull,
+		0xbe89523386091465ull, 0xf6bbb397f1135823ull, 0xee2ba6c0678b597full, 0x746aa07ded582e2cull,
+		0x94db483840b717efull, 0xa8c2a44eb4571cdcull, 0xba121a4650e4ddebull, 0x92f34d62616ce413ull,
+		0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull, 0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull,
+		0xb5b5ada8aaff80b8ull, 0x0d819992132456baull, 0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull,
+		0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull, 0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull,
+		0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull, 0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull,
+		0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull, 0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull,
+		0x87625f056c7c4a8bull, 0x11471cd764ad4972ull, 0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull,
+		0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull, 0x843610cb4bf160cbull, 0xcedf722a585139baull,
+		0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull, 0xce947a3da6a9273eull, 0x733d226229feea32ull,
+		0x811ccc668829b887ull, 0x0806357d5a3f525full, 0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull,
+		0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull, 0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull,
+		0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull, 0xc5029163f384a931ull, 0x0a9e795e65d4df11ull,
+		0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull, 0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull,
+		0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull, 0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull,
+		0x964e858c91ba2655ull, 0x3a6a07f8d510f86full, 0xbbe226efb628afeaull, 0x890489f70a55368bull,
+		0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull, 0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull,
+		0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull, 0xe55990879ddcaabdull, 0xcc420a6a101d0515ull,
+		0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull, 0xb32df8e9f3546564ull, 0x47939822dc96abf9ull,
+		0xdff9772470297ebdull, 0x59787e2b93bc56f7ull, 0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull,
+		0xaefae51477a06b03ull, 0xede622920b6b23f1ull, 0xdab99e59958885c4ull, 0xe95fab368e45ecedull,
+		0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull, 0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull,
+		0xd59944a37c0752a2ull, 0x4be76d3346f0495full, 0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull,
+		0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull, 0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull,
+		0x825ecc24c873782full, 0x8ed400668c0c28c8ull, 0xa2f67f2dfa90563bull, 0x728900802f0f32faull,
+		0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull, 0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull,
+		0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull, 0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull,
+		0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull, 0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull,
+		0xc24452da229b021bull, 0xfbe85badce996168ull, 0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull,
+		0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull, 0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull,
+		0xed246723473e3813ull, 0x290123e9aab23b68ull, 0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull,
+		0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull, 0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull,
+		0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull, 0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull,
+		0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull, 0x8d590723948a535full, 0x579c487e5a38ad0eull,
+		0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull, 0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull,
+		0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull, 0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full,
+		0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full, 0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull,
+		0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull, 0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull,
+		0x83a3eeeef9153e89ull, 0x1953cf68300424acull, 0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull,
+		0xcdb02555653131b6ull, 0x3792f412cb06794dull, 0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull,
+		0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull, 0xc8de047564d20a8bull, 0xf245825a5a445275ull,
+		0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull, 0x9ced737bb6c4183dull, 0x55464dd69685606bull,
+		0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull, 0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull,
+		0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull, 0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull,
+		0xef73d256a5c0f77cull, 0x963e66858f6d4440ull, 0x95a8637627989aadull, 0xdde7001379a44aa8ull,
+		0xbb127c53b17ec159ull, 0x5560c018580d5d52ull, 0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull,
+		0x9226712162ab070dull, 0xcab3961304ca70e8ull, 0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull,
+		0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull, 0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull,
+		0xb267ed1940f1c61cull, 0x55f038b237591ed3ull, 0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull,
+		0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull, 0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull,
+		0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull, 0x881cea14545c7575ull, 0x7e50d64177da2e54ull,
+		0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull, 0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull,
+		0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull, 0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull,
+		0xcfb11ead453994baull, 0x67de18eda5814af2ull, 0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull,
+		0xa2425ff75e14fc31ull, 0xa1258379a94d028dull, 0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull,
+		0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull, 0x9e74d1b791e07e48ull, 0x775ea264cf55347eull,
+		0xc612062576589ddaull, 0x95364afe032a819eull, 0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull,
+		0x9abe14cd44753b52ull, 0xc4926a9672793543ull, 0xc16d9a0095928a27ull, 0x75b7053c0f178294ull,
+		0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull, 0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull,
+		0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull, 0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull,
+		0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull, 0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull,
+		0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull, 0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull,
+		0xb424dc35095cd80full, 0x538484c19ef38c95ull, 0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull,
+		0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull, 0xafebff0bcb24aafeull, 0xf78f69a51539d749ull,
+		0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull, 0x89705f4136b4a597ull, 0x31680a88f8953031ull,
+		0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull, 0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull,
+		0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull, 0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull,
+		0xd1b71758e219652bull, 0xd3c36113404ea4a9ull, 0x83126e978d4fdf3bull, 0x645a1cac083126eaull,
+		0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull, 0xccccccccccccccccull, 0xcccccccccccccccdull,
+		0x8000000000000000ull, 0x0000000000000000ull, 0xa000000000000000ull, 0x0000000000000000ull,
+		0xc800000000000000ull, 0x0000000000000000ull, 0xfa00000000000000ull, 0x0000000000000000ull,
+		0x9c40000000000000ull, 0x0000000000000000ull, 0xc350000000000000ull, 0x0000000000000000ull,
+		0xf424000000000000ull, 0x0000000000000000ull, 0x9896800000000000ull, 0x0000000000000000ull,
+		0xbebc200000000000ull, 0x0000000000000000ull, 0xee6b280000000000ull, 0x0000000000000000ull,
+		0x9502f90000000000ull, 0x0000000000000000ull, 0xba43b74000000000ull, 0x0000000000000000ull,
+		0xe8d4a51000000000ull, 0x0000000000000000ull, 0x9184e72a00000000ull, 0x0000000000000000ull,
+		0xb5e620f480000000ull, 0x0000000000000000ull, 0xe35fa931a0000000ull, 0x0000000000000000ull,
+		0x8e1bc9bf04000000ull, 0x0000000000000000ull, 0xb1a2bc2ec5000000ull, 0x0000000000000000ull,
+		0xde0b6b3a76400000ull, 0x0000000000000000ull, 0x8ac7230489e80000ull, 0x0000000000000000ull,
+		0xad78ebc5ac620000ull, 0x0000000000000000ull, 0xd8d726b7177a8000ull, 0x0000000000000000ull,
+		0x878678326eac9000ull, 0x0000000000000000ull, 0xa968163f0a57b400ull, 0x0000000000000000ull,
+		0xd3c21bcecceda100ull, 0x0000000000000000ull, 0x84595161401484a0ull, 0x0000000000000000ull,
+		0xa56fa5b99019a5c8ull, 0x0000000000000000ull, 0xcecb8f27f4200f3aull, 0x0000000000000000ull,
+		0x813f3978f8940984ull, 0x4000000000000000ull, 0xa18f07d736b90be5ull, 0x5000000000000000ull,
+		0xc9f2c9cd04674edeull, 0xa400000000000000ull, 0xfc6f7c4045812296ull, 0x4d00000000000000ull,
+		0x9dc5ada82b70b59dull, 0xf020000000000000ull, 0xc5371912364ce305ull, 0x6c28000000000000ull,
+		0xf684df56c3e01bc6ull, 0xc732000000000000ull, 0x9a130b963a6c115cull, 0x3c7f400000000000ull,
+		0xc097ce7bc90715b3ull, 0x4b9f100000000000ull, 0xf0bdc21abb48db20ull, 0x1e86d40000000000ull,
+		0x96769950b50d88f4ull, 0x1314448000000000ull, 0xbc143fa4e250eb31ull, 0x17d955a000000000ull,
+		0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull, 0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull,
+		0xb7abc627050305adull, 0xf14a3d9e40000000ull, 0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull,
+		0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull, 0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull,
+		0xe0352f62a19e306eull, 0xd50b2037ad200000ull, 0x8c213d9da502de45ull, 0x4526f422cc340000ull,
+		0xaf298d050e4395d6ull, 0x9670b12b7f410000ull, 0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull,
+		0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull, 0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull,
+		0xd5d238a4abe98068ull, 0x72a4904598d6d880ull, 0x85a36366eb71f041ull, 0x47a6da2b7f864750ull,
+		0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull, 0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull,
+		0x82818f1281ed449full, 0xbff8f10e7a8921a4ull, 0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull,
+		0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull, 0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull,
+		0x9f4f2726179a2245ull, 0x01d762422c946590ull, 0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull,
+		0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull, 0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full,
+		0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull, 0xf316271c7fc3908aull, 0x8bef464e3945ef7aull,
+		0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull, 0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull,
+		0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull, 0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull,
+		0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull, 0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull,
+		0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull, 0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull,
+		0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull, 0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull,
+		0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull, 0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull,
+		0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull, 0xacb92ed9397bf996ull, 0x49c2c37f07965404ull,
+		0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull, 0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull,
+		0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull, 0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull,
+		0x83c7088e1aab65dbull, 0x792667c6da79e0faull, 0xa4b8cab1a1563f52ull, 0x577001b891185938ull,
+		0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull, 0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull,
+		0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull, 0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull,
+		0xfb5878494ace3a5full, 0x04ab48a04065c723ull, 0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull,
+		0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull, 0xf5746577930d6500ull, 0xca8f44ec7ee36479ull,
+		0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull, 0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull,
+		0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull, 0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull,
+		0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull, 0xea1575143cf97226ull, 0xf52d09d71a3293bdull,
+		0x924d692ca61be758ull, 0x593c2626705f9c56ull, 0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull,
+		0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull, 0x8edf98b59a373fecull, 0x4724bd4189bd5eacull,
+		0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull, 0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull,
+		0x8b865b215899f46cull, 0xbd79e0d20082ee74ull, 0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull,
+		0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull, 0x884134fe908658b2ull, 0x3109058d147fdcddull,
+		0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull, 0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull,
+		0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull, 0xa6539930bf6bff45ull, 0x84db8346b786151cull,
+		0xcfe87f7cef46ff16ull, 0xe612641865679a63ull, 0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull,
+		0xa26da3999aef7749ull, 0xe3be5e330f38f09dull, 0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull,
+		0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull, 0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull,
+		0xc646d63501a1511dull, 0xb281e1fd541501b8ull, 0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull,
+		0x9ae757596946075full, 0x3375788de9b06958ull, 0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull,
+		0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull, 0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull,
+		0xbd176620a501fbffull, 0xb650e5a93bc3d898ull, 0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull,
+		0x93ba47c980e98cdfull, 0xc66f336c36b10137ull, 0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull,
+		0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull, 0x9043ea1ac7e41392ull, 0x87c89837ad68db2full,
+		0xb454e4a179dd1877ull, 0x29babe4598c311fbull, 0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull,
+		0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull, 0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full,
+		0xdc21a1171d42645dull, 0x76707543f4fa1f73ull, 0x899504ae72497ebaull, 0x6a06494a791c53a8ull,
+		0xabfa45da0edbde69ull, 0x0487db9d17636892ull, 0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull,
+		0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull, 0xa7f26836f282b732ull, 0x8e6cac7768d7141eull,
+		0xd1ef0244af2364ffull, 0x3207d795430cd926ull, 0x8335616aed761f1full, 0x7f44e6bd49e807b8ull,
+		0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull, 0xcd036837130890a1ull, 0x36dba887c37a8c0full,
+		0x802221226be55a64ull, 0xc2494954da2c9789ull, 0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull,
+		0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull, 0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull,
+		0x9c69a97284b578d7ull, 0xff2a760414536efbull, 0xc38413cf25e2d70dull, 0xfef5138519684abaull,
+		0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull, 0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull,
+		0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull, 0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull,
+		0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull, 0xba756174393d88dfull, 0x94f971119aeef9e4ull,
+		0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull, 0x91abb422ccb812eeull, 0xac62e055c10ab33aull,
+		0xb616a12b7fe617aaull, 0x577b986b314d6009ull, 0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull,
+		0x8e41ade9fbebc27dull, 0x14588f13be847307ull, 0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull,
+		0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull, 0x8aec23d680043beeull, 0x25de7bb9480d5854ull,
+		0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull, 0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull,
+		0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull, 0xa99541bf57452b28ull, 0x353a1607ac744a53ull,
+		0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull, 0x847c9b5d7c2e09b7ull, 0x69956135febada11ull,
+		0xa59bc234db398c25ull, 0x43fab9837e699095ull, 0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull,
+		0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull, 0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull,
+		0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull, 0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull,
+		0x9defbf01b061adabull, 0x3a0888136afa64a7ull, 0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull,
+		0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull, 0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull,
+		0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull, 0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull,
+		0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull, 0xbc4665b596706114ull, 0x873d5d9f0dde1feeull,
+		0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull, 0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull,
+		0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full, 0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull,
+		0x8fa475791a569d10ull, 0xf96e017d694487bcull, 0xb38d92d760ec4455ull, 0x37c981dcc395a9acull,
+		0xe070f78d3927556aull, 0x85bbe253f47b1417ull, 0x8c469ab843b89562ull, 0x93956d7478ccec8eull,
+		0xaf58416654a6babbull, 0x387ac8d1970027b2ull, 0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull,
+		0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull, 0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull,
+		0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull, 0x85c7056562757456ull, 0xf6872d5667844e49ull,
+		0xa738c6bebb12d16cull, 0xb428f8ac016561dbull, 0xd106f86e69d785c7ull, 0xe13336d701beba52ull,
+		0x82a45b450226b39cull, 0xecc0024661173473ull, 0xa34d721642b06084ull, 0x27f002d7f95d0190ull,
+		0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull, 0xff290242c83396ceull, 0x7e67047175a15271ull,
+		0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull, 0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull,
+		0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull, 0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull,
+		0xc2abf989935ddbfeull, 0x6acff893d00ea435ull, 0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull,
+		0x98165af37b2153deull, 0xc3727a337a8b704aull, 0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull,
+		0xeda2ee1c7064130cull, 0x1162def06f79df73ull, 0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull,
+		0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull, 0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull,
+		0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull, 0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull,
+		0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull, 0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull,
+		0xb10d8e1456105dadull, 0x7425a83e872c5f47ull, 0xdd50f1996b947518ull, 0xd12f124e28f77719ull,
+		0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full, 0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull,
+		0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull, 0x8714a775e3e95c78ull, 0x65acfaec34810a71ull,
+		0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull, 0xd31045a8341ca07cull, 0x1ede48111209a050ull,
+		0x83ea2b892091e44dull, 0x934aed0aab460432ull, 0xa4e4b66b68b65d60ull, 0xf81da84d5617853full,
+		0xce1de40642e3f4b9ull, 0x36251260ab9d668eull, 0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull,
+		0xa1075a24e4421730ull, 0xb24cf65b8612f81full, 0xc94930ae1d529cfcull, 0xdee033f26797b627ull,
+		0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull, 0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull,
+		0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull, 0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull,
+		0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull, 0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull,
+		0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull, 0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull,
+		0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull, 0xea53df5fd18d5513ull, 0x84c86189216dc5edull,
+		0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull, 0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull,
+		0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull, 0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull,
+		0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull, 0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull,
+		0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull, 0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull,
+		0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull, 0x8865899617fb1871ull, 0x7e2fa67c7a658892ull,
+		0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull, 0xd51ea6fa85785631ull, 0x552a74227f3ea565ull,
+		0x8533285c936b35deull, 0xd53a88958f87275full, 0xa67ff273b8460356ull, 0x8a892abaf368f137ull,
+		0xd01fef10a657842cull, 0x2d2b7569b0432d85ull, 0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull,
+		0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full, 0xcb3f2f7642717713ull, 0x241c70a936219a73ull,
+		0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull, 0x9ec95d1463e8a506ull, 0xf4363804324a40aaull,
+		0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull, 0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull,
+		0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull, 0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull,
+		0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull, 0x976e41088617ca01ull, 0xd5be0503e085d813ull,
+		0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull, 0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull,
+		0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull, 0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull,
+		0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull, 0x906a617d450187e2ull, 0x27fb2b80668b24c5ull,
+		0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull, 0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull,
+		0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull, 0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull,
+		0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull, 0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull,
+		0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull, 0xd732290fbacaf133ull, 0xa97c177947ad4095ull,
+		0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull, 0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull,
+		0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull, 0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull,
+		0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull, 0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull,
+		0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull, 0xa0555e361951c366ull, 0xd7e105bcc332621full,
+		0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull, 0xfa856334878fc150ull, 0xb14f98f6f0feb951ull,
+		0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull, 0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull,
+		0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull, 0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull,
+		0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull, 0xeeea5d5004981478ull, 0x1858ccfce06cac74ull,
+		0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull, 0xbaa718e68396cffdull, 0xd30560258f54e6baull,
+		0xe950df20247c83fdull, 0x47c6b82ef32a2069ull, 0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull,
+		0xb6472e511c81471dull, 0xe0133fe4adf8e952ull, 0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull,
+		0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull
+	};
+
+	//! Powers of ten that are exact in double.
+	static const double s_exactPowersOfTen[23] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	//! Parameters of binary floating point formats.
+	template <class T> struct _FloatFormat;
+	//!
+	template <> struct _FloatFormat<double>
+	{
+		typedef uint64 Bits;
+		static const int MantissaBits = 52;
+		static const int MinExponent = -1023;
+		static const int InfinitePower = 0x7ff;
+		static const int SmallestPowerOfTen = -342;
+		static const int LargestPowerOfTen = 308;
+		static const int MinRoundToEven = -4;
+		static const int MaxRoundToEven = 23;
+		static const int MaxFastPower = 22;
+		static const uint64 MaxFastMantissa = 1ull << 53;
+		static double Strtod(const char* _str) { return strtod(_str, nullptr); }
+	};
+	//!
+	template <> struct _FloatFormat<float>
+	{
+		typedef uint Bits;
+		static const int MantissaBits = 23;
+		static const int MinExponent = -127;
+		static const int InfinitePower = 0xff;
+		static const int SmallestPowerOfTen = -64;
+		static const int LargestPowerOfTen = 38;
+		static const int MinRoundToEven = -17;
+		static const int MaxRoundToEven = 10;
+		static const int MaxFastPower = 10;
+		static const uint64 MaxFastMantissa = 1ull << 24;
+		static float Strtod(const char* _str) { return strtof(_str, nullptr); }
+	};
+
+	//! Convert w * 10^q to the nearest binary float (Daniel Lemire: "Number Parsing at a Gigabyte per Second").
+	//! The 128-bit product is always enough to round correctly (Noble Mushtak, Daniel Lemire: "Fast Number Parsing Without Fallback").
+	//!\return Bits of positive float.
+	template <class T> static typename _FloatFormat<T>::Bits _ComputeFloat(int64 _q, uint64 _w)
+	{
+		typedef _FloatFormat<T> F;
+		typedef typename F::Bits Bits;
+		if (!_w || _q < F::SmallestPowerOfTen)
+			return 0;
+		if (_q > F::LargestPowerOfTen)
+			return (Bits)F::InfinitePower << F::MantissaBits;
+
+		uint _lz = _LeadingZeros(_w);
+		_w <<= _lz;
+
+		// product with the rounded power of five, the lower half is needed only when the upper bits are ambiguous
+		const uint64* _pow5 = s_powersOfFive + 2 * (_q + 342);
+		const uint64 _precisionMask = ~0ull >> (F::MantissaBits + 3);
+		uint64 _high, _low = _Mul128(_w, _pow5[0], _high);
+		if ((_high & _precisionMask) == _precisionMask)
+		{
+			uint64 _high2;
+			_Mul128(_w, _pow5[1], _high2);
+			_low += _high2;
+			if (_high2 > _low)
+				++_high;
+		}
+
+		int _upperBit = (int)(_high >> 63);
+		int _shift = _upperBit + 64 - F::MantissaBits - 3;
+		uint64 _mantissa = _high >> _shift;
+		int _power2 = (int)(((152170 + 65536) * _q) >> 16) + 63 + _upperBit - (int)_lz - F::MinExponent; // floor(q * log2(10)) + 63
+
+		if (_power2 <= 0) // subnormal
+		{
+			if (-_power2 + 1 >= 64)
+				return 0;
+			_mantissa >>= -_power2 + 1;
+			_mantissa += _mantissa & 1;
+			_mantissa >>= 1;
+			// rounding can make the normal number
+			return (Bits)_mantissa;
+		}
+
+		// exactly in the middle between two floats, round to even
+		if (_low <= 1 && _q >= F::MinRoundToEven && _q <= F::MaxRoundToEven && (_mantissa & 3) == 1 && (_mantissa << _shift) == _high)
+			_mantissa &= ~1ull;
+
+		_mantissa += _mantissa & 1;
+		_mantissa >>= 1;
+		if (_mantissa >= (2ull << F::MantissaBits))
+		{
+			_mantissa = 1ull << F::MantissaBits;
+			++_power2;
+		}
+		_mantissa &= ~(1ull << F::MantissaBits);
+		if (_power2 >= F::InfinitePower)
+			return (Bits)F::InfinitePower << F::MantissaBits;
+		return (Bits)(_mantissa | ((uint64)_power2 << F::MantissaBits));
+	}
+
+	//! Parse "inf", "infinity" or "nan" ignoring case. \return Pointer past the word or nullptr.
+	static const char* _ParseSpecialFloat(const char* _str, const char* _end, bool& _nan)
+	{
+		uint _length = (uint)(_end - _str);
+		if (_length >= 3 && StringView(_str, 3).Compare("nan", true) == 0)
+		{
+			_nan = true;
+			return _str + 3;
+		}
+		if (_length >= 3 && StringView(_str, 3).Compare("inf", true) == 0)
+		{
+			_nan = false;
+			return _str + (_length >= 8 && StringView(_str, 8).Compare("infinity", true) == 0 ? 8 : 3);
+		}
+		return nullptr;
+	}
+
+	//! Parse decimal float: [+-]digits[.digits][(e|E)[+-]digits], "inf", "infinity" or "nan". \return Pointer past the number or nullptr.
+	template <class T> static const char* _ParseFloat(const char* _str, const char* _end, T& _value)
+	{
+		typedef _FloatFormat<T> F;
+		typedef typename F::Bits Bits;
+
+		const char* _p = _str;
+		bool _negative = _p < _end && *_p == '-';
+		if (_p < _end && (*_p == '-' || *_p == '+'))
+			++_p;
+
+		// significand, the digits over 19 are wrapped and parsed again later
+		const char* _start = _p;
+		uint64 _w = 0;
+		while (_end - _p >= 8 && _IsEightDigits(_LoadEightChars(_p)))
+		{
+			_w = _w * 100000000 + _ParseEightDigits(_LoadEightChars(_p));
+			_p += 8;
+		}
+		while (_p < _end && (uint8)(*_p - '0') < 10)
+			_w = _w * 10 + (*_p++ - '0');
+		const char* _intEnd = _p;
+		const char* _fraction = _p;
+		const char* _fractionEnd = _p;
+		if (_p < _end && *_p == '.')
+		{
+			_fraction = ++_p;
+			while (_end - _p >= 8 && _IsEightDigits(_LoadEightChars(_p)))
+			{
+				_w = _w * 100000000 + _ParseEightDigits(_LoadEightChars(_p));
+				_p += 8;
+			}
+			while (_p < _end && (uint8)(*_p - '0') < 10)
+				_w = _w * 10 + (*_p++ - '0');
+			_fractionEnd = _p;
+		}
+		int64 _digits = (_intEnd - _start) + (_fractionEnd - _fraction);
+
+		if (!_digits)
+		{
+			bool _nan;
+			const char* _r = _p == _start ? _ParseSpecialFloat(_p, _end, _nan) : nullptr;
+			if (_r)
+			{
+				Bits _bits = ((Bits)F::InfinitePower << F::MantissaBits) | ((Bits)_nan << (F::MantissaBits - 1)) | ((Bits)_negative << (sizeof(Bits) * 8 - 1));
+				memcpy(&_value, &_bits, sizeof(_value));
+			}
+			return _r;
+		}
+
+		int64 _expNumber = 0;
+		if (_p < _end && (*_p | 0x20) == 'e')
+		{
+			const char* _e = _p + 1;
+			bool _negativeExp = _e < _end && *_e == '-';
+			if (_e < _end && (*_e == '-' || *_e == '+'))
+				++_e;
+			if (_e < _end && (uint8)(*_e - '0') < 10) // otherwise 'e' is not a part of number
+			{
+				for (; _e < _end && (uint8)(*_e - '0') < 10; ++_e)
+				{
+					if (_expNumber < 0x10000000)
+						_expNumber = _expNumber * 10 + (*_e - '0');
+				}
+				if (_negativeExp)
+					_expNumber = -_expNumber;
+				_p = _e;
+			}
+		}
+		int64 _exponent = _expNumber - (_fractionEnd - _fraction);
+
+		// more than 19 significant digits, take first 19 digits and check that the next value is rounded to the same float
+		bool _truncated = false;
+		if (_digits > 19)
+		{
+			for (const char* _s = _start; _s < _fractionEnd && (*_s == '0' || *_s == '.'); ++_s)
+				_digits -= *_s == '0';
+			if (_digits > 19)
+			{
+				_truncated = true;
+				_w = 0;
+				const char* _s = _start;
+				while (_w < 1000000000000000000ull && _s < _intEnd)
+					_w = _w * 10 + (*_s++ - '0');
+				if (_w >= 1000000000000000000ull)
+					_exponent = (_intEnd - _s) + _expNumber;
+				else
+				{
+					_s = _fraction;
+					while (_w < 1000000000000000000ull && _s < _fractionEnd)
+						_w = _w * 10 + (*_s++ - '0');
+					_exponent = (_fraction - _s) + _expNumber;
+				}
+			}
+		}
+
+		// exact product of exact values (Clinger's fast path)
+		if (!_truncated && _exponent >= -F::MaxFastPower && _exponent <= F::MaxFastPower && _w <= F::MaxFastMantissa)
+		{
+			T _v = (T)_w;
+			_v = _exponent < 0 ? _v / (T)s_exactPowersOfTen[-_exponent] : _v * (T)s_exactPowersOfTen[_exponent];
+			_value = _negative ? -_v : _v;
+			return _p;
+		}
+
+		Bits _bits = _ComputeFloat<T>(_exponent, _w);
+		if (_truncated && _bits != _ComputeFloat<T>(_exponent, _w + 1))
+		{
+			// too close to the middle between two floats, rare
+			char _buff[256];
+			String _temp;
+			uint _length = (uint)(_p - _str);
+			const char* _text = _buff;
+			if (_length < sizeof(_buff))
+			{
+				memcpy(_buff, _str, _length);
+				_buff[_length] = 0;
+			}
+			else
+				_text = (_temp = String(_str, _length)).CStr();
+			_value = F::Strtod(_text);
+			return _p;
+		}
+		_bits |= (Bits)_negative << (sizeof(Bits) * 8 - 1);
+		memcpy(&_value, &_bits, sizeof(_value));
+		return _p;
+	}
+
+	//! Write the float in the shortest form. \see _FormatDigits
+	template <class T> static uint _FloatToStr(T _value, char* _dst)
+	{
+		char* _p = _dst;
+		if (signbit(_value))
+		{
+			*_p++ = '-';
+			_value = -_value;
+		}
+		if (isnan(_value) || isinf(_value))
+		{
+			memcpy(_p, isnan(_value) ? "nan" : "inf", 3);
+			_p += 3;
+		}
+		else if (_value == 0)
+			*_p++ = '0';
+		else
+		{
+			char _digits[20];
+			int _k;
+			int _n = _ShortestDigits(_value, _digits, _k);
+			_p += _FormatDigits(_p, _digits, _n, _k, 'g', false);
+		}
+		return (uint)(_p - _dst);
+	}
+
+	//----------------------------------------------------------------------------//
+	// UTF-8 utilities
+	//----------------------------------------------------------------------------//
+
+	//! Decode one codepoint. Checks overlong forms, surrogates and the upper limit. \return Codepoint or ~0 if the sequence is invalid.
+	static FORCEINLINE uint _DecodeUtf8(const uint8*& _s, const uint8* _end)
+	{
+		uint _c = *_s;
+		if (_c < 0x80)
+		{
+			++_s;
+			return _c;
+		}
+		uint _n = (uint)(_end - _s);
+		if (_c < 0xc2)
+			return ~0u;
+		if (_c < 0xe0)
+		{
+			if (_n < 2 || (_s[1] & 0xc0) != 0x80)
+				return ~0u;
+			_s += 2;
+			return ((_c & 0x1f) << 6) | (_s[-1] & 0x3f);
+		}
+		if (_c < 0xf0)
+		{
+			uint8 _lo = _c == 0xe0 ? 0xa0 : 0x80, _hi = _c == 0xed ? 0x9f : 0xbf;
+			if (_n < 3 || _s[1] < _lo || _s[1] > _hi || (_s[2] & 0xc0) != 0x80)
+				return ~0u;
+			_s += 3;
+			return ((_c & 0x0f) << 12) | ((_s[-2] & 0x3f) << 6) | (_s[-1] & 0x3f);
+		}
+		if (_c < 0xf5)
+		{
+			uint8 _lo = _c == 0xf0 ? 0x90 : 0x80, _hi = _c == 0xf4 ? 0x8f : 0xbf;
+			if (_n < 4 || _s[1] < _lo || _s[1] > _hi || (_s[2] & 0xc0) != 0x80 || (_s[3] & 0xc0) != 0x80)
+				return ~0u;
+			_s += 4;
+			return ((_c & 0x07) << 18) | ((_s[-3] & 0x3f) << 12) | ((_s[-2] & 0x3f) << 6) | (_s[-1] & 0x3f);
+		}
+		return ~0u;
+	}
+
+	//! Skip ASCII characters. \return First non-ASCII character or _end.
+	static FORCEINLINE const uint8* _SkipAscii(const uint8* _s, const uint8* _end)
+	{
+#ifdef RX_SSE2
+		for (; _end - _s >= 16; _s += 16)
+		{
+			uint _mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_s)));
+			if (_mask)
+				return _s + RX_CTZ(_mask);
+		}
+#endif
+		while (_s < _end && *_s < 0x80)
+			++_s;
+		return _s;
+	}
+
+	//!
+	static bool _ValidateUtf8Scalar(const uint8* _s, const uint8* _end)
+	{
+		for (;;)
+		{
+			_s = _SkipAscii(_s, _end);
+			if (_s == _end)
+				return true;
+			if (_DecodeUtf8(_s, _end) == ~0u)
+				return false;
+		}
+	}
+
+#ifdef RX_X86
+	// Validation by lookup tables (John Keiser, Daniel Lemire: "Validating UTF-8 In Less Than One Instruction Per Byte").
+	// Each error is a bit. Three tables are indexed by high and low nibbles of previous byte and high nibble of current byte,
+	// the error is set only if it is present in all three. The lengths of 3 and 4-byte sequences are checked separately.
+
+	enum : uint8
+	{
+		UTF8_TOO_SHORT = 1 << 0, //!< lead byte or ASCII after lead byte
+		UTF8_TOO_LONG = 1 << 1, //!< continuation after ASCII
+		UTF8_OVERLONG_3 = 1 << 2,
+		UTF8_TOO_LARGE = 1 << 3,
+		UTF8_SURROGATE = 1 << 4,
+		UTF8_OVERLONG_2 = 1 << 5,
+		UTF8_TOO_LARGE_1000 = 1 << 6,
+		UTF8_OVERLONG_4 = 1 << 6,
+		UTF8_TWO_CONTS = 1 << 7, //!< continuation after continuation
+		UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS,
+	};
+
+	//! By high nibble of previous byte.
+	RX_ALIGN(16) static const uint8 s_utf8Byte1High[16] =
+	{
+		UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+		UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+		UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+		UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+	};
+
+	//! By low nibble of previous byte.
+	RX_ALIGN(16) static const uint8 s_utf8Byte1Low[16] =
+	{
+		UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+		UTF8_CARRY | UTF8_OVERLONG_2,
+		UTF8_CARRY,
+		UTF8_CARRY,
+		UTF8_CARRY | UTF8_TOO_LARGE,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	};
+
+	//! By high nibble of current byte.
+	RX_ALIGN(16) static const uint8 s_utf8Byte2High[16] =
+	{
+		UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+		UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+	};
+
+	//! The last bytes of block that start incomplete sequences are greater than these values.
+	RX_ALIGN(32) static const uint8 s_utf8IncompleteMax[32] =
+	{
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+	};
+
+	//! Errors of 16 bytes. _prev is the previous block.
+	RX_TARGET("ssse3") static FORCEINLINE __m128i _Utf8ErrorsSsse3(__m128i _in, __m128i _prev)
+	{
+		const __m128i _nibble = _mm_set1_epi8(0x0f);
+		__m128i _prev1 = _mm_alignr_epi8(_in, _prev, 15);
+		__m128i _b1h = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte1High)), _mm_and_si128(_mm_srli_epi16(_prev1, 4), _nibble));
+		__m128i _b1l = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte1Low)), _mm_and_si128(_prev1, _nibble));
+		__m128i _b2h = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte2High)), _mm_and_si128(_mm_srli_epi16(_in, 4), _nibble));
+		__m128i _special = _mm_and_si128(_mm_and_si128(_b1h, _b1l), _b2h);
+
+		// the third and the fourth bytes of sequences must be continuations
+		__m128i _prev2 = _mm_alignr_epi8(_in, _prev, 14);
+		__m128i _prev3 = _mm_alignr_epi8(_in, _prev, 13);
+		__m128i _is3 = _mm_subs_epu8(_prev2, _mm_set1_epi8((char)(0xe0 - 0x80)));
+		__m128i _is4 = _mm_subs_epu8(_prev3, _mm_set1_epi8((char)(0xf0 - 0x80)));
+		__m128i _must23 = _mm_and_si128(_mm_or_si128(_is3, _is4), _mm_set1_epi8((char)0x80));
+		return _mm_xor_si128(_must23, _special);
+	}
+
+	//!
+	RX_TARGET("ssse3") static bool _ValidateUtf8Ssse3(const uint8* _s, const uint8* _end)
+	{
+		const __m128i _max = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s_utf8IncompleteMax + 16));
+		__m128i _error = _mm_setzero_si128();
+		__m128i _prev = _mm_setzero_si128();
+		__m128i _incomplete = _mm_setzero_si128();
+		for (; _end - _s >= 16; _s += 16)
+		{
+			__m128i _in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_s));
+			if (!_mm_movemask_epi8(_in)) // ASCII
+			{
+				_error = _mm_or_si128(_error, _incomplete);
+				_incomplete = _mm_setzero_si128();
+			}
+			else
+			{
+				_error = _mm_or_si128(_error, _Utf8ErrorsSsse3(_in, _prev));
+				_incomplete = _mm_subs_epu8(_in, _max);
+			}
+			_prev = _in;
+		}
+
+		// the tail is padded by zeros, so the incomplete sequence at the end is an error
+		RX_ALIGN(16) uint8 _tail[16] = { 0 };
+		memcpy(_tail, _s, _end - _s);
+		_error = _mm_or_si128(_error, _Utf8ErrorsSsse3(_mm_load_si128(reinterpret_cast<const __m128i*>(_tail)), _prev));
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_error, _mm_setzero_si128())) == 0xffff;
+	}
+
+	//! Errors of 32 bytes. _prev is the previous block.
+	RX_TARGET("avx2") static FORCEINLINE __m256i _Utf8ErrorsAvx2(__m256i _in, __m256i _prev)
+	{
+		const __m256i _nibble = _mm256_set1_epi8(0x0f);
+		__m256i _shifted = _mm256_permute2x128_si256(_prev, _in, 0x21); // high half of _prev and low half of _in
+		__m256i _prev1 = _mm256_alignr_epi8(_in, _shifted, 15);
+		__m256i _b1h = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte1High))), _mm256_and_si256(_mm256_srli_epi16(_prev1, 4), _nibble));
+		__m256i _b1l = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte1Low))), _mm256_and_si256(_prev1, _nibble));
+		__m256i _b2h = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8Byte2High))), _mm256_and_si256(_mm256_srli_epi16(_in, 4), _nibble));
+		__m256i _special = _mm256_and_si256(_mm256_and_si256(_b1h, _b1l), _b2h);
+
+		__m256i _prev2 = _mm256_alignr_epi8(_in, _shifted, 14);
+		__m256i _prev3 = _mm256_alignr_epi8(_in, _shifted, 13);
+		__m256i _is3 = _mm256_subs_epu8(_prev2, _mm256_set1_epi8((char)(0xe0 - 0x80)));
+		__m256i _is4 = _mm256_subs_epu8(_prev3, _mm256_set1_epi8((char)(0xf0 - 0x80)));
+		__m256i _must23 = _mm256_and_si256(_mm256_or_si256(_is3, _is4), _mm256_set1_epi8((char)0x80));
+		return _mm256_xor_si256(_must23, _special);
+	}
+
+	//! Processes 64 bytes per iteration, ASCII blocks are skipped.
+	RX_TARGET("avx2") static bool _ValidateUtf8Avx2(const uint8* _s, const uint8* _end)
+	{
+		const __m256i _max = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_utf8IncompleteMax));
+		__m256i _error = _mm256_setzero_si256();
+		__m256i _prev = _mm256_setzero_si256();
+		__m256i _incomplete = _mm256_setzero_si256();
+		for (; _end - _s >= 64; _s += 64)
+		{
+			__m256i _in0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_s));
+			__m256i _in1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_s + 32));
+			if (!_mm256_movemask_epi8(_mm256_or_si256(_in0, _in1))) // ASCII
+			{
+				_error = _mm256_or_si256(_error, _incomplete);
+				_incomplete = _mm256_setzero_si256();
+			}
+			else
+			{
+				_error = _mm256_or_si256(_error, _Utf8ErrorsAvx2(_in0, _prev));
+				_error = _mm256_or_si256(_error, _Utf8ErrorsAvx2(_in1, _in0));
+				_incomplete = _mm256_subs_epu8(_in1, _max);
+			}
+			_prev = _in1;
+		}
+
+		RX_ALIGN(32) uint8 _tail[64] = { 0 };
+		memcpy(_tail, _s, _end - _s);
+		__m256i _in0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_tail));
+		__m256i _in1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_tail + 32));
+		_error = _mm256_or_si256(_error, _Utf8ErrorsAvx2(_in0, _prev));
+		_error = _mm256_or_si256(_error, _Utf8ErrorsAvx2(_in1, _in0));
+		return _mm256_testz_si256(_error, _error) != 0;
+	}
+
+	//! Is initialized before main.
+	static const bool s_hasSsse3 = GetCpuFeatures().ssse3;
+#endif
+
+	//! Write codepoint as UTF-16. \return Number of units.
+	static FORCEINLINE uint _EncodeUtf16(uint _c, uint16* _dst)
+	{
+		if (_c < 0x10000)
+		{
+			*_dst = (uint16)_c;
+			return 1;
+		}
+		_c -= 0x10000;
+		_dst[0] = (uint16)(0xd800 | (_c >> 10));
+		_dst[1] = (uint16)(0xdc00 | (_c & 0x3ff));
+		return 2;
+	}
+
+	//! Decode UTF-8. ASCII blocks are expanded by SIMD.
+	template <class T> static uint _Utf8ToWide(const char* _src, uint _length, T* _dst)
+	{
+		const uint8* _s = reinterpret_cast<const uint8*>(_src);
+		const uint8* _end = _s + _length;
+		T* _d = _dst;
+		while (_s < _end)
+		{
+#ifdef RX_SSE2
+			for (; _end - _s >= 16; _s += 16, _d += 16)
+			{
+				__m128i _in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_s));
+				if (_mm_movemask_epi8(_in))
+					break;
+				__m128i _lo = _mm_unpacklo_epi8(_in, _mm_setzero_si128());
+				__m128i _hi = _mm_unpackhi_epi8(_in, _mm_setzero_si128());
+				if (sizeof(T) == 2)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d), _lo);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d + 8), _hi);
+				}
+				else
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d), _mm_unpacklo_epi16(_lo, _mm_setzero_si128()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d + 4), _mm_unpackhi_epi16(_lo, _mm_setzero_si128()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d + 8), _mm_unpacklo_epi16(_hi, _mm_setzero_si128()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(_d + 12), _mm_unpackhi_epi16(_hi, _mm_setzero_si128()));
+				}
+			}
+#endif
+			// decode at least 16 bytes before next check of ASCII
+			for (const uint8* _stop = _end - _s > 16 ? _s + 16 : _end; _s < _stop;)
+			{
+				uint _c = _DecodeUtf8(_s, _end);
+				if (_c == ~0u)
+				{
+					_c = 0xfffd;
+					++_s;
+				}
+				if (sizeof(T) == 2)
+					_d += _EncodeUtf16(_c, reinterpret_cast<uint16*>(_d));
+				else
+					*_d++ = (T)_c;
+			}
+		}
+		return (uint)(_d - _dst);
+	}
+
+	//! Encode codepoints as UTF-8. Counts the bytes only if Write is false.
+	template <bool Write> static uint _Utf32ToUtf8(const uint32* _src, uint _length, char* _dst)
+	{
+		uint _size = 0;
+		char _buff[4];
+		for (const uint32* _end = _src + _length; _src < _end; ++_src)
+		{
+			if (*_src < 0x80)
+			{
+				if (Write)
+					_dst[_size] = (char)*_src;
+				++_size;
+			}
+			else
+				_size += String::EncodeUtf8(*_src, Write ? _dst + _size : _buff);
+		}
+		return _size;
+	}
+
+	//! Encode UTF-16 as UTF-8. Unpaired surrogates are encoded as U+FFFD. Counts the bytes only if Write is false.
+	template <bool Write> static uint _Utf16ToUtf8(const uint16* _src, uint _length, char* _dst)
+	{
+		uint _size = 0;
+		char _buff[4];
+		for (const uint16* _end = _src + _length; _src < _end; ++_src)
+		{
+			uint _c = *_src;
+			if (_c < 0x80)
+			{
+				if (Write)
+					_dst[_size] = (char)_c;
+				++_size;
+				continue;
+			}
+			if (_c >= 0xd800 && _c < 0xe000)
+			{
+				if (_c < 0xdc00 && _src + 1 < _end && _src[1] >= 0xdc00 && _src[1] < 0xe000)
+					_c = 0x10000 + ((_c - 0xd800) << 10) + (*++_src - 0xdc00);
+				else
+					_c = 0xfffd;
+			}
+			_size += String::EncodeUtf8(_c, Write ? _dst + _size : _buff);
+		}
+		return _size;
+	}
+
+	//----------------------------------------------------------------------------//
+	// StringView
+	//----------------------------------------------------------------------------//
+
+	const StringView StringView::Empty;
+
+	//----------------------------------------------------------------------------//
+	StringView StringView::Trim(void) const
+	{
+		const char* _start = m_str;
+		const char* _end = m_str + m_length;
+		while (_start < _end && (uint8)*_start <= ' ')
+			++_start;
+		while (_end > _start && (uint8)_end[-1] <= ' ')
+			--_end;
+		return StringView(_start, _end);
+	}
+	//----------------------------------------------------------------------------//
+	const char* StringView::Find(const StringView& _str, bool _ignoreCase) const
+	{
+		return _ignoreCase ? _FindRange<true>(m_str, m_length, _str.m_str, _str.m_length) : _FindRange<false>(m_str, m_length, _str.m_str, _str.m_length);
+	}
+	//----------------------------------------------------------------------------//
+	int StringView::Compare(const StringView& _rhs, bool _ignoreCase) const
+	{
+		uint _length = m_length < _rhs.m_length ? m_length : _rhs.m_length;
+		int _d = _ignoreCase ? _CompareRange<true>(m_str, _rhs.m_str, _length) : _CompareRange<false>(m_str, _rhs.m_str, _length);
+		if (_d)
+			return _d;
+		return m_length < _rhs.m_length ? -1 : (m_length > _rhs.m_length ? 1 : 0);
+	}
+	//----------------------------------------------------------------------------//
+	uint StringView::Hash(uint _hash) const
+	{
+		return _HashRange<false>(m_str, m_str + m_length, _hash);
+	}
+	//----------------------------------------------------------------------------//
+	uint StringView::IHash(uint _hash) const
+	{
+		return _HashRange<true>(m_str, m_str + m_length, _hash);
+	}
+	//----------------------------------------------------------------------------//
+	int StringView::ToInt(int _default) const
+	{
+		int64 _value = ToInt64(_default);
+		return _value >= INT32_MIN && _value <= INT32_MAX ? (int)_value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	int64 StringView::ToInt64(int64 _default) const
+	{
+		StringView _str = Trim();
+		int64 _value;
+		return String::ParseInt(_str.m_str, _str.EndPtr(), _value) == _str.EndPtr() && _str.m_length ? _value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	uint StringView::ToUInt(uint _default) const
+	{
+		uint64 _value = ToUInt64(_default);
+		return _value <= UINT32_MAX ? (uint)_value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	uint64 StringView::ToUInt64(uint64 _default) const
+	{
+		StringView _str = Trim();
+		uint64 _value;
+		return String::ParseUInt(_str.m_str, _str.EndPtr(), _value) == _str.EndPtr() && _str.m_length ? _value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	float StringView::ToFloat(float _default) const
+	{
+		StringView _str = Trim();
+		float _value;
+		return String::ParseFloat(_str.m_str, _str.EndPtr(), _value) == _str.EndPtr() && _str.m_length ? _value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	double StringView::ToDouble(double _default) const
+	{
+		StringView _str = Trim();
+		double _value;
+		return String::ParseFloat(_str.m_str, _str.EndPtr(), _value) == _str.EndPtr() && _str.m_length ? _value : _default;
+	}
+	//----------------------------------------------------------------------------//
+	StringTokenizer StringView::Split(const char* _delimiters) const
+	{
+		return StringTokenizer(*this, _delimiters);
+	}
+	//----------------------------------------------------------------------------//
+	void StringView::Split(const char* _delimiters, Array<StringView>& _dst) const
+	{
+		StringTokenizer _tokenizer(*this, _delimiters);
+		for (StringView _token; _tokenizer.Next(_token);)
+			_dst.Push(_token);
+	}
+
+	//----------------------------------------------------------------------------//
+	// StringTokenizer
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	StringTokenizer::StringTokenizer(const StringView& _str, const char* _delimiters) : m_pos(_str.Ptr()), m_end(_str.EndPtr())
+	{
+		memset(m_delimiters, 0, sizeof(m_delimiters));
+		if (_delimiters)
+		{
+			for (; *_delimiters; ++_delimiters)
+				m_delimiters[(uint8)*_delimiters >> 5] |= 1u << (*_delimiters & 31);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	bool StringTokenizer::Next(StringView& _token)
+	{
+		while (m_pos < m_end && _IsDelimiter(*m_pos))
+			++m_pos;
+		if (m_pos == m_end)
+			return false;
+
+		const char* _start = m_pos;
+		while (m_pos < m_end && !_IsDelimiter(*m_pos))
+			++m_pos;
+		_token = StringView(_start, m_pos);
+		return true;
+	}
+
+	//----------------------------------------------------------------------------//
+	// String
+	//----------------------------------------------------------------------------//
+
+	const String String::Empty;
+
+	//----------------------------------------------------------------------------//
+	String::String(const char* _str1, int _length1, const char* _str2, int _length2)
+	{
+		_length1 = Length(_str1, _length1);
+		_length2 = Length(_str2, _length2);
+		Reserve(_length1 + _length2);
+		Append(_str1, _length1);
+		Append(_str2, _length2);
+	}
+	//----------------------------------------------------------------------------//
+	String& String::operator = (const String& _rhs)
+	{
+		if (_rhs.m_data != m_data)
+		{
+			Reserve(_rhs.m_length);
+			if (m_data)
+			{
+				memmove(m_data, _rhs.m_data, _rhs.m_length);
+				m_data[_rhs.m_length] = 0;
+			}
+			m_length = _rhs.m_length;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::operator = (String&& _rhs)
+	{
+		Swap(m_length, _rhs.m_length);
+		Swap(m_capacity, _rhs.m_capacity);
+		Swap(m_data, _rhs.m_data);
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::operator = (const char* _str)
+	{
+		uint _length = Length(_str);
+		Reserve(_length);
+		if (m_data)
+		{
+			memmove(m_data, _str, _length);
+			m_data[_length] = 0;
+		}
+		m_length = _length;
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::Reserve(uint _maxLength)
+	{
+		if (m_capacity < _maxLength)
+		{
+			_maxLength = GrowTo(m_capacity, _maxLength) | 15;
+			char* _newData = Allocate<char>(_maxLength + 1);
+			memcpy(_newData, m_data, m_length);
+			_newData[m_length] = 0;
+			Deallocate(m_data);
+			m_data = _newData;
+			m_capacity = _maxLength;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::Resize(uint _newLength, char _ch)
+	{
+		if (m_length < _newLength)
+		{
+			Append(_newLength - m_length, _ch);
+		}
+		else if (m_length > _newLength)
+		{
+			m_data[_newLength] = 0;
+			m_length = _newLength;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::Append(const char* _str, int _length)
+	{
+		_length = Length(_str, _length);
+		if (_length)
+		{
+			uint _newLength = m_length + _length;
+			Reserve(_newLength);
+			memmove(m_data + m_length, _str, _length);
+			m_length = _newLength;
+			m_data[m_length] = 0;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::Append(char _ch)
+	{
+		uint _newLength = m_length + 1;
+		Reserve(_newLength);
+		m_data[m_length] = _ch;
+		m_data[_newLength] = 0;
+		m_length = _newLength;
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::Append(uint _count, char _ch)
+	{
+		uint _newLength = m_length + _count;
+		Reserve(_newLength);
+		memset(m_data + m_length, _ch, _count);
+		m_length = _newLength;
+		m_data[m_length] = 0;
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::AppendInt(int64 _value)
+	{
+		char _buff[20];
+		return Append(_buff, IntToStr(_value, _buff));
+	}
+	//----------------------------------------------------------------------------//
+	String& String::AppendUInt(uint64 _value)
+	{
+		char _buff[20];
+		return Append(_buff, UIntToStr(_value, _buff));
+	}
+	//----------------------------------------------------------------------------//
+	String& String::AppendFloat(double _value)
+	{
+		char _buff[32];
+		return Append(_buff, FloatToStr(_value, _buff));
+	}
+	//----------------------------------------------------------------------------//
+	String& String::AppendFloat(float _value)
+	{
+		char _buff[32];
+		return Append(_buff, FloatToStr(_value, _buff));
+	}
+	//----------------------------------------------------------------------------//
+	String String::SubStr(uint _offset, int _length) const
+	{
+		if (_offset > m_length)
+			_offset = m_length;
+		if (_length < 0 || _offset + _length > m_length)
+			_length = m_length - _offset;
+		return String(m_data + _offset, _length);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Hash(const char* _str, uint _hash)
+	{
+		return _str ? _HashStr<false>(_str, _hash) : _hash;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::IHash(const char* _str, uint _hash)
+	{
+		return _str ? _HashStr<true>(_str, _hash) : _hash;
+	}
+	//----------------------------------------------------------------------------//
+	char* String::Lower(char* _str, int _length)
+	{
+		if (_str)
+			_ConvertCase<true>(_str, _str + Length(_str, _length));
+		return _str;
+	}
+	//----------------------------------------------------------------------------//
+	char* String::Upper(char* _str, int _length)
+	{
+		if (_str)
+			_ConvertCase<false>(_str, _str + Length(_str, _length));
+		return _str;
+	}
+	//----------------------------------------------------------------------------//
+	int String::Compare(const char* _lhs, const char* _rhs, bool _ignoreCase)
+	{
+		_lhs = _lhs ? _lhs : "";
+		_rhs = _rhs ? _rhs : "";
+		return _ignoreCase ? _CompareStrIgnoreCase(_lhs, _rhs) : strcmp(_lhs, _rhs);
+	}
+	//----------------------------------------------------------------------------//
+	const char* String::ParseInt(const char* _str, const char* _end, int64& _value)
+	{
+		bool _negative = _str < _end && *_str == '-';
+		if (_str < _end && (*_str == '-' || *_str == '+'))
+			++_str;
+		if (_str == _end || (uint8)(*_str - '0') >= 10)
+			return nullptr;
+		uint64 _v;
+		_str = _ParseUInt(_str, _end, _v);
+		if (!_str || _v > (uint64)INT64_MAX + _negative)
+			return nullptr;
+		_value = (int64)((_v ^ (0 - (uint64)_negative)) + _negative);
+		return _str;
+	}
+	//----------------------------------------------------------------------------//
+	const char* String::ParseUInt(const char* _str, const char* _end, uint64& _value)
+	{
+		if (_str < _end && *_str == '+')
+			++_str;
+		if (_str == _end || (uint8)(*_str - '0') >= 10)
+			return nullptr;
+		return _ParseUInt(_str, _end, _value);
+	}
+	//----------------------------------------------------------------------------//
+	const char* String::ParseFloat(const char* _str, const char* _end, double& _value)
+	{
+		return _ParseFloat(_str, _end, _value);
+	}
+	//----------------------------------------------------------------------------//
+	const char* String::ParseFloat(const char* _str, const char* _end, float& _value)
+	{
+		return _ParseFloat(_str, _end, _value);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::IntToStr(int64 _value, char* _dst)
+	{
+		uint64 _negative = _value < 0;
+		*_dst = '-';
+		return UIntToStr(((uint64)_value ^ (0 - _negative)) + _negative, _dst + _negative) + (uint)_negative;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::UIntToStr(uint64 _value, char* _dst)
+	{
+		uint _length = _DecimalLength(_value);
+		_UIntToStr(_value, _dst + _length);
+		return _length;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::FloatToStr(double _value, char* _dst)
+	{
+		return _FloatToStr(_value, _dst);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::FloatToStr(float _value, char* _dst)
+	{
+		return _FloatToStr(_value, _dst);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::_FormatTo(char* _buffer, uint _size, const char* _fmt, const FormatArg* _args, uint _numArgs)
+	{
+		_FormatOutput _out = { _buffer, _size ? _size - 1 : 0, 0 };
+		_Format(_out, _fmt, _args, _numArgs);
+		if (_size)
+			_buffer[_out.length < _out.size ? _out.length : _out.size] = 0;
+		return _out.length;
+	}
+	//----------------------------------------------------------------------------//
+	String& String::_FormatTo(String& _dst, const char* _fmt, const FormatArg* _args, uint _numArgs)
+	{
+		// the most of texts are short, so the second pass is rare
+		char _buff[512];
+		_FormatOutput _out = { _buff, sizeof(_buff), 0 };
+		_Format(_out, _fmt, _args, _numArgs);
+		if (_out.length <= _out.size)
+			return _dst.Append(_buff, _out.length);
+
+		uint _length = _out.length;
+		_dst.Reserve(_dst.m_length + _length);
+		_out = { _dst.m_data + _dst.m_length, _length, 0 };
+		_Format(_out, _fmt, _args, _numArgs);
+		_dst.m_length += _length;
+		_dst.m_data[_dst.m_length] = 0;
+		return _dst;
+	}
+	//----------------------------------------------------------------------------//
+	String String::FormatV(const char* _fmt, va_list _args)
+	{
+#if 0
+		char _buff[4096];
+		vsnprintf_s(_buff, sizeof(_buff), _fmt, _args);
+		return _buff;
+#else
+		//this code from ptypes: pputf.cxx
+		struct
+		{
+			bool operator () (char _ch) const
+			{
+				return strchr(" #+-~.0123456789", _ch) != 0;
+			}
+		} _check_fmtopts;
+		enum fmt_type_t { FMT_NONE, FMT_CHAR, FMT_SHORT, FMT_INT, FMT_LONG, FMT_LARGE, FMT_STR, FMT_PTR, FMT_DOUBLE, FMT_LONG_DOUBLE };
+
+		String _res;
+		fmt_type_t fmt_type;
+		const char *e, *p = _fmt;
+		char buf[4096], fbuf[128];
+		while (p && *p != 0)
+		{
+			// write out raw data between format specifiers
+			e = strchr(p, '%');
+			if (e == 0)
+				e = p + strlen(p);
+			if (e > p)
+				_res.Append(p, e);
+			if (*e != '%')
+				break;
+			if (*++e == '%') // write out a single '%' 
+			{
+				_res += '%';
+				p = e + 1;
+				continue;
+			}
+
+
+			// build a temporary buffer for the conversion specification
+			fbuf[0] = '%';
+			char* f = fbuf + 1;
+			bool modif = false;
+
+			// formatting flags and width specifiers
+			while (_check_fmtopts(*e) && uint(f - fbuf) < sizeof(fbuf) - 5)
+				*f++ = *e++, modif = true;
+
+			// prefixes
+			switch (*e)
+			{
+			case 'h':
+				fmt_type = FMT_SHORT;
+				*f++ = *e++;
+				break;
+
+			case 'L':
+				fmt_type = FMT_LONG_DOUBLE;
+				*f++ = *e++;
+				break;
+
+			case 'l':
+			{
+				if (*++e == 'l')
+				{
+#                   if defined(_MSC_VER) || defined(__BORLANDC__)
+					*f++ = 'I'; *f++ = '6'; *f++ = '4';
+#                   else
+					*f++ = 'l'; *f++ = 'l';
+#                   endif
+					++e;
+					fmt_type = FMT_LARGE;
+				}
+				else
+				{
+					*f++ = 'l';
+					fmt_type = FMT_LONG;
+					// x64 ?
+				}
+			} break;
+
+			default:
+				fmt_type = FMT_NONE;
+				break;
+			};
+
+			// format specifier
+			switch (*e)
+			{
+			case 'c':
+				fmt_type = FMT_CHAR;
+				*f++ = *e++;
+				break;
+
+			case 'd':
+			case 'i':
+			case 'o':
+			case 'u':
+			case 'x':
+			case 'X':
+				if (fmt_type < FMT_SHORT || fmt_type > FMT_LARGE)
+					fmt_type = FMT_INT;
+				*f++ = *e++;
+				break;
+
+			case 'e':
+			case 'E':
+			case 'f':
+			case 'g':
+			case 'G':
+				if (fmt_type != FMT_LONG_DOUBLE)
+					fmt_type = FMT_DOUBLE;
+				*f++ = *e++;
+				break;
+
+			case 's':
+				fmt_type = FMT_STR;
+				*f++ = *e++;
+				break;
+
+			case 'p':
+				fmt_type = FMT_PTR;
+				*f++ = *e++;
+				break;
+			};
+			if (fmt_type == FMT_NONE)
+				break;
+			*f = 0;
+
+			// some formatters are processed here 'manually', while others are passed to snprintf
+			int s = 0;
+			switch (fmt_type)
+			{
+			case FMT_NONE: // to avoid compiler warning 
+				break;
+			case FMT_CHAR:
+				if (modif)
+					s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
+				else
+					_res += (char)(va_arg(_args, int));
+				break;
+
+			case FMT_SHORT:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
+				break;
+
+			case FMT_INT:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
+				break;
+
+			case FMT_LONG:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, long));
+				break;
+
+			case FMT_LARGE:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int64));
+				break;
+
+			case FMT_STR:
+			{
+				if (modif)
+					s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, const char*));
+				else
+				{
+					const char* _str = va_arg(_args, const char*);
+					if (_str)
+						_res += _str;
+					//else _res += "<null>";
+				}
+			}break;
+
+			case FMT_PTR:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, void*));
+				break;
+			case FMT_DOUBLE:
+
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, double));
+				for (; s > 0; --s)
+				{
+					if (buf[s - 1] == '0')
+						buf[s - 1] = 0;
+					else if (buf[s - 1] == '.')
+					{
+						buf[--s] = 0;
+						break;
+					}
+					else
+						break;
+				}
+				break;
+
+			case FMT_LONG_DOUBLE:
+				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, long double));
+				break;
+			}
+
+			if (s > 0)
+				_res.Append(buf, s);
+
+			p = e;
+		}
+		return _res;
+#endif
+	}
+	//----------------------------------------------------------------------------//
+	WString String::ToWide(void) const
+	{
+		return ToWide(m_data, m_length);
+	}
+	//----------------------------------------------------------------------------//
+	WString String::ToWide(const char* _str, int _length)
+	{
+		uint _srcLength = Length(_str, _length);
+		WString _dst;
+		_dst.Reserve(_srcLength); // the number of units is not greater than the number of bytes
+		if (_dst.m_data)
+		{
+			_dst.m_length = _Utf8ToWide(_str, _srcLength, _dst.m_data);
+			_dst.m_data[_dst.m_length] = 0;
+		}
+		return _dst;
+	}
+	//----------------------------------------------------------------------------//
+	String String::FromWide(const wchar_t* _str, int _length)
+	{
+		uint _srcLength = WString::Length(_str, _length);
+		String _dst;
+		if (sizeof(wchar_t) == 2)
+		{
+			const uint16* _src = reinterpret_cast<const uint16*>(_str);
+			_dst.Reserve(_Utf16ToUtf8<false>(_src, _srcLength, nullptr));
+			_dst.m_length = _Utf16ToUtf8<true>(_src, _srcLength, _dst.m_data);
+		}
+		else
+		{
+			const uint32* _src = reinterpret_cast<const uint32*>(_str);
+			_dst.Reserve(_Utf32ToUtf8<false>(_src, _srcLength, nullptr));
+			_dst.m_length = _Utf32ToUtf8<true>(_src, _srcLength, _dst.m_data);
+		}
+		if (_dst.m_data)
+			_dst.m_data[_dst.m_length] = 0;
+		return _dst;
+	}
+	//----------------------------------------------------------------------------//
+	String String::FromWide(const WString& _str)
+	{
+		return FromWide(_str.CStr(), _str.Length());
+	}
+	//----------------------------------------------------------------------------//
+	bool String::IsValidUtf8(const char* _str, uint _length)
+	{
+		const uint8* _s = reinterpret_cast<const uint8*>(_str);
+#ifdef RX_X86
+		if (s_hasAvx2)
+			return _ValidateUtf8Avx2(_s, _s + _length);
+		if (s_hasSsse3)
+			return _ValidateUtf8Ssse3(_s, _s + _length);
+#endif
+		return _ValidateUtf8Scalar(_s, _s + _length);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Utf8Length(const char* _str, uint _length)
+	{
+		// well-formed text has one lead byte per codepoint, otherwise count as DecodeUtf8 decodes
+		if (!IsValidUtf8(_str, _length))
+		{
+			const uint8* _s = reinterpret_cast<const uint8*>(_str);
+			const uint8* _end = _s + _length;
+			uint _count = 0;
+			for (;;)
+			{
+				const uint8* _next = _SkipAscii(_s, _end);
+				_count += (uint)(_next - _s);
+				if ((_s = _next) == _end)
+					return _count;
+				if (_DecodeUtf8(_s, _end) == ~0u)
+					++_s;
+				++_count;
+			}
+		}
+
+		// number of bytes that are not continuations (10xxxxxx)
+		uint _count = 0, i = 0;
+#ifdef RX_SSE2
+		const __m128i _firstLead = _mm_set1_epi8((char)0xc0);
+		while (i + 16 <= _length)
+		{
+			// 8-bit counters of continuations, summed every 255 blocks
+			__m128i _acc = _mm_setzero_si128();
+			for (uint n = 0; n < 255 && i + 16 <= _length; ++n, i += 16)
+				_acc = _mm_sub_epi8(_acc, _mm_cmpgt_epi8(_firstLead, _mm_loadu_si128(reinterpret_cast<const __m128i*>(_str + i)))); // signed: 0x80..0xbf < 0xc0
+			__m128i _sum = _mm_sad_epu8(_acc, _mm_setzero_si128());
+			_count -= _mm_cvtsi128_si32(_sum) + _mm_extract_epi16(_sum, 4);
+		}
+		_count += i;
+#endif
+		for (; i < _length; ++i)
+			_count += ((uint8)_str[i] & 0xc0) != 0x80;
+		return _count;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::DecodeUtf8(const char*& _str, const char* _end)
+	{
+		ASSERT(_str < _end);
+		const uint8* _s = reinterpret_cast<const uint8*>(_str);
+		uint _c = _DecodeUtf8(_s, reinterpret_cast<const uint8*>(_end));
+		if (_c == ~0u)
+		{
+			_c = 0xfffd;
+			++_s;
+		}
+		_str = reinterpret_cast<const char*>(_s);
+		return _c;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::EncodeUtf8(uint _codepoint, char* _dst)
+	{
+		uint8* _d = reinterpret_cast<uint8*>(_dst);
+		if (_codepoint < 0x80)
+		{
+			_d[0] = (uint8)_codepoint;
+			return 1;
+		}
+		if (_codepoint < 0x800)
+		{
+			_d[0] = (uint8)(0xc0 | (_codepoint >> 6));
+			_d[1] = (uint8)(0x80 | (_codepoint & 0x3f));
+			return 2;
+		}
+		if (_codepoint >= 0x110000 || (_codepoint >= 0xd800 && _codepoint < 0xe000))
+			_codepoint = 0xfffd;
+		if (_codepoint < 0x10000)
+		{
+			_d[0] = (uint8)(0xe0 | (_codepoint >> 12));
+			_d[1] = (uint8)(0x80 | ((_codepoint >> 6) & 0x3f));
+			_d[2] = (uint8)(0x80 | (_codepoint & 0x3f));
+			return 3;
+		}
+		_d[0] = (uint8)(0xf0 | (_codepoint >> 18));
+		_d[1] = (uint8)(0x80 | ((_codepoint >> 12) & 0x3f));
+		_d[2] = (uint8)(0x80 | ((_codepoint >> 6) & 0x3f));
+		_d[3] = (uint8)(0x80 | (_codepoint & 0x3f));
+		return 4;
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Utf8ToUtf16(const char* _src, uint _length, uint16* _dst)
+	{
+		return _Utf8ToWide(_src, _length, _dst);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Utf8ToUtf32(const char* _src, uint _length, uint32* _dst)
+	{
+		return _Utf8ToWide(_src, _length, _dst);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Utf16ToUtf8(const uint16* _src, uint _length, char* _dst)
+	{
+		return _dst ? _Utf16ToUtf8<true>(_src, _length, _dst) : _Utf16ToUtf8<false>(_src, _length, nullptr);
+	}
+	//----------------------------------------------------------------------------//
+	uint String::Utf32ToUtf8(const uint32* _src, uint _length, char* _dst)
+	{
+		return _dst ? _Utf32ToUtf8<true>(_src, _length, _dst) : _Utf32ToUtf8<false>(_src, _length, nullptr);
+	}
+	//----------------------------------------------------------------------------//
+	bool String::Match(const char* _str, const char* _pattern, bool _ignoreCase)
+	{
+		return GlobPattern(_pattern, _ignoreCase).Match(_str);
+	}
+	//----------------------------------------------------------------------------//
+	const char* String::Find(const char* _str1, const char* _str2, bool _ignoreCase)
+	{
+		_str1 = _str1 ? _str1 : "";
+		_str2 = _str2 ? _str2 : "";
+		if (_ignoreCase)
+			return _FindRange<true>(_str1, (uint)strlen(_str1), _str2, (uint)strlen(_str2));
+		return strstr(_str1, _str2);
+	}
+	//----------------------------------------------------------------------------//
+	char* String::Find(char* _str1, const char* _str2, bool _ignoreCase)
+	{
+		return _str1 ? const_cast<char*>(Find(const_cast<const char*>(_str1), _str2, _ignoreCase)) : nullptr;
+	}
+	//----------------------------------------------------------------------------//
+	void String::Split(const char* _str, const char* _delimiters, Array<String>& _dst)
+	{
+		StringTokenizer _tokenizer(_str, _delimiters);
+		for (StringView _token; _tokenizer.Next(_token);)
+			_dst.Push(String(_token));
+	}
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	// StringBuilder
+	//----------------------------------------------------------------------------//
+
+	//----------------------------------------------------------------------------//
+	StringBuilder::StringBuilder(StringBuilder&& _temp) : m_first(_temp.m_first), m_last(_temp.m_last), m_length(_temp.m_length), m_chunkSize(_temp.m_chunkSize)
+	{
+		_temp.m_first = nullptr;
+		_temp.m_last = nullptr;
+		_temp.m_length = 0;
+	}
+	//----------------------------------------------------------------------------//
+	StringBuilder::~StringBuilder(void)
+	{
+		for (Chunk* _next; m_first; m_first = _next)
+		{
+			_next = m_first->next;
+			Deallocate(m_first);
+		}
+	}
+	//----------------------------------------------------------------------------//
+	StringBuilder& StringBuilder::Append(const char* _str, int _length)
+	{
+		uint _size = String::Length(_str, _length);
+		uint _space = _Space();
+		if (_size > _space && _space) // fill the last chunk
+		{
+			memcpy(m_last->data + m_last->size, _str, _space);
+			_Commit(_space);
+			_str += _space;
+			_size -= _space;
+		}
+		if (_size)
+		{
+			memcpy(_Reserve(_size), _str, _size);
+			_Commit(_size);
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	StringBuilder& StringBuilder::Append(uint _count, char _ch)
+	{
+		uint _space = _Space();
+		if (_count > _space && _space)
+		{
+			memset(m_last->data + m_last->size, _ch, _space);
+			_Commit(_space);
+			_count -= _space;
+		}
+		if (_count)
+		{
+			memset(_Reserve(_count), _ch, _count);
+			_Commit(_count);
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	StringBuilder& StringBuilder::Clear(void)
+	{
+		if (m_first)
+		{
+			for (Chunk *_next, *_chunk = m_first->next; _chunk; _chunk = _next)
 			{
-			case 'h':
-				fmt_type = FMT_SHORT;
-				*f++ = *e++;
-				break;
+				_next = _chunk->next;
+				Deallocate(_chunk);
+			}
+			m_first->next = nullptr;
+			m_first->size = 0;
+			m_last = m_first;
+		}
+		m_length = 0;
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	String StringBuilder::ToString(void) const
+	{
+		String _str;
+		if (m_length)
+		{
+			_str.Reserve(m_length);
+			CopyTo(_str.m_data);
+			_str.m_length = m_length;
+			_str.m_data[m_length] = 0;
+		}
+		return _str;
+	}
+	//----------------------------------------------------------------------------//
+	void StringBuilder::CopyTo(char* _dst) const
+	{
+		for (Chunk* _chunk = m_first; _chunk; _chunk = _chunk->next)
+		{
+			memcpy(_dst, _chunk->data, _chunk->size);
+			_dst += _chunk->size;
+		}
+	}
+	//----------------------------------------------------------------------------//
+	bool StringBuilder::WriteTo(FILE* _file) const
+	{
+		for (Chunk* _chunk = m_first; _chunk; _chunk = _chunk->next)
+		{
+			if (fwrite(_chunk->data, 1, _chunk->size, _file) != _chunk->size)
+				return false;
+		}
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	bool StringBuilder::WriteTo(int _fd) const
+	{
+		for (Chunk* _chunk = m_first; _chunk; _chunk = _chunk->next)
+		{
+			for (const char *_p = _chunk->data, *_end = _p + _chunk->size; _p < _end;)
+			{
+#ifdef _WIN32
+				int _written = _write(_fd, _p, (uint)(_end - _p));
+#else
+				ssize_t _written = write(_fd, _p, _end - _p);
+				if (_written < 0 && errno == EINTR)
+					continue;
+#endif
+				if (_written <= 0)
+					return false;
+				_p += _written;
+			}
+		}
+		return true;
+	}
+	//----------------------------------------------------------------------------//
+	char* StringBuilder::_AddChunk(uint _size)
+	{
+		uint _capacity = _size > m_chunkSize ? _size : m_chunkSize;
+		m_chunkSize = m_chunkSize < MaxChunkSize / 2 ? m_chunkSize * 2 : MaxChunkSize;
 
-			case 'L':
-				fmt_type = FMT_LONG_DOUBLE;
-				*f++ = *e++;
-				break;
+		Chunk* _chunk = AllocateBlock<Chunk>(sizeof(Chunk) + _capacity);
+		_chunk->next = nullptr;
+		_chunk->size = 0;
+		_chunk->capacity = _capacity;
+		if (m_last)
+			m_last->next = _chunk;
+		else
+			m_first = _chunk;
+		m_last = _chunk;
+		return _chunk->data;
+	}
 
-			case 'l':
+	//----------------------------------------------------------------------------//
+	// SharedString
+	//----------------------------------------------------------------------------//
+
+	const SharedString SharedString::Empty;
+
+	//----------------------------------------------------------------------------//
+	SharedString::Buffer* SharedString::_Create(const char* _str, uint _length)
+	{
+		if (!_length)
+			return nullptr;
+		Buffer* _buffer = AllocateBlock<Buffer>(sizeof(Buffer) + _length);
+		_buffer->refCount = 1;
+		_buffer->length = _length;
+		_buffer->hash = StringView(_str, _length).Hash();
+		memcpy(_buffer->str, _str, _length);
+		_buffer->str[_length] = 0;
+		return _buffer;
+	}
+
+	//----------------------------------------------------------------------------//
+	// StringId
+	//----------------------------------------------------------------------------//
+
+	//! Global table of interned strings. It is divided into shards by hash to reduce contention between threads.
+	class StringIdTable : public NonCopyable
+	{
+	public:
+		//! Number of shards. Must be power of two.
+		static const uint NUM_SHARDS = 32;
+		//! Size of memory block for entries.
+		static const uint BLOCK_SIZE = 64 * 1024;
+
+		//!
+		typedef StringId::Entry Entry;
+
+		//! \note The table is never destroyed, because static StringIds from other modules can refer to entries at exit.
+		static StringIdTable& Get(void)
+		{
+			static StringIdTable* _instance = new StringIdTable;
+			return *_instance;
+		}
+
+		//!
+		const Entry* Intern(const char* _str, uint _length, uint _hash)
+		{
+			Shard& _shard = m_shards[((_hash * 0x9e3779b1u) >> 27) & (NUM_SHARDS - 1)];
+			ScopeLock<SpinLock> _lock(_shard.lock);
+
+			if (_shard.buckets)
 			{
-				if (*++e == 'l')
+				for (Entry* _entry = _shard.buckets[_hash & (_shard.numBuckets - 1)]; _entry; _entry = _entry->next)
 				{
-#                   if defined(_MSC_VER) || defined(__BORLANDC__)
-					*f++ = 'I'; *f++ = '6'; *f++ = '4';
-#                   else
-					*f++ = 'l'; *f++ = 'l';
-#                   endif
-					++e;
-					fmt_type = FMT_LARGE;
+					if (_entry->hash == _hash && _entry->length == _length && !memcmp(_entry->str, _str, _length))
+						return _entry;
 				}
-				else
+			}
+
+			return _shard.Add(_str, _length, _hash);
+		}
+
+	protected:
+		//!
+		struct Shard
+		{
+			//!
+			Entry* Add(const char* _str, uint _length, uint _hash)
+			{
+				uint _size = (uint)((offsetof(Entry, str) + _length + 1 + (sizeof(void*) - 1)) & ~(sizeof(void*) - 1));
+				if (_size > blockSize - blockUsed)
 				{
-					*f++ = 'l';
-					fmt_type = FMT_LONG;
-					// x64 ?
+					blockSize = _size > BLOCK_SIZE ? _size : BLOCK_SIZE;
+					block = Allocate<uint8>(blockSize);
+					blockUsed = 0;
 				}
-			} break;
+				Entry* _entry = reinterpret_cast<Entry*>(block + blockUsed);
+				blockUsed += _size;
 
-			default:
-				fmt_type = FMT_NONE;
-				break;
-			};
+				_entry->hash = _hash;
+				_entry->length = _length;
+				memcpy(_entry->str, _str, _length);
+				_entry->str[_length] = 0;
 
-			// format specifier
-			switch (*e)
+				if (++size > numBuckets)
+					_Rehash(numBuckets ? numBuckets << 1 : 64);
+
+				uint _index = _hash & (numBuckets - 1);
+				_entry->next = buckets[_index];
+				buckets[_index] = _entry;
+
+				return _entry;
+			}
+
+			//!
+			void _Rehash(uint _newSize)
 			{
-			case 'c':
-				fmt_type = FMT_CHAR;
-				*f++ = *e++;
-				break;
+				Entry** _newBuckets = new Entry*[_newSize];
+				memset(_newBuckets, 0, _newSize * sizeof(Entry*));
+				for (uint i = 0; i < numBuckets; ++i)
+				{
+					for (Entry* _entry = buckets[i]; _entry;)
+					{
+						Entry* _next = _entry->next;
+						uint _index = _entry->hash & (_newSize - 1);
+						_entry->next = _newBuckets[_index];
+						_newBuckets[_index] = _entry;
+						_entry = _next;
+					}
+				}
+				delete[] buckets;
+				buckets = _newBuckets;
+				numBuckets = _newSize;
+			}
 
-			case 'd':
-			case 'i':
-			case 'o':
-			case 'u':
-			case 'x':
-			case 'X':
-				if (fmt_type < FMT_SHORT || fmt_type > FMT_LARGE)
-					fmt_type = FMT_INT;
-				*f++ = *e++;
-				break;
+			SpinLock lock;
+			Entry** buckets = nullptr;
+			uint numBuckets = 0;
+			uint size = 0;
+			uint8* block = nullptr;
+			uint blockSize = 0;
+			uint blockUsed = 0;
+		};
 
-			case 'e':
-			case 'E':
-			case 'f':
-			case 'g':
-			case 'G':
-				if (fmt_type != FMT_LONG_DOUBLE)
-					fmt_type = FMT_DOUBLE;
-				*f++ = *e++;
-				break;
+		Shard m_shards[NUM_SHARDS];
+	};
 
-			case 's':
-				fmt_type = FMT_STR;
-				*f++ = *e++;
-				break;
+	//----------------------------------------------------------------------------//
+	const StringId StringId::Empty;
+	//----------------------------------------------------------------------------//
+	StringId::StringId(const char* _str, int _length)
+	{
+		StringView _view(_str, String::Length(_str, _length));
+		m_entry = _Intern(_view.Ptr(), _view.Length(), _view.Hash());
+	}
+	//----------------------------------------------------------------------------//
+	const StringId::Entry* StringId::_Intern(const char* _str, uint _length, uint _hash)
+	{
+		return _length ? StringIdTable::Get().Intern(_str, _length, _hash) : nullptr;
+	}
+	//----------------------------------------------------------------------------//
 
-			case 'p':
-				fmt_type = FMT_PTR;
-				*f++ = *e++;
-				break;
-			};
-			if (fmt_type == FMT_NONE)
-				break;
-			*f = 0;
+	//----------------------------------------------------------------------------//
+	// GlobPattern
+	//----------------------------------------------------------------------------//
 
-			// some formatters are processed here 'manually', while others are passed to snprintf
-			int s = 0;
-			switch (fmt_type)
+	//----------------------------------------------------------------------------//
+	GlobPattern& GlobPattern::Compile(const char* _pattern, bool _ignoreCase)
+	{
+		m_pattern = _pattern;
+		m_text.Clear();
+		m_ops.Clear();
+		m_sets.Clear();
+		m_minLength = 0;
+		m_suffixLength = 0;
+		m_ignoreCase = _ignoreCase;
+		m_valid = m_pattern.NonEmpty();
+
+		for (const char* _p = m_pattern.CStr(); _p && *_p;)
+		{
+			Op _op = { OP_Text, m_text.Length(), 0 };
+			if (*_p == '*')
 			{
-			case FMT_NONE: // to avoid compiler warning 
-				break;
-			case FMT_CHAR:
-				if (modif)
-					s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
-				else
-					_res += (char)(va_arg(_args, int));
-				break;
+				while (*++_p == '*');
+				_op.type = OP_Star;
+				m_ops.Push(_op);
+				continue;
+			}
 
-			case FMT_SHORT:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
-				break;
+			++m_minLength;
+			if (*_p == '?')
+			{
+				_op.type = OP_Any;
+				++_p;
+			}
+			else if (*_p == ' ')
+			{
+				while (*++_p == ' ');
+				_op.type = OP_Spaces;
+			}
+			else if (*_p == '[')
+			{
+				// items and ranges, the bounds of range can be in any order
+				CharSet _items = { { 0 } }, _ranges = { { 0 } };
+				for (++_p; *_p && *_p != ']'; ++_p)
+				{
+					if (*_p == '\\' && (_p[1] == '[' || _p[1] == ']' || _p[1] == '\\'))
+						++_p;
+					char _ch = _ignoreCase ? String::Lower(*_p) : *_p;
+					_items.bits[(uint8)_ch >> 5] |= 1u << (_ch & 31);
+					if (_p[1] == '-' && _p[2] != ']') // '-' before ']' is a character
+					{
+						if (!_p[2]) // unfinished range never matches
+						{
+							m_valid = false;
+							break;
+						}
+						int _lo = _p[0] < _p[2] ? _p[0] : _p[2], _hi = _p[0] < _p[2] ? _p[2] : _p[0];
+						for (int c = _lo; c <= _hi; ++c)
+							_ranges.bits[(uint8)c >> 5] |= 1u << (c & 31);
+						_p += 2;
+					}
+				}
+				if (*_p)
+					++_p;
 
-			case FMT_INT:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int));
-				break;
+				CharSet _set = { { 0 } };
+				for (int c = -128; c < 128; ++c)
+				{
+					char _ch = (char)c;
+					if (_ignoreCase ? (_items.Contains(String::Lower(_ch)) || _ranges.Contains(String::Lower(_ch)) || _ranges.Contains(String::Upper(_ch))) : (_items.Contains(_ch) || _ranges.Contains(_ch)))
+						_set.bits[(uint8)_ch >> 5] |= 1u << (_ch & 31);
+				}
+				_op.type = OP_Set;
+				_op.start = m_sets.Size();
+				m_sets.Push(_set);
+			}
+			else
+			{
+				if (*_p == '\\' && (_p[1] == '[' || _p[1] == ']' || _p[1] == '\\'))
+					++_p;
+				m_text.Append(_ignoreCase ? String::Lower(*_p) : *_p);
+				++_p;
+				if (m_ops.NonEmpty() && m_ops.Back().type == OP_Text)
+				{
+					++m_ops.Back().length;
+					continue;
+				}
+				_op.length = 1;
+			}
+			m_ops.Push(_op);
+		}
+
+		uint _numOps = m_ops.Size();
+		if (_numOps >= 2 && m_ops[_numOps - 1].type == OP_Text && m_ops[_numOps - 2].type == OP_Star)
+			m_suffixLength = m_ops[_numOps - 1].length;
+
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	bool GlobPattern::Match(const StringView& _str) const
+	{
+		if (!m_valid || _str.IsEmpty() || _str.Length() < m_minLength)
+			return false;
 
-			case FMT_LONG:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, long));
-				break;
+		const char* _end = _str.EndPtr();
+		uint _numOps = m_ops.Size();
+		if (m_suffixLength) // "*.ext": the end is checked first, the last '*' absorbs the rest
+		{
+			const char* _suffix = m_text.CStr(m_text.Length() - m_suffixLength);
+			_end -= m_suffixLength;
+			if (m_ignoreCase ? _Mismatch<true>(_end, _suffix, m_suffixLength) != m_suffixLength : memcmp(_end, _suffix, m_suffixLength) != 0)
+				return false;
+			--_numOps;
+		}
+		return _Match(_str.Ptr(), _end, _numOps);
+	}
+	//----------------------------------------------------------------------------//
+	bool GlobPattern::_Match(const char* _str, const char* _end, uint _numOps) const
+	{
+		// Greedy matching with return to the last '*' only. All other elements have one way to match,
+		// so the earliest match of the part after '*' is always the best.
 
-			case FMT_LARGE:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, int64));
-				break;
+		const Op* _ops = m_ops.Data();
+		const char* _text = m_text.CStr();
+		const char* _s = _str;
+		const char* _starS = nullptr;
+		uint _starP = 0;
+		bool _star = false;
 
-			case FMT_STR:
+		for (uint p = 0;;)
+		{
+			if (p < _numOps)
 			{
-				if (modif)
-					s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, const char*));
-				else
+				const Op& _op = _ops[p];
+				if (_op.type == OP_Star)
 				{
-					const char* _str = va_arg(_args, const char*);
-					if (_str)
-						_res += _str;
-					//else _res += "<null>";
+					if (++p == _numOps)
+						return true;
+					_star = true;
+					_starP = p;
+					_starS = _s;
+					goto $_find;
 				}
-			}break;
-
-			case FMT_PTR:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, void*));
-				break;
-			case FMT_DOUBLE:
-
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, double));
-				for (; s > 0; --s)
+				if (_s < _end)
 				{
-					if (buf[s - 1] == '0')
-						buf[s - 1] = 0;
-					else if (buf[s - 1] == '.')
+					switch (_op.type)
 					{
-						buf[--s] = 0;
+					case OP_Text:
+						if ((uint)(_end - _s) >= _op.length && (m_ignoreCase ? _Mismatch<true>(_s, _text + _op.start, _op.length) == _op.length : memcmp(_s, _text + _op.start, _op.length) == 0))
+						{
+							_s += _op.length;
+							++p;
+							continue;
+						}
 						break;
-					}
-					else
+					case OP_Any:
+						++_s;
+						++p;
+						continue;
+					case OP_Spaces:
+						if (*_s != ' ')
+							break;
+						while (++_s < _end && *_s == ' ');
+						++p;
+						continue;
+					case OP_Set:
+						if (!m_sets[_op.start].Contains(*_s))
+							break;
+						++_s;
+						++p;
+						continue;
+					default:
 						break;
+					}
 				}
-				break;
+			}
+			else if (_s == _end)
+				return true;
 
-			case FMT_LONG_DOUBLE:
-				s = _snprintf(buf, sizeof(buf), fbuf, va_arg(_args, long double));
-				break;
+			// try the next position for the last '*'
+			if (!_star || _starS >= _end)
+				return false;
+			p = _starP;
+			_s = ++_starS;
+
+		$_find:
+			if (_ops[p].type == OP_Text) // skip to the next occurrence of text
+			{
+				const Op& _op = _ops[p];
+				_s = m_ignoreCase ? _FindRange<true>(_s, (uint)(_end - _s), _text + _op.start, _op.length) : _FindRange<false>(_s, (uint)(_end - _s), _text + _op.start, _op.length);
+				if (!_s)
+					return false;
+				_starS = _s;
+			}
+		}
+	}
+	//----------------------------------------------------------------------------//
+	uint GlobPattern::Filter(const StringView* _strs, uint _count, Array<uint>& _dst) const
+	{
+		uint _matched = 0;
+		for (uint i = 0; i < _count; ++i)
+		{
+			if (Match(_strs[i]))
+			{
+				_dst.Push(i);
+				++_matched;
+			}
+		}
+		return _matched;
+	}
+	//----------------------------------------------------------------------------//
+	uint GlobPattern::Filter(const Array<String>& _strs, Array<uint>& _dst) const
+	{
+		uint _matched = 0;
+		for (uint i = 0; i < _strs.Size(); ++i)
+		{
+			if (Match(_strs[i]))
+			{
+				_dst.Push(i);
+				++_matched;
 			}
+		}
+		return _matched;
+	}
 
-			if (s > 0)
-				_res.Append(buf, s);
+	//----------------------------------------------------------------------------//
+	// GlobSet
+	//----------------------------------------------------------------------------//
 
-			p = e;
+	//----------------------------------------------------------------------------//
+	uint GlobSet::Add(const char* const* _patterns, uint _count, bool _ignoreCase)
+	{
+		uint _first = m_patterns.Size();
+		for (uint i = 0; i < _count; ++i)
+		{
+			uint _index = m_patterns.Size();
+			m_patterns.Push(GlobPattern(_patterns[i], _ignoreCase));
+			char _key = m_patterns.Back().SuffixKey();
+			if (!_key)
+				m_other.Push(_index);
+			else if (_ignoreCase)
+				m_byISuffix[(uint8)_key].Push(_index);
+			else
+				m_bySuffix[(uint8)_key].Push(_index);
 		}
-		return _res;
-#endif
+		if (!m_overflow) // new patterns never reduce the number of states
+			_Build();
+		return _first;
 	}
 	//----------------------------------------------------------------------------//
-	bool String::Match(const char* _str, const char* _pattern, bool _ignoreCase)
+	GlobSet& GlobSet::Clear(void)
+	{
+		m_patterns.Clear();
+		m_other.Clear();
+		for (uint i = 0; i < 256; ++i)
+		{
+			m_bySuffix[i].Clear();
+			m_byISuffix[i].Clear();
+		}
+		m_transitions.Clear();
+		m_matchedStart.Clear();
+		m_matched.Clear();
+		m_numClasses = 0;
+		m_start = 0;
+		m_overflow = false;
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	void GlobSet::_Build(void)
 	{
-		// '*' - any symbols sequence
-		// ' '(space) - any number of spaces
-		// '['charset']' - set of symbols
-		// '['lower'-'upper']' - range of symbols
-		// "file.ext" matched "*.ext"
+		typedef GlobPattern::CharSet CharSet;
+		enum : uint8 { E_Char, E_Star, E_Spaces, E_End };
+		struct Element
+		{
+			uint8 type;
+			uint set;
+			uint pattern;
+		};
 
-		if (!_str || !_str[0])
-			return false;
-		if (!_pattern || !_pattern[0])
-			return false;
+		m_transitions.Clear();
+		m_matchedStart.Clear();
+		m_matched.Clear();
+		m_numClasses = 0;
+		m_start = 0;
 
-		Array<Pair<const char*, const char*>> _stack; // <string, pattern>
-		_stack.Push({ _str, _pattern });
-		for (const char *_s = _str, *_p = _pattern;;)
+		// elements of all patterns, '?', '[...]' and each character of text match one character of a set
+		Array<Element> _elements;
+		Array<uint> _starts;
+		Array<CharSet> _sets;
+		CharSet _any, _space = { { 0 } };
+		memset(&_any, 0xff, sizeof(_any));
+		_space.bits[' ' >> 5] |= 1u << (' ' & 31);
+		_sets.Push(_any);
+		for (uint p = 0; p < m_patterns.Size(); ++p)
 		{
-		$_frame:
-			if (*_p == 0 && *_s == 0)
-				goto $_true;
-			if (*_s == 0 && *_p != '*')
-				goto $_false;
-			if (*_p == '*') // 
+			const GlobPattern& _pattern = m_patterns[p];
+			if (!_pattern.m_valid)
+				continue;
+			_starts.Push(_elements.Size());
+			for (uint i = 0; i < _pattern.m_ops.Size(); ++i)
 			{
-				++_p;
-				if (*_p == 0) goto $_true;
-				for (;; )
+				const GlobPattern::Op& _op = _pattern.m_ops[i];
+				switch (_op.type)
 				{
-					_stack.Back().first = _s;
-					_stack.Back().second = _p;
-					_stack.Push({ _s, _p });
-					goto $_frame;
-				$_xmatch_true:
-					goto $_true;
-				$_xmatch_false:
-					if (*_s == 0)
-						goto $_false;
-					++_s;
+				case GlobPattern::OP_Text:
+					for (uint j = 0; j < _op.length; ++j)
+					{
+						char _ch = _pattern.m_text.CStr()[_op.start + j];
+						CharSet _set = { { 0 } };
+						for (uint c = 0; c < 256; ++c)
+						{
+							if ((_pattern.m_ignoreCase ? String::Lower((char)c) : (char)c) == _ch)
+								_set.bits[c >> 5] |= 1u << (c & 31);
+						}
+						_elements.Push({ E_Char, _sets.Size(), p });
+						_sets.Push(_set);
+					}
+					break;
+				case GlobPattern::OP_Any:
+					_elements.Push({ E_Char, 0, p });
+					break;
+				case GlobPattern::OP_Star:
+					_elements.Push({ E_Star, 0, p });
+					break;
+				case GlobPattern::OP_Spaces:
+					_elements.Push({ E_Spaces, 0, p });
+					break;
+				case GlobPattern::OP_Set:
+					_elements.Push({ E_Char, _sets.Size(), p });
+					_sets.Push(_pattern.m_sets[_op.start]);
+					break;
 				}
 			}
-			if (*_p == '?') //   
-				goto $_match;
-			if (*_p == ' ') //   
+			_elements.Push({ E_End, 0, p });
+		}
+		if (_elements.IsEmpty())
+			return;
+
+		// classes of characters: split the classes by each set
+		uint _numClasses = 1;
+		memset(m_classes, 0, sizeof(m_classes));
+		for (uint i = 0; i <= _sets.Size(); ++i)
+		{
+			const CharSet& _set = i < _sets.Size() ? _sets[i] : _space;
+			uint16 _remap[512];
+			memset(_remap, 0xff, _numClasses * 2 * sizeof(uint16));
+			uint _newNumClasses = 0;
+			for (uint c = 0; c < 256; ++c)
+			{
+				uint _key = m_classes[c] * 2 + _set.Contains((char)c);
+				if (_remap[_key] == 0xffff)
+					_remap[_key] = (uint16)_newNumClasses++;
+				m_classes[c] = (uint8)_remap[_key];
+			}
+			_numClasses = _newNumClasses;
+		}
+		uint8 _chars[256];
+		for (uint c = 256; c-- > 0;)
+			_chars[m_classes[c]] = (uint8)c;
+
+		// state of DFA is a set of positions: element * 2 + 1 if the element is ' ' and it has matched some spaces.
+		// ' ' takes all spaces like in GlobPattern::_Match, so the next element gets only a character that is not a space.
+		uint _words = (_elements.Size() * 2 + 31) / 32;
+		Array<uint> _states;
+		HashMap<uint, Array<uint>> _index;
+		Array<uint> _positions, _bits(_words, 0);
+
+		// position before element and before all elements after '*'
+		auto _enter = [&](uint _e)
+		{
+			for (;; ++_e)
 			{
-				if (*_s == ' ')
-				{
-					for (; _p[1] == ' '; ++_p);
-					for (; _s[1] == ' '; ++_s);
-					goto $_match;
-				}
-				goto $_false;
+				_bits[_e >> 4] |= 1u << ((_e * 2) & 31);
+				if (_elements[_e].type != E_Star)
+					break;
+			}
+		};
+		auto _step = [&](uint _e, char _ch)
+		{
+			const Element& _element = _elements[_e];
+			if (_element.type == E_Char && _sets[_element.set].Contains(_ch))
+				_enter(_e + 1);
+			else if (_element.type == E_Star)
+				_enter(_e);
+			else if (_element.type == E_Spaces && _ch == ' ')
+				_bits[_e >> 4] |= 2u << ((_e * 2) & 31);
+		};
+		auto _addState = [&](void) -> uint
+		{
+			Array<uint>& _list = _index[Hash(_bits.Data(), _words * sizeof(uint))];
+			for (uint _id : _list)
+			{
+				if (!memcmp(_states.Data() + _id * _words, _bits.Data(), _words * sizeof(uint)))
+					return _id;
+			}
+			uint _id = _states.Size() / _words;
+			_states.Push(_bits.Data(), _words);
+			_list.Push(_id);
+			return _id;
+		};
+
+		_addState(); // empty set
+		for (uint _start : _starts)
+			_enter(_start);
+		m_start = _addState();
+
+		for (uint _state = 0; _state < _states.Size() / _words; ++_state)
+		{
+			if (_state >= MAX_STATES) // too large, use candidates
+			{
+				m_transitions.Clear();
+				m_matchedStart.Clear();
+				m_matched.Clear();
+				m_start = 0;
+				m_overflow = true;
+				return;
 			}
-			if (*_p == '[') //  
+
+			// positions and matched patterns
+			_positions.Clear();
+			m_matchedStart.Push(m_matched.Size());
+			for (uint w = 0; w < _words; ++w)
 			{
-				for (++_p; ; )
+				for (uint _b = _states[_state * _words + w]; _b; _b &= _b - 1)
 				{
-					if (*_p == ']' || *_p == 0)
-						goto $_false;
-					if (*_p == '\\') //  
+					uint _pos = w * 32 + RX_CTZ(_b), _last = _pos >> 1;
+					_positions.Push(_pos);
+					if (_pos & 1)
 					{
-						if (_p[1] == '[' || _p[1] == ']' || _p[1] == '\\')
-							++_p;
+						while (_elements[++_last].type == E_Star);
 					}
-					if (_ignoreCase ? (Lower(*_p) == Lower(*_s)) : (*_p == *_s))
-						break;
+					uint _pattern = _elements[_last].pattern;
+					if (_elements[_last].type == E_End && (m_matched.Size() == m_matchedStart.Back() || m_matched.Back() != _pattern))
+						m_matched.Push(_pattern);
+				}
+			}
 
-					if (_p[1] == '-') // 
+			// transitions
+			for (uint c = 0; c < _numClasses; ++c)
+			{
+				char _ch = (char)_chars[c];
+				memset(_bits.Data(), 0, _words * sizeof(uint));
+				for (uint _pos : _positions)
+				{
+					uint _e = _pos >> 1;
+					if (!(_pos & 1))
+						_step(_e, _ch);
+					else if (_ch == ' ')
+						_bits[_e >> 4] |= 2u << ((_e * 2) & 31);
+					else
 					{
-						if (!_p[2])
-							goto $_false;
-						if (_ignoreCase)
-						{
-							char l = Lower(*_s);
-							char u = Upper(*_s);
-							if (_p[0] <= l && _p[2] >= l)
-								break;
-							if (_p[0] >= l && _p[2] <= l)
-								break;
-							if (_p[0] <= u && _p[2] >= u)
-								break;
-							if (_p[0] >= u && _p[2] <= u)
-								break;
-						}
-						else
+						for (uint i = _e + 1;; ++i)
 						{
-							if (_p[0] <= *_s && _p[2] >= *_s)
-								break;
-							if (_p[0] >= *_s && _p[2] <= *_s)
+							_step(i, _ch);
+							if (_elements[i].type != E_Star)
 								break;
 						}
-						_p += 2;
 					}
-					++_p;
 				}
-				while (*_p != ']')
+				m_transitions.Push((uint16)_addState());
+			}
+		}
+		m_matchedStart.Push(m_matched.Size());
+		m_numClasses = _numClasses;
+	}
+	//----------------------------------------------------------------------------//
+	uint GlobSet::_Run(const StringView& _str, const uint*& _matched) const
+	{
+		uint _state = _str.NonEmpty() ? m_start : 0;
+		const uint16* _transitions = m_transitions.Data();
+		for (const char* _s = _str.Ptr(), *_end = _s + _str.Length(); _s < _end && _state; ++_s)
+			_state = _transitions[_state * m_numClasses + m_classes[(uint8)*_s]];
+		_matched = m_matched.Data() + m_matchedStart[_state];
+		return m_matchedStart[_state + 1] - m_matchedStart[_state];
+	}
+	//----------------------------------------------------------------------------//
+	void GlobSet::_Candidates(const StringView& _str, const uint*(&_lists)[3], uint(&_sizes)[3]) const
+	{
+		char _last = _str.NonEmpty() ? _str.EndPtr()[-1] : 0;
+		const Array<uint>& _a = m_bySuffix[(uint8)_last];
+		const Array<uint>& _b = m_byISuffix[(uint8)String::Lower(_last)];
+		_lists[0] = m_other.Data(), _sizes[0] = m_other.Size();
+		_lists[1] = _a.Data(), _sizes[1] = _a.Size();
+		_lists[2] = _b.Data(), _sizes[2] = _b.Size();
+	}
+	//----------------------------------------------------------------------------//
+	int GlobSet::Find(const StringView& _str) const
+	{
+		if (m_numClasses)
+		{
+			const uint* _matched;
+			return _Run(_str, _matched) ? (int)_matched[0] : -1;
+		}
+
+		const uint* _lists[3];
+		uint _sizes[3];
+		_Candidates(_str, _lists, _sizes);
+
+		uint _best = m_patterns.Size();
+		for (uint l = 0; l < 3; ++l)
+		{
+			for (uint i = 0; i < _sizes[l] && _lists[l][i] < _best; ++i)
+			{
+				if (m_patterns[_lists[l][i]].Match(_str))
 				{
-					if (*_p == '\\' && (_p[1] == '[' || _p[1] == ']' || _p[1] == '\\')) //  
-						++_p;
-					if (*_p == 0)
-					{
-						--_p;
-						break;
-					}
-					++_p;
+					_best = _lists[l][i];
+					break;
 				}
-				goto $_match;
 			}
-			if (*_p == '\\' && (_p[1] == '[' || _p[1] == ']' || _p[1] == '\\')) //  
-				++_p;
-			if (_ignoreCase ? (Lower(*_p) != Lower(*_s)) : (*_p != *_s))
-				goto $_false;
+		}
+		return _best < m_patterns.Size() ? (int)_best : -1;
+	}
+	//----------------------------------------------------------------------------//
+	uint GlobSet::MatchAll(const StringView& _str, Array<uint>& _dst) const
+	{
+		if (m_numClasses)
+		{
+			const uint* _matched;
+			uint _count = _Run(_str, _matched);
+			_dst.Push(_matched, _count);
+			return _count;
+		}
 
-		$_match:
-			++_p;
-			++_s;
-			continue;
-		$_true:
-			if (_stack.Size() > 1)
+		const uint* _lists[3];
+		uint _sizes[3];
+		_Candidates(_str, _lists, _sizes);
+
+		uint _matched = 0;
+		for (uint _pos[3] = { 0, 0, 0 };;)
+		{
+			// merge of sorted lists
+			uint _min = ~0u, _list = 0;
+			for (uint l = 0; l < 3; ++l)
 			{
-				_stack.Pop();
-				_s = _stack.Back().first;
-				_p = _stack.Back().second;
-				goto $_xmatch_true;
+				if (_pos[l] < _sizes[l] && _lists[l][_pos[l]] < _min)
+					_min = _lists[l][_pos[l]], _list = l;
 			}
-			return true;
-		$_false:
-			if (_stack.Size() > 1)
+			if (_min == ~0u)
+				break;
+			++_pos[_list];
+			if (m_patterns[_min].Match(_str))
 			{
-				_stack.Pop();
-				_s = _stack.Back().first;
-				_p = _stack.Back().second;
-				goto $_xmatch_false;
+				_dst.Push(_min);
+				++_matched;
 			}
-			break;
 		}
-		return false;
+		return _matched;
 	}
 	//----------------------------------------------------------------------------//
-	const char* String::Find(const char* _str1, const char* _str2, bool _ignoreCase)
+	uint GlobSet::Filter(const StringView* _strs, uint _count, Array<uint>& _dst) const
 	{
-		_str1 = _str1 ? _str1 : "";
-		_str2 = _str2 ? _str2 : "";
-		if (_ignoreCase)
+		uint _matched = 0;
+		for (uint i = 0; i < _count; ++i)
 		{
-			for (; *_str1; *_str1++)
+			if (Find(_strs[i]) >= 0)
 			{
-				for (const char *a = _str1, *b = _str2; Lower(*a++) == Lower(*b++);)
-				{
-					if (!*b)
-						return _str1;
-				}
+				_dst.Push(i);
+				++_matched;
 			}
-			return nullptr;
 		}
-		return strstr(_str1, _str2);
+		return _matched;
 	}
 	//----------------------------------------------------------------------------//
-	char* String::Find(char* _str1, const char* _str2, bool _ignoreCase)
+	uint GlobSet::Filter(const Array<String>& _strs, Array<uint>& _dst) const
 	{
-		if (!_str1)
-			return nullptr;
-
-		_str2 = _str2 ? _str2 : "";
-		if (_ignoreCase)
+		uint _matched = 0;
+		for (uint i = 0; i < _strs.Size(); ++i)
 		{
-			for (; *_str1; *_str1++)
+			if (Find(_strs[i]) >= 0)
 			{
-				for (const char *a = _str1, *b = _str2; Lower(*a++) == Lower(*b++);)
-				{
-					if (!*b)
-						return _str1;
-				}
+				_dst.Push(i);
+				++_matched;
 			}
-			return nullptr;
 		}
-		return strstr(_str1, _str2);
+		return _matched;
 	}
+
 	//----------------------------------------------------------------------------//
-	void String::Split(const char* _str, const char* _delimiters, Array<String>& _dst)
+	// WString
+	//----------------------------------------------------------------------------//
+
+	const WString WString::Empty;
+
+	//----------------------------------------------------------------------------//
+	WString& WString::operator = (const WString& _rhs)
 	{
-		if (_str)
+		if (_rhs.m_data != m_data)
+			Clear().Append(_rhs);
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString& WString::operator = (WString&& _rhs)
+	{
+		Swap(m_length, _rhs.m_length);
+		Swap(m_capacity, _rhs.m_capacity);
+		Swap(m_data, _rhs.m_data);
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString& WString::Reserve(uint _maxLength)
+	{
+		if (m_capacity < _maxLength)
 		{
-			const char* _end = _str;
-			if (_delimiters)
-			{
-				while (*_str)
-				{
-					while (*_str && strchr(_delimiters, *_str))
-						++_str;
-					_end = _str;
-					while (*_end && !strchr(_delimiters, *_end))
-						++_end;
-					if (_str != _end)
-						_dst.Push(String(_str, _end));
-					_str = _end;
-				}
-			}
-			else
-				_end = _str + strlen(_str);
-			if (_str != _end)
-				_dst.Push(String(_str, _end));
+			_maxLength = GrowTo(m_capacity, _maxLength) | 7;
+			wchar_t* _newData = Allocate<wchar_t>(_maxLength + 1);
+			if (m_data)
+				memcpy(_newData, m_data, m_length * sizeof(wchar_t));
+			_newData[m_length] = 0;
+			Deallocate(m_data);
+			m_data = _newData;
+			m_capacity = _maxLength;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString& WString::Resize(uint _newLength, wchar_t _ch)
+	{
+		if (m_length < _newLength)
+		{
+			Append(_newLength - m_length, _ch);
+		}
+		else if (m_length > _newLength)
+		{
+			m_data[_newLength] = 0;
+			m_length = _newLength;
 		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString& WString::Append(const wchar_t* _str, int _length)
+	{
+		_length = Length(_str, _length);
+		if (_length)
+		{
+			uint _newLength = m_length + _length;
+			Reserve(_newLength);
+			memmove(m_data + m_length, _str, _length * sizeof(wchar_t));
+			m_length = _newLength;
+			m_data[m_length] = 0;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString& WString::Append(uint _count, wchar_t _ch)
+	{
+		if (_count)
+		{
+			uint _newLength = m_length + _count;
+			Reserve(_newLength);
+			for (wchar_t* _p = m_data + m_length; _count--;)
+				*_p++ = _ch;
+			m_length = _newLength;
+			m_data[m_length] = 0;
+		}
+		return *this;
+	}
+	//----------------------------------------------------------------------------//
+	WString WString::SubStr(uint _offset, int _length) const
+	{
+		if (_offset > m_length)
+			_offset = m_length;
+		if (_length < 0 || _offset + _length > m_length)
+			_length = m_length - _offset;
+		return WString(m_data + _offset, _length);
 	}
 	//----------------------------------------------------------------------------//
+	uint WString::Hash(uint _hash) const
+	{
+		for (uint i = 0; i < m_length; ++i)
+			_hash = m_data[i] + (_hash << 6) + (_hash << 16) - _hash;
+		return _hash;
+	}
 
 	//----------------------------------------------------------------------------//
 	// 
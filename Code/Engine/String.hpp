@@ -1,12 +1,301 @@
 #pragma once
 
 #include "Container.hpp"
+#include "Concurrency.hpp"
 
 namespace Reax
 {
 	//!\addtogroup String
 	//!\{
 
+	class String;
+	class StringTokenizer;
+	class StringId;
+	class WString;
+	class Utf8Range;
+
+	//----------------------------------------------------------------------------//
+	// StringView
+	//----------------------------------------------------------------------------//
+
+	//! Non-owning reference to a range of characters. Is not null-terminated.
+	class RX_API StringView
+	{
+	public:
+		//!
+		typedef ArrayIterator<const char> Iterator;
+		//!
+		typedef ArrayIterator<const char> ConstIterator;
+
+		//!
+		StringView(void) = default;
+		//!
+		StringView(const char* _str) : m_str(_str ? _str : ""), m_length(_str ? (uint)strlen(_str) : 0) { }
+		//!
+		StringView(const char* _str, uint _length) : m_str(_str ? _str : ""), m_length(_length) { ASSERT(_str || !_length); }
+		//!
+		StringView(const char* _start, const char* _end) : m_str(_start), m_length((uint)(_end - _start)) { ASSERT(_start <= _end); }
+
+		//!
+		char operator [] (uint _index) const { ASSERT(_index < m_length); return m_str[_index]; }
+		//!
+		char At(uint _index) const { ASSERT(_index < m_length); return m_str[_index]; }
+		//!
+		const char* Data(void) const { return m_str; }
+		//!
+		const char* Ptr(void) const { return m_str; }
+		//! Pointer to the end of range.
+		const char* EndPtr(void) const { return m_str + m_length; }
+
+		//!
+		ConstIterator Begin(void) const { return m_str; }
+		//!
+		ConstIterator End(void) const { return m_str + m_length; }
+
+		//!
+		bool IsEmpty(void) const { return m_length == 0; }
+		//!
+		bool NonEmpty(void) const { return m_length != 0; }
+		//!
+		uint Length(void) const { return m_length; }
+		//!
+		uint Size(void) const { return m_length; }
+
+		//!
+		bool operator == (const StringView& _rhs) const { return m_length == _rhs.m_length && Compare(_rhs) == 0; }
+		//!
+		bool operator != (const StringView& _rhs) const { return !(*this == _rhs); }
+		//!
+		bool operator < (const StringView& _rhs) const { return Compare(_rhs) < 0; }
+		//!
+		bool operator <= (const StringView& _rhs) const { return Compare(_rhs) <= 0; }
+		//!
+		bool operator > (const StringView& _rhs) const { return Compare(_rhs) > 0; }
+		//!
+		bool operator >= (const StringView& _rhs) const { return Compare(_rhs) >= 0; }
+
+		//!
+		StringView SubStr(uint _offset, int _length = -1) const
+		{
+			if (_offset > m_length)
+				_offset = m_length;
+			if (_length < 0 || _offset + _length > m_length)
+				_length = m_length - _offset;
+			return StringView(m_str + _offset, (uint)_length);
+		}
+		//! Get the range without leading and trailing whitespaces.
+		StringView Trim(void) const;
+		//!
+		bool StartsWith(const StringView& _str, bool _ignoreCase = false) const { return m_length >= _str.m_length && SubStr(0, _str.m_length).Compare(_str, _ignoreCase) == 0; }
+		//!
+		bool EndsWith(const StringView& _str, bool _ignoreCase = false) const { return m_length >= _str.m_length && SubStr(m_length - _str.m_length).Compare(_str, _ignoreCase) == 0; }
+
+		//! \return pointer to the first occurrence or nullptr.
+		const char* Find(char _ch) const { return m_length ? reinterpret_cast<const char*>(memchr(m_str, _ch, m_length)) : nullptr; }
+		//! \return pointer to the first occurrence or nullptr.
+		const char* Find(const StringView& _str, bool _ignoreCase = false) const;
+		//!
+		int Compare(const StringView& _rhs, bool _ignoreCase = false) const;
+		//! \note Is equal to String::Hash of the same text.
+		uint Hash(uint _hash = 0) const;
+		//! \note Is equal to String::IHash of the same text.
+		uint IHash(uint _hash = 0) const;
+
+		//! Convert the whole range to number. Leading and trailing whitespaces are skipped.
+		//!\return _default if the range is not a number or the number is out of range. \see String::ParseInt, String::ParseFloat
+		int ToInt(int _default = 0) const;
+		//!
+		int64 ToInt64(int64 _default = 0) const;
+		//!
+		uint ToUInt(uint _default = 0) const;
+		//!
+		uint64 ToUInt64(uint64 _default = 0) const;
+		//!
+		float ToFloat(float _default = 0) const;
+		//!
+		double ToDouble(double _default = 0) const;
+
+		//! Lazy split to tokens. Empty tokens are skipped.
+		StringTokenizer Split(const char* _delimiters) const;
+		//! Split to tokens. Empty tokens are skipped.
+		void Split(const char* _delimiters, Array<StringView>& _dst) const;
+
+		static const StringView Empty;
+
+	protected:
+		const char* m_str = "";
+		uint m_length = 0;
+	};
+
+	//!
+	inline uint MakeHash(const StringView& _value) { return _value.Hash(); }
+
+	//!
+	inline auto begin(const StringView& _str)->decltype(_str.Begin()) { return _str.Begin(); }
+	//!
+	inline auto end(const StringView& _str)->decltype(_str.End()) { return _str.End(); }
+
+	//----------------------------------------------------------------------------//
+	// StringTokenizer
+	//----------------------------------------------------------------------------//
+
+	//! Lazy splitting of a string to tokens. Does not allocate memory.
+	class RX_API StringTokenizer
+	{
+	public:
+		//!
+		class Iterator
+		{
+		public:
+			//!
+			Iterator(StringTokenizer* _owner = nullptr) : m_owner(_owner) { _Next(); }
+			//!
+			const StringView& operator * (void) const { return m_token; }
+			//!
+			const StringView* operator -> (void) const { return &m_token; }
+			//!
+			Iterator& operator ++ (void) { _Next(); return *this; }
+			//! Only the end is comparable.
+			bool operator == (const Iterator& _rhs) const { return m_owner == _rhs.m_owner; }
+			//! Only the end is comparable.
+			bool operator != (const Iterator& _rhs) const { return m_owner != _rhs.m_owner; }
+
+		protected:
+			//!
+			void _Next(void) { if (m_owner && !m_owner->Next(m_token)) m_owner = nullptr; }
+
+			StringTokenizer* m_owner;
+			StringView m_token;
+		};
+
+		//!
+		StringTokenizer(const StringView& _str, const char* _delimiters);
+
+		//! Get next token. \return false if no more tokens.
+		bool Next(StringView& _token);
+		//! Get remaining part of the string.
+		StringView Tail(void) const { return StringView(m_pos, m_end); }
+
+		//!
+		Iterator Begin(void) { return Iterator(this); }
+		//!
+		Iterator End(void) { return Iterator(); }
+
+	protected:
+		//!
+		bool _IsDelimiter(char _ch) const { return (m_delimiters[(uint8)_ch >> 5] & (1u << (_ch & 31))) != 0; }
+
+		const char* m_pos;
+		const char* m_end;
+		uint m_delimiters[8]; // bitset of 256 bits
+	};
+
+	//!
+	inline StringTokenizer::Iterator begin(StringTokenizer& _tokenizer) { return _tokenizer.Begin(); }
+	//!
+	inline StringTokenizer::Iterator end(StringTokenizer& _tokenizer) { return _tokenizer.End(); }
+
+	//----------------------------------------------------------------------------//
+	// FormatArg
+	//----------------------------------------------------------------------------//
+
+	//! Argument of String::Format. The value keeps its own type, so the format specifier defines only the appearance of the value.
+	class RX_API FormatArg
+	{
+	public:
+		//!
+		enum Type : uint8
+		{
+			T_None,
+			T_Bool,
+			T_Char,
+			T_Int,
+			T_UInt,
+			T_Float,
+			T_Double,
+			T_String,
+			T_Pointer,
+		};
+
+		//!
+		FormatArg(void) : m_type(T_None) { m_uint = 0; }
+		//!
+		FormatArg(bool _value) : m_type(T_Bool) { m_uint = _value; }
+		//!
+		FormatArg(char _value) : m_type(T_Char) { m_uint = (uint8)_value; }
+		//!
+		FormatArg(signed char _value) : m_type(T_Int) { m_int = _value; }
+		//!
+		FormatArg(unsigned char _value) : m_type(T_UInt) { m_uint = _value; }
+		//!
+		FormatArg(short _value) : m_type(T_Int) { m_int = _value; }
+		//!
+		FormatArg(unsigned short _value) : m_type(T_UInt) { m_uint = _value; }
+		//!
+		FormatArg(int _value) : m_type(T_Int) { m_int = _value; }
+		//!
+		FormatArg(unsigned int _value) : m_type(T_UInt) { m_uint = _value; }
+		//!
+		FormatArg(long _value) : m_type(T_Int) { m_int = _value; }
+		//!
+		FormatArg(unsigned long _value) : m_type(T_UInt) { m_uint = _value; }
+		//!
+		FormatArg(long long _value) : m_type(T_Int) { m_int = _value; }
+		//!
+		FormatArg(unsigned long long _value) : m_type(T_UInt) { m_uint = _value; }
+		//!
+		FormatArg(float _value) : m_type(T_Float) { m_float = _value; }
+		//!
+		FormatArg(double _value) : m_type(T_Double) { m_double = _value; }
+		//!
+		FormatArg(long double _value) : m_type(T_Double) { m_double = (double)_value; }
+		//! The length is computed when the argument is written.
+		FormatArg(const char* _str) : m_type(T_String) { m_str.ptr = _str; m_str.length = ~0u; }
+		//!
+		FormatArg(const StringView& _str) : m_type(T_String) { m_str.ptr = _str.Ptr(); m_str.length = _str.Length(); }
+		//!
+		FormatArg(const String& _str);
+		//!
+		FormatArg(const StringId& _str);
+		//!
+		FormatArg(const void* _ptr) : m_type(T_Pointer) { m_ptr = _ptr; }
+		//!
+		FormatArg(decltype(nullptr)) : m_type(T_Pointer) { m_ptr = nullptr; }
+
+		//!
+		Type GetType(void) const { return m_type; }
+		//!
+		int64 Int(void) const { return m_int; }
+		//!
+		uint64 UInt(void) const { return m_uint; }
+		//!
+		float Float(void) const { return m_float; }
+		//!
+		double Double(void) const { return m_double; }
+		//!
+		const char* Str(void) const { return m_str.ptr; }
+		//!
+		uint StrLength(void) const;
+		//!
+		const void* Ptr(void) const { return m_ptr; }
+
+	protected:
+		Type m_type;
+		union
+		{
+			int64 m_int;
+			uint64 m_uint;
+			float m_float;
+			double m_double;
+			const void* m_ptr;
+			struct
+			{
+				const char* ptr;
+				uint length;
+			} m_str;
+		};
+	};
+
 	//----------------------------------------------------------------------------//
 	// String
 	//----------------------------------------------------------------------------//
@@ -42,6 +331,8 @@ namespace Reax
 		//!
 		String(uint _count, char _ch) { Append(_count, _ch); }
 		//!
+		String(const StringView& _str) { Append(_str.Ptr(), _str.Length()); }
+		//!
 		String(const char* _str1, int _length1, const char* _str2, int _length2);
 
 		//!
@@ -68,6 +359,10 @@ namespace Reax
 		char* Data(uint _offset = 0) { ASSERT(_offset <= m_length); return m_data + _offset; }
 		//!
 		const char* CStr(uint _offset = 0) const { ASSERT(_offset <= m_length); return m_data + _offset; }
+		//!
+		operator StringView (void) const { return StringView(m_data, m_length); }
+		//!
+		StringView View(void) const { return StringView(m_data, m_length); }
 
 		//!
 		Iterator Begin(void) { return m_data; }
@@ -104,11 +399,17 @@ namespace Reax
 		//! 
 		String& operator += (char _rhs) { return Append(_rhs); }
 		//! 
-		String operator + (const String& _rhs) const { return String(m_data, m_length, _rhs.m_data, _rhs.m_length); }
+		String operator + (const String& _rhs) const & { return String(m_data, m_length, _rhs.m_data, _rhs.m_length); }
 		//! 
-		String operator + (const char* _rhs) const { return String(m_data, m_length, _rhs, -1); }
+		String operator + (const char* _rhs) const & { return String(m_data, m_length, _rhs, -1); }
 		//! 
-		String operator + (char _rhs) const { return String(m_data, m_length, &_rhs, 1); }
+		String operator + (char _rhs) const & { return String(m_data, m_length, &_rhs, 1); }
+		//! Append to temporary string. The chain a + b + c reuses the buffer of the first temporary.
+		String operator + (const String& _rhs) && { return Move(Append(_rhs)); }
+		//! 
+		String operator + (const char* _rhs) && { return Move(Append(_rhs)); }
+		//! 
+		String operator + (char _rhs) && { return Move(Append(_rhs)); }
 		//!
 		friend String operator + (const char* _lhs, const String& _rhs) { return String(_lhs, -1, _rhs.m_data, _rhs.m_length); }
 		//!
@@ -117,6 +418,8 @@ namespace Reax
 		//!
 		String& Append(const String& _str) { return Append(_str.m_data, _str.m_length); }
 		//!
+		String& Append(const StringView& _str) { return Append(_str.Ptr(), _str.Length()); }
+		//!
 		String& Append(const char* _str, int _length = -1);
 		//!
 		String& Append(const char* _start, const char* _end) { return Append(_start, (uint)(_end - _start)); }
@@ -124,6 +427,14 @@ namespace Reax
 		String& Append(char _ch);
 		//!
 		String& Append(uint _count, char _ch);
+		//! Append decimal integer.
+		String& AppendInt(int64 _value);
+		//!
+		String& AppendUInt(uint64 _value);
+		//! Append float in the shortest form that is read back to the same value. \see FloatToStr
+		String& AppendFloat(double _value);
+		//!
+		String& AppendFloat(float _value);
 
 		//!
 		bool operator == (const String& _rhs) const { return m_length == _rhs.m_length && Compare(m_data, _rhs.m_data) == 0; }
@@ -144,6 +455,8 @@ namespace Reax
 
 		//!
 		String SubStr(uint _offset, int _length = -1) const;
+		//! Get a part of string without copying.
+		StringView SubView(uint _offset, int _length = -1) const { return View().SubStr(_offset, _length); }
 		//!
 		String Copy(void) const { return *this; }
 		//!
@@ -151,14 +464,27 @@ namespace Reax
 		//!
 		String& MakeUpper(void) { Upper(m_data, m_length); return *this; }
 		//!
-		String Lower(void) const { Copy().MakeLower(); }
+		String Lower(void) const { return Copy().MakeLower(); }
 		//!
-		String Upper(void) const { Copy().MakeUpper(); }
+		String Upper(void) const { return Copy().MakeUpper(); }
 		//!
 		uint Hash(uint _hash = 0) const { return Hash(m_data, _hash); }
 		//!
 		uint IHash(uint _hash = 0) const { return IHash(m_data, _hash); }
 
+		//! Convert the whole string to number. \see StringView::ToInt
+		int ToInt(int _default = 0) const { return View().ToInt(_default); }
+		//!
+		int64 ToInt64(int64 _default = 0) const { return View().ToInt64(_default); }
+		//!
+		uint ToUInt(uint _default = 0) const { return View().ToUInt(_default); }
+		//!
+		uint64 ToUInt64(uint64 _default = 0) const { return View().ToUInt64(_default); }
+		//!
+		float ToFloat(float _default = 0) const { return View().ToFloat(_default); }
+		//!
+		double ToDouble(double _default = 0) const { return View().ToDouble(_default); }
+
 
 		//!
 		static uint Length(const char* _str, int _length = -1) { return _str ? (uint)(_length < 0 ? strlen(_str) : _length) : 0; }
@@ -186,12 +512,68 @@ namespace Reax
 		//!
 		static int Compare(const char* _lhs, const char* _rhs, bool _ignoreCase = false);
 
-		//!
-		static String Format(const char* _fmt, ...);
-		//!
+		//! Number of arguments required by the format. \see RX_FORMAT
+		static constexpr uint FormatArgCount(const char* _fmt, uint _count = 0)
+		{
+			return *_fmt != '%' ? (*_fmt ? FormatArgCount(_fmt + 1, _count) : _count) : (_fmt[1] == '%' ? FormatArgCount(_fmt + 2, _count) : _FormatSpecArgCount(_fmt + 1, _count));
+		}
+
+		//! Type-safe printf-like formatting: %[flags][width][.precision][length]conversion.
+		//! Flags are '-', '+', ' ', '#' and '0'. Length modifiers are skipped, the type of the value is taken from the argument.
+		//! Conversions: d, i, u, x, X, o, c, s, p, f, F, e, E, g, G. Other conversions write the value in its default form.
+		//! Floats without precision are written in the shortest form that is read back to the same value.
+		//! Each specifier takes one argument, the missing arguments are written as empty strings.
+		//! Width and precision '*' take one more integer argument before the value, negative width is left-justified, negative precision is ignored.
+		template <class... Args> static String Format(const char* _fmt, const Args&... _args)
+		{
+			const FormatArg _argv[] = { _args..., FormatArg() };
+			String _str;
+			_FormatTo(_str, _fmt, _argv, sizeof...(Args));
+			return _str;
+		}
+		//! Format with the number of arguments checked at compile time. \see RX_FORMAT
+		template <uint Count, class... Args> static String Format(const char* _fmt, const Args&... _args)
+		{
+			static_assert(Count == sizeof...(Args), "Wrong number of format arguments");
+			return Format(_fmt, _args...);
+		}
+		//! Write formatted text to the buffer. The result is always null-terminated when _size is not zero.
+		//!\return Length of the whole text, can be greater than _size - 1.
+		template <class... Args> static uint FormatTo(char* _buffer, uint _size, const char* _fmt, const Args&... _args)
+		{
+			const FormatArg _argv[] = { _args..., FormatArg() };
+			return _FormatTo(_buffer, _size, _fmt, _argv, sizeof...(Args));
+		}
+		//! Append formatted text to the string. Allocates memory at most once.
+		template <class... Args> static String& FormatTo(String& _dst, const char* _fmt, const Args&... _args)
+		{
+			const FormatArg _argv[] = { _args..., FormatArg() };
+			return _FormatTo(_dst, _fmt, _argv, sizeof...(Args));
+		}
+		//! Legacy printf formatting of C variable arguments.
 		static String FormatV(const char* _fmt, va_list _args);
 
-		//!
+		//! Parse decimal integer with optional sign at the beginning of the range. Whitespaces are not skipped, the range may be not null-terminated.
+		//!\return Pointer past the number, or nullptr if there is no number or it is out of range.
+		static const char* ParseInt(const char* _str, const char* _end, int64& _value);
+		//! Parse decimal integer with optional '+'. \see ParseInt
+		static const char* ParseUInt(const char* _str, const char* _end, uint64& _value);
+		//! Parse decimal float [+-]digits[.digits][(e|E)[+-]digits], "inf", "infinity" or "nan" at the beginning of the range.
+		//! The result is correctly rounded, as by strtod in the "C" locale. \return Pointer past the number or nullptr.
+		static const char* ParseFloat(const char* _str, const char* _end, double& _value);
+		//!
+		static const char* ParseFloat(const char* _str, const char* _end, float& _value);
+		//! Write decimal integer to _dst without null-terminator. _dst must have space for 20 chars. \return Number of written chars.
+		static uint IntToStr(int64 _value, char* _dst);
+		//! \see IntToStr
+		static uint UIntToStr(uint64 _value, char* _dst);
+		//! Write float in the shortest form that is read back to the same value, as %g of Format without precision.
+		//! _dst must have space for 32 chars. Null-terminator is not written. \return Number of written chars.
+		static uint FloatToStr(double _value, char* _dst);
+		//! The shortest form for float, so 0.1f is written as "0.1". \see FloatToStr
+		static uint FloatToStr(float _value, char* _dst);
+
+		//! Match the glob pattern. The pattern is compiled on each call, use GlobPattern to match it many times.
 		static bool Match(const char* _str, const char* _pattern, bool _ignoreCase = true);
 		//!
 		static const char* Find(const char* _str1, const char* _str2, bool _ignoreCase = false);
@@ -199,9 +581,61 @@ namespace Reax
 		static char* Find(char* _str1, const char* _str2, bool _ignoreCase = false);
 		//!
 		static void Split(const char* _str, const char* _delimiters, Array<String>& _dst);
+		//! Lazy split to tokens without copying. Empty tokens are skipped.
+		StringTokenizer Split(const char* _delimiters) const { return StringTokenizer(View(), _delimiters); }
+
+		//! Codepoints of UTF-8 text.
+		Utf8Range Codepoints(void) const;
+		//! Number of codepoints in UTF-8 text.
+		uint Utf8Length(void) const { return Utf8Length(m_data, m_length); }
+		//!
+		bool IsValidUtf8(void) const { return IsValidUtf8(m_data, m_length); }
+		//! Convert UTF-8 to UTF-16 (16-bit wchar_t) or UTF-32. Invalid sequences are replaced by U+FFFD.
+		WString ToWide(void) const;
+		//!
+		static WString ToWide(const char* _str, int _length = -1);
+		//! Convert UTF-16 (16-bit wchar_t) or UTF-32 to UTF-8. Invalid sequences are replaced by U+FFFD.
+		static String FromWide(const wchar_t* _str, int _length = -1);
+		//!
+		static String FromWide(const WString& _str);
+
+		//! Check that the text is well-formed UTF-8 (no overlong forms, surrogates and codepoints above U+10FFFF).
+		static bool IsValidUtf8(const char* _str, uint _length);
+		//! Number of codepoints in UTF-8 text. Each byte of invalid sequence is counted as a codepoint, like DecodeUtf8 and Utf8Iterator decode it.
+		static uint Utf8Length(const char* _str, uint _length);
+		//! Decode one codepoint and move _str to the next one. Invalid byte is decoded as U+FFFD. \note _str must be less than _end.
+		static uint DecodeUtf8(const char*& _str, const char* _end);
+		//! \return Number of written bytes (1-4). Invalid codepoint is encoded as U+FFFD.
+		static uint EncodeUtf8(uint _codepoint, char* _dst);
+		//! _dst must have space for _length units. \return Number of written units.
+		static uint Utf8ToUtf16(const char* _src, uint _length, uint16* _dst);
+		//! _dst must have space for _length codepoints. \return Number of written codepoints.
+		static uint Utf8ToUtf32(const char* _src, uint _length, uint32* _dst);
+		//! \return Number of bytes. If _dst is null, only counts the bytes.
+		static uint Utf16ToUtf8(const uint16* _src, uint _length, char* _dst);
+		//! \return Number of bytes. If _dst is null, only counts the bytes.
+		static uint Utf32ToUtf8(const uint32* _src, uint _length, char* _dst);
 
 		static const String Empty;
 
+	protected:
+		friend class StringBuilder;
+
+		//!
+		static uint _FormatTo(char* _buffer, uint _size, const char* _fmt, const FormatArg* _args, uint _numArgs);
+		//!
+		static String& _FormatTo(String& _dst, const char* _fmt, const FormatArg* _args, uint _numArgs);
+		//! Number of arguments of the specifier: one for the value and one for each '*'. \see FormatArgCount
+		static constexpr uint _FormatSpecArgCount(const char* _fmt, uint _count)
+		{
+			return *_fmt == '*' ? _FormatSpecArgCount(_fmt + 1, _count + 1) : (_FormatIsSpecChar(*_fmt) ? _FormatSpecArgCount(_fmt + 1, _count) : (*_fmt ? FormatArgCount(_fmt + 1, _count + 1) : _count + 1));
+		}
+		//! Flag, digit, '.' or length modifier.
+		static constexpr bool _FormatIsSpecChar(char _ch, const char* _chars = "-+ #.0123456789hlLzjtqI")
+		{
+			return *_chars && (*_chars == _ch || _FormatIsSpecChar(_ch, _chars + 1));
+		}
+
 	private:
 		const char* operator * (void) const = delete;
 		template <class T> String operator - (const T&) = delete;
@@ -225,22 +659,634 @@ namespace Reax
 	//!
 	inline auto end(const String& _str)->decltype(_str.End()) { return _str.End(); }
 
+	//----------------------------------------------------------------------------//
+	// StringBuilder
+	//----------------------------------------------------------------------------//
+
+	//! Accumulates text in a list of chunks. The text is never moved, ToString allocates and copies it exactly once.
+	class RX_API StringBuilder : public NonCopyable
+	{
+	public:
+		//! \param _chunkSize size of the first chunk, the next chunks are doubled up to MaxChunkSize.
+		StringBuilder(uint _chunkSize = 1024) : m_chunkSize(_chunkSize ? _chunkSize : 1024) { }
+		//!
+		StringBuilder(StringBuilder&& _temp);
+		//!
+		~StringBuilder(void);
+
+		//!
+		StringBuilder& Append(const char* _str, int _length = -1);
+		//!
+		StringBuilder& Append(const StringView& _str) { return Append(_str.Ptr(), _str.Length()); }
+		//!
+		StringBuilder& Append(const String& _str) { return Append(_str.CStr(), _str.Length()); }
+		//!
+		StringBuilder& Append(char _ch) { *_Reserve(1) = _ch; return _Commit(1); }
+		//!
+		StringBuilder& Append(uint _count, char _ch);
+		//!
+		StringBuilder& AppendInt(int64 _value) { return _Commit(String::IntToStr(_value, _Reserve(20))); }
+		//!
+		StringBuilder& AppendUInt(uint64 _value) { return _Commit(String::UIntToStr(_value, _Reserve(20))); }
+		//! \see String::FloatToStr
+		StringBuilder& AppendFloat(double _value) { return _Commit(String::FloatToStr(_value, _Reserve(32))); }
+		//!
+		StringBuilder& AppendFloat(float _value) { return _Commit(String::FloatToStr(_value, _Reserve(32))); }
+		//! Append formatted text. \see String::Format
+		template <class... Args> StringBuilder& AppendFormat(const char* _fmt, const Args&... _args)
+		{
+			char* _dst = _Reserve(0);
+			uint _space = _Space();
+			uint _length = String::FormatTo(_dst, _space, _fmt, _args...);
+			if (_length >= _space)
+				String::FormatTo(_Reserve(_length + 1), _length + 1, _fmt, _args...);
+			return _Commit(_length);
+		}
+
+		//!
+		StringBuilder& operator << (const StringView& _str) { return Append(_str.Ptr(), _str.Length()); }
+		//!
+		StringBuilder& operator << (const String& _str) { return Append(_str.CStr(), _str.Length()); }
+		//!
+		StringBuilder& operator << (const char* _str) { return Append(_str); }
+		//!
+		StringBuilder& operator << (char _ch) { return Append(_ch); }
+		//! Number, boolean or pointer in default format. \see FormatArg
+		template <class T> StringBuilder& operator << (const T& _value) { return AppendFormat("%s", _value); }
+
+		//!
+		uint Length(void) const { return m_length; }
+		//!
+		bool IsEmpty(void) const { return m_length == 0; }
+		//! Remove the text. The first chunk is kept for reuse.
+		StringBuilder& Clear(void);
+
+		//! Copy the text to a new string.
+		String ToString(void) const;
+		//! Copy the text without terminating null. _dst must have space for Length() characters.
+		void CopyTo(char* _dst) const;
+		//! Write the text to the file.
+		bool WriteTo(FILE* _file) const;
+		//! Write the text to the file descriptor.
+		bool WriteTo(int _fd) const;
+
+		//!
+		static const uint MaxChunkSize = 1024 * 1024;
+
+	protected:
+		//!
+		struct Chunk
+		{
+			Chunk* next;
+			uint size;
+			uint capacity;
+			char data[1];
+		};
+
+		//! Free space of last chunk.
+		uint _Space(void) const { return m_last ? m_last->capacity - m_last->size : 0; }
+		//! Get space for _size characters at end of last chunk. Adds a new chunk if needed.
+		char* _Reserve(uint _size) { return _size <= _Space() && m_last ? m_last->data + m_last->size : _AddChunk(_size); }
+		//!
+		StringBuilder& _Commit(uint _size) { m_last->size += _size; m_length += _size; return *this; }
+		//!
+		char* _AddChunk(uint _size);
+
+		Chunk* m_first = nullptr;
+		Chunk* m_last = nullptr;
+		uint m_length = 0;
+		uint m_chunkSize;
+	};
+
+	//----------------------------------------------------------------------------//
+	// SharedString
+	//----------------------------------------------------------------------------//
+
+	//! Immutable string. All copies share one reference-counted buffer, so a copy is a single atomic increment.
+	//! The length and the hash are computed once, when the buffer is created.
+	class RX_API SharedString
+	{
+	public:
+		//!
+		SharedString(void) = default;
+		//!
+		SharedString(const char* _str, int _length = -1) : m_buffer(_Create(_str, String::Length(_str, _length))) { }
+		//!
+		SharedString(const StringView& _str) : m_buffer(_Create(_str.Ptr(), _str.Length())) { }
+		//!
+		SharedString(const String& _str) : m_buffer(_Create(_str.CStr(), _str.Length())) { }
+		//!
+		SharedString(const SharedString& _other) : m_buffer(_other.m_buffer) { _AddRef(); }
+		//!
+		SharedString(SharedString&& _temp) : m_buffer(_temp.m_buffer) { _temp.m_buffer = nullptr; }
+		//!
+		~SharedString(void) { _Release(); }
+
+		//!
+		SharedString& operator = (const SharedString& _rhs)
+		{
+			_rhs._AddRef();
+			_Release();
+			m_buffer = _rhs.m_buffer;
+			return *this;
+		}
+		//!
+		SharedString& operator = (SharedString&& _rhs) { Swap(m_buffer, _rhs.m_buffer); return *this; }
+
+		//!
+		bool operator == (const SharedString& _rhs) const
+		{
+			return m_buffer == _rhs.m_buffer || (Length() == _rhs.Length() && Hash() == _rhs.Hash() && memcmp(CStr(), _rhs.CStr(), Length()) == 0);
+		}
+		//!
+		bool operator != (const SharedString& _rhs) const { return !(*this == _rhs); }
+		//!
+		bool operator == (const StringView& _rhs) const { return View() == _rhs; }
+		//!
+		bool operator != (const StringView& _rhs) const { return View() != _rhs; }
+		//!
+		bool operator == (const String& _rhs) const { return View() == _rhs.View(); }
+		//!
+		bool operator != (const String& _rhs) const { return View() != _rhs.View(); }
+		//!
+		bool operator == (const char* _rhs) const { return View() == StringView(_rhs); }
+		//!
+		bool operator != (const char* _rhs) const { return View() != StringView(_rhs); }
+		//! Lexicographical order.
+		bool operator < (const SharedString& _rhs) const { return View() < _rhs.View(); }
+
+		//!
+		const char* CStr(void) const { return m_buffer ? m_buffer->str : ""; }
+		//!
+		StringView View(void) const { return StringView(CStr(), Length()); }
+		//!
+		operator StringView (void) const { return View(); }
+		//!
+		String ToString(void) const { return String(CStr(), Length()); }
+
+		//!
+		uint Length(void) const { return m_buffer ? m_buffer->length : 0; }
+		//!
+		bool IsEmpty(void) const { return m_buffer == nullptr; }
+		//!
+		bool NonEmpty(void) const { return m_buffer != nullptr; }
+		//! Precomputed String::Hash of the text.
+		uint Hash(void) const { return m_buffer ? m_buffer->hash : 0; }
+		//! Number of copies that share the buffer.
+		int RefCount(void) const { return m_buffer ? AtomicGet(m_buffer->refCount, MemoryOrder::Relaxed) : 0; }
+
+		static const SharedString Empty;
+
+	protected:
+		//!
+		struct Buffer
+		{
+			int refCount;
+			uint length;
+			uint hash;
+			char str[1];
+		};
+
+		//! The increment can be relaxed, because the new copy is made from an existing reference.
+		void _AddRef(void) const { if (m_buffer) AtomicAdd(m_buffer->refCount, 1, MemoryOrder::Relaxed); }
+		//!
+		void _Release(void) { if (m_buffer && AtomicSubtract(m_buffer->refCount, 1, MemoryOrder::AcquireRelease) == 1) Deallocate(m_buffer); }
+		//! \return Null for empty string.
+		static Buffer* _Create(const char* _str, uint _length);
+
+		Buffer* m_buffer = nullptr;
+	};
+
+	//!
+	inline uint MakeHash(const SharedString& _value) { return _value.Hash(); }
+
+	//----------------------------------------------------------------------------//
+	// Utf8Range
+	//----------------------------------------------------------------------------//
+
+	//! Iterator of codepoints of UTF-8 text.
+	class Utf8Iterator
+	{
+	public:
+		//!
+		Utf8Iterator(const char* _pos, const char* _end) : m_pos(_pos), m_next(_pos), m_end(_end) { _Decode(); }
+
+		//!
+		uint operator * (void) const { return m_codepoint; }
+		//!
+		Utf8Iterator& operator ++ (void) { m_pos = m_next; _Decode(); return *this; }
+		//!
+		bool operator == (const Utf8Iterator& _rhs) const { return m_pos == _rhs.m_pos; }
+		//!
+		bool operator != (const Utf8Iterator& _rhs) const { return m_pos != _rhs.m_pos; }
+		//! Position of current codepoint in the text.
+		const char* Ptr(void) const { return m_pos; }
+
+	protected:
+		//!
+		void _Decode(void) { m_codepoint = m_next < m_end ? String::DecodeUtf8(m_next, m_end) : 0; }
+
+		const char* m_pos;
+		const char* m_next;
+		const char* m_end;
+		uint m_codepoint = 0;
+	};
+
+	//! Codepoints of UTF-8 text. Invalid bytes are decoded as U+FFFD.
+	class Utf8Range
+	{
+	public:
+		//!
+		Utf8Range(const StringView& _str) : m_str(_str) { }
+
+		//!
+		Utf8Iterator Begin(void) const { return Utf8Iterator(m_str.Ptr(), m_str.EndPtr()); }
+		//!
+		Utf8Iterator End(void) const { return Utf8Iterator(m_str.EndPtr(), m_str.EndPtr()); }
+		//! Number of codepoints.
+		uint Length(void) const { return String::Utf8Length(m_str.Ptr(), m_str.Length()); }
+
+	protected:
+		StringView m_str;
+	};
+
+	//!
+	inline Utf8Range String::Codepoints(void) const { return Utf8Range(View()); }
+
+	//!
+	inline Utf8Iterator begin(const Utf8Range& _range) { return _range.Begin(); }
+	//!
+	inline Utf8Iterator end(const Utf8Range& _range) { return _range.End(); }
+
+	//----------------------------------------------------------------------------//
+	// StringId
+	//----------------------------------------------------------------------------//
+
+	//! Interned string. All equal strings share one immutable entry in the global table,
+	//! so comparison is a pointer compare and the hash is computed only once.
+	//!\note The hash is equal to String::Hash of the same text.
+	class RX_API StringId
+	{
+	public:
+		//! Entry of the global table. Never deleted.
+		struct Entry
+		{
+			//! Next entry in the bucket.
+			Entry* next;
+			//!
+			uint hash;
+			//!
+			uint length;
+			//! Null-terminated text.
+			char str[1];
+		};
+
+		//!
+		StringId(void) = default;
+		//!
+		StringId(const char* _str, int _length = -1);
+		//!
+		StringId(const String& _str) : StringId(_str.CStr(), _str.Length()) { }
+		//!
+		StringId(const StringView& _str) : StringId(_str.Ptr(), _str.Length()) { }
+
+		//!
+		bool operator == (const StringId& _rhs) const { return m_entry == _rhs.m_entry; }
+		//!
+		bool operator != (const StringId& _rhs) const { return m_entry != _rhs.m_entry; }
+		//! Order of entries in memory. Is not lexicographical and can be different between launches.
+		bool operator < (const StringId& _rhs) const { return m_entry < _rhs.m_entry; }
+
+		//!
+		const char* CStr(void) const { return m_entry ? m_entry->str : ""; }
+		//!
+		uint Length(void) const { return m_entry ? m_entry->length : 0; }
+		//!
+		uint Hash(void) const { return m_entry ? m_entry->hash : 0; }
+		//!
+		bool IsEmpty(void) const { return m_entry == nullptr; }
+		//!
+		bool NonEmpty(void) const { return m_entry != nullptr; }
+
+		//! Intern a string with hash computed at compile time. \see RX_ID
+		template <uint Hash> static StringId Literal(const char* _str, uint _length) { return StringId(_Intern(_str, _length, Hash)); }
+
+		static const StringId Empty;
+
+	protected:
+		//!
+		explicit StringId(const Entry* _entry) : m_entry(_entry) { }
+
+		//! Find or add the string to the global table.
+		static const Entry* _Intern(const char* _str, uint _length, uint _hash);
+
+		const Entry* m_entry = nullptr;
+	};
+
+	//!
+	inline uint MakeHash(const StringId& _value) { return _value.Hash(); }
+
+	//!
+	inline FormatArg::FormatArg(const String& _str) : m_type(T_String) { m_str.ptr = _str.CStr(); m_str.length = _str.Length(); }
+	//!
+	inline FormatArg::FormatArg(const StringId& _str) : m_type(T_String) { m_str.ptr = _str.CStr(); m_str.length = _str.Length(); }
+	//!
+	inline uint FormatArg::StrLength(void) const { return m_str.length != ~0u ? m_str.length : String::Length(m_str.ptr); }
+
+	//! Format with the number of arguments checked at compile time. _fmt must be a string literal.
+#define RX_FORMAT(_fmt, ...) Reax::String::Format<Reax::String::FormatArgCount(_fmt)>(_fmt, ##__VA_ARGS__)
+
+	//! Get StringId of a literal. The hash is computed at compile time and the table is searched only once per call site.
+#define RX_ID(_literal) ([]() -> const Reax::StringId& { static const Reax::StringId _id = Reax::StringId::Literal<Reax::String::ConstHash(_literal)>(_literal, sizeof(_literal) - 1); return _id; }())
+
+	//----------------------------------------------------------------------------//
+	// GlobPattern
+	//----------------------------------------------------------------------------//
+
+	//! Compiled pattern of String::Match. Parses the pattern once and matches without memory allocation.
+	//! '*' - any sequence of characters, '?' - any character, ' ' - one or more spaces,
+	//! '[abc]' - set of characters, '[a-z]' - range of characters ('-' before ']' is a character), '\[', '\]', '\\' - escaped characters.
+	//! An empty string or pattern never matches.
+	class RX_API GlobPattern
+	{
+	public:
+		//!
+		GlobPattern(void) = default;
+		//!
+		GlobPattern(const char* _pattern, bool _ignoreCase = true) { Compile(_pattern, _ignoreCase); }
+
+		//!
+		GlobPattern& Compile(const char* _pattern, bool _ignoreCase = true);
+
+		//!
+		bool Match(const StringView& _str) const;
+		//! Match many strings. Appends indices of matched strings to _dst. \return Number of matched strings.
+		uint Filter(const StringView* _strs, uint _count, Array<uint>& _dst) const;
+		//!
+		uint Filter(const Array<String>& _strs, Array<uint>& _dst) const;
+
+		//!
+		const String& Pattern(void) const { return m_pattern; }
+		//!
+		bool IgnoreCase(void) const { return m_ignoreCase; }
+		//! Last character of the literal end of pattern ("*.ext"). Zero if pattern ends with a wildcard.
+		char SuffixKey(void) const { return m_suffixLength ? m_text[m_text.Length() - 1] : 0; }
+
+	protected:
+		//!
+		enum OpType : uint8
+		{
+			OP_Text, //!< literal text, lowered if the case is ignored
+			OP_Any, //!< '?'
+			OP_Star, //!< '*'
+			OP_Spaces, //!< ' '
+			OP_Set, //!< '[...]'
+		};
+
+		//!
+		struct Op
+		{
+			OpType type;
+			//! Offset in m_text or index in m_sets.
+			uint start;
+			//! Length of text.
+			uint length;
+		};
+
+		//! 256-bit set of characters.
+		struct CharSet
+		{
+			uint bits[8];
+
+			bool Contains(char _ch) const { return (bits[(uint8)_ch >> 5] >> (_ch & 31)) & 1; }
+		};
+
+		friend class GlobSet;
+
+		//!
+		bool _Match(const char* _str, const char* _end, uint _numOps) const;
+
+		String m_pattern;
+		String m_text;
+		Array<Op> m_ops;
+		Array<CharSet> m_sets;
+		uint m_minLength = 0;
+		//! Length of literal end of pattern that is preceded by '*'.
+		uint m_suffixLength = 0;
+		bool m_ignoreCase = true;
+		bool m_valid = false;
+	};
+
+	//----------------------------------------------------------------------------//
+	// GlobSet
+	//----------------------------------------------------------------------------//
+
+	//! Set of patterns matched against a string in one pass.
+	//! All patterns are compiled into one DFA over classes of characters, a string is matched by one table lookup per character
+	//! regardless of the number of patterns. The DFA is rebuilt by each Add, so the set is intended to be filled once (preferably
+	//! by one call) and used many times.
+	//! If the DFA has more than MAX_STATES states (many patterns with several '*'), the patterns are grouped by the last character
+	//! of their literal end and only a few of them are checked separately for each string.
+	class RX_API GlobSet
+	{
+	public:
+		//! Limit of number of states of DFA.
+		static const uint MAX_STATES = 4096;
+
+		//! Add a pattern and rebuild the DFA. \return Index of pattern.
+		uint Add(const char* _pattern, bool _ignoreCase = true) { return Add(&_pattern, 1, _ignoreCase); }
+		//! Add patterns and rebuild the DFA once. \return Index of first added pattern.
+		uint Add(const char* const* _patterns, uint _count, bool _ignoreCase = true);
+		//!
+		GlobSet& Clear(void);
+		//!
+		uint Size(void) const { return m_patterns.Size(); }
+		//!
+		const GlobPattern& operator [] (uint _index) const { return m_patterns[_index]; }
+
+		//! \return Index of first matched pattern or -1.
+		int Find(const StringView& _str) const;
+		//!
+		bool MatchAny(const StringView& _str) const { return Find(_str) >= 0; }
+		//! Appends indices of all matched patterns in ascending order to _dst. \return Number of matched patterns.
+		uint MatchAll(const StringView& _str, Array<uint>& _dst) const;
+		//! Select strings that match any of patterns. Appends indices of matched strings to _dst. \return Number of matched strings.
+		uint Filter(const StringView* _strs, uint _count, Array<uint>& _dst) const;
+		//!
+		uint Filter(const Array<String>& _strs, Array<uint>& _dst) const;
+		//! Returns true if the patterns are matched by DFA.
+		bool UsesDfa(void) const { return m_numClasses != 0; }
+
+	protected:
+		//! Build DFA of all patterns (subset construction).
+		void _Build(void);
+		//! Run DFA. \return Number of matched patterns, _matched points to their indices in ascending order.
+		uint _Run(const StringView& _str, const uint*& _matched) const;
+		//! Get sorted lists of patterns that can match the string.
+		void _Candidates(const StringView& _str, const uint*(&_lists)[3], uint(&_sizes)[3]) const;
+
+		Array<GlobPattern> m_patterns;
+		//! Transitions of DFA, m_numClasses per state. State 0 doesn't match anything.
+		Array<uint16> m_transitions;
+		//! Matched patterns of state i are m_matched[m_matchedStart[i]] .. m_matched[m_matchedStart[i + 1] - 1].
+		Array<uint> m_matchedStart;
+		//!
+		Array<uint> m_matched;
+		//! Class of each character. Characters of one class are not distinguished by any pattern.
+		uint8 m_classes[256];
+		//! Zero if DFA is not used.
+		uint m_numClasses = 0;
+		//!
+		uint m_start = 0;
+		//! The DFA exceeded MAX_STATES.
+		bool m_overflow = false;
+		//! Patterns without literal end.
+		Array<uint> m_other;
+		//! Case-sensitive patterns by last character.
+		Array<uint> m_bySuffix[256];
+		//! Case-insensitive patterns by lowered last character.
+		Array<uint> m_byISuffix[256];
+	};
+
 	//----------------------------------------------------------------------------//
 	// WString
 	//----------------------------------------------------------------------------//
 
-	//! Unicode string.
+	//! Unicode string. UTF-16 if wchar_t is 16-bit, otherwise UTF-32.
 	class RX_API WString
 	{
 	public:
+		//!
+		typedef ArrayIterator<wchar_t> Iterator;
+		//!
+		typedef ArrayIterator<const wchar_t> ConstIterator;
+
+		//!
+		WString(void) = default;
+		//!
+		~WString(void) { if (m_data) Deallocate(m_data); }
+		//!
+		WString(const WString& _other) { Append(_other); }
+		//!
+		WString(WString&& _temp) : m_length(_temp.m_length), m_capacity(_temp.m_capacity), m_data(_temp.m_data)
+		{
+			_temp.m_length = 0;
+			_temp.m_capacity = 0;
+			_temp.m_data = nullptr;
+		}
+		//!
+		WString(const wchar_t* _str, int _length = -1) { Append(_str, _length); }
+		//!
+		WString(uint _count, wchar_t _ch) { Append(_count, _ch); }
+		//! Convert from UTF-8.
+		explicit WString(const String& _str) : WString(String::ToWide(_str.CStr(), _str.Length())) { }
 
+		//!
+		WString& operator = (const WString& _rhs);
+		//!
+		WString& operator = (WString&& _rhs);
+		//!
+		WString& operator = (const wchar_t* _str) { return Clear().Append(_str); }
+
+		//!
+		wchar_t& operator [] (int _index) { ASSERT((uint)_index < m_length); return m_data[_index]; }
+		//!
+		wchar_t operator [] (int _index) const { ASSERT((uint)_index < m_length); return m_data[_index]; }
+
+		//!
+		operator const wchar_t* (void) const { return m_data; }
+		//!
+		wchar_t* Data(uint _offset = 0) { ASSERT(_offset <= m_length); return m_data + _offset; }
+		//!
+		const wchar_t* CStr(uint _offset = 0) const { ASSERT(_offset <= m_length); return m_data ? m_data + _offset : L""; }
+
+		//!
+		Iterator Begin(void) { return m_data; }
+		//!
+		ConstIterator Begin(void) const { return m_data; }
+		//!
+		Iterator End(void) { return m_data + m_length; }
+		//!
+		ConstIterator End(void) const { return m_data + m_length; }
+
+		//!
+		bool IsEmpty(void) const { return m_length == 0; }
+		//!
+		bool NonEmpty(void) const { return m_length != 0; }
+		//!
+		uint Length(void) const { return m_length; }
+		//!
+		uint Capacity(void) const { return m_capacity; }
+		//!
+		WString& Reserve(uint _maxLength);
+		//!
+		WString& Resize(uint _newLength, wchar_t _ch = 0);
+		//!
+		WString& Clear(void) { return Resize(0); }
+
+		//!
+		WString& operator += (const WString& _rhs) { return Append(_rhs); }
+		//!
+		WString& operator += (const wchar_t* _rhs) { return Append(_rhs); }
+		//!
+		WString& operator += (wchar_t _rhs) { return Append(1, _rhs); }
+		//!
+		WString operator + (const WString& _rhs) const { return WString(*this).Append(_rhs); }
+		//!
+		WString operator + (const wchar_t* _rhs) const { return WString(*this).Append(_rhs); }
+
+		//!
+		WString& Append(const WString& _str) { return Append(_str.m_data, _str.m_length); }
+		//!
+		WString& Append(const wchar_t* _str, int _length = -1);
+		//!
+		WString& Append(uint _count, wchar_t _ch);
+
+		//!
+		bool operator == (const WString& _rhs) const { return m_length == _rhs.m_length && Compare(CStr(), _rhs.CStr()) == 0; }
+		//!
+		bool operator == (const wchar_t* _rhs) const { return Compare(CStr(), _rhs) == 0; }
+		//!
+		bool operator != (const WString& _rhs) const { return !(*this == _rhs); }
+		//!
+		bool operator != (const wchar_t* _rhs) const { return !(*this == _rhs); }
+		//!
+		bool operator < (const WString& _rhs) const { return Compare(CStr(), _rhs.CStr()) < 0; }
+
+		//!
+		WString SubStr(uint _offset, int _length = -1) const;
+		//!
+		uint Hash(uint _hash = 0) const;
+		//! Convert to UTF-8.
+		String ToUtf8(void) const { return String::FromWide(*this); }
+
+		//!
+		static uint Length(const wchar_t* _str, int _length = -1) { return _str ? (uint)(_length < 0 ? wcslen(_str) : _length) : 0; }
+		//!
+		static int Compare(const wchar_t* _lhs, const wchar_t* _rhs) { return wcscmp(_lhs ? _lhs : L"", _rhs ? _rhs : L""); }
+
+		static const WString Empty;
 
 	protected:
+		friend class String;
+
 		uint m_length = 0;
 		uint m_capacity = 0;
 		wchar_t* m_data = nullptr;
 	};
 
+	//!
+	inline uint MakeHash(const WString& _value) { return _value.Hash(); }
+
+	//!
+	inline auto begin(WString& _str)->decltype(_str.Begin()) { return _str.Begin(); }
+	//!
+	inline auto begin(const WString& _str)->decltype(_str.Begin()) { return _str.Begin(); }
+	//!
+	inline auto end(WString& _str)->decltype(_str.End()) { return _str.End(); }
+	//!
+	inline auto end(const WString& _str)->decltype(_str.End()) { return _str.End(); }
+
 	//----------------------------------------------------------------------------//
 	// 
 	//----------------------------------------------------------------------------//
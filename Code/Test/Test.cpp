@@ -2,6 +2,10 @@
 #include <Concurrency.hpp>
 #include <String.hpp>
 #include <Object.hpp>
+#include <Math.hpp>
+#include <MathBatch.hpp>
+#include <Serializer.hpp>
+#include <Entity.hpp>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -286,6 +290,702 @@ void MyContainerBenchmark()
 // -     Base.natvis
 // -  m_caps  m_capasity
 
+void StringBenchmark(uint _size = 16 * 1024 * 1024)
+{
+	Timer _timer;
+	printf("%d bytes\n", _size);
+
+	// scalar versions for comparison
+	struct Scalar
+	{
+		static const char* Find(const char* _str1, const char* _str2)
+		{
+			for (; *_str1; _str1++)
+			{
+				for (const char *a = _str1, *b = _str2; String::Lower(*a++) == String::Lower(*b++);)
+				{
+					if (!*b)
+						return _str1;
+				}
+			}
+			return nullptr;
+		}
+		static void Lower(char* _str)
+		{
+			for (; *_str; ++_str)
+				*_str = String::Lower(*_str);
+		}
+		static int Compare(const char* _lhs, const char* _rhs)
+		{
+			for (;; ++_lhs, ++_rhs)
+			{
+				int _d = (uint8)String::Lower(*_lhs) - (uint8)String::Lower(*_rhs);
+				if (_d || !*_lhs)
+					return _d;
+			}
+		}
+		static uint IHash(const char* _str)
+		{
+			uint _hash = 0;
+			while (*_str)
+				_hash = String::Lower(*_str++) + (_hash << 6) + (_hash << 16) - _hash;
+			return _hash;
+		}
+	};
+
+	// asset-like names
+	String _text;
+	_text.Reserve(_size);
+	srand(1);
+	while (_text.Length() < _size - 64)
+	{
+		_text += "Textures/Level";
+		_text.Append((uint)(rand() % 9 + 1), (char)('A' + rand() % 26));
+		_text += "_diffuse.dds;";
+	}
+	String _needle = "textures/levelxxxxx_NORMAL.DDS";
+	_text += "Textures/LevelXXXXX_normal.dds";
+	String _copy = _text;
+	String _upper = _text.Upper();
+
+	const char* _r1;
+	const char* _r2;
+	uint _h1, _h2;
+	int _c1, _c2;
+
+	_timer.Start();
+	_r1 = Scalar::Find(_text, _needle);
+	_timer.Stop();
+	printf("scalar Find(ignoreCase): time: %f seconds\n", _timer.time);
+	_timer.Start();
+	_r2 = String::Find(_text, _needle, true);
+	_timer.Stop();
+	printf("String::Find(ignoreCase): time: %f seconds, %s\n", _timer.time, _r1 == _r2 ? "ok" : "FAILED");
+
+	_timer.Start();
+	_c1 = Scalar::Compare(_text, _upper);
+	_timer.Stop();
+	printf("scalar Compare(ignoreCase): time: %f seconds\n", _timer.time);
+	_timer.Start();
+	_c2 = String::Compare(_text, _upper, true);
+	_timer.Stop();
+	printf("String::Compare(ignoreCase): time: %f seconds, %s\n", _timer.time, _c1 == _c2 ? "ok" : "FAILED");
+
+	_timer.Start();
+	_h1 = Scalar::IHash(_text);
+	_timer.Stop();
+	printf("scalar IHash: time: %f seconds\n", _timer.time);
+	_timer.Start();
+	_h2 = String::IHash(_text);
+	_timer.Stop();
+	printf("String::IHash: time: %f seconds, %s\n", _timer.time, _h1 == _h2 ? "ok" : "FAILED");
+
+	_timer.Start();
+	Scalar::Lower(_copy.Data());
+	_timer.Stop();
+	printf("scalar Lower: time: %f seconds\n", _timer.time);
+	_timer.Start();
+	_text.MakeLower();
+	_timer.Stop();
+	printf("String::MakeLower: time: %f seconds, %s\n", _timer.time, _text == _copy ? "ok" : "FAILED");
+
+	// length, decoding and transcoding of invalid UTF-8 must agree
+	const char _utf8[] = "a\x80\x80\xe0\x80\x80\xe2\x82\xac\xed\xa0\x80\xf0\x9f";
+	uint _utf8Length = sizeof(_utf8) - 1, _decoded = 0;
+	for (const char* _p = _utf8; _p < _utf8 + _utf8Length; ++_decoded)
+		String::DecodeUtf8(_p, _utf8 + _utf8Length);
+	uint _counted = String::Utf8Length(_utf8, _utf8Length);
+	printf("String::Utf8Length: %d codepoints, %s\n", _counted, _counted == _decoded && _decoded == String::ToWide(_utf8, _utf8Length).Length() ? "ok" : "FAILED");
+
+	// GlobSet must match the same strings as its patterns
+	const char* _globs[] = { "*.png", "Textures/*_n.*", "*lod[0-3]*", "a b?", "[!-/]*\\]" };
+	const char* _names[] = { "ui/icon.PNG", "textures/rock_n.dds", "rock_lod2.fbx", "a   bc", "a bcd", "-x]", "texture/x_n.dds", "" };
+	GlobSet _globSet;
+	_globSet.Add(_globs, sizeof(_globs) / sizeof(_globs[0]));
+	uint _globErrors = 0;
+	for (const char* _name : _names)
+	{
+		Array<uint> _matched;
+		_globSet.MatchAll(_name, _matched);
+		for (uint i = 0, j = 0; i < _globSet.Size(); ++i)
+		{
+			bool _match = j < _matched.Size() && _matched[j] == i;
+			_globErrors += _match != _globSet[i].Match(_name);
+			j += _match;
+		}
+	}
+	printf("GlobSet (%s): %s\n", _globSet.UsesDfa() ? "DFA" : "candidates", _globErrors ? "FAILED" : "ok");
+}
+
+//! Compare results that are identical unless the compiler fuses multiply and add (-ffp-contract, /fp:contract).
+bool Near(float _a, float _b, float _eps = 1e-6f)
+{
+	return Abs(_a - _b) <= _eps * Max(1.0f, Abs(_b));
+}
+template <class T> bool Near(const T& _a, const T& _b, float _eps = 1e-6f)
+{
+	for (uint i = 0; i < sizeof(_a.v) / sizeof(_a.v[0]); ++i)
+	{
+		if (!Near(_a.v[i], _b.v[i], _eps))
+			return false;
+	}
+	return true;
+}
+
+void MathTest(uint _num = 1000000)
+{
+	Timer _timer;
+	printf("%d iterations\n", _num);
+
+	// scalar reference, the order of operations is the same as in Math.hpp
+	struct Scalar
+	{
+		static float Dot(const float* _a, const float* _b)
+		{
+			return (_a[0] * _b[0] + _a[1] * _b[1]) + (_a[2] * _b[2] + _a[3] * _b[3]);
+		}
+		static Matrix4x4 Mul(const Matrix4x4& _a, const Matrix4x4& _b)
+		{
+			Matrix4x4 _r;
+			for (uint i = 0; i < 4; ++i)
+			{
+				for (uint j = 0; j < 4; ++j)
+					_r.m[i][j] = ((_a.m[i][0] * _b.m[0][j] + _a.m[i][1] * _b.m[1][j]) + _a.m[i][2] * _b.m[2][j]) + _a.m[i][3] * _b.m[3][j];
+			}
+			return _r;
+		}
+		static Vector4 Mul(const Matrix4x4& _m, const Vector4& _v)
+		{
+			return Vector4(Dot(_m.m[0], _v.v), Dot(_m.m[1], _v.v), Dot(_m.m[2], _v.v), Dot(_m.m[3], _v.v));
+		}
+		static Matrix3x4 Mul(const Matrix3x4& _a, const Matrix3x4& _b)
+		{
+			Matrix3x4 _r;
+			for (uint i = 0; i < 3; ++i)
+			{
+				for (uint j = 0; j < 4; ++j)
+					_r.m[i][j] = (_a.m[i][0] * _b.m[0][j] + _a.m[i][1] * _b.m[1][j]) + _a.m[i][2] * _b.m[2][j] + (j == 3 ? _a.m[i][3] : 0);
+			}
+			return _r;
+		}
+		static Quaternion Mul(const Quaternion& _a, const Quaternion& _b)
+		{
+			return Quaternion(
+				((_a.w * _b.x + _a.x * _b.w) + _a.y * _b.z) - _a.z * _b.y,
+				((_a.w * _b.y - _a.x * _b.z) + _a.y * _b.w) + _a.z * _b.x,
+				((_a.w * _b.z + _a.x * _b.y) - _a.y * _b.x) + _a.z * _b.w,
+				((_a.w * _b.w - _a.x * _b.x) - _a.y * _b.y) - _a.z * _b.z);
+		}
+		static void Inverse(const Matrix4x4& _m, double* _r) // by cofactors
+		{
+			double _a[16];
+			for (uint i = 0; i < 16; ++i)
+				_a[i] = _m.v[i];
+			for (uint i = 0; i < 4; ++i)
+			{
+				for (uint j = 0; j < 4; ++j)
+				{
+					double _s[9];
+					for (uint k = 0, n = 0; k < 4; ++k)
+					{
+						for (uint l = 0; l < 4; ++l)
+						{
+							if (k != i && l != j)
+								_s[n++] = _a[k * 4 + l];
+						}
+					}
+					double _minor = _s[0] * (_s[4] * _s[8] - _s[5] * _s[7]) - _s[1] * (_s[3] * _s[8] - _s[5] * _s[6]) + _s[2] * (_s[3] * _s[7] - _s[4] * _s[6]);
+					_r[j * 4 + i] = ((i + j) & 1) ? -_minor : _minor;
+				}
+			}
+			double _det = _a[0] * _r[0] + _a[1] * _r[4] + _a[2] * _r[8] + _a[3] * _r[12];
+			for (uint i = 0; i < 16; ++i)
+				_r[i] /= _det;
+		}
+	};
+
+	srand(1);
+	auto _rand = []() { return (float)rand() / RAND_MAX * 2 - 1; };
+	const uint _count = 1024;
+	Array<Matrix4x4> _m4(_count);
+	Array<Matrix3x4> _m3(_count);
+	Array<Vector4> _v4(_count);
+	Array<Quaternion> _q(_count);
+	for (uint i = 0; i < _count; ++i)
+	{
+		for (uint j = 0; j < 16; ++j)
+			_m4[i].v[j] = _rand();
+		for (uint j = 0; j < 12; ++j)
+			_m3[i].v[j] = _rand();
+		_v4[i] = Vector4(_rand(), _rand(), _rand(), _rand());
+		_q[i] = Quaternion(_rand(), _rand(), _rand(), _rand()).Normalize();
+	}
+
+	// identical results, up to the rounding of fused multiply-add
+	uint _errors = 0;
+	for (uint i = 0; i < _count; ++i)
+	{
+		uint j = (i + 1) % _count;
+		const Vector4& a = _v4[i];
+		const Vector4& b = _v4[j];
+		Vector4 _sum(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+		Vector4 _mul(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+		Vector4 _lerp(a.x + (b.x - a.x) * 0.3f, a.y + (b.y - a.y) * 0.3f, a.z + (b.z - a.z) * 0.3f, a.w + (b.w - a.w) * 0.3f);
+		float _l = sqrtf(Scalar::Dot(a.v, a.v));
+		Vector4 _norm(a.x / _l, a.y / _l, a.z / _l, a.w / _l);
+		_errors += a + b != _sum;
+		_errors += a * b != _mul;
+		_errors += !Near(a.Lerp(b, 0.3f), _lerp);
+		_errors += !Near(a.Dot(b), Scalar::Dot(a.v, b.v));
+		_errors += !Near(a.Copy().Normalize(), _norm);
+		_errors += !Near(_m4[i] * _m4[j], Scalar::Mul(_m4[i], _m4[j]));
+		_errors += !Near(_m4[i] * a, Scalar::Mul(_m4[i], a));
+		_errors += _m4[i].Transpose().Transpose() != _m4[i];
+		_errors += !Near(_m3[i] * _m3[j], Scalar::Mul(_m3[i], _m3[j]));
+		_errors += !Near(_q[i] * _q[j], Scalar::Mul(_q[i], _q[j]));
+	}
+	printf("Vector4, Quaternion, Matrix: %s\n", _errors ? "FAILED" : "ok");
+
+	// results of different algorithms
+	float _maxError = 0;
+	for (uint i = 0; i < _count; ++i)
+	{
+		uint j = (i + 1) % _count;
+		double _ref[16];
+		Scalar::Inverse(_m4[i], _ref);
+		Matrix4x4 _inv = _m4[i].Inverse();
+		double _scale = 0, _norm = 0; // the error grows with the condition number, ~_norm * _scale
+		for (uint k = 0; k < 16; ++k)
+			_scale = Max(_scale, fabs(_ref[k])), _norm = Max(_norm, (double)fabs(_m4[i].v[k]));
+		for (uint k = 0; k < 16; ++k)
+			_maxError = Max(_maxError, (float)(fabs(_inv.v[k] - _ref[k]) / (_scale * _scale * _norm)));
+
+		Matrix3x4 _t = _m3[i] * _m3[i].Inverse();
+		for (uint k = 0; k < 12; ++k)
+			_maxError = Max(_maxError, Abs(_t.v[k] - ((k % 5) ? 0.0f : 1.0f)) * 1e-2f); // ill-conditioned matrices are not rare
+
+		Vector3 _p(_rand(), _rand(), _rand());
+		Vector3 _r = _q[i] * _p;
+		Quaternion _qp = _q[i] * Quaternion(_p.x, _p.y, _p.z, 0) * _q[i].Conjugate();
+		_maxError = Max(_maxError, Max(Abs(_r.x - _qp.x), Abs(_r.y - _qp.y), Abs(_r.z - _qp.z)));
+		_r = Matrix3x4(Vector3(0), _q[i]).TransformPoint(_p) - _r;
+		_maxError = Max(_maxError, Max(Abs(_r.x), Abs(_r.y), Abs(_r.z)));
+
+		Quaternion _s = _q[i].Slerp(_q[j], 0.25f);
+		Quaternion _qj = _q[i].Dot(_q[j]) < 0 ? -_q[j] : _q[j];
+		double _angle = acos(Min(1.0, (double)_q[i].Dot(_qj)));
+		for (uint k = 0; k < 4; ++k)
+		{
+			double _e = _angle > 1e-3 ? (sin(0.75 * _angle) * _q[i].v[k] + sin(0.25 * _angle) * _qj.v[k]) / sin(_angle) : _q[i].v[k];
+			_maxError = Max(_maxError, (float)fabs(_s.v[k] - _e));
+		}
+	}
+	printf("Inverse, rotation, Slerp: max error %g, %s\n", _maxError, _maxError < 1e-4f ? "ok" : "FAILED");
+
+	// throughput
+	Matrix4x4 _acc;
+	_acc.SetIdentity();
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_acc = Scalar::Mul(_m4[i & (_count - 1)], _acc);
+	_timer.Stop();
+	printf("scalar Matrix4x4 * Matrix4x4: time: %f seconds\n", _timer.time);
+	Matrix4x4 _acc2;
+	_acc2.SetIdentity();
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_acc2 = _m4[i & (_count - 1)] * _acc2;
+	_timer.Stop();
+	printf("Matrix4x4 * Matrix4x4: time: %f seconds, %s\n", _timer.time, memcmp(&_acc, &_acc2, sizeof(_acc)) == 0 ? "ok" : "FAILED");
+}
+
+void FastMathBenchmark(uint _num = 1000000)
+{
+	Timer _timer;
+	printf("%d values\n", _num);
+
+	srand(1);
+	auto _rand = []() { return (float)rand() / RAND_MAX; };
+	Array<float> _angle(_num), _x(_num), _y(_num), _pos(_num), _exp(_num);
+	for (uint i = 0; i < _num; ++i)
+	{
+		_angle[i] = (_rand() * 2 - 1) * 1000;
+		_x[i] = _rand() * 2 - 1;
+		_y[i] = _rand() * 2 - 1;
+		_pos[i] = _rand() * 1000 + 1e-3f;
+		_exp[i] = (_rand() * 2 - 1) * 100;
+	}
+	Array<float> _ref(_num), _ref2(_num), _r(_num), _r2(_num);
+	double _libm, _maxError;
+	uint _errors;
+
+	// error is measured against double precision, batch and scalar results must be identical (up to fused multiply-add)
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_ref[i] = 1 / sqrtf(_pos[i]);
+	_timer.Stop();
+	_libm = _timer.time;
+	_timer.Start();
+	RSqrt(_pos.Data(), _r.Data(), _num);
+	_timer.Stop();
+	_maxError = 0, _errors = 0;
+	for (uint i = 0; i < _num; ++i)
+	{
+		_maxError = Max(_maxError, fabs(_r[i] * sqrt((double)_pos[i]) - 1));
+		_errors += !Near(_r[i], RSqrt(_pos[i]));
+	}
+	printf("RSqrt: libm: %f seconds, fast: %f seconds, max relative error: %g, %s\n", _libm, _timer.time, _maxError, !_errors && _maxError < 3e-7 ? "ok" : "FAILED");
+
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_ref[i] = sinf(_angle[i]), _ref2[i] = cosf(_angle[i]);
+	_timer.Stop();
+	_libm = _timer.time;
+	_timer.Start();
+	SinCos(_angle.Data(), _r.Data(), _r2.Data(), _num);
+	_timer.Stop();
+	_maxError = 0, _errors = 0;
+	for (uint i = 0; i < _num; ++i)
+	{
+		_maxError = Max(_maxError, fabs(_r[i] - sin((double)_angle[i])), fabs(_r2[i] - cos((double)_angle[i])));
+		_errors += !Near(_r[i], Sin(_angle[i])) || !Near(_r2[i], Cos(_angle[i]));
+	}
+	printf("SinCos: libm: %f seconds, fast: %f seconds, max error: %g, %s\n", _libm, _timer.time, _maxError, !_errors && _maxError < 1e-7 ? "ok" : "FAILED");
+
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_ref[i] = atan2f(_y[i], _x[i]);
+	_timer.Stop();
+	_libm = _timer.time;
+	_timer.Start();
+	ATan2(_y.Data(), _x.Data(), _r.Data(), _num);
+	_timer.Stop();
+	_maxError = 0, _errors = 0;
+	for (uint i = 0; i < _num; ++i)
+	{
+		_maxError = Max(_maxError, fabs(_r[i] - atan2((double)_y[i], (double)_x[i])));
+		_errors += !Near(_r[i], ATan2(_y[i], _x[i]));
+	}
+	printf("ATan2: libm: %f seconds, fast: %f seconds, max error: %g, %s\n", _libm, _timer.time, _maxError, !_errors && _maxError < 1e-6 ? "ok" : "FAILED");
+
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_ref[i] = exp2f(_exp[i]);
+	_timer.Stop();
+	_libm = _timer.time;
+	_timer.Start();
+	Exp2(_exp.Data(), _r.Data(), _num);
+	_timer.Stop();
+	_maxError = 0, _errors = 0;
+	for (uint i = 0; i < _num; ++i)
+	{
+		_maxError = Max(_maxError, fabs(_r[i] / exp2((double)_exp[i]) - 1));
+		_errors += !Near(_r[i], Exp2(_exp[i]));
+	}
+	printf("Exp2: libm: %f seconds, fast: %f seconds, max relative error: %g, %s\n", _libm, _timer.time, _maxError, !_errors && _maxError < 2.5e-7 ? "ok" : "FAILED");
+
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_ref[i] = log2f(_pos[i]);
+	_timer.Stop();
+	_libm = _timer.time;
+	_timer.Start();
+	Log2(_pos.Data(), _r.Data(), _num);
+	_timer.Stop();
+	_maxError = 0, _errors = 0;
+	for (uint i = 0; i < _num; ++i)
+	{
+		_maxError = Max(_maxError, fabs(_r[i] - log2((double)_pos[i])));
+		_errors += !Near(_r[i], Log2(_pos[i]));
+	}
+	printf("Log2: libm: %f seconds, fast: %f seconds, max error: %g, %s\n", _libm, _timer.time, _maxError, !_errors && _maxError < 4e-6 ? "ok" : "FAILED");
+
+	_errors = 0;
+	for (uint i = 1; i < 0x7fffffff && !_errors; i = i * 3 + 1)
+		_errors += Log2i(i) != (int)floor(log2((double)i));
+	printf("Log2i: %s\n", _errors ? "FAILED" : "ok");
+
+	// exponent overflow, large angles (libm path) and signed zeros
+	_errors = 0;
+	_errors += fabs(Exp2(127.6f) / exp2((double)127.6f) - 1) > 2.5e-7 || !isinf(Exp2(128.0f));
+	_errors += fabs(Sin(1e7f) - sin(1e7)) > 1e-6 || fabs(Cos(-1e7f) - cos(-1e7)) > 1e-6;
+	_errors += ATan2(0.0f, -0.0f) != PI || ATan2(-0.0f, -0.0f) != -PI || ATan2(-0.0f, 0.0f) != 0;
+	printf("Edge cases: %s\n", _errors ? "FAILED" : "ok");
+}
+
+class SerializedMaterial : public Object
+{
+	RX_OBJECT(SerializedMaterial, Object);
+
+public:
+	String m_shader;
+	Vector4 m_color;
+	bool m_twoSided = false;
+};
+
+RX_TYPE(SerializedMaterial)
+{
+	RX_ATTRIBUTE("Shader", m_shader);
+	RX_ATTRIBUTE("Color", m_color);
+	RX_ATTRIBUTE("TwoSided", m_twoSided);
+}
+
+class SerializedNode : public Object
+{
+	RX_OBJECT(SerializedNode, Object);
+
+public:
+	const String& GetName(void) const { return m_name; }
+	void SetName(const String& _name) { m_name = _name; }
+
+	Vector3 m_position;
+	float m_scale = 1;
+	String m_name;
+	StringId m_tag;
+	ObjectPtr m_material;
+	ObjectPtr m_parent;
+	bool m_visible = true;
+	int m_temp = 0;
+};
+
+RX_TYPE(SerializedNode)
+{
+	RX_ATTRIBUTE("Position", m_position);
+	RX_ATTRIBUTE("Scale", m_scale);
+	RX_ACCESSOR("Name", GetName, SetName);
+	RX_ATTRIBUTE("Tag", m_tag);
+	RX_ATTRIBUTE("Material", m_material);
+	RX_ATTRIBUTE("Parent", m_parent);
+	RX_ATTRIBUTE("Visible", m_visible);
+	RX_ATTRIBUTE("Temp", m_temp, Attribute::F_NoSerialize);
+}
+
+void SerializerTest(uint _num = 1000)
+{
+	Timer _timer;
+	printf("%d objects\n", _num);
+
+	ObjectPtr _material = new SerializedMaterial;
+	_material.Cast<SerializedMaterial>()->m_shader = "lit";
+	_material.Cast<SerializedMaterial>()->m_color = Vector4(1, 0.5f, 0.25f, 1);
+	_material.Cast<SerializedMaterial>()->m_twoSided = true;
+
+	// chain of nodes, only the last one is saved explicitly
+	Array<ObjectPtr> _nodes;
+	for (uint i = 0; i < _num; ++i)
+	{
+		SerializedNode* _node = new SerializedNode;
+		_nodes.Push(_node);
+		_node->m_position = Vector3((float)i, (float)i * 2, (float)i * 3);
+		_node->m_scale = i * 0.5f;
+		_node->m_name = RX_FORMAT("node%d", i);
+		_node->m_tag = RX_ID("tag");
+		_node->m_material = _material;
+		_node->m_parent = i ? _nodes[i - 1] : nullptr;
+		_node->m_visible = (i & 1) != 0;
+		_node->m_temp = 5;
+	}
+
+	Array<uint8> _blob;
+	_timer.Start();
+	BinarySerializer::Save(_blob, _nodes.Back(), 7);
+	_timer.Stop();
+	printf("BinarySerializer::Save: time: %f seconds, size: %d bytes\n", _timer.time, _blob.Size());
+
+	uint _errors = 0;
+	BlobView _view(_blob.Data(), _blob.Size());
+	const BlobString* _name = _view.Get<BlobString>(0, "Name");
+	_errors += !_view.IsValid() || _view.Version() != 7 || _view.NumRoots() != 1 || _view.NumObjects() != _num + 1;
+	_errors += !_name || RX_FORMAT("node%d", _num - 1) != _name->CStr();
+
+	Array<ObjectPtr> _loaded;
+	_timer.Start();
+	_errors += !BinarySerializer::Load(_view, _loaded) || _loaded.Size() != 1;
+	_timer.Stop();
+
+	SerializedNode* _node = _loaded.Size() ? _loaded[0].Cast<SerializedNode>() : nullptr;
+	SerializedMaterial* _loadedMaterial = _node ? _node->m_material.Cast<SerializedMaterial>() : nullptr;
+	_errors += !_loadedMaterial || _loadedMaterial->m_shader != "lit" || _loadedMaterial->m_color != Vector4(1, 0.5f, 0.25f, 1) || !_loadedMaterial->m_twoSided;
+	uint _depth = 0;
+	for (uint i = _num; i-- > 0 && _node; _node = _node->m_parent.Cast<SerializedNode>(), ++_depth)
+	{
+		_errors += _node->m_position != Vector3((float)i, (float)i * 2, (float)i * 3) || _node->m_scale != i * 0.5f || _node->m_name != RX_FORMAT("node%d", i);
+		_errors += _node->m_tag != RX_ID("tag") || _node->m_visible != ((i & 1) != 0) || _node->m_temp != 0 || _node->m_material.Get() != _loadedMaterial;
+		_errors += !i && _node->m_parent;
+	}
+	_errors += _depth != _num;
+	printf("BinarySerializer::Load: time: %f seconds, %s\n", _timer.time, _errors ? "FAILED" : "ok");
+
+	// break the chains iteratively
+	for (ObjectPtr& _object : _nodes)
+		_object.Cast<SerializedNode>()->m_parent = nullptr;
+	for (ObjectPtr _object = _loaded.Size() ? _loaded[0] : nullptr; _object; )
+	{
+		ObjectPtr _parent = _object.Cast<SerializedNode>()->m_parent;
+		_object.Cast<SerializedNode>()->m_parent = nullptr;
+		_object = _parent;
+	}
+}
+
+struct EcsPosition { float x = 0, y = 0, z = 0; };
+struct EcsVelocity { float x = 1, y = 2, z = 3; };
+struct EcsMass { float mass = 1; };
+struct EcsName { std::string name; }; // short strings are not trivially relocatable in some implementations
+
+struct EcsObject
+{
+	EcsPosition position;
+	EcsVelocity velocity;
+	EcsMass mass;
+};
+
+void EntityBenchmark(uint _num = 1000000)
+{
+	Timer _timer;
+	printf("%d entities\n", _num);
+
+	SharedPtr<EntityWorld> _world = new EntityWorld;
+	const ComponentMask _mask = ComponentMaskOf<EcsPosition, EcsVelocity, EcsMass>();
+	Array<Entity> _entities(_num);
+	_timer.Start();
+	for (uint i = 0; i < _num; ++i)
+		_entities[i] = _world->Create(_mask);
+	_timer.Stop();
+	printf("EntityWorld::Create: time: %f seconds\n", _timer.time);
+
+	// objects allocated one by one and visited in random order
+	srand(1);
+	std::vector<std::unique_ptr<EcsObject>> _objects(_num);
+	for (uint i = 0; i < _num; ++i)
+		_objects[i].reset(new EcsObject);
+	for (uint i = _num; i > 1; --i)
+		std::swap(_objects[i - 1], _objects[(((uint)rand() << 15) | (uint)rand()) % i]);
+	_timer.Start();
+	for (auto& _object : _objects)
+	{
+		_object->position.x += _object->velocity.x * _object->mass.mass;
+		_object->position.y += _object->velocity.y * _object->mass.mass;
+		_object->position.z += _object->velocity.z * _object->mass.mass;
+	}
+	_timer.Stop();
+	printf("objects update: time: %f seconds\n", _timer.time);
+
+	_timer.Start();
+	_world->ForEach<EcsPosition, EcsVelocity, EcsMass>([](const Entity&, EcsPosition& _p, EcsVelocity& _v, EcsMass& _m)
+	{
+		_p.x += _v.x * _m.mass;
+		_p.y += _v.y * _m.mass;
+		_p.z += _v.z * _m.mass;
+	});
+	_timer.Stop();
+	printf("EntityWorld::ForEach: time: %f seconds\n", _timer.time);
+
+	_timer.Start();
+	_world->ForEachParallel<EcsPosition, EcsVelocity, EcsMass>([](const Entity&, EcsPosition& _p, EcsVelocity& _v, EcsMass& _m)
+	{
+		_p.x += _v.x * _m.mass;
+		_p.y += _v.y * _m.mass;
+		_p.z += _v.z * _m.mass;
+	});
+	_timer.Stop();
+	uint _errors = 0;
+	_world->ForEach<EcsPosition>([&_errors](const Entity&, EcsPosition& _p) { _errors += _p.x != 2 || _p.y != 4 || _p.z != 6; });
+	printf("EntityWorld::ForEachParallel: time: %f seconds, %s\n", _timer.time, _errors ? "FAILED" : "ok");
+
+	// structural changes during iteration are deferred, the names are moved between pages of the buffer
+	EntityCommandBuffer _commands;
+	uint _numNamed = 0;
+	_timer.Start();
+	_world->ForEach<EcsPosition, EcsMass>([&](const Entity& _entity, EcsPosition&, EcsMass&)
+	{
+		if (_entity.index % 100 == 0)
+		{
+			_commands.Add<EcsName>(_entity, { std::string(8, 'a' + _entity.index % 26) });
+			_commands.Remove<EcsMass>(_entity);
+			++_numNamed;
+		}
+		else if (_entity.index % 100 == 1)
+			_commands.Destroy(_entity);
+	});
+	Entity _created = _commands.Create(ComponentMaskOf<EcsPosition>());
+	_commands.Add<EcsName>(_created, { "created" });
+	_commands.Playback(*_world);
+	_timer.Stop();
+	uint _named = 0;
+	_world->ForEach<EcsName>([&](const Entity& _entity, EcsName& _name)
+	{
+		++_named;
+		if (_name.name == "created")
+			_errors += _world->GetMask(_entity) != (ComponentMaskOf<EcsPosition, EcsName>());
+		else
+			_errors += _name.name != std::string(8, 'a' + _entity.index % 26) || _world->Has<EcsMass>(_entity);
+	});
+	_errors += !_commands.IsEmpty() || _named != _numNamed + 1 || _world->Size() != _num - _num / 100 - (_num % 100 > 1) + 1;
+	printf("EntityCommandBuffer::Playback: time: %f seconds, %s\n", _timer.time, _errors ? "FAILED" : "ok");
+
+	// random changes compared with a plain model
+	_world = new EntityWorld;
+	_entities.Clear();
+	Array<ComponentMask> _masks;
+	Array<float> _values;
+	Array<Entity> _dead;
+	const uint _ids[] = { ComponentType<EcsPosition>::Id(), ComponentType<EcsVelocity>::Id(), ComponentType<EcsMass>::Id(), ComponentType<EcsName>::Id() };
+	const ComponentMask _types[] = { ComponentType<EcsPosition>::Mask(), ComponentType<EcsVelocity>::Mask(), ComponentType<EcsMass>::Mask(), ComponentType<EcsName>::Mask() };
+	for (uint i = 0; i < 100000; ++i)
+	{
+		uint _op = rand() % 6; // create, destroy, add and remove in ratio 2:1:2:1
+		uint _index = _entities.Size() ? rand() % _entities.Size() : 0;
+		uint _id = rand() % 4;
+		ComponentMask _type = _types[_id];
+		if (_op < 2 || _entities.IsEmpty())
+		{
+			ComponentMask _components = (rand() & 1 ? _types[0] : 0) | (rand() & 1 ? _types[1] : 0) | (rand() & 1 ? _types[2] : 0);
+			Entity _entity = _world->Create(_components);
+			if (_components & _types[0])
+				_world->Get<EcsPosition>(_entity)->x = (float)i;
+			_entities.Push(_entity);
+			_masks.Push(_components);
+			_values.Push((float)i);
+		}
+		else if (_op == 2)
+		{
+			_world->Destroy(_entities[_index]);
+			_dead.Push(_entities[_index]);
+			_entities[_index] = _entities.Back(), _masks[_index] = _masks.Back(), _values[_index] = _values.Back();
+			_entities.Pop(), _masks.Pop(), _values.Pop();
+		}
+		else if (_op < 5)
+		{
+			if (_id == 0)
+				_world->Add<EcsPosition>(_entities[_index], { (float)i, 0, 0 }), _values[_index] = (float)i;
+			else if (_id == 3)
+				_world->Add<EcsName>(_entities[_index], { "name" });
+			else
+				_world->AddComponent(_entities[_index], _ids[_id]);
+			_masks[_index] |= _type;
+		}
+		else
+		{
+			_world->RemoveComponent(_entities[_index], _ids[_id]);
+			_masks[_index] &= ~_type;
+		}
+	}
+	_errors = _world->Size() != _entities.Size();
+	for (uint i = 0; i < _entities.Size(); ++i)
+	{
+		_errors += !_world->IsAlive(_entities[i]) || _world->GetMask(_entities[i]) != _masks[i];
+		_errors += (_masks[i] & _types[0]) && _world->Get<EcsPosition>(_entities[i])->x != _values[i];
+		_errors += (_masks[i] & _types[3]) && _world->Get<EcsName>(_entities[i])->name != "name";
+	}
+	for (const Entity& _entity : _dead)
+		_errors += _world->IsAlive(_entity);
+	uint _count = 0;
+	_world->ForEach<EcsPosition>([&](const Entity& _entity, EcsPosition& _p) { ++_count, _errors += _world->Get<EcsPosition>(_entity) != &_p; });
+	for (ComponentMask _m : _masks)
+		_count -= (_m & _types[0]) != 0;
+	printf("EntityWorld random changes: %d entities, %d archetypes, %s\n", _entities.Size(), _world->Archetypes().Size(), _errors || _count ? "FAILED" : "ok");
+}
+
 void main()
 {
 	std::vector<int> sv = { 1, 2, 3 };
@@ -325,6 +1025,19 @@ void main()
 	MyContainerBenchmark();
 	printf("\n");
 	StdContainerBenchmark();
+	printf("\n");
+	StringBenchmark();
+	printf("\n");
+	MathTest();
+	printf("\n");
+	FastMathBenchmark();
+	printf("\n");
+	{
+		ReflectionSystem _reflection;
+		SerializerTest();
+		printf("\n");
+		EntityBenchmark();
+	}
 
 	std::shared_ptr<int> ssp = std::make_shared<int>(0);
 	std::weak_ptr<int> swp = ssp;